@@ -0,0 +1,656 @@
+// CEF Browser - Page Load Benchmark
+// Loads every page of a local corpus K times in headless mode and reports
+// time-to-commit, load end, first paint and peak renderer RSS.
+//
+// Pages are served from https://bench.test/ by an in-process scheme handler,
+// so runs never touch the network. In cold mode every load gets a fresh
+// browser and in-memory request context (new renderer, empty caches); in warm
+// mode one browser loads each page once untimed and then K timed times. In
+// pool mode every load checks a browser out of a BrowserPool, sized by the
+// --pool-* switches, and returns it afterwards; only load end is timed, since
+// the pool does not report commits or paints.
+//
+// Usage: cef_browser_bench [--corpus=DIR] [--iterations=K]
+//                          [--mode=cold|warm|pool|both|all] [--json=FILE] [--csv=FILE]
+//                          [--timeout-ms=N] [chromium switches]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "include/base/cef_callback.h"
+#include "include/cef_app.h"
+#include "include/cef_browser.h"
+#include "include/cef_command_line.h"
+#include "include/cef_parser.h"
+#include "include/cef_request_context.h"
+#include "include/cef_scheme.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+#include "app.h"
+#include "browser_client.h"
+#include "browser_config.h"
+#include "browser_pool.h"
+#include "histogram.h"
+#include "internal_pages.h"
+#include "json_writer.h"
+#include "process_memory.h"
+#include "rendering_config.h"
+#include "resource_util.h"
+#include "scheme_handler.h"
+
+#if defined(OS_WIN)
+#include <windows.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kCorpusOrigin[] = "https://bench.test/";
+constexpr char kCorpusScheme[] = "https";
+constexpr char kCorpusHost[] = "bench.test";
+
+// How long to wait for a first paint once the main frame has loaded
+constexpr int kPaintGraceMs = 1000;
+
+using Clock = std::chrono::steady_clock;
+using Corpus = std::map<std::string, std::shared_ptr<const std::string>>;
+
+struct BenchOptions {
+    std::string corpus_dir;
+    int iterations = 5;
+    bool cold = true;
+    bool warm = true;
+    bool pool = true;
+    std::string json_path = "bench_results.json";
+    std::string csv_path = "bench_results.csv";
+    int timeout_ms = 30000;
+};
+
+struct Sample {
+    std::string mode;
+    std::string page;
+    int iteration = 0;
+
+    // Milliseconds since LoadURL, or -1 if the phase was not reached
+    double commit_ms = -1;
+    double load_end_ms = -1;
+    double first_paint_ms = -1;
+
+    uint64_t peak_rss_bytes = 0;
+    std::string error;
+};
+
+// Read every file under |dir| keyed by its '/'-separated relative path
+bool LoadCorpus(const std::string& dir, Corpus* corpus) {
+    std::error_code error;
+    for (const auto& entry : fs::recursive_directory_iterator(dir, error)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        std::ifstream in(entry.path(), std::ios::binary);
+        std::ostringstream data;
+        data << in.rdbuf();
+        const std::string name = fs::relative(entry.path(), dir).generic_string();
+        (*corpus)[name] = std::make_shared<const std::string>(data.str());
+    }
+    return !error && !corpus->empty();
+}
+
+// Serves the corpus from memory on https://bench.test/
+class CorpusSchemeHandlerFactory : public CefSchemeHandlerFactory {
+public:
+    explicit CorpusSchemeHandlerFactory(std::shared_ptr<const Corpus> corpus)
+        : corpus_(std::move(corpus)) {}
+
+    CefRefPtr<CefResourceHandler> Create(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                         const CefString& scheme_name,
+                                         CefRefPtr<CefRequest> request) override {
+        CEF_REQUIRE_IO_THREAD();
+
+        CefURLParts parts;
+        if (!CefParseURL(request->GetURL(), parts)) {
+            return nullptr;
+        }
+
+        std::string path = CefString(&parts.path).ToString();
+        if (!path.empty() && path[0] == '/') {
+            path.erase(0, 1);
+        }
+
+        auto it = corpus_->find(path);
+        if (it == corpus_->end()) {
+            CefRefPtr<BufferResourceHandler> handler =
+                new BufferResourceHandler(std::string_view("Not Found"), "text/plain");
+            handler->SetStatus(404, "Not Found");
+            return handler;
+        }
+
+        std::string mime_type;
+        size_t dot = path.find_last_of('.');
+        if (dot != std::string::npos) {
+            mime_type = CefGetMimeType(path.substr(dot + 1)).ToString();
+        }
+        CefRefPtr<BufferResourceHandler> handler = new BufferResourceHandler(
+            it->second, mime_type.empty() ? "application/octet-stream" : mime_type);
+        handler->AddHeader("Cache-Control", "max-age=3600");
+        return handler;
+    }
+
+private:
+    std::shared_ptr<const Corpus> corpus_;
+
+    IMPLEMENT_REFCOUNTING(CorpusSchemeHandlerFactory);
+    DISALLOW_COPY_AND_ASSIGN(CorpusSchemeHandlerFactory);
+};
+
+// Drives the runs on the UI thread, one load at a time
+class PageLoadBench : public BrowserClient::Delegate {
+public:
+    PageLoadBench(const BenchOptions& options, std::shared_ptr<const Corpus> corpus,
+                  const std::vector<std::string>& pages)
+        : options_(options),
+          corpus_(std::move(corpus)),
+          client_(new BrowserClient(this)),
+          blank_url_(GetInternalURL("blank.html")) {
+        for (const char* mode : {"cold", "warm", "pool"}) {
+            const std::string name = mode;
+            if ((name == "cold" && !options_.cold) || (name == "warm" && !options_.warm) ||
+                (name == "pool" && !options_.pool)) {
+                continue;
+            }
+            for (const std::string& page : pages) {
+                // Warm runs start with an untimed load that fills the caches
+                for (int i = name == "warm" ? -1 : 0; i < options_.iterations; ++i) {
+                    runs_.push_back({mode, page, i});
+                }
+            }
+        }
+    }
+
+    void Start() { Next(); }
+
+    const std::vector<Sample>& samples() const { return samples_; }
+
+    // BrowserClient::Delegate methods
+    void OnBrowserCreated(CefRefPtr<CefBrowser> browser) override { browser_ = browser; }
+
+    void OnBrowserClosed(CefRefPtr<CefBrowser> browser) override {
+        browser_ = nullptr;
+        Post(&PageLoadBench::Next);
+    }
+
+    void OnMainFrameCommit(CefRefPtr<CefBrowser> browser, const std::string& url) override {
+        if (state_ == State::kLoading && current_.commit_ms < 0) {
+            current_.commit_ms = ElapsedMs();
+        }
+    }
+
+    void OnViewPainted(CefRefPtr<CefBrowser> browser) override {
+        // Paints before the commit still show the previous page
+        if (state_ == State::kLoading && current_.commit_ms >= 0 && current_.first_paint_ms < 0) {
+            current_.first_paint_ms = ElapsedMs();
+            MaybeFinishLoad();
+        }
+    }
+
+    void OnMainFrameLoadEnd(CefRefPtr<CefBrowser> browser, const std::string& url,
+                            int http_status) override {
+        if (state_ == State::kCreating && url == blank_url_) {
+            state_ = State::kIdle;
+            Post(&PageLoadBench::BeginLoad);
+        } else if (state_ == State::kLoading && current_.load_end_ms < 0) {
+            current_.load_end_ms = ElapsedMs();
+            if (http_status >= 400) {
+                current_.error = "HTTP " + std::to_string(http_status);
+            }
+            CefPostDelayedTask(TID_UI,
+                               base::BindOnce(&PageLoadBench::OnTimeout, base::Unretained(this),
+                                              generation_),
+                               kPaintGraceMs);
+            MaybeFinishLoad();
+        }
+    }
+
+    void OnMainFrameLoadError(CefRefPtr<CefBrowser> browser, const std::string& url,
+                              cef_errorcode_t error_code) override {
+        if (state_ == State::kLoading) {
+            FinishLoad("net error " + std::to_string(error_code));
+        } else if (state_ == State::kCreating) {
+            // Without the blank page nothing else will load either
+            fprintf(stderr, "Failed to load %s (%d)\n", url.c_str(), error_code);
+            next_run_ = runs_.size();
+            CloseBrowser();
+        }
+    }
+
+private:
+    enum class State {
+        kIdle,
+        kCreating,     // Waiting for a new browser's blank page
+        kCheckingOut,  // Waiting for a pooled browser
+        kLoading,      // Timing a page load
+        kClosing,      // Waiting for a cold or warm browser to close
+        kDraining,     // Waiting for the pool to close its browsers
+    };
+
+    struct Run {
+        std::string mode;
+        std::string page;
+        int iteration;  // -1 for the untimed warm-up load
+    };
+
+    void Post(void (PageLoadBench::*method)()) {
+        CefPostTask(TID_UI, base::BindOnce(method, base::Unretained(this)));
+    }
+
+    double ElapsedMs() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - load_start_).count();
+    }
+
+    // Start the next run, creating or closing browsers as its mode requires
+    void Next() {
+        state_ = State::kIdle;
+
+        if (next_run_ == runs_.size()) {
+            if (browser_) {
+                CloseBrowser();
+            } else if (pool_) {
+                state_ = State::kDraining;
+                pool_->Shutdown([] { CefQuitMessageLoop(); });
+            } else {
+                CefQuitMessageLoop();
+            }
+            return;
+        }
+
+        // Every cold load gets its own browser; warm loads share one, and
+        // pooled loads use the pool's
+        const Run& run = runs_[next_run_];
+        if (browser_ && (run.mode != browser_mode_ || (run.mode == "cold" && !browser_fresh_))) {
+            CloseBrowser();
+            return;
+        }
+
+        if (run.mode == "pool") {
+            Checkout();
+            return;
+        }
+
+        if (!browser_) {
+            CreateBrowser(run.mode);
+            return;
+        }
+        BeginLoad();
+    }
+
+    void CloseBrowser() {
+        state_ = State::kClosing;
+        browser_->GetHost()->CloseBrowser(true);
+    }
+
+    void CreateBrowser(const std::string& mode) {
+        state_ = State::kCreating;
+        browser_mode_ = mode;
+        browser_fresh_ = true;
+
+        CefWindowInfo window_info;
+        window_info.SetAsWindowless(kNullWindowHandle);
+
+        CefBrowserSettings browser_settings;
+        browser_settings.windowless_frame_rate = GetBrowserConfig().frame_rate;
+
+        // A new in-memory context per browser gives empty caches and a new
+        // renderer process
+        CefRequestContextSettings context_settings;
+        CefRefPtr<CefRequestContext> request_context =
+            CefRequestContext::CreateContext(context_settings, nullptr);
+        RegisterInternalSchemeHandlerFactory(request_context);
+        request_context->RegisterSchemeHandlerFactory(kCorpusScheme, kCorpusHost,
+                                                      new CorpusSchemeHandlerFactory(corpus_));
+
+        CefBrowserHost::CreateBrowser(window_info, client_, blank_url_, browser_settings,
+                                      nullptr,  // extra_info
+                                      request_context);
+    }
+
+    void BeginLoad() {
+        StartSample();
+        browser_fresh_ = false;
+        browser_->GetMainFrame()->LoadURL(kCorpusOrigin + runs_[next_run_].page);
+    }
+
+    // Start timing the current run
+    void StartSample() {
+        const Run& run = runs_[next_run_];
+
+        state_ = State::kLoading;
+        generation_++;
+        current_ = Sample();
+        current_.mode = run.mode;
+        current_.page = run.page;
+        current_.iteration = run.iteration;
+
+        CefPostDelayedTask(TID_UI,
+                           base::BindOnce(&PageLoadBench::OnTimeout, base::Unretained(this),
+                                          generation_),
+                           options_.timeout_ms);
+        load_start_ = Clock::now();
+    }
+
+    void Checkout() {
+        if (!pool_) {
+            const BrowserConfig& config = GetBrowserConfig();
+            BrowserPoolOptions pool_options;
+            pool_options.min_size = std::max(config.pool_min_size, 1);
+            pool_options.max_size = std::max(config.pool_max_size, 1);
+            pool_options.max_uses = config.pool_max_uses;
+            pool_options.idle_timeout = std::chrono::seconds(config.pool_idle_timeout);
+
+            std::shared_ptr<const Corpus> corpus = corpus_;
+            pool_ = std::make_unique<BrowserPool>(
+                pool_options, [corpus](CefRefPtr<CefRequestContext> request_context) {
+                    request_context->RegisterSchemeHandlerFactory(
+                        kCorpusScheme, kCorpusHost, new CorpusSchemeHandlerFactory(corpus));
+                });
+            pool_->Start();
+        }
+
+        // Pool creation and checkout waits are not part of the sample
+        state_ = State::kCheckingOut;
+        pool_->Checkout([this](CefRefPtr<CefBrowser> browser) {
+            CefPostTask(TID_UI, base::BindOnce(&PageLoadBench::BeginPoolLoad,
+                                               base::Unretained(this), browser));
+        });
+    }
+
+    void BeginPoolLoad(CefRefPtr<CefBrowser> browser) {
+        if (!browser) {
+            fprintf(stderr, "The browser pool is shut down\n");
+            next_run_ = runs_.size();
+            Post(&PageLoadBench::Next);
+            return;
+        }
+
+        pooled_ = browser;
+        StartSample();
+        pool_->Load(browser, kCorpusOrigin + runs_[next_run_].page,
+                    [this, generation = generation_](CefRefPtr<CefBrowser>,
+                                                     const BrowserPoolLoadResult& result) {
+                        OnPoolLoadEnd(generation, result);
+                    });
+    }
+
+    void OnPoolLoadEnd(uint64_t generation, const BrowserPoolLoadResult& result) {
+        if (state_ != State::kLoading || generation != generation_) {
+            return;
+        }
+        current_.load_end_ms = ElapsedMs();
+        if (result.error_code != ERR_NONE) {
+            FinishLoad("net error " + std::to_string(result.error_code));
+        } else if (result.http_status >= 400) {
+            FinishLoad("HTTP " + std::to_string(result.http_status));
+        } else {
+            FinishLoad("");
+        }
+    }
+
+    void MaybeFinishLoad() {
+        if (current_.load_end_ms >= 0 && current_.first_paint_ms >= 0) {
+            FinishLoad(current_.error);
+        }
+    }
+
+    void OnTimeout(uint64_t generation) {
+        if (state_ != State::kLoading || generation != generation_) {
+            return;
+        }
+        // Past load end this is the paint grace period, not a failure
+        FinishLoad(current_.load_end_ms >= 0 ? current_.error : "timeout");
+    }
+
+    void FinishLoad(const std::string& error) {
+        state_ = State::kIdle;
+        generation_++;
+
+        current_.error = error;
+        const BrowserRecord* record =
+            GetBrowserRegistry().Find((pooled_ ? pooled_ : browser_)->GetIdentifier());
+        const int pid = record ? record->renderer_pid : 0;
+        current_.peak_rss_bytes = pid ? GetPeakResidentBytes(pid) : 0;
+
+        // A load still in flight is abandoned with the browser
+        if (pooled_) {
+            pool_->Return(pooled_);
+            pooled_ = nullptr;
+        }
+
+        if (current_.iteration >= 0) {
+            samples_.push_back(current_);
+            fprintf(stderr, "%-4s %-32s #%d commit %.1f ms, load %.1f ms, paint %.1f ms%s%s\n",
+                    current_.mode.c_str(), current_.page.c_str(), current_.iteration,
+                    current_.commit_ms, current_.load_end_ms, current_.first_paint_ms,
+                    error.empty() ? "" : ", ", error.c_str());
+        }
+
+        next_run_++;
+        Post(&PageLoadBench::Next);
+    }
+
+    BenchOptions options_;
+    std::shared_ptr<const Corpus> corpus_;
+    CefRefPtr<BrowserClient> client_;
+    CefRefPtr<CefBrowser> browser_;
+    std::string browser_mode_;
+    bool browser_fresh_ = false;
+    const std::string blank_url_;
+
+    // Created by the first pooled run; |pooled_| is checked out of it
+    std::unique_ptr<BrowserPool> pool_;
+    CefRefPtr<CefBrowser> pooled_;
+
+    std::vector<Run> runs_;
+    size_t next_run_ = 0;
+
+    State state_ = State::kIdle;
+    uint64_t generation_ = 0;
+    Clock::time_point load_start_;
+    Sample current_;
+    std::vector<Sample> samples_;
+};
+
+void RecordMs(Histogram& histogram, double ms) {
+    if (ms >= 0) {
+        histogram.Record(static_cast<uint64_t>(ms * 1000.0));
+    }
+}
+
+bool WriteJsonReport(const std::string& path, const BenchOptions& options,
+                     const std::string& command_line, const std::vector<Sample>& samples) {
+    JsonWriter writer;
+    writer.BeginObject();
+    writer.Key("corpus").String(options.corpus_dir);
+    writer.Key("iterations").Int(options.iterations);
+    writer.Key("command_line").String(command_line);
+
+    writer.Key("samples").BeginArray();
+    for (const Sample& sample : samples) {
+        writer.BeginObject();
+        writer.Key("mode").String(sample.mode);
+        writer.Key("page").String(sample.page);
+        writer.Key("iteration").Int(sample.iteration);
+        writer.Key("commit_ms").Double(sample.commit_ms);
+        writer.Key("load_end_ms").Double(sample.load_end_ms);
+        writer.Key("first_paint_ms").Double(sample.first_paint_ms);
+        writer.Key("peak_renderer_rss_bytes").Uint(sample.peak_rss_bytes);
+        writer.Key("error").String(sample.error);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    // Per mode and page distributions, in microseconds like navigation_metrics
+    struct Summary {
+        Histogram commit;
+        Histogram load_end;
+        Histogram first_paint;
+        uint64_t peak_rss_bytes = 0;
+        uint64_t errors = 0;
+    };
+    std::map<std::pair<std::string, std::string>, Summary> summaries;
+    for (const Sample& sample : samples) {
+        Summary& summary = summaries[{sample.mode, sample.page}];
+        RecordMs(summary.commit, sample.commit_ms);
+        RecordMs(summary.load_end, sample.load_end_ms);
+        RecordMs(summary.first_paint, sample.first_paint_ms);
+        summary.peak_rss_bytes = std::max(summary.peak_rss_bytes, sample.peak_rss_bytes);
+        summary.errors += sample.error.empty() ? 0 : 1;
+    }
+
+    writer.Key("summary").BeginArray();
+    for (const auto& it : summaries) {
+        writer.BeginObject();
+        writer.Key("mode").String(it.first.first);
+        writer.Key("page").String(it.first.second);
+        writer.Key("errors").Uint(it.second.errors);
+        writer.Key("commit_us");
+        it.second.commit.WriteJson(writer);
+        writer.Key("load_end_us");
+        it.second.load_end.WriteJson(writer);
+        writer.Key("first_paint_us");
+        it.second.first_paint.WriteJson(writer);
+        writer.Key("peak_renderer_rss_bytes").Uint(it.second.peak_rss_bytes);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << writer.str() << "\n";
+    return static_cast<bool>(out);
+}
+
+bool WriteCsvReport(const std::string& path, const std::vector<Sample>& samples) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << "mode,page,iteration,commit_ms,load_end_ms,first_paint_ms,peak_renderer_rss_bytes,"
+           "error\n";
+    for (const Sample& sample : samples) {
+        char line[512];
+        snprintf(line, sizeof(line), "%s,%s,%d,%.3f,%.3f,%.3f,%llu,%s\n", sample.mode.c_str(),
+                 sample.page.c_str(), sample.iteration, sample.commit_ms, sample.load_end_ms,
+                 sample.first_paint_ms, static_cast<unsigned long long>(sample.peak_rss_bytes),
+                 sample.error.c_str());
+        out << line;
+    }
+    return static_cast<bool>(out);
+}
+
+std::string GetSwitch(CefRefPtr<CefCommandLine> command_line, const char* name,
+                      const std::string& default_value) {
+    std::string value = command_line->GetSwitchValue(name).ToString();
+    return value.empty() ? default_value : value;
+}
+
+int RunBench(int argc, char* argv[]) {
+    CefRefPtr<CefCommandLine> command_line = CefCommandLine::CreateCommandLine();
+#if defined(OS_WIN)
+    command_line->InitFromString(::GetCommandLineW());
+#else
+    command_line->InitFromArgv(argc, argv);
+#endif
+
+    // The benchmark always renders off-screen
+    if (!command_line->HasSwitch("headless")) {
+        command_line->AppendSwitch("headless");
+    }
+    InitBrowserConfig(command_line);
+
+#if defined(OS_WIN)
+    CefMainArgs main_args(GetModuleHandle(nullptr));
+#else
+    CefMainArgs main_args(argc, argv);
+#endif
+    CefRefPtr<BrowserApp> app(new BrowserApp);
+
+    // Renderer, GPU and utility subprocesses run this executable too
+    int exit_code = CefExecuteProcess(main_args, app, nullptr);
+    if (exit_code >= 0) {
+        return exit_code;
+    }
+    InitRenderingConfig(GetBrowserConfig().rendering);
+
+    BenchOptions options;
+    options.corpus_dir =
+        GetSwitch(command_line, "corpus", GetApplicationDir() + "/bench_corpus");
+    options.iterations = std::max(1, std::atoi(GetSwitch(command_line, "iterations", "5").c_str()));
+    const std::string mode = GetSwitch(command_line, "mode", "all");
+    options.cold = mode == "cold" || mode == "both" || mode == "all";
+    options.warm = mode == "warm" || mode == "both" || mode == "all";
+    options.pool = mode == "pool" || mode == "all";
+    options.json_path = GetSwitch(command_line, "json", options.json_path);
+    options.csv_path = GetSwitch(command_line, "csv", options.csv_path);
+    options.timeout_ms =
+        std::max(1000, std::atoi(GetSwitch(command_line, "timeout-ms", "30000").c_str()));
+
+    auto corpus = std::make_shared<Corpus>();
+    if (!LoadCorpus(options.corpus_dir, corpus.get())) {
+        fprintf(stderr, "No corpus found in %s\n", options.corpus_dir.c_str());
+        return 1;
+    }
+
+    // Top-level HTML files are pages; everything else is a subresource
+    std::vector<std::string> pages;
+    for (const auto& it : *corpus) {
+        const std::string& name = it.first;
+        if (name.find('/') == std::string::npos && name.size() > 5 &&
+            name.compare(name.size() - 5, 5, ".html") == 0) {
+            pages.push_back(name);
+        }
+    }
+
+    CefSettings settings;
+    settings.windowless_rendering_enabled = true;
+    settings.chrome_runtime = false;
+    settings.log_severity = LOGSEVERITY_WARNING;
+    settings.multi_threaded_message_loop = false;
+    settings.external_message_pump = false;
+
+    if (!CefInitialize(main_args, settings, app, nullptr)) {
+        return 1;
+    }
+
+    int result = 0;
+    {
+        PageLoadBench bench(options, corpus, pages);
+        bench.Start();
+        CefRunMessageLoop();
+
+        const std::string switches = command_line->GetCommandLineString().ToString();
+        if (!WriteJsonReport(options.json_path, options, switches, bench.samples()) ||
+            !WriteCsvReport(options.csv_path, bench.samples())) {
+            fprintf(stderr, "Failed to write the reports\n");
+            result = 1;
+        } else {
+            fprintf(stderr, "Wrote %zu samples to %s and %s\n", bench.samples().size(),
+                    options.json_path.c_str(), options.csv_path.c_str());
+        }
+    }
+
+    CefShutdown();
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    return RunBench(argc, argv);
+}
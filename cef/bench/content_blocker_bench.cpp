@@ -0,0 +1,136 @@
+// CEF Browser - Content Blocker Micro-Benchmark
+// Reports filter list compile time and per-request matching latency. Without
+// a filter list a synthetic EasyList-sized list is generated.
+//
+// Usage: content_blocker_bench [filter-list] [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "content_blocker.h"
+
+namespace {
+
+// Keeps the match results observable so calls are not optimized away
+volatile size_t g_sink;
+
+std::string RandomWord(std::mt19937& rng, size_t min_length, size_t max_length) {
+    std::uniform_int_distribution<size_t> length(min_length, max_length);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::string word(length(rng), 'a');
+    for (char& c : word) {
+        c = static_cast<char>(letter(rng));
+    }
+    return word;
+}
+
+// Roughly the mix of EasyList: mostly host rules, then path fragments,
+// options and exceptions
+std::string MakeSyntheticList(std::mt19937& rng, std::vector<std::string>* hosts) {
+    std::string list = "[Adblock Plus 2.0]\n! Synthetic list\n";
+    for (int i = 0; i < 60000; ++i) {
+        switch (i % 10) {
+            case 0:
+            case 1:
+            case 2:
+            case 3:
+            case 4: {
+                std::string host = RandomWord(rng, 4, 12) + ".test";
+                hosts->push_back(host);
+                list += "||" + host + "^\n";
+                break;
+            }
+            case 5:
+            case 6:
+                list += "/" + RandomWord(rng, 4, 10) + "/" + RandomWord(rng, 3, 8) + ".\n";
+                break;
+            case 7:
+                list += "&" + RandomWord(rng, 3, 8) + "=*^\n";
+                break;
+            case 8:
+                list += "-" + RandomWord(rng, 4, 10) + "-ad.$image,third-party\n";
+                break;
+            default:
+                list += "@@||" + RandomWord(rng, 4, 12) + ".test/" + RandomWord(rng, 4, 8) +
+                        "$script\n";
+                break;
+        }
+    }
+    return list;
+}
+
+std::vector<std::string> MakeUrls(std::mt19937& rng, const std::vector<std::string>& hosts) {
+    std::vector<std::string> urls;
+    std::uniform_int_distribution<size_t> pick(0, hosts.empty() ? 0 : hosts.size() - 1);
+    for (int i = 0; i < 10000; ++i) {
+        // About one in ten requests goes to a listed host
+        std::string host = (i % 10 == 0 && !hosts.empty())
+                               ? "cdn." + hosts[pick(rng)]
+                               : RandomWord(rng, 3, 10) + ".example.com";
+        urls.push_back("https://" + host + "/" + RandomWord(rng, 3, 10) + "/" +
+                       RandomWord(rng, 5, 20) + ".js?v=" + std::to_string(rng() % 1000) +
+                       "&session=" + RandomWord(rng, 16, 16));
+    }
+    return urls;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const char* list_path = argc > 1 ? argv[1] : nullptr;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::mt19937 rng(42);
+    std::vector<std::string> hosts;
+    std::string list;
+    if (list_path) {
+        std::ifstream in(list_path, std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "Cannot read %s\n", list_path);
+            return 1;
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        list = buffer.str();
+    } else {
+        list = MakeSyntheticList(rng, &hosts);
+    }
+
+    ContentBlocker blocker;
+    auto start = std::chrono::steady_clock::now();
+    size_t rules = blocker.AddRules(list);
+    blocker.Compile();
+    auto compile = std::chrono::steady_clock::now() - start;
+
+    std::printf("Rules: %zu (compiled in %.1f ms)\n", rules,
+                std::chrono::duration<double, std::milli>(compile).count());
+
+    const std::vector<std::string> urls = MakeUrls(rng, hosts);
+    const uint32_t types[] = {kContentScript, kContentImage, kContentXmlHttpRequest};
+    size_t blocked = 0;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (size_t u = 0; u < urls.size(); ++u) {
+            ContentRequest request;
+            request.url = urls[u];
+            request.document_url = "https://news.example.org/article";
+            request.type = types[u % 3];
+            blocked += blocker.ShouldBlock(request);
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    g_sink = blocked;
+
+    const double requests = static_cast<double>(iterations) * urls.size();
+    std::printf("Requests: %.0f, blocked %.1f%%\n", requests, 100.0 * blocked / requests);
+    std::printf("ns/request: %.1f\n",
+                std::chrono::duration<double, std::nano>(elapsed).count() / requests);
+    return 0;
+}
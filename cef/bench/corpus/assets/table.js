@@ -0,0 +1,26 @@
+// Builds a 2000-row table with a deterministic pseudo-random fill
+(function() {
+    let seed = 42;
+    function random() {
+        seed = (seed * 1103515245 + 12345) % 2147483648;
+        return seed / 2147483648;
+    }
+
+    const rows = [];
+    let total = 0;
+    for (let i = 0; i < 2000; i++) {
+        const value = Math.round(random() * 100000);
+        total += value;
+        rows.push({ name: 'item-' + i.toString(36), value: value });
+    }
+
+    const tbody = document.querySelector('#data tbody');
+    const fragment = document.createDocumentFragment();
+    rows.forEach(function(row, i) {
+        const tr = document.createElement('tr');
+        tr.innerHTML = '<td>' + i + '</td><td>' + row.name + '</td><td>' + row.value +
+                       '</td><td>' + (100 * row.value / total).toFixed(3) + '%</td>';
+        fragment.appendChild(tr);
+    });
+    tbody.appendChild(fragment);
+})();
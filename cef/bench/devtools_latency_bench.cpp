@@ -0,0 +1,416 @@
+// CEF Browser - DevTools Latency Benchmark
+// Measures Runtime.evaluate round trips to an off-screen page through the
+// in-process DevToolsClient and through Chromium's DevTools WebSocket, one
+// call in flight at a time, and reports the latency distribution of each.
+//
+// Usage: devtools_latency_bench [--iterations=N] [--payload-bytes=N]
+//
+// --payload-bytes makes each call return a string of that size instead of a
+// number, to show the cost of framing and parsing larger results.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "include/base/cef_callback.h"
+#include "include/cef_app.h"
+#include "include/cef_browser.h"
+#include "include/cef_command_line.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+#include "app.h"
+#include "browser_client.h"
+#include "browser_config.h"
+#include "devtools_client.h"
+#include "devtools_message.h"
+#include "devtools_server.h"
+#include "histogram.h"
+#include "rendering_config.h"
+#include "resource_util.h"
+#include "websocket.h"
+
+namespace {
+
+// Calls made before measuring, on each path
+constexpr int kWarmupCalls = 50;
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t MicrosecondsSince(Clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+}
+
+std::string EvaluateExpression(int payload_bytes) {
+    return payload_bytes > 0 ? "'x'.repeat(" + std::to_string(payload_bytes) + ")" : "1+1";
+}
+
+// Blocking loopback client of Chromium's DevTools server
+class WebSocketClient {
+public:
+    ~WebSocketClient() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    bool Connect(int port) {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd_ < 0) {
+            return false;
+        }
+        int no_delay = 1;
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        return connect(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    }
+
+    bool Write(const std::string& data) {
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t result = send(fd_, data.data() + written, data.size() - written, 0);
+            if (result <= 0) {
+                return false;
+            }
+            written += result;
+        }
+        return true;
+    }
+
+    // Read an HTTP response head, and its body when it has a Content-Length
+    bool ReadHttpResponse(std::string* head, std::string* body) {
+        size_t end = std::string::npos;
+        while ((end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+            if (!Fill()) {
+                return false;
+            }
+        }
+        *head = buffer_.substr(0, end + 4);
+        buffer_.erase(0, end + 4);
+
+        size_t length = 0;
+        size_t header = head->find("Content-Length:");
+        if (header == std::string::npos) {
+            header = head->find("content-length:");
+        }
+        if (header != std::string::npos) {
+            length = std::strtoul(head->c_str() + header + 15, nullptr, 10);
+        }
+        while (buffer_.size() < length) {
+            if (!Fill()) {
+                return false;
+            }
+        }
+        *body = buffer_.substr(0, length);
+        buffer_.erase(0, length);
+        return true;
+    }
+
+    bool SendText(const std::string& message) {
+        // Masking hides nothing on loopback; a fixed key keeps the cost constant
+        static const uint8_t kMask[4] = {0x12, 0x34, 0x56, 0x78};
+        std::string frame;
+        EncodeWebSocketFrame(kWebSocketText, message, &frame, kMask);
+        return Write(frame);
+    }
+
+    bool ReadText(std::string* message) {
+        WebSocketFrame frame;
+        size_t consumed = 0;
+        for (;;) {
+            ParseStatus status = DecodeWebSocketFrame(buffer_, &frame, &consumed,
+                                                      256 * 1024 * 1024, WebSocketSender::kServer);
+            if (status == ParseStatus::kError) {
+                return false;
+            }
+            if (status == ParseStatus::kIncomplete) {
+                if (!Fill()) {
+                    return false;
+                }
+                continue;
+            }
+            buffer_.erase(0, consumed);
+            if (frame.opcode == kWebSocketText) {
+                *message = std::move(frame.payload);
+                return true;
+            }
+            if (frame.opcode == kWebSocketClose) {
+                return false;
+            }
+        }
+    }
+
+private:
+    bool Fill() {
+        char chunk[65536];
+        ssize_t result = recv(fd_, chunk, sizeof(chunk), 0);
+        if (result <= 0) {
+            return false;
+        }
+        buffer_.append(chunk, result);
+        return true;
+    }
+
+    int fd_ = -1;
+    std::string buffer_;
+};
+
+// Path of the first page's WebSocket in a /json/list response
+std::string FindDebuggerPath(const std::string& list) {
+    size_t key = list.find("\"webSocketDebuggerUrl\"");
+    size_t scheme = key == std::string::npos ? key : list.find("ws://", key);
+    size_t path = scheme == std::string::npos ? scheme : list.find('/', scheme + 5);
+    size_t end = path == std::string::npos ? path : list.find('"', path);
+    return end == std::string::npos ? std::string() : list.substr(path, end - path);
+}
+
+// Round trips over Chromium's DevTools WebSocket on |port|. Returns an error
+// message, or an empty string on success.
+std::string RunWebSocketCalls(int port, int iterations, int payload_bytes, Histogram* latency_us) {
+    const std::string host = "127.0.0.1:" + std::to_string(port);
+    std::string head;
+    std::string body;
+
+    WebSocketClient list;
+    if (!list.Connect(port) ||
+        !list.Write("GET /json/list HTTP/1.1\r\nHost: " + host + "\r\n\r\n") ||
+        !list.ReadHttpResponse(&head, &body)) {
+        return "cannot list DevTools targets on port " + std::to_string(port);
+    }
+    const std::string path = FindDebuggerPath(body);
+    if (path.empty()) {
+        return "no page target in /json/list";
+    }
+
+    WebSocketClient client;
+    if (!client.Connect(port) ||
+        !client.Write("GET " + path + " HTTP/1.1\r\nHost: " + host +
+                      "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                      "Sec-WebSocket-Version: 13\r\n\r\n")) {
+        return "cannot connect to " + path;
+    }
+    // The upgrade response has no body
+    const std::string upgrade = "HTTP/1.1 101";
+    if (!client.ReadHttpResponse(&head, &body) || head.compare(0, upgrade.size(), upgrade) != 0) {
+        return "WebSocket upgrade refused";
+    }
+
+    const std::string expression = EvaluateExpression(payload_bytes);
+    for (int i = 1; i <= kWarmupCalls + iterations; ++i) {
+        const std::string request = "{\"id\":" + std::to_string(i) +
+                                    ",\"method\":\"Runtime.evaluate\",\"params\":{"
+                                    "\"expression\":\"" +
+                                    expression + "\",\"returnByValue\":true}}";
+        const Clock::time_point start = Clock::now();
+        if (!client.SendText(request)) {
+            return "WebSocket send failed";
+        }
+        // Skip anything that is not this call's result
+        std::string message;
+        DevToolsMessageView view;
+        do {
+            if (!client.ReadText(&message)) {
+                return "WebSocket closed";
+            }
+        } while (!ScanDevToolsMessage(message, &view) || view.id != i);
+        if (i > kWarmupCalls) {
+            latency_us->Record(MicrosecondsSince(start));
+        }
+    }
+    return std::string();
+}
+
+// Loads a blank page in one off-screen browser and runs both paths in turn
+class DevToolsLatencyBench : public BrowserClient::Delegate {
+public:
+    DevToolsLatencyBench(int iterations, int payload_bytes)
+        : iterations_(iterations),
+          payload_bytes_(payload_bytes),
+          client_(new BrowserClient(this)) {}
+
+    ~DevToolsLatencyBench() override {
+        if (websocket_thread_.joinable()) {
+            websocket_thread_.join();
+        }
+    }
+
+    void Start() {
+        CefWindowInfo window_info;
+        window_info.SetAsWindowless(kNullWindowHandle);
+        CefBrowserSettings browser_settings;
+        CefBrowserHost::CreateBrowser(window_info, client_,
+                                      GetDataURI("<!DOCTYPE html><title>bench</title>",
+                                                 "text/html"),
+                                      browser_settings, nullptr, nullptr);
+    }
+
+    bool finished() const { return finished_; }
+    const std::string& error() const { return error_; }
+    const Histogram& in_process_us() const { return in_process_us_; }
+    const Histogram& websocket_us() const { return websocket_us_; }
+
+    // BrowserClient::Delegate methods
+    void OnBrowserCreated(CefRefPtr<CefBrowser> browser) override { browser_ = browser; }
+
+    void OnBrowserClosed(CefRefPtr<CefBrowser> browser) override {
+        browser_ = nullptr;
+        CefQuitMessageLoop();
+    }
+
+    void OnMainFrameLoadEnd(CefRefPtr<CefBrowser> browser, const std::string& url,
+                            int http_status) override {
+        if (devtools_) {
+            return;
+        }
+        devtools_ = std::make_unique<DevToolsClient>(browser);
+        CallInProcess();
+    }
+
+    void OnMainFrameLoadError(CefRefPtr<CefBrowser> browser, const std::string& url,
+                              cef_errorcode_t error_code) override {
+        error_ = "failed to load the page (" + std::to_string(error_code) + ")";
+        browser_->GetHost()->CloseBrowser(true);
+    }
+
+private:
+    void CallInProcess() {
+        if (calls_ == kWarmupCalls + iterations_) {
+            devtools_.reset();
+            StartWebSocket();
+            return;
+        }
+        DevToolsRuntime::EvaluateParams params;
+        params.expression = EvaluateExpression(payload_bytes_);
+        const Clock::time_point start = Clock::now();
+        devtools_->Runtime().Evaluate(params, [this, start](
+                                                  const DevToolsRuntime::EvaluateResult& result) {
+            if (!result.success) {
+                error_ = "Runtime.evaluate failed: " + result.error;
+                browser_->GetHost()->CloseBrowser(true);
+                return;
+            }
+            if (++calls_ > kWarmupCalls) {
+                in_process_us_.Record(MicrosecondsSince(start));
+            }
+            CallInProcess();
+        });
+    }
+
+    void StartWebSocket() {
+        const int port = GetDevToolsEndpoint().port;
+        websocket_thread_ = std::thread([this, port] {
+            websocket_error_ = RunWebSocketCalls(port, iterations_, payload_bytes_, &websocket_us_);
+            CefPostTask(TID_UI, base::BindOnce(&DevToolsLatencyBench::Finish,
+                                               base::Unretained(this)));
+        });
+    }
+
+    void Finish() {
+        websocket_thread_.join();
+        if (websocket_error_.empty()) {
+            finished_ = true;
+        } else {
+            error_ = websocket_error_;
+        }
+        browser_->GetHost()->CloseBrowser(true);
+    }
+
+    const int iterations_;
+    const int payload_bytes_;
+    CefRefPtr<BrowserClient> client_;
+    CefRefPtr<CefBrowser> browser_;
+    std::unique_ptr<DevToolsClient> devtools_;
+    int calls_ = 0;
+    Histogram in_process_us_;
+
+    // Written by the WebSocket thread before it posts Finish()
+    std::thread websocket_thread_;
+    Histogram websocket_us_;
+    std::string websocket_error_;
+
+    bool finished_ = false;
+    std::string error_;
+};
+
+void PrintRow(const char* path, const Histogram& latency_us) {
+    printf("%-12s %7llu %9.1f %9.1f %9.1f %9.1f %9.1f\n", path,
+           static_cast<unsigned long long>(latency_us.count()),
+           latency_us.ValueAtPercentile(50) / 1000.0, latency_us.ValueAtPercentile(90) / 1000.0,
+           latency_us.ValueAtPercentile(99) / 1000.0, latency_us.mean() / 1000.0,
+           latency_us.max() / 1000.0);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    CefRefPtr<CefCommandLine> command_line = CefCommandLine::CreateCommandLine();
+    command_line->InitFromArgv(argc, argv);
+    const bool browser_process = !command_line->HasSwitch("type");
+
+    // Off-screen, with Chromium's DevTools server eagerly on a free port
+    if (browser_process) {
+        command_line->AppendSwitch("headless");
+        command_line->AppendSwitchWithValue("devtools-transport", "tcp");
+        command_line->AppendSwitchWithValue("remote-debugging-port", "0");
+    }
+    InitBrowserConfig(command_line);
+
+    CefMainArgs main_args(argc, argv);
+    CefRefPtr<BrowserApp> app(new BrowserApp);
+    int exit_code = CefExecuteProcess(main_args, app, nullptr);
+    if (exit_code >= 0) {
+        return exit_code;
+    }
+    InitRenderingConfig(GetBrowserConfig().rendering);
+    const DevToolsEndpoint& devtools = InitDevToolsEndpoint(GetBrowserConfig());
+
+    const std::string iterations_value = command_line->GetSwitchValue("iterations").ToString();
+    const int iterations =
+        iterations_value.empty() ? 1000 : std::max(1, std::atoi(iterations_value.c_str()));
+    const int payload_bytes =
+        std::max(0, std::atoi(command_line->GetSwitchValue("payload-bytes").ToString().c_str()));
+
+    CefSettings settings;
+    settings.windowless_rendering_enabled = true;
+    settings.chrome_runtime = false;
+    settings.log_severity = LOGSEVERITY_WARNING;
+    settings.remote_debugging_port = devtools.ChromiumPort();
+    if (!CefInitialize(main_args, settings, app, nullptr)) {
+        return 1;
+    }
+
+    int result = 1;
+    {
+        DevToolsLatencyBench bench(iterations, payload_bytes);
+        bench.Start();
+        CefRunMessageLoop();
+        if (bench.finished()) {
+            printf("Runtime.evaluate round trips, %d byte result\n", payload_bytes);
+            printf("%-12s %7s %9s %9s %9s %9s %9s\n", "path", "calls", "p50 ms", "p90 ms",
+                   "p99 ms", "mean ms", "max ms");
+            PrintRow("in-process", bench.in_process_us());
+            PrintRow("websocket", bench.websocket_us());
+            result = 0;
+        } else {
+            fprintf(stderr, "devtools_latency_bench: %s\n", bench.error().c_str());
+        }
+    }
+    CefShutdown();
+    return result;
+}
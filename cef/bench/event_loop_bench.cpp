@@ -0,0 +1,234 @@
+// CEF Browser - Event Loop Micro-Benchmark
+// Compares the epoll event loop behind --external-message-pump with a thread
+// that polls its fds on a fixed interval, the alternative for servicing
+// native fds next to CefRunMessageLoop(). Reports idle CPU, fd and
+// cross-thread wakeup latency, and timer lateness.
+//
+// Usage: event_loop_bench [seconds-per-scenario]
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <thread>
+
+#include "event_loop.h"
+#include "histogram.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t NowMicroseconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               Clock::now().time_since_epoch())
+        .count();
+}
+
+Clock::time_point Deadline(double seconds) {
+    return Clock::now() +
+           std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+uint64_t ThreadCpuMicroseconds() {
+    rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * uint64_t{1000000} +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+struct Result {
+    uint64_t cpu_us = 0;
+    uint64_t wakeups = 0;
+    Histogram latency_us;
+};
+
+void Print(const char* name, const Result& result, double seconds) {
+    std::printf("  %-22s %8.3f%% cpu %9.1f wakeups/s  latency p50 %6llu us  p99 %6llu us  "
+                "max %6llu us\n",
+                name, 100.0 * result.cpu_us / (seconds * 1e6), result.wakeups / seconds,
+                static_cast<unsigned long long>(result.latency_us.ValueAtPercentile(50)),
+                static_cast<unsigned long long>(result.latency_us.ValueAtPercentile(99)),
+                static_cast<unsigned long long>(result.latency_us.max()));
+}
+
+// Writes its send time into |fd| every |interval_ms| on average, jittered so
+// events do not phase-lock with a polling interval
+void RunWriter(int fd, int interval_ms, double seconds, std::atomic<bool>* done) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> jitter(interval_ms * 500, interval_ms * 1500);
+    const Clock::time_point end = Deadline(seconds);
+    while (Clock::now() < end) {
+        if (interval_ms > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(jitter(rng)));
+            uint64_t sent = NowMicroseconds();
+            ssize_t written = write(fd, &sent, sizeof(sent));
+            (void)written;
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    }
+    done->store(true);
+}
+
+void DrainPipe(int fd, Histogram* latency) {
+    uint64_t sent;
+    while (read(fd, &sent, sizeof(sent)) == sizeof(sent)) {
+        uint64_t now = NowMicroseconds();
+        latency->Record(now > sent ? now - sent : 0);
+    }
+}
+
+// Pipe events serviced by the epoll loop
+Result RunEpoll(int interval_ms, double seconds) {
+    int fds[2];
+    if (pipe2(fds, O_NONBLOCK) != 0) {
+        std::abort();
+    }
+
+    Result result;
+    EventLoop loop;
+    loop.Init();
+    loop.AddFd(fds[0], EPOLLIN, [&](uint32_t) { DrainPipe(fds[0], &result.latency_us); });
+
+    std::atomic<bool> done{false};
+    std::thread writer(RunWriter, fds[1], interval_ms, seconds, &done);
+    std::thread quitter([&] {
+        while (!done.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        loop.Quit();
+    });
+
+    const uint64_t cpu_start = ThreadCpuMicroseconds();
+    loop.Run();
+    result.cpu_us = ThreadCpuMicroseconds() - cpu_start;
+    result.wakeups = loop.wakeups();
+
+    writer.join();
+    quitter.join();
+    close(fds[0]);
+    close(fds[1]);
+    return result;
+}
+
+// Pipe events checked every |poll_ms|, as a repeating task on the UI thread
+// would
+Result RunPolling(int interval_ms, int poll_ms, double seconds) {
+    int fds[2];
+    if (pipe2(fds, O_NONBLOCK) != 0) {
+        std::abort();
+    }
+
+    Result result;
+    std::atomic<bool> done{false};
+    std::thread writer(RunWriter, fds[1], interval_ms, seconds, &done);
+
+    const uint64_t cpu_start = ThreadCpuMicroseconds();
+    while (!done.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(poll_ms));
+        pollfd pfd = {fds[0], POLLIN, 0};
+        poll(&pfd, 1, 0);
+        if (pfd.revents & POLLIN) {
+            DrainPipe(fds[0], &result.latency_us);
+        }
+        ++result.wakeups;
+    }
+    result.cpu_us = ThreadCpuMicroseconds() - cpu_start;
+
+    writer.join();
+    close(fds[0]);
+    close(fds[1]);
+    return result;
+}
+
+// Tasks posted from another thread, as CEF threads request pump work
+Result RunPostTask(double seconds) {
+    Result result;
+    EventLoop loop;
+    loop.Init();
+
+    std::thread poster([&] {
+        std::mt19937 rng(2);
+        std::uniform_int_distribution<int> jitter(500, 1500);
+        const Clock::time_point end = Deadline(seconds);
+        while (Clock::now() < end) {
+            std::this_thread::sleep_for(std::chrono::microseconds(jitter(rng)));
+            const uint64_t posted = NowMicroseconds();
+            loop.PostTask([&result, posted] {
+                uint64_t now = NowMicroseconds();
+                result.latency_us.Record(now > posted ? now - posted : 0);
+            });
+        }
+        loop.Quit();
+    });
+
+    const uint64_t cpu_start = ThreadCpuMicroseconds();
+    loop.Run();
+    result.cpu_us = ThreadCpuMicroseconds() - cpu_start;
+    result.wakeups = loop.wakeups();
+    poster.join();
+    return result;
+}
+
+// Timers with 1-50 ms delays, as CEF schedules delayed work
+Result RunTimers(double seconds) {
+    Result result;
+    EventLoop loop;
+    loop.Init();
+
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> delay_ms(1, 50);
+    const Clock::time_point end = Deadline(seconds);
+    std::function<void()> schedule = [&] {
+        if (Clock::now() >= end) {
+            loop.Quit();
+            return;
+        }
+        const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(delay_ms(rng));
+        loop.AddTimer(deadline - Clock::now(), [&, deadline] {
+            result.latency_us.Record(
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - deadline)
+                    .count());
+            schedule();
+        });
+    };
+    schedule();
+
+    const uint64_t cpu_start = ThreadCpuMicroseconds();
+    loop.Run();
+    result.cpu_us = ThreadCpuMicroseconds() - cpu_start;
+    result.wakeups = loop.wakeups();
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+
+    std::printf("Idle, no events (%.0f s)\n", seconds);
+    Print("epoll", RunEpoll(0, seconds), seconds);
+    Print("poll every 10 ms", RunPolling(0, 10, seconds), seconds);
+    Print("poll every 1 ms", RunPolling(0, 1, seconds), seconds);
+
+    std::printf("\nPipe event every ~20 ms, send to handler\n");
+    Print("epoll", RunEpoll(20, seconds), seconds);
+    Print("poll every 10 ms", RunPolling(20, 10, seconds), seconds);
+    Print("poll every 1 ms", RunPolling(20, 1, seconds), seconds);
+
+    std::printf("\nCross-thread PostTask every ~1 ms, post to run\n");
+    Print("epoll", RunPostTask(seconds), seconds);
+
+    std::printf("\nTimers of 1-50 ms, lateness past deadline\n");
+    Print("epoll", RunTimers(seconds), seconds);
+    return 0;
+}
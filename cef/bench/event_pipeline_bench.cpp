@@ -0,0 +1,166 @@
+// CEF Browser - Event Pipeline Micro-Benchmark
+// Measures what a BrowserClient callback pays on the UI thread to hand an
+// event to observers: calling them inline, pushing onto a mutex-guarded
+// deque drained by a worker, and EventPipeline::Publish(). The observer
+// serializes each event to JSON, like --event-log without the disk.
+//
+// Usage: event_pipeline_bench [events] [workers]
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "event_pipeline.h"
+#include "histogram.h"
+#include "json_writer.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class JsonObserver : public BrowserEventObserver {
+public:
+    void OnBrowserEvent(const BrowserEvent& event) override {
+        JsonWriter writer;
+        event.WriteJson(writer, epoch_);
+        bytes_.fetch_add(writer.str().size(), std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const { return count_.load(); }
+
+private:
+    const Clock::time_point epoch_ = Clock::now();
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> count_{0};
+};
+
+// Baseline: one lock shared by the UI thread and the worker
+class LockedQueue {
+public:
+    explicit LockedQueue(BrowserEventObserver* observer)
+        : observer_(observer), thread_([this] { Run(); }) {}
+
+    ~LockedQueue() {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            stopping_ = true;
+        }
+        ready_.notify_one();
+        thread_.join();
+    }
+
+    void Push(const BrowserEvent& event) {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            queue_.push_back(event);
+        }
+        ready_.notify_one();
+    }
+
+private:
+    void Run() {
+        std::unique_lock<std::mutex> lock(lock_);
+        for (;;) {
+            ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            BrowserEvent event = queue_.front();
+            queue_.pop_front();
+            lock.unlock();
+            observer_->OnBrowserEvent(event);
+            lock.lock();
+        }
+    }
+
+    BrowserEventObserver* observer_;
+    std::mutex lock_;
+    std::condition_variable ready_;
+    std::deque<BrowserEvent> queue_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+// A callback's worth of event: a load start with a typical URL
+BrowserEvent MakeEvent(int i) {
+    BrowserEvent event(BrowserEventType::kLoadStart, 1 + i % 16);
+    event.SetText("https://www.example.com/articles/2024/05/some-article-title?utm_source=feed");
+    return event;
+}
+
+// Time |enqueue| for |events| events, pausing every 64 to let consumers
+// catch up the way callbacks arrive in bursts
+template <typename Enqueue>
+Histogram Measure(int events, Enqueue&& enqueue) {
+    Histogram latency_ns;
+    for (int i = 0; i < events; ++i) {
+        const BrowserEvent event = MakeEvent(i);
+        const Clock::time_point start = Clock::now();
+        enqueue(event);
+        latency_ns.Record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        if (i % 64 == 63) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    return latency_ns;
+}
+
+void Print(const char* name, const Histogram& latency_ns) {
+    std::printf("  %-18s p50 %6llu ns  p99 %6llu ns  p99.9 %7llu ns  max %8llu ns\n", name,
+                static_cast<unsigned long long>(latency_ns.ValueAtPercentile(50)),
+                static_cast<unsigned long long>(latency_ns.ValueAtPercentile(99)),
+                static_cast<unsigned long long>(latency_ns.ValueAtPercentile(99.9)),
+                static_cast<unsigned long long>(latency_ns.max()));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int events = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const int workers = argc > 2 ? std::atoi(argv[2]) : 2;
+    std::printf("Enqueue cost on the publishing thread, %d events\n", events);
+
+    {
+        JsonObserver observer;
+        Print("inline", Measure(events, [&](const BrowserEvent& event) {
+                  observer.OnBrowserEvent(event);
+              }));
+    }
+
+    {
+        JsonObserver observer;
+        Histogram latency;
+        {
+            LockedQueue queue(&observer);
+            latency = Measure(events, [&](const BrowserEvent& event) { queue.Push(event); });
+        }
+        Print("mutex deque", latency);
+    }
+
+    {
+        JsonObserver observer;
+        EventPipelineOptions options;
+        options.workers = workers;
+        EventPipeline pipeline(options);
+        pipeline.AddObserver(&observer);
+        pipeline.Start();
+        Histogram latency =
+            Measure(events, [&](const BrowserEvent& event) { pipeline.Publish(event); });
+        pipeline.Stop();
+        Print("event pipeline", latency);
+
+        const EventPipelineStats stats = pipeline.GetStats();
+        std::printf("  delivered %llu of %llu, dropped %llu\n",
+                    static_cast<unsigned long long>(stats.delivered),
+                    static_cast<unsigned long long>(stats.published),
+                    static_cast<unsigned long long>(stats.total_dropped()));
+    }
+    return 0;
+}
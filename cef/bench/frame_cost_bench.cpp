@@ -0,0 +1,393 @@
+// CEF Browser - Frame Cost Benchmark
+// Renders an animated page off-screen under each rendering configuration and
+// reports the CPU time of the browser and all its subprocesses per painted
+// frame. CEF initializes once per process, so the driver runs every
+// configuration in a child process of this executable.
+//
+// Usage: frame_cost_bench [--configs=software,swiftshader,...]
+//                         [--raster-threads=1,4] [--duration-ms=N] [--frame-rate=N]
+//        frame_cost_bench --rendering=NAME [--duration-ms=N]   (one run)
+//
+// Without --configs every software configuration is measured, plus gpu when
+// the GPU probe finds one. --raster-threads adds software runs with that many
+// raster threads.
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "include/base/cef_callback.h"
+#include "include/cef_app.h"
+#include "include/cef_browser.h"
+#include "include/cef_command_line.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+#include "app.h"
+#include "browser_client.h"
+#include "browser_config.h"
+#include "gpu_detection.h"
+#include "rendering_config.h"
+#include "resource_util.h"
+
+namespace {
+
+// Let the page settle before measuring
+constexpr int kWarmupMs = 1000;
+
+// Canvas drawing and repainted boxes need raster work every frame;
+// transformed boxes only need compositing
+constexpr char kAnimatedPage[] = R"(<!DOCTYPE html>
+<html><head><style>
+body { margin: 0; font: 14px sans-serif; }
+canvas { display: block; }
+.grid { display: flex; flex-wrap: wrap; }
+.box { width: 60px; height: 60px; margin: 4px; border-radius: 8px;
+       animation: spin 2s linear infinite, shade 1s ease-in-out infinite alternate; }
+@keyframes spin { to { transform: rotate(360deg); } }
+@keyframes shade { from { background: #3b82f6; } to { background: #f97316; } }
+</style></head><body>
+<canvas id="canvas" width="1280" height="360"></canvas>
+<div class="grid" id="grid"></div>
+<script>
+const grid = document.getElementById('grid');
+for (let i = 0; i < 120; i++) {
+  const box = document.createElement('div');
+  box.className = 'box';
+  box.style.animationDelay = (i * 37 % 1000) + 'ms';
+  box.textContent = i;
+  grid.appendChild(box);
+}
+const context = document.getElementById('canvas').getContext('2d');
+function draw(time) {
+  context.clearRect(0, 0, 1280, 360);
+  for (let i = 0; i < 300; i++) {
+    const x = 640 + Math.sin(time / 700 + i) * 600;
+    const y = 180 + Math.cos(time / 900 + i * 1.3) * 170;
+    context.fillStyle = `hsl(${(i * 7 + time / 20) % 360}, 70%, 55%)`;
+    context.beginPath();
+    context.arc(x, y, 6 + i % 12, 0, Math.PI * 2);
+    context.fill();
+  }
+  requestAnimationFrame(draw);
+}
+requestAnimationFrame(draw);
+</script></body></html>)";
+
+using Clock = std::chrono::steady_clock;
+
+// CPU milliseconds of this process and its descendants, by process type
+struct CpuTimes {
+    double browser_ms = 0;
+    double gpu_ms = 0;
+    double renderer_ms = 0;
+    double other_ms = 0;
+
+    double total() const { return browser_ms + gpu_ms + renderer_ms + other_ms; }
+};
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// Sum utime + stime over the process tree rooted at this process
+CpuTimes GetProcessTreeCpu() {
+    struct Process {
+        int parent = 0;
+        double cpu_ms = 0;
+    };
+    std::map<int, Process> processes;
+
+    const double ms_per_tick = 1000.0 / sysconf(_SC_CLK_TCK);
+    DIR* proc = opendir("/proc");
+    while (dirent* entry = proc ? readdir(proc) : nullptr) {
+        int pid = std::atoi(entry->d_name);
+        if (pid <= 0) {
+            continue;
+        }
+        // Fields after the parenthesized command name, which may contain spaces
+        std::string stat = ReadFile("/proc/" + std::string(entry->d_name) + "/stat");
+        size_t paren = stat.rfind(')');
+        if (paren == std::string::npos) {
+            continue;
+        }
+        std::istringstream fields(stat.substr(paren + 2));
+        std::string state;
+        Process process;
+        unsigned long long ignored = 0;
+        unsigned long long utime = 0;
+        unsigned long long stime = 0;
+        fields >> state >> process.parent;
+        for (int i = 0; i < 9; ++i) {
+            fields >> ignored;
+        }
+        fields >> utime >> stime;
+        process.cpu_ms = (utime + stime) * ms_per_tick;
+        processes[pid] = process;
+    }
+    if (proc) {
+        closedir(proc);
+    }
+
+    CpuTimes times;
+    const int self = getpid();
+    for (const auto& it : processes) {
+        // Walk up to this process or the root
+        int pid = it.first;
+        while (pid > 1 && pid != self) {
+            auto parent = processes.find(pid);
+            pid = parent == processes.end() ? 0 : parent->second.parent;
+        }
+        if (pid != self) {
+            continue;
+        }
+
+        if (it.first == self) {
+            times.browser_ms += it.second.cpu_ms;
+            continue;
+        }
+        std::string cmdline = ReadFile("/proc/" + std::to_string(it.first) + "/cmdline");
+        if (cmdline.find("--type=gpu-process") != std::string::npos) {
+            times.gpu_ms += it.second.cpu_ms;
+        } else if (cmdline.find("--type=renderer") != std::string::npos) {
+            times.renderer_ms += it.second.cpu_ms;
+        } else {
+            times.other_ms += it.second.cpu_ms;
+        }
+    }
+    return times;
+}
+
+// Loads the animated page in one off-screen browser and measures it
+class FrameCostBench : public BrowserClient::Delegate {
+public:
+    explicit FrameCostBench(int duration_ms)
+        : duration_ms_(duration_ms), client_(new BrowserClient(this)) {}
+
+    void Start() {
+        CefWindowInfo window_info;
+        window_info.SetAsWindowless(kNullWindowHandle);
+        CefBrowserSettings browser_settings;
+        browser_settings.windowless_frame_rate = GetBrowserConfig().frame_rate;
+        CefBrowserHost::CreateBrowser(window_info, client_,
+                                      GetDataURI(kAnimatedPage, "text/html"), browser_settings,
+                                      nullptr, nullptr);
+    }
+
+    bool finished() const { return finished_; }
+    int frames() const { return end_frames_ - start_frames_; }
+    double seconds() const {
+        return std::chrono::duration<double>(end_time_ - start_time_).count();
+    }
+    CpuTimes cpu() const {
+        CpuTimes delta;
+        delta.browser_ms = end_cpu_.browser_ms - start_cpu_.browser_ms;
+        delta.gpu_ms = end_cpu_.gpu_ms - start_cpu_.gpu_ms;
+        delta.renderer_ms = end_cpu_.renderer_ms - start_cpu_.renderer_ms;
+        delta.other_ms = end_cpu_.other_ms - start_cpu_.other_ms;
+        return delta;
+    }
+
+    // BrowserClient::Delegate methods
+    void OnBrowserCreated(CefRefPtr<CefBrowser> browser) override { browser_ = browser; }
+
+    void OnBrowserClosed(CefRefPtr<CefBrowser> browser) override {
+        browser_ = nullptr;
+        CefQuitMessageLoop();
+    }
+
+    void OnViewPainted(CefRefPtr<CefBrowser> browser) override { ++frames_; }
+
+    void OnMainFrameLoadEnd(CefRefPtr<CefBrowser> browser, const std::string& url,
+                            int http_status) override {
+        CefPostDelayedTask(
+            TID_UI, base::BindOnce(&FrameCostBench::BeginMeasure, base::Unretained(this)),
+            kWarmupMs);
+    }
+
+    void OnMainFrameLoadError(CefRefPtr<CefBrowser> browser, const std::string& url,
+                              cef_errorcode_t error_code) override {
+        fprintf(stderr, "Failed to load the animated page (%d)\n", error_code);
+        browser_->GetHost()->CloseBrowser(true);
+    }
+
+private:
+    void BeginMeasure() {
+        start_cpu_ = GetProcessTreeCpu();
+        start_time_ = Clock::now();
+        start_frames_ = frames_;
+        CefPostDelayedTask(
+            TID_UI, base::BindOnce(&FrameCostBench::EndMeasure, base::Unretained(this)),
+            duration_ms_);
+    }
+
+    void EndMeasure() {
+        end_cpu_ = GetProcessTreeCpu();
+        end_time_ = Clock::now();
+        end_frames_ = frames_;
+        finished_ = true;
+        browser_->GetHost()->CloseBrowser(true);
+    }
+
+    const int duration_ms_;
+    CefRefPtr<BrowserClient> client_;
+    CefRefPtr<CefBrowser> browser_;
+    int frames_ = 0;
+    int start_frames_ = 0;
+    int end_frames_ = 0;
+    bool finished_ = false;
+    Clock::time_point start_time_;
+    Clock::time_point end_time_;
+    CpuTimes start_cpu_;
+    CpuTimes end_cpu_;
+};
+
+std::vector<std::string> SplitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::istringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Measure one rendering configuration and print a RESULT line
+int RunConfig(int argc, char* argv[], CefRefPtr<CefCommandLine> command_line) {
+    CefMainArgs main_args(argc, argv);
+    CefRefPtr<BrowserApp> app(new BrowserApp);
+    int exit_code = CefExecuteProcess(main_args, app, nullptr);
+    if (exit_code >= 0) {
+        return exit_code;
+    }
+    InitRenderingConfig(GetBrowserConfig().rendering);
+
+    const std::string duration = command_line->GetSwitchValue("duration-ms").ToString();
+    const int duration_ms = duration.empty() ? 5000 : std::max(1000, std::atoi(duration.c_str()));
+
+    CefSettings settings;
+    settings.windowless_rendering_enabled = true;
+    settings.chrome_runtime = false;
+    settings.log_severity = LOGSEVERITY_WARNING;
+    if (!CefInitialize(main_args, settings, app, nullptr)) {
+        return 1;
+    }
+
+    int result = 1;
+    {
+        FrameCostBench bench(duration_ms);
+        bench.Start();
+        CefRunMessageLoop();
+        if (bench.finished()) {
+            const CpuTimes cpu = bench.cpu();
+            printf("RESULT %d %.3f %.1f %.1f %.1f %.1f\n", bench.frames(), bench.seconds(),
+                   cpu.browser_ms, cpu.gpu_ms, cpu.renderer_ms, cpu.other_ms);
+            result = 0;
+        }
+    }
+    CefShutdown();
+    return result;
+}
+
+// Run every requested configuration in a child process and print a table
+int RunDriver(CefRefPtr<CefCommandLine> command_line) {
+    struct Run {
+        std::string label;
+        std::string arguments;
+    };
+    std::vector<Run> runs;
+
+    std::vector<std::string> configs = SplitList(command_line->GetSwitchValue("configs"));
+    if (configs.empty()) {
+        configs = {"software", "swiftshader"};
+        GpuProbeResult probe = ProbeGpu();
+        fprintf(stderr, "GPU probe: %s\n", probe.reason.c_str());
+        if (probe.hardware) {
+            configs.push_back("gpu");
+        }
+    }
+    for (const std::string& config : configs) {
+        runs.push_back({config, "--rendering=" + config});
+    }
+    for (const std::string& threads : SplitList(command_line->GetSwitchValue("raster-threads"))) {
+        runs.push_back({"software, " + threads + " raster threads",
+                        "--rendering=software --num-raster-threads=" + threads});
+    }
+
+    std::string common;
+    for (const char* name : {"duration-ms", "frame-rate", "viewport"}) {
+        std::string value = command_line->GetSwitchValue(name).ToString();
+        if (!value.empty()) {
+            common += std::string(" --") + name + "=" + value;
+        }
+    }
+
+    printf("%-34s %7s %9s %9s %9s %9s %9s\n", "configuration", "fps", "cpu/frame", "browser",
+           "gpu", "renderer", "cores");
+    for (const Run& run : runs) {
+        const std::string command = "/proc/self/exe " + run.arguments + common;
+        FILE* child = popen(command.c_str(), "r");
+        if (!child) {
+            continue;
+        }
+        char line[256];
+        int frames = 0;
+        double seconds = 0;
+        CpuTimes cpu;
+        bool found = false;
+        while (fgets(line, sizeof(line), child)) {
+            if (sscanf(line, "RESULT %d %lf %lf %lf %lf %lf", &frames, &seconds, &cpu.browser_ms,
+                       &cpu.gpu_ms, &cpu.renderer_ms, &cpu.other_ms) == 6) {
+                found = true;
+            }
+        }
+        pclose(child);
+
+        if (!found || frames <= 0) {
+            printf("%-34s failed\n", run.label.c_str());
+            continue;
+        }
+        // Milliseconds of CPU per frame, overall and per process type
+        printf("%-34s %7.1f %6.2f ms %6.2f ms %6.2f ms %6.2f ms %9.2f\n", run.label.c_str(),
+               frames / seconds, cpu.total() / frames, cpu.browser_ms / frames,
+               cpu.gpu_ms / frames, cpu.renderer_ms / frames, cpu.total() / (seconds * 1000));
+        fflush(stdout);
+    }
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    CefRefPtr<CefCommandLine> command_line = CefCommandLine::CreateCommandLine();
+    command_line->InitFromArgv(argc, argv);
+
+    // Subprocesses carry --type; configuration runs carry --rendering
+    if (!command_line->HasSwitch("type") && !command_line->HasSwitch("rendering")) {
+        return RunDriver(command_line);
+    }
+
+    // The benchmark always renders off-screen, by default at 60 fps
+    if (!command_line->HasSwitch("headless")) {
+        command_line->AppendSwitch("headless");
+    }
+    if (!command_line->HasSwitch("frame-rate")) {
+        command_line->AppendSwitchWithValue("frame-rate", "60");
+    }
+    InitBrowserConfig(command_line);
+    return RunConfig(argc, argv, command_line);
+}
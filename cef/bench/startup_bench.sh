@@ -0,0 +1,153 @@
+#!/bin/bash
+# CEF Browser Startup Benchmark
+# Compares startup time and memory of off-screen rendering on the headless
+# ozone platform with the Xvfb setups it replaces:
+#
+#   headless    --headless, ozone headless, no display server
+#   osr-x11     --headless --ozone-platform=x11 under Xvfb
+#   window-x11  windowed browser under Xvfb
+#
+# Startup is the time until the DevTools endpoint lists the first page.
+# Memory is sampled after a settle period over the browser process tree and,
+# for the X11 modes, Xvfb: RSS and PSS (shared pages split between processes).
+#
+# Usage: bench/startup_bench.sh [iterations] [modes...]
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${BUILD_DIR:-${SCRIPT_DIR}/../build}"
+BROWSER_BIN="${BUILD_DIR}/cef_browser"
+ITERATIONS="${1:-5}"
+shift || true
+MODES="${*:-headless osr-x11 window-x11}"
+PORT=9222
+SETTLE_SECONDS=3
+TIMEOUT_SECONDS=30
+DISPLAY_NUMBER=97
+
+cleanup() {
+    if [ -n "$BROWSER_PID" ]; then
+        kill $BROWSER_PID 2>/dev/null || true
+        wait $BROWSER_PID 2>/dev/null || true
+    fi
+    if [ -n "$XVFB_PID" ]; then
+        kill $XVFB_PID 2>/dev/null || true
+        wait $XVFB_PID 2>/dev/null || true
+    fi
+    BROWSER_PID=
+    XVFB_PID=
+}
+
+trap cleanup EXIT
+
+now_ms() {
+    echo $(($(date +%s%N) / 1000000))
+}
+
+# Print "rss_kb pss_kb" summed over |pid| and its descendants
+tree_memory() {
+    local pids="$1" queue="$1" pid children rss=0 pss=0 value
+    while [ -n "$queue" ]; do
+        set -- $queue
+        pid=$1
+        shift
+        queue="$*"
+        children=$(cat /proc/$pid/task/*/children 2>/dev/null || true)
+        pids="$pids $children"
+        queue="$queue $children"
+    done
+    for pid in $pids; do
+        value=$(awk '/^VmRSS:/ { print $2 }' /proc/$pid/status 2>/dev/null || true)
+        rss=$((rss + ${value:-0}))
+        value=$(awk '/^Pss:/ { print $2 }' /proc/$pid/smaps_rollup 2>/dev/null || true)
+        pss=$((pss + ${value:-0}))
+    done
+    echo "$rss $pss"
+}
+
+# Run |mode| once and print "startup_ms rss_kb pss_kb"
+run_once() {
+    local mode="$1" start ready memory xvfb_memory="0 0"
+    local args=(--url=about:blank --metrics-interval=0 --no-sandbox)
+
+    start=$(now_ms)
+    case "$mode" in
+        headless)
+            env -u DISPLAY -u WAYLAND_DISPLAY "$BROWSER_BIN" --headless "${args[@]}" \
+                >/dev/null 2>&1 &
+            BROWSER_PID=$!
+            ;;
+        osr-x11 | window-x11)
+            Xvfb :$DISPLAY_NUMBER -screen 0 1280x800x24 -nolisten tcp >/dev/null 2>&1 &
+            XVFB_PID=$!
+            while [ ! -e /tmp/.X11-unix/X$DISPLAY_NUMBER ]; do
+                sleep 0.01
+            done
+            if [ "$mode" = osr-x11 ]; then
+                args+=(--headless --ozone-platform=x11)
+            fi
+            DISPLAY=:$DISPLAY_NUMBER "$BROWSER_BIN" "${args[@]}" >/dev/null 2>&1 &
+            BROWSER_PID=$!
+            ;;
+        *)
+            echo "Unknown mode $mode" >&2
+            return 1
+            ;;
+    esac
+
+    until curl -s "http://127.0.0.1:$PORT/json/list" 2>/dev/null | grep -q '"type": *"page"'; do
+        if [ $(($(now_ms) - start)) -gt $((TIMEOUT_SECONDS * 1000)) ]; then
+            echo "timeout"
+            cleanup
+            return 0
+        fi
+        sleep 0.02
+    done
+    ready=$(now_ms)
+
+    sleep $SETTLE_SECONDS
+    memory=$(tree_memory $BROWSER_PID)
+    if [ -n "$XVFB_PID" ]; then
+        xvfb_memory=$(tree_memory $XVFB_PID)
+    fi
+    cleanup
+
+    set -- $memory $xvfb_memory
+    echo "$((ready - start)) $(($1 + $3)) $(($2 + $4))"
+}
+
+median() {
+    sort -n | awk '{ values[NR] = $1 } END { if (NR) print values[int((NR + 1) / 2)]; else print 0 }'
+}
+
+if [ ! -x "$BROWSER_BIN" ]; then
+    echo "Browser binary not found at $BROWSER_BIN" >&2
+    exit 1
+fi
+
+printf "%-12s %6s %12s %12s %12s\n" "mode" "runs" "startup ms" "RSS MB" "PSS MB"
+for mode in $MODES; do
+    if [ "$mode" != headless ] && ! command -v Xvfb >/dev/null; then
+        printf "%-12s skipped, Xvfb not installed\n" "$mode"
+        continue
+    fi
+
+    results=()
+    for ((i = 0; i < ITERATIONS; i++)); do
+        result=$(run_once "$mode")
+        if [ "$result" != timeout ]; then
+            results+=("$result")
+        fi
+    done
+
+    if [ ${#results[@]} -eq 0 ]; then
+        printf "%-12s failed\n" "$mode"
+        continue
+    fi
+    startup=$(printf "%s\n" "${results[@]}" | awk '{ print $1 }' | median)
+    rss=$(printf "%s\n" "${results[@]}" | awk '{ print $2 }' | median)
+    pss=$(printf "%s\n" "${results[@]}" | awk '{ print $3 }' | median)
+    printf "%-12s %6d %12d %12.1f %12.1f\n" "$mode" ${#results[@]} "$startup" \
+        "$(echo "$rss / 1024" | bc -l)" "$(echo "$pss / 1024" | bc -l)"
+done
@@ -6,12 +6,14 @@ set -e
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 BUILD_DIR="${SCRIPT_DIR}/build"
 BUILD_TYPE="${1:-Release}"
+HEADLESS_ONLY="${HEADLESS_ONLY:-OFF}"
 
 echo "==================================="
 echo "CEF Browser Build Script"
 echo "==================================="
 echo "Build Type: ${BUILD_TYPE}"
 echo "Build Directory: ${BUILD_DIR}"
+echo "Headless Only: ${HEADLESS_ONLY}"
 echo ""
 
 # Check for required tools
@@ -70,7 +72,7 @@ cd "${BUILD_DIR}"
 
 # Configure with CMake
 echo "Configuring with CMake..."
-cmake -DCMAKE_BUILD_TYPE="${BUILD_TYPE}" ..
+cmake -DCMAKE_BUILD_TYPE="${BUILD_TYPE}" -DHEADLESS_ONLY="${HEADLESS_ONLY}" ..
 
 # Build
 echo ""
@@ -89,4 +91,4 @@ echo "To run the browser:"
 echo "  cd ${BUILD_DIR}"
 echo "  ./cef_browser"
 echo ""
-echo "Remote debugging available at: http://localhost:9222"
+echo "Remote debugging available at: http://localhost:9222 (or the port in DevToolsEndpoint.json)"
@@ -1,46 +1,159 @@
 // CEF Browser - Application Handler Implementation
 #include "app.h"
-
+#include "browser_config.h"
+#include "devtools_server.h"
+#include "internal_pages.h"
+#include "message_pump.h"
+#include "performance_profile.h"
+#include "process_memory.h"
+#include "rendering_config.h"
+#include "scheme_handler.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "include/base/cef_logging.h"
 #include "include/cef_browser.h"
 #include "include/cef_command_line.h"
 #include "include/wrapper/cef_helpers.h"
 
-BrowserApp::BrowserApp() {}
+namespace {
+
+// Append |entry| unless the switch is already set, e.g. on the command line.
+// Returns whether it was appended.
+bool AppendSwitchIfMissing(CefRefPtr<CefCommandLine> command_line,
+                           const CommandLineSwitch& entry) {
+    if (command_line->HasSwitch(entry.name)) {
+        return false;
+    }
+    if (entry.value.empty()) {
+        command_line->AppendSwitch(entry.name);
+    } else {
+        command_line->AppendSwitchWithValue(entry.name, entry.value);
+    }
+    return true;
+}
 
-void BrowserApp::OnBeforeCommandLineProcessing(const CefString& process_type,
-                                               CefRefPtr<CefCommandLine> command_line) {
-    // Add command line switches for better performance and compatibility
+// Resolve the performance profile selected by |config| for |resources|
+PerformanceProfile LoadPerformanceProfile(const BrowserConfig& config,
+                                          const HostResources& resources) {
+    PerformanceProfileConfig profile_config;
+    const std::string& path = config.performance_profile_config;
+    if (!path.empty()) {
+        std::ifstream file(path);
+        std::ostringstream text;
+        text << file.rdbuf();
+        int error_line = 0;
+        if (!file) {
+            LOG(WARNING) << "Cannot read performance profile config " << path;
+        } else if (!ParsePerformanceProfileConfig(text.str(), &profile_config, &error_line)) {
+            LOG(WARNING) << path << ":" << error_line << ": missing switch name";
+        }
+    }
+
+    std::string name = config.performance_profile;
+    if (name.empty()) {
+        name = profile_config.profile.empty() ? kDefaultPerformanceProfile : profile_config.profile;
+    }
+
+    PerformanceProfile profile;
+    if (!GetPerformanceProfile(name, resources, config.off_screen, &profile)) {
+        LOG(WARNING) << "Unknown performance profile " << name << ", using "
+                     << kDefaultPerformanceProfile;
+        GetPerformanceProfile(kDefaultPerformanceProfile, resources, config.off_screen, &profile);
+    }
+    ApplyPerformanceProfileConfig(profile_config, &profile);
+    return profile;
+}
+
+// DOMContentLoaded listener of a main frame document that reports the event
+// to the browser process, where it gates page readiness
+class DomContentLoadedHandler : public CefV8Handler {
+public:
+    DomContentLoadedHandler() = default;
 
-    // Enable hardware acceleration
-    command_line->AppendSwitch("enable-gpu");
-    command_line->AppendSwitch("enable-gpu-rasterization");
-    command_line->AppendSwitch("enable-zero-copy");
+    bool Execute(const CefString& name, CefRefPtr<CefV8Value> object,
+                 const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval,
+                 CefString& exception) override {
+        CefV8Context::GetCurrentContext()->GetFrame()->SendProcessMessage(
+            PID_BROWSER, CefProcessMessage::Create(kDomContentLoadedMessage));
+        return true;
+    }
 
-    // Enable smooth scrolling
-    command_line->AppendSwitch("enable-smooth-scrolling");
+private:
+    IMPLEMENT_REFCOUNTING(DomContentLoadedHandler);
+    DISALLOW_COPY_AND_ASSIGN(DomContentLoadedHandler);
+};
 
-    // Enable experimental web features
-    command_line->AppendSwitch("enable-experimental-web-platform-features");
+}  // namespace
 
+BrowserApp::BrowserApp() {}
+
+void BrowserApp::OnBeforeCommandLineProcessing(const CefString& process_type,
+                                               CefRefPtr<CefCommandLine> command_line) {
     // Disable some security features for local development (remove in production)
     // command_line->AppendSwitch("disable-web-security");
 
-    // Enable remote debugging
-    command_line->AppendSwitchWithValue("remote-debugging-port", "9222");
-
-    // GPU process settings
-    command_line->AppendSwitch("ignore-gpu-blocklist");
+    if (!process_type.empty()) {
+        return;
+    }
+
+    // DevTools port chosen before CefInitialize(). A port given on the command
+    // line is replaced, by 0 when Chromium must not listen; the last value of
+    // a repeated switch wins.
+    command_line->AppendSwitchWithValue("remote-debugging-port",
+                                        std::to_string(GetDevToolsEndpoint().ChromiumPort()));
+
+    // GPU or software rendering, chosen before CefInitialize()
+    for (const CommandLineSwitch& entry : GetActiveRenderingConfig().switches) {
+        AppendSwitchIfMissing(command_line, entry);
+    }
+
+    // Process, raster thread and V8 heap sizing come from the performance
+    // profile. Subprocesses inherit the switches they use from the browser
+    // process.
+    const BrowserConfig& config = GetBrowserConfig();
+    const HostResources resources = DetectHostResources();
+    PerformanceProfile profile = LoadPerformanceProfile(config, resources);
+    for (const CommandLineSwitch& entry : profile.switches) {
+        if (!AppendSwitchIfMissing(command_line, entry)) {
+            profile.Set(entry.name, command_line->GetSwitchValue(entry.name).ToString());
+        }
+    }
+    LOG(INFO) << "Performance profile " << profile.name << " for " << resources.cpu_count
+              << " cores and " << resources.memory_bytes / (1024 * 1024)
+              << " MB: " << profile.ToString();
+
+    // Off-screen rendering needs no display server. Subprocesses inherit the
+    // ozone platform from the browser process. Headless-only builds have no
+    // other platform to offer; the last value of a repeated switch wins.
+#if defined(CEF_BROWSER_HEADLESS_ONLY)
+    command_line->AppendSwitchWithValue("ozone-platform", "headless");
+#else
+    if (config.off_screen && !command_line->HasSwitch("ozone-platform")) {
+        command_line->AppendSwitchWithValue("ozone-platform", "headless");
+    }
+#endif
 
-    // Renderer process limit (0 = unlimited)
-    command_line->AppendSwitchWithValue("renderer-process-limit", "4");
+    LOG(INFO) << "Effective command line: " << command_line->GetCommandLineString().ToString();
+}
 
-    // Enable tab discarding when memory is low
-    command_line->AppendSwitch("enable-tab-discarding");
+void BrowserApp::OnRegisterCustomSchemes(CefRawPtr<CefSchemeRegistrar> registrar) {
+    // Internal pages are served from app://internal/. Registration must match
+    // in every process, so this runs in the browser and all subprocesses.
+    registrar->AddCustomScheme(kInternalScheme, CEF_SCHEME_OPTION_STANDARD |
+                                                    CEF_SCHEME_OPTION_SECURE |
+                                                    CEF_SCHEME_OPTION_CORS_ENABLED |
+                                                    CEF_SCHEME_OPTION_FETCH_ENABLED);
 }
 
 void BrowserApp::OnContextInitialized() {
     CEF_REQUIRE_UI_THREAD();
 
+    // Serve internal pages and packed resources directly, without data: URIs
+    RegisterInternalSchemeHandlerFactory();
+
     // Browser process has been initialized
     // The browser window will be created from main.cpp
 }
@@ -50,6 +163,11 @@ CefRefPtr<CefClient> BrowserApp::GetDefaultClient() {
     return nullptr;
 }
 
+void BrowserApp::OnScheduleMessagePumpWork(int64_t delay_ms) {
+    // Only called when CefSettings.external_message_pump is set
+    ScheduleMessagePumpWork(delay_ms);
+}
+
 void BrowserApp::OnWebKitInitialized() {
     // Called in the renderer process when WebKit has been initialized
     // This is where you can register custom JavaScript bindings
@@ -84,4 +202,40 @@ void BrowserApp::OnContextCreated(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFr
 
     // Register the browser object globally
     global->SetValue("cefBrowser", browserObj, V8_PROPERTY_ATTRIBUTE_NONE);
+
+    // Tell the browser which process hosts this page, e.g. for memory stats
+    if (frame->IsMain()) {
+        CefRefPtr<CefProcessMessage> message = CefProcessMessage::Create(kRendererInfoMessage);
+        message->GetArgumentList()->SetInt(0, GetCurrentProcessIdentifier());
+        frame->SendProcessMessage(PID_BROWSER, message);
+
+        // Listen without a global the page could see or overwrite
+        CefRefPtr<CefV8Value> document = global->GetValue("document");
+        CefRefPtr<CefV8Value> add_listener;
+        if (document && document->IsObject()) {
+            add_listener = document->GetValue("addEventListener");
+        }
+        if (add_listener && add_listener->IsFunction()) {
+            CefV8ValueList arguments;
+            arguments.push_back(CefV8Value::CreateString("DOMContentLoaded"));
+            arguments.push_back(
+                CefV8Value::CreateFunction("onDOMContentLoaded", new DomContentLoadedHandler()));
+            add_listener->ExecuteFunctionWithContext(context, document, arguments);
+        }
+    }
+}
+
+bool BrowserApp::OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
+                                          CefRefPtr<CefFrame> frame,
+                                          CefProcessId source_process,
+                                          CefRefPtr<CefProcessMessage> message) {
+    // Answered on the renderer main thread, so a page stuck in script or
+    // layout leaves the ping unanswered
+    if (message->GetName() == kRendererPingMessage) {
+        CefRefPtr<CefProcessMessage> pong = CefProcessMessage::Create(kRendererPongMessage);
+        pong->GetArgumentList()->SetInt(0, message->GetArgumentList()->GetInt(0));
+        frame->SendProcessMessage(PID_BROWSER, pong);
+        return true;
+    }
+    return false;
 }
@@ -6,6 +6,22 @@
 #include "include/cef_browser_process_handler.h"
 #include "include/cef_render_process_handler.h"
 
+// Renderer to browser message sent when a main frame context is created.
+// Arguments: [0] renderer process id.
+constexpr char kRendererInfoMessage[] = "BrowserApp.RendererInfo";
+
+// Renderer to browser message sent when a main frame document has fired
+// DOMContentLoaded. No arguments.
+constexpr char kDomContentLoadedMessage[] = "BrowserApp.DOMContentLoaded";
+
+// Browser to renderer message that checks the renderer's main thread still
+// runs, answered with kRendererPongMessage. Arguments: [0] sequence number.
+constexpr char kRendererPingMessage[] = "BrowserApp.Ping";
+
+// Renderer to browser answer to kRendererPingMessage. Arguments: [0] the
+// ping's sequence number.
+constexpr char kRendererPongMessage[] = "BrowserApp.Pong";
+
 // Application handler that manages browser and renderer processes
 class BrowserApp : public CefApp, public CefBrowserProcessHandler, public CefRenderProcessHandler {
 public:
@@ -16,15 +32,20 @@ public:
     CefRefPtr<CefRenderProcessHandler> GetRenderProcessHandler() override { return this; }
     void OnBeforeCommandLineProcessing(const CefString& process_type,
                                        CefRefPtr<CefCommandLine> command_line) override;
+    void OnRegisterCustomSchemes(CefRawPtr<CefSchemeRegistrar> registrar) override;
 
     // CefBrowserProcessHandler methods
     void OnContextInitialized() override;
     CefRefPtr<CefClient> GetDefaultClient() override;
+    void OnScheduleMessagePumpWork(int64_t delay_ms) override;
 
     // CefRenderProcessHandler methods
     void OnWebKitInitialized() override;
     void OnContextCreated(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
                           CefRefPtr<CefV8Context> context) override;
+    bool OnProcessMessageReceived(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                  CefProcessId source_process,
+                                  CefRefPtr<CefProcessMessage> message) override;
 
 private:
     IMPLEMENT_REFCOUNTING(BrowserApp);
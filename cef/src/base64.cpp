@@ -0,0 +1,380 @@
+// CEF Browser - Base64 Encoding Implementation
+//
+// The vector kernels follow Wojciech Muła's approach: shuffle each 3-byte group
+// into a 32-bit lane, split it into four 6-bit indices with multiplies, then
+// map indices to ASCII with a 16-entry offset table.
+#include "base64.h"
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BASE64_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define BASE64_TARGET(features)
+#else
+#define BASE64_TARGET(features) __attribute__((target(features)))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BASE64_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Write |c|, as "%2B", "%2F" or "%3D" if it is one of the base64 characters
+// that CefURIEncode() escapes
+inline char* PutUriChar(char c, char* dst) {
+    if (c != '+' && c != '/' && c != '=') {
+        *dst = c;
+        return dst + 1;
+    }
+    dst[0] = '%';
+    dst[1] = c == '=' ? '3' : '2';
+    dst[2] = c == '+' ? 'B' : c == '/' ? 'F' : 'D';
+    return dst + 3;
+}
+
+template <bool kEscape>
+inline char* Put(char c, char* dst) {
+    if (kEscape) {
+        return PutUriChar(c, dst);
+    }
+    *dst = c;
+    return dst + 1;
+}
+
+template <bool kEscape>
+size_t EncodeScalar(const uint8_t* src, size_t size, char* out) {
+    char* dst = out;
+    size_t i = 0;
+    for (; i + 3 <= size; i += 3) {
+        uint32_t triple = (uint32_t{src[i]} << 16) | (uint32_t{src[i + 1]} << 8) | src[i + 2];
+        dst = Put<kEscape>(kAlphabet[(triple >> 18) & 0x3F], dst);
+        dst = Put<kEscape>(kAlphabet[(triple >> 12) & 0x3F], dst);
+        dst = Put<kEscape>(kAlphabet[(triple >> 6) & 0x3F], dst);
+        dst = Put<kEscape>(kAlphabet[triple & 0x3F], dst);
+    }
+
+    size_t remaining = size - i;
+    if (remaining > 0) {
+        uint32_t triple = uint32_t{src[i]} << 16;
+        if (remaining == 2) {
+            triple |= uint32_t{src[i + 1]} << 8;
+        }
+        dst = Put<kEscape>(kAlphabet[(triple >> 18) & 0x3F], dst);
+        dst = Put<kEscape>(kAlphabet[(triple >> 12) & 0x3F], dst);
+        dst = Put<kEscape>(remaining == 2 ? kAlphabet[(triple >> 6) & 0x3F] : '=', dst);
+        dst = Put<kEscape>('=', dst);
+    }
+
+    return static_cast<size_t>(dst - out);
+}
+
+#if defined(BASE64_X86)
+
+// Encode the first 12 bytes of |input| into 16 characters
+BASE64_TARGET("sse4.1")
+inline __m128i EncodeBlockSSE(__m128i input) {
+    input = _mm_shuffle_epi8(input,
+                             _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+    const __m128i t0 = _mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(input, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
+
+    // Reduce each index to a table slot: 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10,
+    // 62 -> 11, 63 -> 12. The slot holds the offset from the index to its character.
+    const __m128i shift_lut =
+        _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    __m128i slots = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    slots = _mm_or_si128(slots, _mm_and_si128(less, _mm_set1_epi8(13)));
+
+    return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, slots), indices);
+}
+
+inline uint32_t LowestSetBit(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+}
+
+// Write the |count| characters of |block|, escaping those whose bit is set in
+// |special| (all '+' or '/'). The runs between them are copied whole.
+inline char* PutUriBlock(const char* block, uint32_t count, uint32_t special, char* dst) {
+    uint32_t pos = 0;
+    while (special) {
+        const uint32_t next = LowestSetBit(special);
+        special &= special - 1;
+        memcpy(dst, block + pos, next - pos);
+        dst += next - pos;
+        dst[0] = '%';
+        dst[1] = '2';
+        dst[2] = block[next] == '+' ? 'B' : 'F';
+        dst += 3;
+        pos = next + 1;
+    }
+    memcpy(dst, block + pos, count - pos);
+    return dst + count - pos;
+}
+
+// Store 16 encoded characters, escaped if |kEscape|
+template <bool kEscape>
+BASE64_TARGET("sse4.1")
+inline char* StoreBlockSSE(__m128i chars, char* dst) {
+    if (kEscape) {
+        const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('+')),
+                                             _mm_cmpeq_epi8(chars, _mm_set1_epi8('/')));
+        if (const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(special))) {
+            alignas(16) char block[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(block), chars);
+            return PutUriBlock(block, sizeof(block), mask, dst);
+        }
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), chars);
+    return dst + 16;
+}
+
+template <bool kEscape>
+BASE64_TARGET("sse4.1")
+size_t EncodeSSE41(const uint8_t* src, size_t size, char* out) {
+    char* dst = out;
+    size_t i = 0;
+
+    // Each step loads 16 bytes but consumes only 12
+    for (; i + 16 <= size; i += 12) {
+        __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        dst = StoreBlockSSE<kEscape>(EncodeBlockSSE(input), dst);
+    }
+
+    dst += EncodeScalar<kEscape>(src + i, size - i, dst);
+    return static_cast<size_t>(dst - out);
+}
+
+template <bool kEscape>
+BASE64_TARGET("avx2")
+size_t EncodeAVX2(const uint8_t* src, size_t size, char* out) {
+    char* dst = out;
+    size_t i = 0;
+
+    // Each step loads two overlapping 16-byte halves and consumes 24 bytes
+    for (; i + 28 <= size; i += 24) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+        __m256i input = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        input = _mm256_shuffle_epi8(
+            input, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1,
+                                    4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+        const __m256i t0 = _mm256_and_si256(input, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(input, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+
+        const __m256i shift_lut = _mm256_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0, 'a' - 26, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+        __m256i slots = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        slots = _mm256_or_si256(slots, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+
+        __m256i result = _mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, slots), indices);
+        if (kEscape) {
+            const __m256i special =
+                _mm256_or_si256(_mm256_cmpeq_epi8(result, _mm256_set1_epi8('+')),
+                                _mm256_cmpeq_epi8(result, _mm256_set1_epi8('/')));
+            if (const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(special))) {
+                alignas(32) char block[32];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(block), result);
+                dst = PutUriBlock(block, sizeof(block), mask, dst);
+                continue;
+            }
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), result);
+        dst += 32;
+    }
+
+    dst += EncodeSSE41<kEscape>(src + i, size - i, dst);
+    return static_cast<size_t>(dst - out);
+}
+
+bool CpuSupports(Base64Kernel kernel) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    bool sse41 = (info[2] & (1 << 19)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (kernel == Base64Kernel::kSSE41) {
+        return sse41;
+    }
+
+    // AVX2 also needs the OS to preserve YMM state
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    if (kernel == Base64Kernel::kSSE41) {
+        return __builtin_cpu_supports("sse4.1");
+    }
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#elif defined(BASE64_NEON)
+
+template <bool kEscape>
+size_t EncodeNEON(const uint8_t* src, size_t size, char* out) {
+    const uint8_t* alphabet = reinterpret_cast<const uint8_t*>(kAlphabet);
+    uint8x16x4_t table;
+    table.val[0] = vld1q_u8(alphabet);
+    table.val[1] = vld1q_u8(alphabet + 16);
+    table.val[2] = vld1q_u8(alphabet + 32);
+    table.val[3] = vld1q_u8(alphabet + 48);
+    const uint8x16_t mask = vdupq_n_u8(0x3F);
+
+    char* dst = out;
+    size_t i = 0;
+
+    // De-interleave 48 bytes into three lanes, produce four index lanes
+    for (; i + 48 <= size; i += 48) {
+        uint8x16x3_t input = vld3q_u8(src + i);
+        uint8x16x4_t result;
+        result.val[0] = vshrq_n_u8(input.val[0], 2);
+        result.val[1] =
+            vandq_u8(vorrq_u8(vshlq_n_u8(input.val[0], 4), vshrq_n_u8(input.val[1], 4)), mask);
+        result.val[2] =
+            vandq_u8(vorrq_u8(vshlq_n_u8(input.val[1], 2), vshrq_n_u8(input.val[2], 6)), mask);
+        result.val[3] = vandq_u8(input.val[2], mask);
+
+        uint8x16_t special = vdupq_n_u8(0);
+        for (int lane = 0; lane < 4; ++lane) {
+            result.val[lane] = vqtbl4q_u8(table, result.val[lane]);
+            if (kEscape) {
+                special = vorrq_u8(special, vceqq_u8(result.val[lane], vdupq_n_u8('+')));
+                special = vorrq_u8(special, vceqq_u8(result.val[lane], vdupq_n_u8('/')));
+            }
+        }
+        if (kEscape && vmaxvq_u8(special)) {
+            char block[64];
+            vst4q_u8(reinterpret_cast<uint8_t*>(block), result);
+            for (char c : block) {
+                dst = PutUriChar(c, dst);
+            }
+            continue;
+        }
+        vst4q_u8(reinterpret_cast<uint8_t*>(dst), result);
+        dst += 64;
+    }
+
+    dst += EncodeScalar<kEscape>(src + i, size - i, dst);
+    return static_cast<size_t>(dst - out);
+}
+
+#endif
+
+template <bool kEscape>
+size_t Encode(Base64Kernel kernel, const void* data, size_t size, char* out) {
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    switch (kernel) {
+#if defined(BASE64_X86)
+        case Base64Kernel::kAVX2:
+            return EncodeAVX2<kEscape>(src, size, out);
+        case Base64Kernel::kSSE41:
+            return EncodeSSE41<kEscape>(src, size, out);
+#elif defined(BASE64_NEON)
+        case Base64Kernel::kNEON:
+            return EncodeNEON<kEscape>(src, size, out);
+#endif
+        default:
+            return EncodeScalar<kEscape>(src, size, out);
+    }
+}
+
+}  // namespace
+
+size_t Base64Encode(const void* data, size_t size, char* out) {
+    static const Base64Kernel kernel = GetBase64Kernel();
+    return Base64EncodeWith(kernel, data, size, out);
+}
+
+size_t Base64EncodeWith(Base64Kernel kernel, const void* data, size_t size, char* out) {
+    return Encode<false>(kernel, data, size, out);
+}
+
+size_t Base64UriEncode(const void* data, size_t size, char* out) {
+    static const Base64Kernel kernel = GetBase64Kernel();
+    return Base64UriEncodeWith(kernel, data, size, out);
+}
+
+size_t Base64UriEncodeWith(Base64Kernel kernel, const void* data, size_t size, char* out) {
+    return Encode<true>(kernel, data, size, out);
+}
+
+Base64Kernel GetBase64Kernel() {
+    static const Base64Kernel kernel = [] {
+        for (Base64Kernel candidate : {Base64Kernel::kNEON, Base64Kernel::kAVX2,
+                                       Base64Kernel::kSSE41}) {
+            if (IsBase64KernelSupported(candidate)) {
+                return candidate;
+            }
+        }
+        return Base64Kernel::kScalar;
+    }();
+    return kernel;
+}
+
+bool IsBase64KernelSupported(Base64Kernel kernel) {
+    switch (kernel) {
+        case Base64Kernel::kScalar:
+            return true;
+#if defined(BASE64_X86)
+        case Base64Kernel::kSSE41:
+        case Base64Kernel::kAVX2:
+            return CpuSupports(kernel);
+#elif defined(BASE64_NEON)
+        case Base64Kernel::kNEON:
+            // Advanced SIMD is mandatory on AArch64
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* GetBase64KernelName(Base64Kernel kernel) {
+    switch (kernel) {
+        case Base64Kernel::kScalar:
+            return "scalar";
+        case Base64Kernel::kSSE41:
+            return "sse4.1";
+        case Base64Kernel::kAVX2:
+            return "avx2";
+        case Base64Kernel::kNEON:
+            return "neon";
+    }
+    return "unknown";
+}
@@ -0,0 +1,50 @@
+// CEF Browser - Base64 Encoding
+#ifndef CEF_BROWSER_BASE64_H_
+#define CEF_BROWSER_BASE64_H_
+
+#include <cstddef>
+
+// Encoding kernels, from slowest to fastest
+enum class Base64Kernel {
+    kScalar,
+    kSSE41,
+    kAVX2,
+    kNEON,
+};
+
+// Get the number of characters needed to encode |size| bytes, with padding
+constexpr size_t Base64EncodedLength(size_t size) {
+    return (size + 2) / 3 * 4;
+}
+
+// Encode |size| bytes from |data| as padded standard base64 into |out|, which
+// must hold at least Base64EncodedLength(size) characters. Uses the fastest
+// kernel supported by this CPU. Returns the number of characters written.
+size_t Base64Encode(const void* data, size_t size, char* out);
+
+// Encode with a specific kernel. The kernel must be supported.
+size_t Base64EncodeWith(Base64Kernel kernel, const void* data, size_t size, char* out);
+
+// Get the largest number of characters Base64UriEncode() writes for |size|
+// bytes, were every character escaped
+constexpr size_t Base64UriEncodedMaxLength(size_t size) {
+    return Base64EncodedLength(size) * 3;
+}
+
+// Encode like Base64Encode(), but with '+', '/' and '=' percent-escaped as
+// "%2B", "%2F" and "%3D", in the same pass. The result equals
+// CefURIEncode(CefBase64Encode(data), false). |out| must hold at least
+// Base64UriEncodedMaxLength(size) characters. Returns the number written.
+size_t Base64UriEncode(const void* data, size_t size, char* out);
+size_t Base64UriEncodeWith(Base64Kernel kernel, const void* data, size_t size, char* out);
+
+// Get the fastest kernel supported by this CPU (detected once at runtime)
+Base64Kernel GetBase64Kernel();
+
+// Check if |kernel| can run on this CPU
+bool IsBase64KernelSupported(Base64Kernel kernel);
+
+// Get a display name for |kernel|
+const char* GetBase64KernelName(Base64Kernel kernel);
+
+#endif  // CEF_BROWSER_BASE64_H_
@@ -1,17 +1,33 @@
 // CEF Browser - Browser Client Implementation
 #include "browser_client.h"
-#include "resource_util.h"
-
-#include <sstream>
+#include "app.h"
+#include "browser_config.h"
+#include "browser_pool.h"
+#include "content_blocking_handler.h"
+#include "devtools_server.h"
+#include "event_pipeline.h"
+#include "http_archive_handler.h"
+#include "internal_pages.h"
+#include "log_sink.h"
+#include "message_pump.h"
+#include "metrics_reporter.h"
+#include "page_readiness_handler.h"
+#include "renderer_recovery_handler.h"
+#include "resource_policy_handler.h"
+#include "trace_capture.h"
+#include "virtual_time_capture.h"
+#include "watchdog_handler.h"
+
+#include <algorithm>
 #include <string>
+#include <string_view>
 
+#include "include/base/cef_logging.h"
 #include "include/cef_app.h"
 #include "include/cef_parser.h"
 #include "include/wrapper/cef_closure_task.h"
 #include "include/wrapper/cef_helpers.h"
 
-int BrowserClient::browser_count_ = 0;
-
 // Custom context menu IDs (start after MENU_ID_USER_FIRST to avoid conflicts)
 enum CustomMenuId {
     CLIENT_MENU_VIEW_SOURCE = MENU_ID_USER_FIRST + 100,
@@ -21,7 +37,29 @@ enum CustomMenuId {
     CLIENT_MENU_COPY_URL,
 };
 
-BrowserClient::BrowserClient() : is_closing_(false) {}
+namespace {
+
+// The event pipeline when something observes it, so callbacks skip building
+// events nobody reads
+EventPipeline* GetObservedEventPipeline() {
+    EventPipeline* events = GetEventPipeline();
+    return events && events->has_observers() ? events : nullptr;
+}
+
+// The code units of |text| without converting them
+std::u16string_view AsUtf16(const CefString& text) {
+    static_assert(sizeof(CefString::char_type) == sizeof(char16_t), "CefString must be UTF-16");
+    return std::u16string_view(reinterpret_cast<const char16_t*>(text.c_str()), text.length());
+}
+
+}  // namespace
+
+CefBrowserRegistry& GetBrowserRegistry() {
+    static CefBrowserRegistry registry;
+    return registry;
+}
+
+BrowserClient::BrowserClient(Delegate* delegate) : is_closing_(false), delegate_(delegate) {}
 
 BrowserClient::~BrowserClient() {}
 
@@ -52,19 +90,36 @@ bool BrowserClient::OnBeforePopup(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFr
 void BrowserClient::OnAfterCreated(CefRefPtr<CefBrowser> browser) {
     CEF_REQUIRE_UI_THREAD();
 
-    browser_list_.push_back(browser);
-    browser_count_++;
+    const bool is_main = !browser_;
+    const uint32_t flags = (is_main ? kBrowserMain : 0) | (delegate_ ? kBrowserDelegated : 0);
+    browsers_.push_back(GetBrowserRegistry().Add(browser->GetIdentifier(), browser, flags));
 
-    if (!browser_) {
+    if (is_main) {
         browser_ = browser;
+
+        // The main browser opens blank and loads the start URL under virtual
+        // time when that is enabled, which reports readiness itself
+        if (!delegate_ && !StartVirtualTimeStartUrl(browser)) {
+            WatchConfiguredPageReady(browser);
+        }
+    }
+
+    AddDevToolsTarget(browser);
+    OnWatchdogBrowserCreated(browser);
+
+    if (delegate_) {
+        delegate_->OnBrowserCreated(browser);
     }
 }
 
 bool BrowserClient::DoClose(CefRefPtr<CefBrowser> browser) {
     CEF_REQUIRE_UI_THREAD();
 
+    GetBrowserRegistry().Update(browser->GetIdentifier(),
+                                [](BrowserRecord& record) { record.flags |= kBrowserClosing; });
+
     // Set closing flag
-    if (browser_list_.size() == 1) {
+    if (browsers_.size() == 1) {
         is_closing_ = true;
     }
 
@@ -75,20 +130,44 @@ bool BrowserClient::DoClose(CefRefPtr<CefBrowser> browser) {
 void BrowserClient::OnBeforeClose(CefRefPtr<CefBrowser> browser) {
     CEF_REQUIRE_UI_THREAD();
 
-    // Remove from list
-    for (auto it = browser_list_.begin(); it != browser_list_.end(); ++it) {
-        if ((*it)->IsSame(browser)) {
-            browser_list_.erase(it);
-            break;
+    const int browser_id = browser->GetIdentifier();
+    GetNavigationMetrics().OnBrowserClosed(browser_id);
+    StopVirtualTimeStartUrl(browser);
+    OnPageReadinessBrowserClosed(browser);
+    RemoveDevToolsTarget(browser);
+    OnRendererRecoveryBrowserClosed(browser);
+    OnWatchdogBrowserClosed(browser);
+    if (TraceCapture* trace = GetTraceCapture()) {
+        trace->OnBrowserClosed(browser);
+    }
+
+    // The handlers above read the record, so it goes last
+    CefBrowserRegistry& registry = GetBrowserRegistry();
+    const SlotHandle handle = registry.HandleOf(browser_id);
+    browsers_.erase(std::remove(browsers_.begin(), browsers_.end(), handle), browsers_.end());
+    registry.Remove(browser_id);
+
+    if (browser_ && browser_->IsSame(browser)) {
+        browser_ = browsers_.empty() ? nullptr : registry.GetBrowser(browsers_.front());
+        if (browser_) {
+            registry.Update(browsers_.front(),
+                            [](BrowserRecord& record) { record.flags |= kBrowserMain; });
         }
     }
 
-    browser_count_--;
+    if (delegate_) {
+        delegate_->OnBrowserClosed(browser);
+        return;
+    }
 
-    if (browser_list_.empty()) {
-        browser_ = nullptr;
-        // Quit the message loop when all browsers have closed
-        CefQuitMessageLoop();
+    if (browsers_.empty()) {
+        // Quit the message loop when all browsers have closed, after the
+        // pooled browsers have closed too
+        if (BrowserPool* pool = GetBrowserPool()) {
+            pool->Shutdown([] { QuitMainMessageLoop(); });
+        } else {
+            QuitMainMessageLoop();
+        }
     }
 }
 
@@ -99,6 +178,12 @@ void BrowserClient::OnBeforeClose(CefRefPtr<CefBrowser> browser) {
 void BrowserClient::OnTitleChange(CefRefPtr<CefBrowser> browser, const CefString& title) {
     CEF_REQUIRE_UI_THREAD();
 
+    if (EventPipeline* events = GetObservedEventPipeline()) {
+        BrowserEvent event(BrowserEventType::kTitleChange, browser->GetIdentifier());
+        event.SetText(title.ToString());
+        events->Publish(event);
+    }
+
     // Update window title
     std::string window_title = title.ToString();
     if (window_title.empty()) {
@@ -126,7 +211,20 @@ void BrowserClient::OnAddressChange(CefRefPtr<CefBrowser> browser, CefRefPtr<Cef
     if (frame->IsMain()) {
         // Address has changed - could update address bar UI here
         std::string current_url = url.ToString();
-        // UI update would go here
+        GetBrowserRegistry().Update(browser->GetIdentifier(),
+                                    [&current_url](BrowserRecord& record) {
+                                        record.url = current_url;
+                                    });
+        GetNavigationMetrics().OnCommit(browser->GetIdentifier(), current_url,
+                                        NavigationMetrics::Clock::now());
+        if (EventPipeline* events = GetObservedEventPipeline()) {
+            BrowserEvent event(BrowserEventType::kAddressChange, browser->GetIdentifier());
+            event.SetText(current_url);
+            events->Publish(event);
+        }
+        if (delegate_) {
+            delegate_->OnMainFrameCommit(browser, current_url);
+        }
     }
 }
 
@@ -139,26 +237,24 @@ void BrowserClient::OnFullscreenModeChange(CefRefPtr<CefBrowser> browser, bool f
 
 bool BrowserClient::OnConsoleMessage(CefRefPtr<CefBrowser> browser, cef_log_severity_t level,
                                      const CefString& message, const CefString& source, int line) {
-    // Log console messages for debugging
-    std::string level_str;
-    switch (level) {
-        case LOGSEVERITY_DEBUG:
-            level_str = "DEBUG";
-            break;
-        case LOGSEVERITY_INFO:
-            level_str = "INFO";
-            break;
-        case LOGSEVERITY_WARNING:
-            level_str = "WARN";
-            break;
-        case LOGSEVERITY_ERROR:
-            level_str = "ERROR";
-            break;
-        default:
-            level_str = "LOG";
+    // Both consumers take the UTF-16 text as is and convert it on their own
+    // threads
+    const std::u16string_view message16 = AsUtf16(message);
+    const std::u16string_view source16 = AsUtf16(source);
+
+    if (EventPipeline* events = GetObservedEventPipeline()) {
+        BrowserEvent event(BrowserEventType::kConsoleMessage, browser->GetIdentifier());
+        event.code = level;
+        event.value = line;
+        event.SetText(message16, source16);
+        events->Publish(event);
     }
 
-    // Could log to file or console here
+    // The sink keeps the message, rate limited, so Chromium need not log it too
+    if (LogSink* sink = GetLogSink()) {
+        sink->Append(browser->GetIdentifier(), level, message16, source16, line);
+        return true;
+    }
     return false;  // Allow default handling
 }
 
@@ -172,6 +268,11 @@ void BrowserClient::OnLoadingStateChange(CefRefPtr<CefBrowser> browser, bool isL
 
     // Update loading indicator and navigation buttons
     // UI update would go here
+
+    if (!isLoading) {
+        GetNavigationMetrics().OnLoadingIdle(browser->GetIdentifier(),
+                                             NavigationMetrics::Clock::now());
+    }
 }
 
 void BrowserClient::OnLoadStart(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
@@ -180,6 +281,22 @@ void BrowserClient::OnLoadStart(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFram
 
     if (frame->IsMain()) {
         // Page load started
+        GetBrowserRegistry().Update(browser->GetIdentifier(),
+                                    [](BrowserRecord& record) { record.flags |= kBrowserLoading; });
+        if (EventPipeline* events = GetObservedEventPipeline()) {
+            BrowserEvent event(BrowserEventType::kLoadStart, browser->GetIdentifier());
+            event.SetText(frame->GetURL().ToString());
+            events->Publish(event);
+        }
+        if (TraceCapture* trace = GetTraceCapture()) {
+            trace->OnLoadStart(browser, frame->GetURL().ToString());
+        }
+        OnPageReadinessLoadStart(browser);
+        OnRendererRecoveryLoadStart(browser);
+    }
+
+    if (delegate_) {
+        delegate_->OnFrameLoadStart(browser, frame->GetURL().ToString());
     }
 }
 
@@ -189,6 +306,23 @@ void BrowserClient::OnLoadEnd(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame>
 
     if (frame->IsMain()) {
         // Page load completed
+        GetBrowserRegistry().Update(browser->GetIdentifier(), [](BrowserRecord& record) {
+            record.flags &= ~kBrowserLoading;
+        });
+        if (EventPipeline* events = GetObservedEventPipeline()) {
+            BrowserEvent event(BrowserEventType::kLoadEnd, browser->GetIdentifier());
+            event.code = httpStatusCode;
+            events->Publish(event);
+        }
+        GetNavigationMetrics().OnLoadEnd(browser->GetIdentifier(),
+                                         NavigationMetrics::Clock::now());
+        if (TraceCapture* trace = GetTraceCapture()) {
+            trace->OnLoadEnd(browser);
+        }
+        OnRendererRecoveryLoadEnd(browser);
+        if (delegate_) {
+            delegate_->OnMainFrameLoadEnd(browser, frame->GetURL().ToString(), httpStatusCode);
+        }
     }
 }
 
@@ -197,33 +331,45 @@ void BrowserClient::OnLoadError(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFram
                                 const CefString& failedUrl) {
     CEF_REQUIRE_UI_THREAD();
 
+    if (frame->IsMain()) {
+        GetBrowserRegistry().Update(browser->GetIdentifier(), [](BrowserRecord& record) {
+            record.flags &= ~kBrowserLoading;
+        });
+        if (EventPipeline* events = GetObservedEventPipeline()) {
+            BrowserEvent event(BrowserEventType::kLoadError, browser->GetIdentifier());
+            event.code = errorCode;
+            event.SetText(failedUrl.ToString());
+            events->Publish(event);
+        }
+        GetNavigationMetrics().OnLoadError(browser->GetIdentifier(), errorCode,
+                                           NavigationMetrics::Clock::now());
+        // A failed load ends its trace like a completed one
+        if (TraceCapture* trace = GetTraceCapture()) {
+            trace->OnLoadEnd(browser);
+        }
+    }
+
+    // Delegated browsers report errors instead of showing an error page
+    if (delegate_) {
+        if (frame->IsMain()) {
+            delegate_->OnMainFrameLoadError(browser, failedUrl.ToString(), errorCode);
+        }
+        return;
+    }
+
     // Don't display an error for cancelled requests
     if (errorCode == ERR_ABORTED) {
         return;
     }
 
+    // Don't replace a failed internal page with another internal page
+    std::string failed_url = failedUrl.ToString();
+    if (failed_url.rfind(GetInternalURL(""), 0) == 0) {
+        return;
+    }
+
     // Display error page
-    std::stringstream ss;
-    ss << "<html><head><title>Load Error</title>"
-       << "<style>"
-       << "body { font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', Roboto, sans-serif; "
-       << "       padding: 50px; text-align: center; background: #f5f5f5; }"
-       << "h1 { color: #333; }"
-       << ".error-code { color: #666; font-size: 14px; }"
-       << ".url { color: #0066cc; word-break: break-all; }"
-       << ".retry-btn { margin-top: 20px; padding: 10px 20px; "
-       << "             background: #0066cc; color: white; border: none; "
-       << "             border-radius: 5px; cursor: pointer; font-size: 16px; }"
-       << ".retry-btn:hover { background: #0055aa; }"
-       << "</style></head><body>"
-       << "<h1>This page isn't working</h1>"
-       << "<p class='error-code'>Error: " << errorText.ToString() << " ("
-       << errorCode << ")</p>"
-       << "<p class='url'>" << failedUrl.ToString() << "</p>"
-       << "<button class='retry-btn' onclick='location.reload()'>Retry</button>"
-       << "</body></html>";
-
-    frame->LoadURL(GetDataURI(ss.str(), "text/html"));
+    frame->LoadURL(GetErrorPageURL(errorCode, errorText.ToString(), failed_url));
 }
 
 // ============================================================================
@@ -235,10 +381,83 @@ bool BrowserClient::OnBeforeBrowse(CefRefPtr<CefBrowser> browser, CefRefPtr<CefF
                                    bool is_redirect) {
     CEF_REQUIRE_UI_THREAD();
 
+    // Keep away from pages that keep crashing their renderer
+    if (frame->IsMain() && IsRendererRecoveryQuarantined(request->GetURL().ToString())) {
+        LOG(WARNING) << "Refusing quarantined URL " << request->GetURL().ToString();
+        return true;
+    }
+
+    // Redirects are timed as part of the navigation that started them
+    if (frame->IsMain() && !is_redirect) {
+        GetNavigationMetrics().OnNavigationStart(browser->GetIdentifier(),
+                                                 request->GetURL().ToString(),
+                                                 NavigationMetrics::Clock::now());
+    }
+
     // Allow all navigation by default
     return false;
 }
 
+void BrowserClient::OnRenderProcessTerminated(CefRefPtr<CefBrowser> browser,
+                                              TerminationStatus status) {
+    CEF_REQUIRE_UI_THREAD();
+
+    const int browser_id = browser->GetIdentifier();
+    CefBrowserRegistry& registry = GetBrowserRegistry();
+    registry.Update(browser_id, [](BrowserRecord& record) {
+        record.flags &= ~kBrowserLoading;
+        record.renderer_pid = 0;
+    });
+    OnWatchdogRendererTerminated(browser);
+
+    // A closing browser needs no renderer
+    const BrowserRecord* record = registry.Find(browser_id);
+    if (!record || (record->flags & kBrowserClosing)) {
+        return;
+    }
+
+    RecoveryDecision decision;
+    std::string url;
+    if (!RecoverRenderer(browser, status, &decision, &url)) {
+        LOG(ERROR) << "Renderer process terminated with status " << status;
+        return;
+    }
+    if (decision.reload || url.empty()) {
+        return;
+    }
+
+    // Quarantined: report it like a failed load instead
+    if (delegate_) {
+        delegate_->OnMainFrameLoadError(browser, url, ERR_FAILED);
+        return;
+    }
+    browser->GetMainFrame()->LoadURL(
+        GetErrorPageURL(ERR_FAILED, "The page repeatedly crashed its renderer", url));
+}
+
+CefRefPtr<CefResourceRequestHandler> BrowserClient::GetResourceRequestHandler(
+    CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request,
+    bool is_navigation, bool is_download, const CefString& request_initiator,
+    bool& disable_default_handling) {
+    // Recording and replay see every request and also apply the blocker
+    CefRefPtr<CefResourceRequestHandler> handler = GetHttpArchiveHandler(request);
+
+    // Downloads are never blocked or suppressed, and outlive the page so
+    // they don't hold up its readiness
+    if (is_download) {
+        return handler;
+    }
+
+    // Main frame navigations are never blocked. Called on the IO thread;
+    // nullptr when no filter lists are loaded.
+    if (!handler && !(is_navigation && frame && frame->IsMain())) {
+        handler = GetContentBlockingHandler();
+    }
+
+    handler = ApplyResourcePolicy(browser, request, handler);
+    return TrackPageReadiness(browser, request, handler);
+}
+
 // ============================================================================
 // CefContextMenuHandler methods
 // ============================================================================
@@ -395,6 +614,19 @@ void BrowserClient::OnDownloadUpdated(CefRefPtr<CefBrowser> browser,
                                       CefRefPtr<CefDownloadItemCallback> callback) {
     CEF_REQUIRE_UI_THREAD();
 
+    if (EventPipeline* events = GetObservedEventPipeline()) {
+        BrowserEvent event(BrowserEventType::kDownloadProgress, browser->GetIdentifier());
+        event.id = download_item->GetId();
+        event.code = download_item->GetPercentComplete();
+        event.value = download_item->GetReceivedBytes();
+        event.total = download_item->GetTotalBytes();
+        event.state = download_item->IsComplete()   ? DownloadState::kComplete
+                      : download_item->IsCanceled() ? DownloadState::kCancelled
+                                                    : DownloadState::kInProgress;
+        event.SetText(download_item->GetFullPath().ToString());
+        events->Publish(event);
+    }
+
     if (download_item->IsComplete()) {
         // Download complete
     } else if (download_item->IsCanceled()) {
@@ -406,15 +638,84 @@ void BrowserClient::OnDownloadUpdated(CefRefPtr<CefBrowser> browser,
 }
 
 // ============================================================================
-// Utility methods
+// CefRenderHandler methods
 // ============================================================================
 
-void BrowserClient::CloseAllBrowsers(bool force_close) {
-    if (browser_list_.empty()) {
+CefRefPtr<CefRenderHandler> BrowserClient::GetRenderHandler() {
+    // Only windowless browsers paint through the render handler
+    if (GetBrowserConfig().off_screen) {
+        return this;
+    }
+    return nullptr;
+}
+
+void BrowserClient::GetViewRect(CefRefPtr<CefBrowser> browser, CefRect& rect) {
+    const BrowserConfig& config = GetBrowserConfig();
+    rect = CefRect(0, 0, config.viewport_width, config.viewport_height);
+}
+
+void BrowserClient::OnPaint(CefRefPtr<CefBrowser> browser, PaintElementType type,
+                            const RectList& dirtyRects, const void* buffer, int width,
+                            int height) {
+    CEF_REQUIRE_UI_THREAD();
+
+    // Popup widgets (e.g. <select> menus) are not composited
+    if (type != PET_VIEW) {
         return;
     }
 
-    for (auto& browser : browser_list_) {
-        browser->GetHost()->CloseBrowser(force_close);
+    FrameBuffer* frame_buffer =
+        GetBrowserRegistry().GetOrCreateFrameBuffer(browser->GetIdentifier());
+    if (!frame_buffer) {
+        return;
+    }
+    frame_buffer->Paint(buffer, width, height, dirtyRects);
+
+    if (delegate_) {
+        delegate_->OnViewPainted(browser);
+    }
+}
+
+const FrameBuffer* BrowserClient::GetFrameBuffer(int browser_id) const {
+    return GetBrowserRegistry().GetFrameBuffer(browser_id);
+}
+
+// ============================================================================
+// CefClient methods
+// ============================================================================
+
+bool BrowserClient::OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
+                                             CefRefPtr<CefFrame> frame,
+                                             CefProcessId source_process,
+                                             CefRefPtr<CefProcessMessage> message) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (message->GetName() == kRendererInfoMessage) {
+        const int pid = message->GetArgumentList()->GetInt(0);
+        GetBrowserRegistry().Update(browser->GetIdentifier(),
+                                    [pid](BrowserRecord& record) { record.renderer_pid = pid; });
+        OnWatchdogRendererReady(browser);
+        return true;
+    }
+
+    if (message->GetName() == kDomContentLoadedMessage) {
+        OnPageReadinessDomContentLoaded(browser);
+        return true;
+    }
+
+    return OnRendererRecoveryMessage(browser, message);
+}
+
+// ============================================================================
+// Utility methods
+// ============================================================================
+
+void BrowserClient::CloseAllBrowsers(bool force_close) {
+    // Copied since closing may remove browsers from the registry
+    const std::vector<SlotHandle> handles = browsers_;
+    for (SlotHandle handle : handles) {
+        if (CefRefPtr<CefBrowser> browser = GetBrowserRegistry().GetBrowser(handle)) {
+            browser->GetHost()->CloseBrowser(force_close);
+        }
     }
 }
@@ -2,8 +2,8 @@
 #ifndef CEF_BROWSER_CLIENT_H_
 #define CEF_BROWSER_CLIENT_H_
 
-#include <list>
 #include <string>
+#include <vector>
 
 #include "include/cef_client.h"
 #include "include/cef_context_menu_handler.h"
@@ -12,8 +12,18 @@
 #include "include/cef_keyboard_handler.h"
 #include "include/cef_life_span_handler.h"
 #include "include/cef_load_handler.h"
+#include "include/cef_render_handler.h"
 #include "include/cef_request_handler.h"
 
+#include "browser_registry.h"
+#include "frame_buffer.h"
+
+using CefBrowserRegistry = BrowserRegistry<CefRefPtr<CefBrowser>>;
+
+// Browsers of every client and their state. BrowserClient registers a
+// browser in OnAfterCreated() and removes it in OnBeforeClose().
+CefBrowserRegistry& GetBrowserRegistry();
+
 // Browser client that handles browser events and callbacks
 class BrowserClient : public CefClient,
                       public CefLifeSpanHandler,
@@ -22,9 +32,40 @@ class BrowserClient : public CefClient,
                       public CefRequestHandler,
                       public CefContextMenuHandler,
                       public CefKeyboardHandler,
-                      public CefDownloadHandler {
+                      public CefDownloadHandler,
+                      public CefRenderHandler {
 public:
-    explicit BrowserClient();
+    // Receives the lifecycle and main frame load events of the browsers
+    // created with this client. All methods are called on the UI thread.
+    class Delegate {
+    public:
+        virtual ~Delegate() = default;
+
+        virtual void OnBrowserCreated(CefRefPtr<CefBrowser> browser) = 0;
+        virtual void OnBrowserClosed(CefRefPtr<CefBrowser> browser) = 0;
+
+        // The main frame finished loading |url| with |http_status|
+        virtual void OnMainFrameLoadEnd(CefRefPtr<CefBrowser> browser, const std::string& url,
+                                        int http_status) = 0;
+
+        // The main frame failed to load |url|
+        virtual void OnMainFrameLoadError(CefRefPtr<CefBrowser> browser, const std::string& url,
+                                          cef_errorcode_t error_code) = 0;
+
+        // The main frame committed a navigation to |url|
+        virtual void OnMainFrameCommit(CefRefPtr<CefBrowser> browser, const std::string& url) {}
+
+        // A frame, the main frame included, started loading |url|
+        virtual void OnFrameLoadStart(CefRefPtr<CefBrowser> browser, const std::string& url) {}
+
+        // An off-screen view painted a frame
+        virtual void OnViewPainted(CefRefPtr<CefBrowser> browser) {}
+    };
+
+    // Browsers of a client with a |delegate| report to it instead of showing
+    // error pages, and closing the last of them does not quit the message
+    // loop. |delegate| must outlive the client's browsers.
+    explicit BrowserClient(Delegate* delegate = nullptr);
     ~BrowserClient() override;
 
     // CefClient methods
@@ -35,6 +76,10 @@ public:
     CefRefPtr<CefContextMenuHandler> GetContextMenuHandler() override { return this; }
     CefRefPtr<CefKeyboardHandler> GetKeyboardHandler() override { return this; }
     CefRefPtr<CefDownloadHandler> GetDownloadHandler() override { return this; }
+    CefRefPtr<CefRenderHandler> GetRenderHandler() override;
+    bool OnProcessMessageReceived(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                  CefProcessId source_process,
+                                  CefRefPtr<CefProcessMessage> message) override;
 
     // CefLifeSpanHandler methods
     bool OnBeforePopup(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
@@ -70,6 +115,12 @@ public:
     bool OnBeforeBrowse(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
                         CefRefPtr<CefRequest> request, bool user_gesture,
                         bool is_redirect) override;
+    void OnRenderProcessTerminated(CefRefPtr<CefBrowser> browser,
+                                   TerminationStatus status) override;
+    CefRefPtr<CefResourceRequestHandler> GetResourceRequestHandler(
+        CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request,
+        bool is_navigation, bool is_download, const CefString& request_initiator,
+        bool& disable_default_handling) override;
 
     // CefContextMenuHandler methods
     void OnBeforeContextMenu(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
@@ -94,6 +145,11 @@ public:
     void OnDownloadUpdated(CefRefPtr<CefBrowser> browser, CefRefPtr<CefDownloadItem> download_item,
                            CefRefPtr<CefDownloadItemCallback> callback) override;
 
+    // CefRenderHandler methods (off-screen rendering only)
+    void GetViewRect(CefRefPtr<CefBrowser> browser, CefRect& rect) override;
+    void OnPaint(CefRefPtr<CefBrowser> browser, PaintElementType type, const RectList& dirtyRects,
+                 const void* buffer, int width, int height) override;
+
     // Browser access
     CefRefPtr<CefBrowser> GetBrowser() const { return browser_; }
 
@@ -103,14 +159,19 @@ public:
     // Close all browsers
     void CloseAllBrowsers(bool force_close);
 
-    // Get browser count
-    static int GetBrowserCount() { return browser_count_; }
+    // Browsers of every client. Any thread.
+    static int GetBrowserCount() { return static_cast<int>(GetBrowserRegistry().size()); }
+
+    // Last painted frame of an off-screen browser, or nullptr. UI thread only.
+    const FrameBuffer* GetFrameBuffer(int browser_id) const;
 
 private:
     CefRefPtr<CefBrowser> browser_;
-    std::list<CefRefPtr<CefBrowser>> browser_list_;
+
+    // This client's browsers in the registry, oldest first
+    std::vector<SlotHandle> browsers_;
     bool is_closing_;
-    static int browser_count_;
+    Delegate* delegate_;
 
     IMPLEMENT_REFCOUNTING(BrowserClient);
     DISALLOW_COPY_AND_ASSIGN(BrowserClient);
@@ -0,0 +1,168 @@
+// CEF Browser - Runtime Configuration Implementation
+#include "browser_config.h"
+#include "process_memory.h"
+#include "resource_util.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+namespace {
+
+BrowserConfig g_config;
+
+std::string GetSwitch(CefRefPtr<CefCommandLine> command_line, const char* name) {
+    return command_line->GetSwitchValue(name).ToString();
+}
+
+int GetIntSwitch(CefRefPtr<CefCommandLine> command_line, const char* name, int default_value,
+                 int min_value, int max_value) {
+    std::string value = GetSwitch(command_line, name);
+    if (value.empty()) {
+        return default_value;
+    }
+    return std::clamp(std::atoi(value.c_str()), min_value, max_value);
+}
+
+double GetDoubleSwitch(CefRefPtr<CefCommandLine> command_line, const char* name,
+                       double default_value, double min_value, double max_value) {
+    std::string value = GetSwitch(command_line, name);
+    if (value.empty()) {
+        return default_value;
+    }
+    return std::clamp(std::atof(value.c_str()), min_value, max_value);
+}
+
+}  // namespace
+
+void InitBrowserConfig(CefRefPtr<CefCommandLine> command_line) {
+    BrowserConfig config;
+
+    std::string url = GetSwitch(command_line, "url");
+    if (!url.empty()) {
+        config.start_url = url;
+    }
+
+    config.user_data_dir = GetSwitch(command_line, "user-data-dir");
+    if (config.user_data_dir.empty()) {
+        config.user_data_dir =
+            GetUserDataDir() + "/instance-" + std::to_string(GetCurrentProcessIdentifier());
+    }
+
+    config.metrics_interval =
+        GetIntSwitch(command_line, "metrics-interval", config.metrics_interval, 0, 86400);
+
+    config.event_log_path = GetSwitch(command_line, "event-log");
+    config.event_workers =
+        GetIntSwitch(command_line, "event-workers", config.event_workers, 1, 64);
+
+    config.console_log_path = GetSwitch(command_line, "console-log");
+    config.console_log_max_mb =
+        GetIntSwitch(command_line, "console-log-max-mb", config.console_log_max_mb, 1, 1024);
+    config.console_log_files =
+        GetIntSwitch(command_line, "console-log-files", config.console_log_files, 0, 100);
+    config.console_log_rate =
+        GetIntSwitch(command_line, "console-log-rate", config.console_log_rate, 1, 100000);
+
+    config.crash_reload_limit =
+        GetIntSwitch(command_line, "crash-reload-limit", config.crash_reload_limit, 0, 100);
+    config.renderer_hang_timeout = GetIntSwitch(command_line, "renderer-hang-timeout",
+                                                config.renderer_hang_timeout, 0, 3600);
+
+    config.watchdog_interval_ms = GetIntSwitch(command_line, "watchdog-interval",
+                                               config.watchdog_interval_ms, 0, 60000);
+    config.watchdog_stall_ms =
+        GetIntSwitch(command_line, "watchdog-stall-ms", config.watchdog_stall_ms, 10, 600000);
+    config.watchdog_trace = command_line->HasSwitch("watchdog-trace");
+
+    config.trace_pattern = GetSwitch(command_line, "trace-navigations");
+    std::string trace_categories = GetSwitch(command_line, "trace-categories");
+    if (!trace_categories.empty()) {
+        config.trace_categories = trace_categories;
+    }
+    config.trace_sample_rate =
+        GetDoubleSwitch(command_line, "trace-sample-rate", config.trace_sample_rate, 0.0, 1.0);
+    config.trace_settle_ms =
+        GetIntSwitch(command_line, "trace-settle-ms", config.trace_settle_ms, 0, 60000);
+    config.trace_max_mb = GetIntSwitch(command_line, "trace-max-mb", config.trace_max_mb, 1, 65536);
+
+    std::string block_lists = GetSwitch(command_line, "block-lists");
+    size_t begin = 0;
+    while (begin < block_lists.size()) {
+        size_t end = block_lists.find(',', begin);
+        if (end == std::string::npos) {
+            end = block_lists.size();
+        }
+        if (end > begin) {
+            config.block_lists.push_back(block_lists.substr(begin, end - begin));
+        }
+        begin = end + 1;
+    }
+
+    config.suppress_resources = GetSwitch(command_line, "suppress-resources");
+
+    config.replay_path = GetSwitch(command_line, "replay");
+    if (config.replay_path.empty()) {
+        config.record_path = GetSwitch(command_line, "record");
+    }
+
+    config.external_message_pump = command_line->HasSwitch("external-message-pump");
+
+    config.performance_profile = GetSwitch(command_line, "performance-profile");
+    config.performance_profile_config = GetSwitch(command_line, "performance-profile-config");
+
+    std::string rendering = GetSwitch(command_line, "rendering");
+    if (!rendering.empty()) {
+        config.rendering = rendering;
+    }
+
+    std::string devtools_transport = GetSwitch(command_line, "devtools-transport");
+    if (!devtools_transport.empty()) {
+        config.devtools_transport = devtools_transport;
+    }
+    config.devtools_port =
+        GetIntSwitch(command_line, "remote-debugging-port", config.devtools_port, 0, 65535);
+    config.devtools_lazy = command_line->HasSwitch("devtools-lazy");
+    config.devtools_discovery_file = GetSwitch(command_line, "devtools-discovery-file");
+
+#if defined(CEF_BROWSER_HEADLESS_ONLY)
+    // There is no windowing system to show a window on
+    config.off_screen = true;
+#else
+    config.off_screen = command_line->HasSwitch("headless") || command_line->HasSwitch("osr");
+#endif
+
+    std::string viewport = GetSwitch(command_line, "viewport");
+    size_t separator = viewport.find('x');
+    if (separator != std::string::npos) {
+        int width = std::atoi(viewport.substr(0, separator).c_str());
+        int height = std::atoi(viewport.substr(separator + 1).c_str());
+        if (width > 0 && height > 0) {
+            config.viewport_width = width;
+            config.viewport_height = height;
+        }
+    }
+
+    config.frame_rate = GetIntSwitch(command_line, "frame-rate", config.frame_rate, 1, 60);
+
+    config.pool_min_size = GetIntSwitch(command_line, "pool-size", config.pool_min_size, 0, 64);
+    config.pool_max_size = GetIntSwitch(command_line, "pool-max-size",
+                                        std::max(config.pool_max_size, config.pool_min_size),
+                                        std::max(config.pool_min_size, 1), 64);
+    config.pool_max_uses =
+        GetIntSwitch(command_line, "pool-max-uses", config.pool_max_uses, 1, 1000000);
+    config.pool_idle_timeout =
+        GetIntSwitch(command_line, "pool-idle-timeout", config.pool_idle_timeout, 1, 86400);
+
+    config.virtual_time_budget_ms = GetIntSwitch(command_line, "virtual-time-budget",
+                                                 config.virtual_time_budget_ms, 0, 3600000);
+    config.deterministic_seed = GetIntSwitch(command_line, "deterministic-seed",
+                                             config.deterministic_seed, 0, INT_MAX);
+    config.ready_when = GetSwitch(command_line, "ready-when");
+
+    g_config = config;
+}
+
+const BrowserConfig& GetBrowserConfig() {
+    return g_config;
+}
@@ -0,0 +1,182 @@
+// CEF Browser - Runtime Configuration
+#ifndef CEF_BROWSER_CONFIG_H_
+#define CEF_BROWSER_CONFIG_H_
+
+#include <string>
+#include <vector>
+
+#include "include/cef_command_line.h"
+
+#include "browser_window.h"
+
+// Browser process configuration, parsed once from the command line
+struct BrowserConfig {
+    // Initial URL (--url)
+    std::string start_url = BrowserWindow::kDefaultUrl;
+
+    // Directory of the cache and of every file the browser writes: metrics,
+    // traces, logs and the DevTools discovery file. Unless given, each
+    // instance gets its own, instance-<pid> in the platform's application
+    // data directory, so concurrent instances share none of them
+    // (--user-data-dir).
+    std::string user_data_dir;
+
+    // Seconds between metrics dumps; 0 disables them (--metrics-interval)
+    int metrics_interval = 60;
+
+    // Append browser events to this file as JSON lines; empty disables the
+    // log (--event-log)
+    std::string event_log_path;
+
+    // Threads that deliver browser events off the UI thread (--event-workers)
+    int event_workers = 2;
+
+    // Write page console messages to size-rotated files from a background
+    // thread; empty for console.log.gz in the user data dir, "off" to leave
+    // them to Chromium's log (--console-log)
+    std::string console_log_path;
+
+    // Size at which the console log is rotated (--console-log-max-mb)
+    int console_log_max_mb = 10;
+
+    // Rotated console logs kept (--console-log-files)
+    int console_log_files = 5;
+
+    // Console messages per second logged from one source location; bursts of
+    // up to twice as many pass (--console-log-rate)
+    int console_log_rate = 20;
+
+    // Exits of a URL's renderer within ten minutes after which it is no
+    // longer reloaded but quarantined for an hour; 0 disables crash recovery
+    // (--crash-reload-limit)
+    int crash_reload_limit = 3;
+
+    // Seconds a renderer may leave pings unanswered before it is killed and
+    // reloaded; 0 disables killing hung renderers (--renderer-hang-timeout)
+    int renderer_hang_timeout = 30;
+
+    // Milliseconds between watchdog heartbeats to the UI and IO threads, and
+    // at most between renderer pings, which run even without crash recovery;
+    // 0 disables the watchdog (--watchdog-interval)
+    int watchdog_interval_ms = 1000;
+
+    // Milliseconds a heartbeat may be pending before the stalled thread's
+    // stack, or a trace of the stalled renderer, is captured
+    // (--watchdog-stall-ms)
+    int watchdog_stall_ms = 2000;
+
+    // Trace renderers the watchdog finds stalled, which turns on trace
+    // capture even without --trace-navigations (--watchdog-trace)
+    bool watchdog_trace = false;
+
+    // Trace main frame loads whose URL matches this pattern; empty disables
+    // tracing (--trace-navigations)
+    std::string trace_pattern;
+
+    // Comma-separated trace categories (--trace-categories)
+    std::string trace_categories =
+        "blink,cc,gpu,loading,navigation,netlog,toplevel,v8,devtools.timeline,"
+        "disabled-by-default-devtools.timeline";
+
+    // Fraction of matching navigations to trace, 0-1 (--trace-sample-rate)
+    double trace_sample_rate = 1.0;
+
+    // Milliseconds to keep tracing after load end (--trace-settle-ms)
+    int trace_settle_ms = 2000;
+
+    // Total trace file size kept in the user data dir (--trace-max-mb)
+    int trace_max_mb = 256;
+
+    // Filter lists of the subresource content blocker; empty disables
+    // blocking (--block-lists, comma-separated)
+    std::vector<std::string> block_lists;
+
+    // Resource types and MIME types every browser suppresses unless given its
+    // own policy, e.g. image=placeholder,font,media (--suppress-resources)
+    std::string suppress_resources;
+
+    // Record all HTTP(S) traffic into this archive (--record)
+    std::string record_path;
+
+    // Serve all HTTP(S) requests from this archive (--replay); takes
+    // precedence over --record
+    std::string replay_path;
+
+    // Drive CEF from the epoll event loop through OnScheduleMessagePumpWork
+    // instead of CefRunMessageLoop(); Linux only (--external-message-pump)
+    bool external_message_pump = false;
+
+    // Chromium switch profile: auto, throughput, low-latency or low-memory
+    // (--performance-profile); overrides the profile config file
+    std::string performance_profile;
+
+    // Profile selection and switch overrides, see PerformanceProfileConfig
+    // (--performance-profile-config)
+    std::string performance_profile_config;
+
+    // Rendering switches: auto probes for a GPU and picks gpu or software;
+    // gpu, software or swiftshader force one (--rendering)
+    std::string rendering = "auto";
+
+    // DevTools transport: tcp, pipe (inherited descriptors 3 and 4) or off
+    // (--devtools-transport)
+    std::string devtools_transport = "tcp";
+
+    // DevTools port of the tcp transport; 0 picks a free port, as does a port
+    // taken by another instance (--remote-debugging-port)
+    int devtools_port = 9222;
+
+    // Serve DevTools from the in-process bridge, which attaches to a browser
+    // only when a client connects, instead of Chromium's server; Linux only
+    // (--devtools-lazy)
+    bool devtools_lazy = false;
+
+    // Where the chosen DevTools endpoint is written; empty for
+    // DevToolsEndpoint.json in the user data dir (--devtools-discovery-file)
+    std::string devtools_discovery_file;
+
+    // Off-screen rendering without a window or display (--headless or --osr);
+    // always set in HEADLESS_ONLY builds
+    bool off_screen = false;
+
+    // Off-screen viewport size in DIPs (--viewport=WIDTHxHEIGHT)
+    int viewport_width = BrowserWindow::kDefaultWidth;
+    int viewport_height = BrowserWindow::kDefaultHeight;
+
+    // Off-screen frame rate, 1-60 (--frame-rate)
+    int frame_rate = 30;
+
+    // Pre-warmed off-screen browsers; the pool is disabled when 0 (--pool-size)
+    int pool_min_size = 0;
+
+    // Upper bound on pooled browsers (--pool-max-size)
+    int pool_max_size = 8;
+
+    // Navigations before a pooled browser is replaced (--pool-max-uses)
+    int pool_max_uses = 100;
+
+    // Seconds an idle browser above the minimum is kept (--pool-idle-timeout)
+    int pool_idle_timeout = 60;
+
+    // Load the start URL under virtual time and report it ready after this
+    // many virtual milliseconds with the network idle; 0 runs the page in
+    // real time (--virtual-time-budget)
+    int virtual_time_budget_ms = 0;
+
+    // Seed Math.random and start Date at a fixed time in virtual time loads;
+    // -1 leaves them real (--deterministic-seed)
+    int deterministic_seed = -1;
+
+    // Print "ready <url>" for each page of the main browser that meets this
+    // PageReadyCondition, e.g. network-idle-0-for-500-ms (--ready-when)
+    std::string ready_when;
+};
+
+// Parse the browser configuration from |command_line|. Called once in the
+// browser process before CefInitialize().
+void InitBrowserConfig(CefRefPtr<CefCommandLine> command_line);
+
+// Get the browser configuration
+const BrowserConfig& GetBrowserConfig();
+
+#endif  // CEF_BROWSER_CONFIG_H_
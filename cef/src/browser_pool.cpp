@@ -0,0 +1,558 @@
+// CEF Browser - Pre-warmed Browser Pool Implementation
+#include "browser_pool.h"
+#include "browser_config.h"
+#include "devtools_client.h"
+#include "internal_pages.h"
+#include "page_readiness_handler.h"
+#include "resource_policy_handler.h"
+#include "scheme_handler.h"
+#include "virtual_time_capture.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "include/base/cef_callback.h"
+#include "include/base/cef_logging.h"
+#include "include/cef_cookie.h"
+#include "include/cef_parser.h"
+#include "include/cef_request_context.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace {
+
+std::unique_ptr<BrowserPool> g_browser_pool;
+
+const std::string& GetBlankURL() {
+    static const std::string url = GetInternalURL("blank.html");
+    return url;
+}
+
+}  // namespace
+
+BrowserPool::BrowserPool(const BrowserPoolOptions& options, ContextCallback configure_context)
+    : state_(options),
+      configure_context_(std::move(configure_context)),
+      client_(new BrowserClient(this)) {}
+
+BrowserPool::~BrowserPool() {}
+
+void BrowserPool::Start() {
+    CEF_REQUIRE_UI_THREAD();
+
+    EnsureCapacity();
+    ScheduleTrim();
+}
+
+void BrowserPool::Checkout(CheckoutCallback callback) {
+    CEF_REQUIRE_UI_THREAD();
+
+    const BrowserPoolCheckout checkout = state_.Checkout();
+    if (checkout.browser_id) {
+        Hand(browsers_[checkout.browser_id], callback);
+        return;
+    }
+    if (state_.shutting_down()) {
+        callback(nullptr);
+        return;
+    }
+
+    waiting_.push_back(std::move(callback));
+    EnsureCapacity();
+}
+
+void BrowserPool::Load(CefRefPtr<CefBrowser> browser, const std::string& url,
+                       LoadCallback callback) {
+    CEF_REQUIRE_UI_THREAD();
+
+    Entry* entry = Find(browser);
+    if (!entry || !IsCheckedOut(*entry)) {
+        BrowserPoolLoadResult result;
+        result.url = url;
+        result.error_code = ERR_INVALID_HANDLE;
+        callback(browser, result);
+        return;
+    }
+
+    CancelDeferredLoad(*entry);
+    entry->load_callback = std::move(callback);
+    browser->GetMainFrame()->LoadURL(url);
+}
+
+void BrowserPool::LoadWithVirtualTime(CefRefPtr<CefBrowser> browser, const std::string& url,
+                                      const VirtualTimeOptions& options, LoadCallback callback) {
+    CEF_REQUIRE_UI_THREAD();
+
+    Entry* entry = Find(browser);
+    if (!entry || !IsCheckedOut(*entry)) {
+        BrowserPoolLoadResult result;
+        result.url = url;
+        result.error_code = ERR_INVALID_HANDLE;
+        callback(browser, result);
+        return;
+    }
+
+    CancelDeferredLoad(*entry);
+    entry->load_callback = std::move(callback);
+    entry->load_status = 0;
+    entry->capture = std::make_unique<VirtualTimeCapture>(browser, options);
+    const int browser_id = browser->GetIdentifier();
+    entry->capture->Load(url, [this, browser_id, url](const VirtualTimeCaptureResult& result) {
+        OnCaptureReady(browser_id, url, result);
+    });
+}
+
+void BrowserPool::LoadUntilReady(CefRefPtr<CefBrowser> browser, const std::string& url,
+                                 const PageReadyCondition& condition, LoadCallback callback) {
+    CEF_REQUIRE_UI_THREAD();
+
+    Entry* entry = Find(browser);
+    if (!entry || !IsCheckedOut(*entry)) {
+        BrowserPoolLoadResult result;
+        result.url = url;
+        result.error_code = ERR_INVALID_HANDLE;
+        callback(browser, result);
+        return;
+    }
+
+    CancelDeferredLoad(*entry);
+    entry->load_callback = std::move(callback);
+    entry->load_status = 0;
+
+    // Watches only see pages that commit after they are added, so the
+    // current page cannot complete the load
+    const int browser_id = browser->GetIdentifier();
+    entry->ready_watch =
+        WatchPageReady(browser, condition,
+                       [this, browser_id](CefRefPtr<CefBrowser>, const PageReadyEvent& event) {
+                           OnPageReady(browser_id, event);
+                       });
+    browser->GetMainFrame()->LoadURL(url);
+}
+
+void BrowserPool::SetResourcePolicy(CefRefPtr<CefBrowser> browser,
+                                    const ResourcePolicy& policy) {
+    CEF_REQUIRE_UI_THREAD();
+
+    Entry* entry = Find(browser);
+    if (entry && IsCheckedOut(*entry)) {
+        ::SetResourcePolicy(browser->GetIdentifier(), policy);
+    }
+}
+
+uint64_t BrowserPool::GetJobId(CefRefPtr<CefBrowser> browser) const {
+    const PooledBrowser* pooled = state_.Find(browser->GetIdentifier());
+    return pooled ? pooled->job_id : 0;
+}
+
+void BrowserPool::Return(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    Entry* entry = Find(browser);
+    if (!entry) {
+        return;
+    }
+
+    switch (state_.Return(browser->GetIdentifier())) {
+        case BrowserPoolReturn::kIgnore:
+            return;
+        case BrowserPoolReturn::kReset:
+            // A load still in flight is abandoned without running its callback
+            entry->load_callback = nullptr;
+            Reset(*entry);
+            return;
+        case BrowserPoolReturn::kRetire:
+            entry->load_callback = nullptr;
+            Close(*entry);
+            EnsureCapacity();
+            return;
+    }
+}
+
+void BrowserPool::Shutdown(std::function<void()> done) {
+    CEF_REQUIRE_UI_THREAD();
+
+    shutdown_done_ = std::move(done);
+    const std::vector<int> retired = state_.Shutdown();
+
+    // Nobody will be handed a browser any more
+    std::deque<CheckoutCallback> waiting;
+    waiting.swap(waiting_);
+    for (auto& callback : waiting) {
+        callback(nullptr);
+    }
+
+    for (int browser_id : retired) {
+        auto it = browsers_.find(browser_id);
+        if (it != browsers_.end()) {
+            Close(it->second);
+        }
+    }
+
+    MaybeFinishShutdown();
+}
+
+// ============================================================================
+// BrowserClient::Delegate methods
+// ============================================================================
+
+void BrowserPool::OnBrowserCreated(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    Entry& entry = browsers_[browser->GetIdentifier()];
+    entry.browser = browser;
+
+    // The blank page was the initial URL; it becomes available once loaded
+    if (!state_.OnCreated(browser->GetIdentifier())) {
+        Close(entry);
+    }
+}
+
+void BrowserPool::OnBrowserClosed(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    const int id = browser->GetIdentifier();
+    auto it = browsers_.find(id);
+    if (it == browsers_.end()) {
+        return;
+    }
+
+    // A browser closed from elsewhere (e.g. a crash) may still be checked out
+    BrowserPoolLoadResult result;
+    result.url = browser->GetMainFrame() ? browser->GetMainFrame()->GetURL().ToString() : "";
+    result.error_code = ERR_ABORTED;
+    CompleteLoad(it->second, result);
+
+    browsers_.erase(it);
+    state_.OnClosed(id);
+
+    if (state_.shutting_down()) {
+        MaybeFinishShutdown();
+        return;
+    }
+
+    EnsureCapacity();
+}
+
+void BrowserPool::OnMainFrameLoadEnd(CefRefPtr<CefBrowser> browser, const std::string& url,
+                                     int http_status) {
+    CEF_REQUIRE_UI_THREAD();
+
+    Entry* entry = Find(browser);
+    const PooledBrowser* pooled = state_.Find(browser->GetIdentifier());
+    if (!entry || !pooled) {
+        return;
+    }
+
+    if (pooled->state == PooledBrowserState::kResetting) {
+        // Ignore the tail of the load that was interrupted by the reset
+        if (url == GetBlankURL() && !entry->cleaner) {
+            ClearStorage(*entry);
+        }
+        return;
+    }
+
+    // Virtual time loads complete when their budget expires, and
+    // LoadUntilReady() once the page is ready
+    if ((entry->capture && entry->capture->loading()) || entry->ready_watch) {
+        entry->load_status = http_status;
+        return;
+    }
+
+    BrowserPoolLoadResult result;
+    result.url = url;
+    result.http_status = http_status;
+    CompleteLoad(*entry, result);
+}
+
+void BrowserPool::OnMainFrameLoadError(CefRefPtr<CefBrowser> browser, const std::string& url,
+                                       cef_errorcode_t error_code) {
+    CEF_REQUIRE_UI_THREAD();
+
+    Entry* entry = Find(browser);
+    const PooledBrowser* pooled = state_.Find(browser->GetIdentifier());
+    if (!entry || !pooled) {
+        return;
+    }
+
+    if (pooled->state == PooledBrowserState::kResetting) {
+        // A browser that cannot load the blank page is not reusable
+        if (url == GetBlankURL()) {
+            state_.Retire(browser->GetIdentifier());
+            Close(*entry);
+            EnsureCapacity();
+        }
+        return;
+    }
+
+    BrowserPoolLoadResult result;
+    result.url = url;
+    result.error_code = error_code;
+    CancelDeferredLoad(*entry);
+    CompleteLoad(*entry, result);
+}
+
+void BrowserPool::OnFrameLoadStart(CefRefPtr<CefBrowser> browser, const std::string& url) {
+    CEF_REQUIRE_UI_THREAD();
+
+    Entry* entry = Find(browser);
+    if (!entry || !IsCheckedOut(*entry)) {
+        return;
+    }
+
+    // Empty for URLs without an origin of their own, such as about:blank,
+    // whose storage is that of the frame's parent
+    CefURLParts parts;
+    if (!CefParseURL(url, parts)) {
+        return;
+    }
+    std::string origin = CefString(&parts.origin).ToString();
+    if (!origin.empty() && origin.back() == '/') {
+        origin.pop_back();
+    }
+    if (!origin.empty()) {
+        entry->origins.insert(origin);
+    }
+}
+
+// ============================================================================
+// Private methods
+// ============================================================================
+
+void BrowserPool::CreateBrowser() {
+    const BrowserConfig& config = GetBrowserConfig();
+
+    CefWindowInfo window_info;
+    window_info.SetAsWindowless(kNullWindowHandle);
+
+    CefBrowserSettings browser_settings;
+    browser_settings.windowless_frame_rate = config.frame_rate;
+
+    // An empty cache path gives each browser its own in-memory storage
+    CefRequestContextSettings context_settings;
+    CefRefPtr<CefRequestContext> request_context =
+        CefRequestContext::CreateContext(context_settings, nullptr);
+
+    // Scheme handlers are per context; the blank page is served from app://
+    RegisterInternalSchemeHandlerFactory(request_context);
+    if (configure_context_) {
+        configure_context_(request_context);
+    }
+
+    CefBrowserHost::CreateBrowser(window_info, client_, GetBlankURL(), browser_settings,
+                                  nullptr,  // extra_info
+                                  request_context);
+}
+
+void BrowserPool::EnsureCapacity() {
+    for (size_t creates = state_.TakeCreates(); creates > 0; --creates) {
+        CreateBrowser();
+    }
+}
+
+void BrowserPool::CancelDeferredLoad(Entry& entry) {
+    // Detaching its DevTools client returns the page to real time
+    entry.capture.reset();
+
+    if (entry.ready_watch) {
+        CancelPageReadyWatch(entry.ready_watch);
+        entry.ready_watch = 0;
+    }
+}
+
+void BrowserPool::Reset(Entry& entry) {
+    CancelDeferredLoad(entry);
+    ClearResourcePolicy(entry.browser->GetIdentifier());
+
+    CefRefPtr<CefBrowserHost> host = entry.browser->GetHost();
+    entry.browser->StopLoad();
+
+    CefRefPtr<CefRequestContext> request_context = host->GetRequestContext();
+    if (request_context) {
+        request_context->GetCookieManager(nullptr)->DeleteCookies("", "", nullptr);
+        request_context->ClearHttpAuthCredentials(nullptr);
+        request_context->CloseAllConnections(nullptr);
+    }
+
+    entry.browser->GetMainFrame()->LoadURL(GetBlankURL());
+}
+
+void BrowserPool::ClearStorage(Entry& entry) {
+    // Nothing was loaded since the browser was created or last cleared
+    if (entry.origins.empty()) {
+        MakeAvailable(entry);
+        return;
+    }
+
+    const int browser_id = entry.browser->GetIdentifier();
+    auto done = [this, browser_id](const DevToolsResult& result) {
+        OnStorageCleared(browser_id, result);
+    };
+
+    entry.cleaner = std::make_unique<DevToolsClient>(entry.browser);
+    entry.clears_pending = entry.origins.size() + 1;
+    entry.clear_failed = false;
+    entry.cleaner->Network().ClearBrowserCache(done);
+    for (const std::string& origin : entry.origins) {
+        entry.cleaner->Storage().ClearDataForOrigin(origin, "all", done);
+    }
+    entry.origins.clear();
+}
+
+void BrowserPool::OnStorageCleared(int browser_id, const DevToolsResult& result) {
+    auto it = browsers_.find(browser_id);
+    if (it == browsers_.end()) {
+        return;
+    }
+    Entry& entry = it->second;
+    if (!result.success) {
+        LOG(WARNING) << "Failed to clear the storage of a pooled browser: " << result.error;
+        entry.clear_failed = true;
+    }
+    if (--entry.clears_pending > 0) {
+        return;
+    }
+    entry.cleaner.reset();
+
+    // A browser closed or shut down meanwhile is no longer resetting
+    const PooledBrowser* pooled = state_.Find(browser_id);
+    if (!pooled || pooled->state != PooledBrowserState::kResetting) {
+        return;
+    }
+
+    // The next checkout would see the last one's storage
+    if (entry.clear_failed) {
+        state_.Retire(browser_id);
+        Close(entry);
+        EnsureCapacity();
+        return;
+    }
+    MakeAvailable(entry);
+}
+
+void BrowserPool::MakeAvailable(Entry& entry) {
+    const BrowserPoolCheckout checkout =
+        state_.OnResetDone(entry.browser->GetIdentifier(), BrowserPoolState::Clock::now());
+    if (checkout.browser_id) {
+        CheckoutCallback callback = std::move(waiting_.front());
+        waiting_.pop_front();
+        Hand(entry, callback);
+    }
+}
+
+void BrowserPool::Hand(Entry& entry, const CheckoutCallback& callback) {
+    callback(entry.browser);
+}
+
+void BrowserPool::Close(Entry& entry) {
+    CancelDeferredLoad(entry);
+    entry.cleaner.reset();
+    entry.browser->GetHost()->CloseBrowser(true);
+}
+
+void BrowserPool::TrimIdle() {
+    if (state_.shutting_down()) {
+        return;
+    }
+
+    for (int browser_id : state_.TrimIdle(BrowserPoolState::Clock::now())) {
+        Close(browsers_[browser_id]);
+    }
+
+    ScheduleTrim();
+}
+
+void BrowserPool::ScheduleTrim() {
+    // Check at twice the timeout rate so idle browsers live at most 1.5x it
+    const auto interval =
+        std::chrono::duration_cast<std::chrono::milliseconds>(state_.options().idle_timeout) / 2;
+    CefPostDelayedTask(TID_UI, base::BindOnce(&BrowserPool::TrimIdle, base::Unretained(this)),
+                       std::max<int64_t>(interval.count(), 1000));
+}
+
+bool BrowserPool::IsCheckedOut(const Entry& entry) const {
+    const PooledBrowser* pooled = state_.Find(entry.browser->GetIdentifier());
+    return pooled && pooled->state == PooledBrowserState::kCheckedOut;
+}
+
+void BrowserPool::MaybeFinishShutdown() {
+    if (state_.closed() && shutdown_done_) {
+        std::move(shutdown_done_)();
+    }
+}
+
+void BrowserPool::CompleteLoad(Entry& entry, const BrowserPoolLoadResult& result) {
+    if (!entry.load_callback) {
+        return;
+    }
+
+    LoadCallback callback = std::move(entry.load_callback);
+    entry.load_callback = nullptr;
+    callback(entry.browser, result);
+}
+
+void BrowserPool::OnCaptureReady(int browser_id, const std::string& url,
+                                 const VirtualTimeCaptureResult& capture) {
+    auto it = browsers_.find(browser_id);
+    if (it == browsers_.end()) {
+        return;
+    }
+    Entry& entry = it->second;
+
+    BrowserPoolLoadResult result;
+    result.url = entry.browser->GetMainFrame()->GetURL().ToString();
+    if (result.url.empty()) {
+        result.url = url;
+    }
+    result.http_status = entry.load_status;
+    if (capture.timed_out) {
+        result.error_code = ERR_TIMED_OUT;
+    } else if (!capture.ready) {
+        result.error_code = ERR_FAILED;
+    }
+
+    // The capture stays until the browser is reset, keeping page time paused
+    // while the caller captures it
+    CompleteLoad(entry, result);
+}
+
+void BrowserPool::OnPageReady(int browser_id, const PageReadyEvent& event) {
+    auto it = browsers_.find(browser_id);
+    if (it == browsers_.end()) {
+        return;
+    }
+    Entry& entry = it->second;
+    CancelPageReadyWatch(entry.ready_watch);
+    entry.ready_watch = 0;
+
+    BrowserPoolLoadResult result;
+    result.url = event.url;
+    result.http_status = entry.load_status;
+    if (event.timed_out) {
+        result.error_code = ERR_TIMED_OUT;
+    }
+    CompleteLoad(entry, result);
+}
+
+BrowserPool::Entry* BrowserPool::Find(CefRefPtr<CefBrowser> browser) {
+    if (!browser) {
+        return nullptr;
+    }
+    auto it = browsers_.find(browser->GetIdentifier());
+    return it != browsers_.end() ? &it->second : nullptr;
+}
+
+BrowserPool* InitBrowserPool(const BrowserPoolOptions& options) {
+    CEF_REQUIRE_UI_THREAD();
+
+    g_browser_pool = std::make_unique<BrowserPool>(options);
+    g_browser_pool->Start();
+    return g_browser_pool.get();
+}
+
+BrowserPool* GetBrowserPool() {
+    return g_browser_pool.get();
+}
@@ -0,0 +1,210 @@
+// CEF Browser - Pre-warmed Browser Pool
+#ifndef CEF_BROWSER_POOL_H_
+#define CEF_BROWSER_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "include/cef_browser.h"
+#include "include/cef_request_context.h"
+
+#include "browser_client.h"
+#include "browser_pool_state.h"
+#include "page_readiness.h"
+#include "resource_policy.h"
+#include "virtual_time.h"
+
+class DevToolsClient;
+class VirtualTimeCapture;
+struct DevToolsResult;
+struct PageReadyEvent;
+struct VirtualTimeCaptureResult;
+
+// Result of a pooled navigation
+struct BrowserPoolLoadResult {
+    std::string url;
+
+    // HTTP status of the main frame, or 0 if it failed to load
+    int http_status = 0;
+
+    // ERR_NONE on success
+    cef_errorcode_t error_code = ERR_NONE;
+};
+
+// Pool of off-screen browsers that are created ahead of time and reused, so
+// page throughput is bound by render time rather than renderer spawn time.
+//
+// Callers check a browser out, Load() a URL into it and Return() it when done.
+// Each browser has its own in-memory request context, which lives as long as
+// the browser. A returned browser is reset to a blank internal page, with its
+// cookies, HTTP auth and connections dropped; once the blank page has loaded,
+// its HTTP cache and the storage of every origin its frames loaded
+// (localStorage, IndexedDB, Cache Storage, service workers, ...) are cleared
+// too, and a browser whose storage cannot be cleared is closed instead. All
+// methods must be called on the UI thread.
+class BrowserPool : public BrowserClient::Delegate {
+public:
+    using CheckoutCallback = std::function<void(CefRefPtr<CefBrowser>)>;
+    using LoadCallback =
+        std::function<void(CefRefPtr<CefBrowser>, const BrowserPoolLoadResult& result)>;
+    using ContextCallback = std::function<void(CefRefPtr<CefRequestContext>)>;
+
+    // |configure_context| is called with the request context of each new
+    // browser before the browser is created, e.g. to register scheme handlers
+    explicit BrowserPool(const BrowserPoolOptions& options,
+                         ContextCallback configure_context = nullptr);
+    ~BrowserPool() override;
+
+    // Create the initial |min_size| browsers and start idle trimming
+    void Start();
+
+    // Hand an idle browser to |callback|. If none is idle a browser is created
+    // when below |max_size|; otherwise |callback| waits for the next Return().
+    // |callback| may run before Checkout() returns. Each checkout gets a new
+    // job id, see GetJobId().
+    void Checkout(CheckoutCallback callback);
+
+    // Navigate a checked out |browser| to |url|. |callback| runs once the main
+    // frame has finished loading or failed.
+    void Load(CefRefPtr<CefBrowser> browser, const std::string& url, LoadCallback callback);
+
+    // Navigate a checked out |browser| to |url| under virtual time, see
+    // VirtualTimeCapture. |callback| runs once the budget has expired with
+    // the network idle; with ERR_TIMED_OUT if that takes longer than the
+    // options allow, and with an error if the main frame fails to load.
+    void LoadWithVirtualTime(CefRefPtr<CefBrowser> browser, const std::string& url,
+                             const VirtualTimeOptions& options, LoadCallback callback);
+
+    // Navigate a checked out |browser| to |url|. |callback| runs once the page
+    // meets |condition| rather than at main frame load end; with
+    // ERR_TIMED_OUT if it does not within the condition's timeout, and with
+    // an error if the main frame fails to load.
+    void LoadUntilReady(CefRefPtr<CefBrowser> browser, const std::string& url,
+                        const PageReadyCondition& condition, LoadCallback callback);
+
+    // Suppress resources of a checked out |browser| by |policy| instead of
+    // the default policy until it is returned. GetResourcePolicyCounts()
+    // reports what the policy avoided.
+    void SetResourcePolicy(CefRefPtr<CefBrowser> browser, const ResourcePolicy& policy);
+
+    // Give a checked out |browser| back to the pool
+    void Return(CefRefPtr<CefBrowser> browser);
+
+    // Close every browser and drop waiting checkouts. |done| runs once the last
+    // browser has closed.
+    void Shutdown(std::function<void()> done);
+
+    // Browsers that exist or are being created
+    size_t size() const { return state_.size(); }
+
+    // Browsers ready for checkout
+    size_t idle_count() const { return state_.idle_count(); }
+
+    // Job id of the current checkout of |browser|, or 0 if it is not checked
+    // out
+    uint64_t GetJobId(CefRefPtr<CefBrowser> browser) const;
+
+    // BrowserClient::Delegate methods
+    void OnBrowserCreated(CefRefPtr<CefBrowser> browser) override;
+    void OnBrowserClosed(CefRefPtr<CefBrowser> browser) override;
+    void OnMainFrameLoadEnd(CefRefPtr<CefBrowser> browser, const std::string& url,
+                            int http_status) override;
+    void OnMainFrameLoadError(CefRefPtr<CefBrowser> browser, const std::string& url,
+                              cef_errorcode_t error_code) override;
+    void OnFrameLoadStart(CefRefPtr<CefBrowser> browser, const std::string& url) override;
+
+private:
+    struct Entry {
+        CefRefPtr<CefBrowser> browser;
+        LoadCallback load_callback;
+
+        // Virtual time load in progress
+        std::unique_ptr<VirtualTimeCapture> capture;
+
+        // Readiness watch of a LoadUntilReady() in progress, or 0
+        int ready_watch = 0;
+
+        // HTTP status of the main frame of a load that completes after it
+        int load_status = 0;
+
+        // Origins whose frames loaded since the last reset
+        std::set<std::string> origins;
+
+        // Clears storage at the end of a reset, with |clears_pending| calls
+        // outstanding
+        std::unique_ptr<DevToolsClient> cleaner;
+        size_t clears_pending = 0;
+        bool clear_failed = false;
+    };
+
+    // Create one browser asynchronously
+    void CreateBrowser();
+
+    // Create the browsers |state_| asks for
+    void EnsureCapacity();
+
+    // Stop waiting for |entry|'s virtual time load or page readiness
+    void CancelDeferredLoad(Entry& entry);
+
+    // Clear |entry|'s state and load the blank page
+    void Reset(Entry& entry);
+
+    // Clear the storage |entry|'s pages left behind, then make it available.
+    // Runs once the blank page has loaded, so no page writes to it after.
+    void ClearStorage(Entry& entry);
+    void OnStorageCleared(int browser_id, const DevToolsResult& result);
+
+    // Mark |entry| idle, or hand it to the first waiting checkout
+    void MakeAvailable(Entry& entry);
+
+    // Hand |entry|, just checked out, to |callback|
+    void Hand(Entry& entry, const CheckoutCallback& callback);
+
+    // Close |entry|'s browser, which |state_| has retired
+    void Close(Entry& entry);
+
+    // Close browsers that stayed idle past |idle_timeout|
+    void TrimIdle();
+    void ScheduleTrim();
+
+    // Whether |entry| is checked out
+    bool IsCheckedOut(const Entry& entry) const;
+
+    // Run |shutdown_done_| once the last browser has closed
+    void MaybeFinishShutdown();
+
+    // Run |entry|'s pending load callback, if any
+    void CompleteLoad(Entry& entry, const BrowserPoolLoadResult& result);
+
+    // Report the outcome of |browser_id|'s virtual time load
+    void OnCaptureReady(int browser_id, const std::string& url,
+                        const VirtualTimeCaptureResult& capture);
+
+    // Report |browser_id|'s page meeting its LoadUntilReady() condition
+    void OnPageReady(int browser_id, const PageReadyEvent& event);
+
+    Entry* Find(CefRefPtr<CefBrowser> browser);
+
+    BrowserPoolState state_;
+    ContextCallback configure_context_;
+    CefRefPtr<BrowserClient> client_;
+
+    // Live browsers keyed by browser identifier
+    std::map<int, Entry> browsers_;
+
+    // Callbacks of the checkouts |state_| counts as waiting, in order
+    std::deque<CheckoutCallback> waiting_;
+    std::function<void()> shutdown_done_;
+};
+
+// Create the process-wide pool. Called once on the UI thread.
+BrowserPool* InitBrowserPool(const BrowserPoolOptions& options);
+
+// Get the process-wide pool, or nullptr if pooling is disabled
+BrowserPool* GetBrowserPool();
+
+#endif  // CEF_BROWSER_POOL_H_
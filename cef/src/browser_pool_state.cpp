@@ -0,0 +1,177 @@
+// CEF Browser - Browser Pool Bookkeeping Implementation
+#include "browser_pool_state.h"
+
+#include <algorithm>
+
+BrowserPoolState::BrowserPoolState(const BrowserPoolOptions& options) : options_(options) {
+    if (options_.max_size < options_.min_size) {
+        options_.max_size = options_.min_size;
+    }
+}
+
+size_t BrowserPoolState::TakeCreates() {
+    if (shutting_down_) {
+        return 0;
+    }
+
+    // Browsers that will become available without being created
+    size_t available = idle_.size() + pending_creates_;
+    for (const auto& it : browsers_) {
+        if (it.second.state == PooledBrowserState::kResetting) {
+            available++;
+        }
+    }
+
+    size_t creates = 0;
+    while (size() < options_.max_size &&
+           (size() < options_.min_size || available < waiting_)) {
+        pending_creates_++;
+        available++;
+        creates++;
+    }
+    return creates;
+}
+
+bool BrowserPoolState::OnCreated(int browser_id) {
+    if (pending_creates_ > 0) {
+        pending_creates_--;
+    }
+    PooledBrowser& browser = browsers_[browser_id];
+
+    // The blank page was the initial URL; it becomes available once loaded
+    browser.state = shutting_down_ ? PooledBrowserState::kClosing : PooledBrowserState::kResetting;
+    return !shutting_down_;
+}
+
+BrowserPoolCheckout BrowserPoolState::Checkout() {
+    if (shutting_down_) {
+        return {};
+    }
+
+    if (idle_.empty()) {
+        waiting_++;
+        return {};
+    }
+
+    const int browser_id = idle_.back();
+    idle_.pop_back();
+    return Hand(browser_id, browsers_[browser_id]);
+}
+
+BrowserPoolReturn BrowserPoolState::Return(int browser_id) {
+    auto it = browsers_.find(browser_id);
+    if (it == browsers_.end() || it->second.state != PooledBrowserState::kCheckedOut) {
+        return BrowserPoolReturn::kIgnore;
+    }
+
+    PooledBrowser& browser = it->second;
+    browser.job_id = 0;
+    if (browser.uses >= options_.max_uses) {
+        browser.state = PooledBrowserState::kClosing;
+        return BrowserPoolReturn::kRetire;
+    }
+    browser.state = PooledBrowserState::kResetting;
+    return BrowserPoolReturn::kReset;
+}
+
+BrowserPoolCheckout BrowserPoolState::OnResetDone(int browser_id, Clock::time_point now) {
+    auto it = browsers_.find(browser_id);
+    if (it == browsers_.end() || it->second.state != PooledBrowserState::kResetting) {
+        return {};
+    }
+
+    PooledBrowser& browser = it->second;
+    if (waiting_ > 0) {
+        waiting_--;
+        return Hand(browser_id, browser);
+    }
+
+    browser.state = PooledBrowserState::kIdle;
+    browser.idle_since = now;
+    idle_.push_back(browser_id);
+    return {};
+}
+
+void BrowserPoolState::Retire(int browser_id) {
+    auto it = browsers_.find(browser_id);
+    if (it == browsers_.end()) {
+        return;
+    }
+    if (it->second.state == PooledBrowserState::kIdle) {
+        RemoveIdle(browser_id);
+    }
+    it->second.state = PooledBrowserState::kClosing;
+    it->second.job_id = 0;
+}
+
+void BrowserPoolState::OnClosed(int browser_id) {
+    if (browsers_.erase(browser_id) > 0) {
+        RemoveIdle(browser_id);
+    }
+}
+
+std::vector<int> BrowserPoolState::TrimIdle(Clock::time_point now) {
+    std::vector<int> retired;
+    if (shutting_down_) {
+        return retired;
+    }
+
+    size_t open = 0;
+    for (const auto& it : browsers_) {
+        if (it.second.state != PooledBrowserState::kClosing) {
+            open++;
+        }
+    }
+
+    while (!idle_.empty() && open > options_.min_size) {
+        const int browser_id = idle_.front();
+        PooledBrowser& browser = browsers_[browser_id];
+        if (now - browser.idle_since < options_.idle_timeout) {
+            break;
+        }
+        idle_.pop_front();
+        browser.state = PooledBrowserState::kClosing;
+        retired.push_back(browser_id);
+        open--;
+    }
+    return retired;
+}
+
+std::vector<int> BrowserPoolState::Shutdown() {
+    shutting_down_ = true;
+    waiting_ = 0;
+    idle_.clear();
+
+    std::vector<int> retired;
+    for (auto& it : browsers_) {
+        if (it.second.state != PooledBrowserState::kClosing) {
+            it.second.state = PooledBrowserState::kClosing;
+            it.second.job_id = 0;
+            retired.push_back(it.first);
+        }
+    }
+    return retired;
+}
+
+const PooledBrowser* BrowserPoolState::Find(int browser_id) const {
+    auto it = browsers_.find(browser_id);
+    return it != browsers_.end() ? &it->second : nullptr;
+}
+
+BrowserPoolCheckout BrowserPoolState::Hand(int browser_id, PooledBrowser& browser) {
+    browser.state = PooledBrowserState::kCheckedOut;
+    browser.uses++;
+    browser.job_id = ++last_job_id_;
+
+    BrowserPoolCheckout checkout;
+    checkout.browser_id = browser_id;
+    checkout.job_id = browser.job_id;
+    return checkout;
+}
+
+void BrowserPoolState::RemoveIdle(int browser_id) {
+    auto it = std::find(idle_.begin(), idle_.end(), browser_id);
+    if (it != idle_.end()) {
+        idle_.erase(it);
+    }
+}
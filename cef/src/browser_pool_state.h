@@ -0,0 +1,143 @@
+// CEF Browser - Browser Pool Bookkeeping
+#ifndef CEF_BROWSER_BROWSER_POOL_STATE_H_
+#define CEF_BROWSER_BROWSER_POOL_STATE_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+// Pool sizing and recycling limits
+struct BrowserPoolOptions {
+    // Browsers created up front and kept alive while idle
+    size_t min_size = 2;
+
+    // Browsers that may exist at once, checked out or not
+    size_t max_size = 8;
+
+    // Checkouts before a browser is closed and replaced
+    int max_uses = 100;
+
+    // How long an idle browser above |min_size| is kept
+    std::chrono::seconds idle_timeout{60};
+};
+
+enum class PooledBrowserState {
+    kResetting,   // Being returned to a clean blank page
+    kIdle,        // Ready for checkout
+    kCheckedOut,  // Owned by a caller
+    kClosing,     // Retired, waiting for the browser to close
+};
+
+struct PooledBrowser {
+    PooledBrowserState state = PooledBrowserState::kResetting;
+
+    // Checkouts so far, the current one included
+    int uses = 0;
+
+    // Job of the current checkout, or 0
+    uint64_t job_id = 0;
+
+    std::chrono::steady_clock::time_point idle_since;
+};
+
+// A browser handed to a checkout, or browser_id 0 for none
+struct BrowserPoolCheckout {
+    int browser_id = 0;
+    uint64_t job_id = 0;
+};
+
+// What to do with a returned browser
+enum class BrowserPoolReturn {
+    kIgnore,  // It was not checked out
+    kReset,   // Reset it, then call OnResetDone()
+    kRetire,  // Close it; it has been used |max_uses| times
+};
+
+// Bookkeeping of a BrowserPool without the browsers themselves: which
+// browsers are idle, checked out or being reset, how many checkouts wait and
+// how many browsers to create. Browsers are known by their identifier; the
+// caller creates, resets and closes them and reports back. Waiting checkouts
+// are served in order, so the caller keeps their callbacks in a queue of its
+// own. Not thread-safe; BrowserPool uses it on the UI thread.
+class BrowserPoolState {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit BrowserPoolState(const BrowserPoolOptions& options);
+
+    const BrowserPoolOptions& options() const { return options_; }
+
+    // Browsers to create now to cover |min_size| and the waiting checkouts,
+    // within |max_size|. They count towards size() until OnCreated().
+    size_t TakeCreates();
+
+    // A browser asked for by TakeCreates() exists and is loading the blank
+    // page. Returns false if the pool is shutting down; the browser is then
+    // closing and the caller closes it.
+    bool OnCreated(int browser_id);
+
+    // Check out the idle browser returned last, whose renderer is the
+    // warmest, under a new job id. Without an idle browser the checkout
+    // waits for OnResetDone(), and browser_id is 0; so it is after
+    // Shutdown(), when the checkout is refused instead.
+    BrowserPoolCheckout Checkout();
+
+    // A checked out |browser_id| came back
+    BrowserPoolReturn Return(int browser_id);
+
+    // |browser_id| finished resetting. It is handed to the first waiting
+    // checkout, which is returned, or becomes idle as of |now|.
+    BrowserPoolCheckout OnResetDone(int browser_id, Clock::time_point now);
+
+    // Mark |browser_id| closing, e.g. when it could not be reset
+    void Retire(int browser_id);
+
+    // |browser_id| closed, whatever its state
+    void OnClosed(int browser_id);
+
+    // Retire idle browsers above |min_size| that have been idle for
+    // |idle_timeout| at |now|, longest idle first. Returns them for the
+    // caller to close.
+    std::vector<int> TrimIdle(Clock::time_point now);
+
+    // Refuse checkouts from now on, drop the waiting ones and retire every
+    // browser. Returns the browsers for the caller to close.
+    std::vector<int> Shutdown();
+
+    // State of |browser_id|, or nullptr if the pool does not know it
+    const PooledBrowser* Find(int browser_id) const;
+
+    // Browsers that exist or are being created
+    size_t size() const { return browsers_.size() + pending_creates_; }
+
+    size_t idle_count() const { return idle_.size(); }
+    size_t waiting_count() const { return waiting_; }
+    bool shutting_down() const { return shutting_down_; }
+
+    // Whether Shutdown() has run and every browser has closed
+    bool closed() const { return shutting_down_ && size() == 0; }
+
+private:
+    // Check |browser| out under a new job id
+    BrowserPoolCheckout Hand(int browser_id, PooledBrowser& browser);
+
+    void RemoveIdle(int browser_id);
+
+    BrowserPoolOptions options_;
+
+    // Known browsers by identifier
+    std::map<int, PooledBrowser> browsers_;
+
+    // Idle browser identifiers, least recently returned first
+    std::deque<int> idle_;
+
+    size_t waiting_ = 0;
+    size_t pending_creates_ = 0;
+    uint64_t last_job_id_ = 0;
+    bool shutting_down_ = false;
+};
+
+#endif  // CEF_BROWSER_BROWSER_POOL_STATE_H_
@@ -0,0 +1,207 @@
+// CEF Browser - Browser Registry
+#ifndef CEF_BROWSER_BROWSER_REGISTRY_H_
+#define CEF_BROWSER_BROWSER_REGISTRY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "frame_buffer.h"
+#include "page_readiness.h"
+#include "slot_map.h"
+
+// Defined by resource_policy_handler.cpp
+struct ResourcePolicyEntry;
+
+// Browser state flags
+enum BrowserFlag : uint32_t {
+    kBrowserMain = 1 << 0,       // First browser of its client
+    kBrowserDelegated = 1 << 1,  // Reports to a BrowserClient::Delegate
+    kBrowserLoading = 1 << 2,    // Main frame load in progress
+    kBrowserClosing = 1 << 3,    // DoClose has run
+};
+
+// Per-browser state of BrowserClient and the handlers it drives
+struct BrowserRecord {
+    int browser_id = 0;
+    uint32_t flags = 0;
+
+    // Process id the renderer of the main frame reported; 0 until it
+    // reports, and after it exits
+    int renderer_pid = 0;
+
+    // Last URL the main frame committed
+    std::string url;
+
+    // Policy replacing the default resource policy, or nullptr. Read on the
+    // IO thread through BrowserRegistry::Lookup().
+    std::shared_ptr<ResourcePolicyEntry> resource_policy;
+
+    // Pages and requests of the main frame, for page readiness watches
+    PageLoadState page_load;
+
+    // When the pending readiness check runs; TimePoint::max() if none
+    PageLoadState::TimePoint ready_check_at = PageLoadState::TimePoint::max();
+
+    // Watchdog target of the renderer, or 0 when the watchdog is off
+    int watchdog_target = 0;
+};
+
+// Live browsers of the process and their state, keyed by browser identifier.
+// Entries sit in one dense SlotMap, so walking every browser touches
+// contiguous memory. A browser keeps its SlotHandle for its lifetime; a
+// handle held past the browser's close, e.g. by a posted task, finds nothing
+// even once the slot is reused. |Browser| is the browser's handle,
+// CefRefPtr<CefBrowser> outside of tests.
+//
+// Only the UI thread adds, removes or changes browsers, so it may read without
+// locking. Other threads use the methods marked "any thread", which read under
+// a shared lock.
+template <typename Browser>
+class BrowserRegistry {
+public:
+    BrowserRegistry() = default;
+    BrowserRegistry(const BrowserRegistry&) = delete;
+    BrowserRegistry& operator=(const BrowserRegistry&) = delete;
+
+    // Register |browser| as |browser_id| with |flags|. Returns its handle, or
+    // an invalid one if |browser_id| is already registered. UI thread.
+    SlotHandle Add(int browser_id, Browser browser, uint32_t flags) {
+        std::unique_lock<std::shared_mutex> lock(lock_);
+        if (slots_.count(browser_id)) {
+            return SlotHandle();
+        }
+        Entry entry;
+        entry.record.browser_id = browser_id;
+        entry.record.flags = flags;
+        entry.browser = std::move(browser);
+        const SlotHandle handle = entries_.Insert(std::move(entry));
+        slots_[browser_id] = handle;
+        size_.store(entries_.size(), std::memory_order_relaxed);
+        return handle;
+    }
+
+    // Forget |browser_id| and its state. Returns false if it was not
+    // registered. UI thread.
+    bool Remove(int browser_id) {
+        // Declared first so the browser is released after the lock
+        Entry removed;
+
+        std::unique_lock<std::shared_mutex> lock(lock_);
+        auto it = slots_.find(browser_id);
+        if (it == slots_.end()) {
+            return false;
+        }
+        removed = std::move(*entries_.Get(it->second));
+        entries_.Erase(it->second);
+        slots_.erase(it);
+        size_.store(entries_.size(), std::memory_order_relaxed);
+        return true;
+    }
+
+    // Handle of |browser_id|, invalid if it is not registered. UI thread.
+    SlotHandle HandleOf(int browser_id) const {
+        auto it = slots_.find(browser_id);
+        return it != slots_.end() ? it->second : SlotHandle();
+    }
+
+    // Record of |browser_id| or |handle|, or nullptr. UI thread.
+    const BrowserRecord* Find(int browser_id) const { return Find(HandleOf(browser_id)); }
+    const BrowserRecord* Find(SlotHandle handle) const {
+        const Entry* entry = entries_.Get(handle);
+        return entry ? &entry->record : nullptr;
+    }
+
+    // Browser of |handle|, or a null handle. UI thread.
+    Browser GetBrowser(SlotHandle handle) const {
+        const Entry* entry = entries_.Get(handle);
+        return entry ? entry->browser : Browser();
+    }
+
+    // Run |update| on the record of |browser_id| or |handle| under the lock;
+    // |update| must not call back into the registry. Returns false if it is
+    // not registered. UI thread.
+    template <typename Fn>
+    bool Update(int browser_id, Fn update) {
+        return Update(HandleOf(browser_id), std::move(update));
+    }
+    template <typename Fn>
+    bool Update(SlotHandle handle, Fn update) {
+        std::unique_lock<std::shared_mutex> lock(lock_);
+        Entry* entry = entries_.Get(handle);
+        if (!entry) {
+            return false;
+        }
+        update(entry->record);
+        return true;
+    }
+
+    // Last painted frame of |browser_id|, created on first use. UI thread.
+    FrameBuffer* GetOrCreateFrameBuffer(int browser_id) {
+        Entry* entry = entries_.Get(HandleOf(browser_id));
+        if (!entry) {
+            return nullptr;
+        }
+        if (!entry->frame_buffer) {
+            entry->frame_buffer = std::make_unique<FrameBuffer>();
+        }
+        return entry->frame_buffer.get();
+    }
+    const FrameBuffer* GetFrameBuffer(int browser_id) const {
+        const Entry* entry = entries_.Get(HandleOf(browser_id));
+        return entry ? entry->frame_buffer.get() : nullptr;
+    }
+
+    // Call |fn| with the record and browser of every registered browser, in
+    // no particular order. |fn| may update records but must not add or remove
+    // browsers. UI thread.
+    template <typename Fn>
+    void ForEach(Fn fn) const {
+        for (const Entry& entry : entries_) {
+            fn(entry.record, entry.browser);
+        }
+    }
+
+    // Call |read| with |browser_id|'s record under the lock. Returns false if
+    // it is not registered. Any thread.
+    template <typename Fn>
+    bool Lookup(int browser_id, Fn read) const {
+        std::shared_lock<std::shared_mutex> lock(lock_);
+        const Entry* entry = entries_.Get(HandleOf(browser_id));
+        if (!entry) {
+            return false;
+        }
+        read(entry->record);
+        return true;
+    }
+
+    // |browser_id|'s browser, or a null handle. Any thread.
+    Browser GetBrowser(int browser_id) const {
+        std::shared_lock<std::shared_mutex> lock(lock_);
+        return GetBrowser(HandleOf(browser_id));
+    }
+
+    // Registered browsers. Any thread.
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+    bool empty() const { return size() == 0; }
+
+private:
+    struct Entry {
+        BrowserRecord record;
+        Browser browser;
+        std::unique_ptr<FrameBuffer> frame_buffer;
+    };
+
+    // Guards |entries_| and |slots_| against readers on other threads
+    mutable std::shared_mutex lock_;
+    SlotMap<Entry> entries_;
+    std::unordered_map<int, SlotHandle> slots_;
+    std::atomic<size_t> size_{0};
+};
+
+#endif  // CEF_BROWSER_BROWSER_REGISTRY_H_
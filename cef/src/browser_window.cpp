@@ -1,6 +1,7 @@
 // CEF Browser - Browser Window Implementation
 #include "browser_window.h"
 #include "browser_client.h"
+#include "browser_config.h"
 
 #include "include/cef_app.h"
 #include "include/wrapper/cef_helpers.h"
@@ -34,6 +35,28 @@ void BrowserWindow::Create() {
     browser_settings.databases = STATE_ENABLED;
     browser_settings.webgl = STATE_ENABLED;
 
+    const BrowserConfig& config = GetBrowserConfig();
+    if (config.off_screen) {
+        // Off-screen: no native window, frames are delivered to OnPaint
+        window_info.SetAsWindowless(kNullWindowHandle);
+        browser_settings.windowless_frame_rate = config.frame_rate;
+    } else {
+        CreateNativeWindow(window_info);
+    }
+
+    // Under virtual time the start URL is loaded once page time is paused
+    const std::string url =
+        config.virtual_time_budget_ms > 0 ? std::string("about:blank") : config.start_url;
+
+    // Create the browser
+    CefBrowserHost::CreateBrowser(window_info, g_browser_client, url,
+                                  browser_settings,
+                                  nullptr,  // extra_info
+                                  nullptr   // request_context
+    );
+}
+
+void BrowserWindow::CreateNativeWindow(CefWindowInfo& window_info) {
 #if defined(OS_WIN)
     // Windows: Create a simple window
     WNDCLASSEX wcex = {0};
@@ -61,15 +84,8 @@ void BrowserWindow::Create() {
 #else
     // Linux/macOS: With chrome_runtime, window is managed by Chrome
     // No special window_info setup needed
-    (void)kDefaultWidth;
-    (void)kDefaultHeight;
+    (void)window_info;
 #endif
-
-    // Create the browser
-    CefBrowserHost::CreateBrowser(window_info, g_browser_client, kDefaultUrl, browser_settings,
-                                  nullptr,  // extra_info
-                                  nullptr   // request_context
-    );
 }
 
 void BrowserWindow::Navigate(const std::string& url) {
@@ -42,6 +42,9 @@ public:
     static const char* kDefaultUrl;
 
 private:
+    // Create the native top-level window the browser is parented to
+    static void CreateNativeWindow(CefWindowInfo& window_info);
+
     BrowserWindow() = delete;
 };
 
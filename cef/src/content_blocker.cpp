@@ -0,0 +1,737 @@
+// CEF Browser - Subresource Content Blocker Implementation
+#include "content_blocker.h"
+#include "json_writer.h"
+
+#include <algorithm>
+#include <deque>
+
+namespace {
+
+constexpr uint32_t kNoRule = UINT32_MAX;
+
+// Literals shorter than this would produce too many automaton candidates
+constexpr size_t kMinLiteralLength = 3;
+
+struct TypeOption {
+    const char* name;
+    uint32_t type;
+};
+
+constexpr TypeOption kTypeOptions[] = {
+    {"script", kContentScript},
+    {"image", kContentImage},
+    {"stylesheet", kContentStylesheet},
+    {"xmlhttprequest", kContentXmlHttpRequest},
+    {"subdocument", kContentSubdocument},
+    {"font", kContentFont},
+    {"media", kContentMedia},
+    {"object", kContentObject},
+    {"ping", kContentPing},
+    {"websocket", kContentWebSocket},
+    {"other", kContentOther},
+};
+
+char ToLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+void ToLower(std::string_view in, std::string* out) {
+    out->resize(in.size());
+    for (size_t i = 0; i < in.size(); ++i) {
+        (*out)[i] = ToLower(in[i]);
+    }
+}
+
+std::string_view Trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// Characters matched by '^': anything but a letter, digit or one of "_-.%".
+// The end of the URL also matches '^'.
+bool IsSeparator(char c) {
+    unsigned char u = static_cast<unsigned char>(c);
+    return !((u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || (u >= '0' && u <= '9') ||
+             u == '_' || u == '-' || u == '.' || u == '%' || u >= 0x80);
+}
+
+bool IsHostChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '.';
+}
+
+// Match |pattern| ('*' and '^' wildcards) against a prefix of |s|, or all of
+// it if |anchor_end|. A |floating| match may also start anywhere in |s|.
+// Greedy with backtracking to the most recent '*', like MatchURLPattern().
+bool MatchGlob(std::string_view pattern, std::string_view s, bool floating, bool anchor_end) {
+    size_t p = 0;
+    size_t u = 0;
+    size_t star_p = 0;
+    size_t star_u = 0;
+    bool has_star = floating;
+
+    while (true) {
+        if (p == pattern.size()) {
+            if (!anchor_end || u == s.size()) {
+                return true;
+            }
+        } else if (pattern[p] == '*') {
+            star_p = ++p;
+            star_u = u;
+            has_star = true;
+            continue;
+        } else if (u < s.size() &&
+                   (pattern[p] == s[u] || (pattern[p] == '^' && IsSeparator(s[u])))) {
+            ++p;
+            ++u;
+            continue;
+        } else if (u == s.size() && pattern[p] == '^') {
+            ++p;
+            continue;
+        }
+
+        if (!has_star || star_u >= s.size()) {
+            return false;
+        }
+        p = star_p;
+        u = ++star_u;
+    }
+}
+
+// Whether |host| is |domain| or one of its subdomains
+bool IsSameOrSubdomain(std::string_view host, std::string_view domain) {
+    if (host.size() < domain.size() || host.substr(host.size() - domain.size()) != domain) {
+        return false;
+    }
+    return host.size() == domain.size() || host[host.size() - domain.size() - 1] == '.';
+}
+
+// Approximate registrable domain of |host|
+std::string_view GetSite(std::string_view host) {
+    size_t last = host.rfind('.');
+    if (last == std::string_view::npos || last == 0) {
+        return host;
+    }
+    size_t second = host.rfind('.', last - 1);
+    if (second == std::string_view::npos) {
+        return host;
+    }
+
+    // Country-code second-level domains such as "co.uk" or "com.au"
+    if (host.size() - last - 1 == 2 && last - second - 1 <= 3 && second > 0) {
+        size_t third = host.rfind('.', second - 1);
+        return third == std::string_view::npos ? host : host.substr(third + 1);
+    }
+    return host.substr(second + 1);
+}
+
+// FNV-1a
+uint64_t HashHost(std::string_view host) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : host) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Longest run of literal characters in |pattern|
+std::string_view LongestLiteral(std::string_view pattern) {
+    std::string_view best;
+    size_t begin = 0;
+    for (size_t i = 0; i <= pattern.size(); ++i) {
+        if (i == pattern.size() || pattern[i] == '*' || pattern[i] == '^') {
+            if (i - begin > best.size()) {
+                best = pattern.substr(begin, i - begin);
+            }
+            begin = i + 1;
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+// ============================================================================
+// Rule
+// ============================================================================
+
+struct ContentBlocker::Rule {
+    enum class Party : uint8_t { kAny, kThird, kFirst };
+
+    // Line from the filter list
+    std::string text;
+
+    // Lower-case pattern without anchors and options
+    std::string pattern;
+
+    bool exception = false;
+    bool host_anchor = false;   // "||"
+    bool start_anchor = false;  // leading "|"
+    bool end_anchor = false;    // trailing "|"
+
+    uint32_t types = kContentDefaultTypes;
+    Party party = Party::kAny;
+
+    // $domain= lists; the rule applies on documents from |domains| (if any)
+    // and never on documents from |excluded_domains|
+    std::vector<std::string> domains;
+    std::vector<std::string> excluded_domains;
+};
+
+// ============================================================================
+// Aho-Corasick automaton over rule literals
+// ============================================================================
+
+class ContentBlocker::Automaton {
+public:
+    Automaton() : build_nodes_(1) {}
+
+    // Report |rule| whenever |literal| occurs in a scanned text
+    void Add(std::string_view literal, uint32_t rule) {
+        uint32_t node = 0;
+        for (char c : literal) {
+            // Characters are mapped to dense classes; 0 is for characters
+            // that occur in no literal
+            uint16_t& char_class = classes_[static_cast<unsigned char>(c)];
+            if (char_class == 0) {
+                char_class = ++class_count_;
+            }
+            uint32_t next = FindChild(node, char_class);
+            if (next == kNoRule) {
+                next = static_cast<uint32_t>(build_nodes_.size());
+                build_nodes_[node].children.emplace_back(char_class, next);
+                build_nodes_.emplace_back();
+            }
+            node = next;
+        }
+        build_nodes_[node].outputs.push_back(rule);
+    }
+
+    // Compute failure links and flatten the trie into arrays. Nodes are
+    // renumbered breadth-first so the shallow nodes, which a scan visits most,
+    // share cache lines; the root and its children get dense transition rows.
+    void Build() {
+        const size_t count = build_nodes_.size();
+
+        std::vector<uint32_t> order;
+        std::vector<uint32_t> id(count);
+        std::vector<uint32_t> fail(count, 0);
+        order.reserve(count);
+        order.push_back(0);
+        for (size_t i = 0; i < order.size(); ++i) {
+            const uint32_t node = order[i];
+            id[node] = static_cast<uint32_t>(i);
+            auto& children = build_nodes_[node].children;
+            std::sort(children.begin(), children.end());
+            for (const auto& [c, child] : children) {
+                if (node != 0) {
+                    uint32_t f = fail[node];
+                    while (f != 0 && FindChild(f, c) == kNoRule) {
+                        f = fail[f];
+                    }
+                    uint32_t target = FindChild(f, c);
+                    fail[child] = target != kNoRule ? target : 0;
+                }
+                order.push_back(child);
+            }
+        }
+
+        nodes_.resize(count + 1);
+        for (size_t i = 0; i < count; ++i) {
+            const BuildNode& build = build_nodes_[order[i]];
+            Node& node = nodes_[i];
+            node.fail = id[fail[order[i]]];
+            node.edges = static_cast<uint32_t>(edges_.size());
+            node.outputs = static_cast<uint32_t>(outputs_.size());
+            for (const auto& [c, child] : build.children) {
+                edges_.push_back({c, id[child]});
+            }
+            outputs_.insert(outputs_.end(), build.outputs.begin(), build.outputs.end());
+        }
+        nodes_[count].edges = static_cast<uint32_t>(edges_.size());
+        nodes_[count].outputs = static_cast<uint32_t>(outputs_.size());
+
+        // Parents precede children, so failure targets are resolved first
+        for (size_t i = 1; i < count; ++i) {
+            const Node& fail_node = nodes_[nodes_[i].fail];
+            nodes_[i].dict = HasOutputs(nodes_[i].fail) ? nodes_[i].fail : fail_node.dict;
+        }
+
+        // Nodes up to depth kDenseDepth are contiguous from 0 in BFS order
+        dense_count_ = 1;
+        for (size_t depth = 0, level_end = 1; depth < kDenseDepth; ++depth) {
+            uint32_t next_end = nodes_[level_end].edges - nodes_[0].edges + 1;
+            if (next_end > kMaxDenseNodes) {
+                break;
+            }
+            dense_count_ = next_end;
+            level_end = next_end;
+        }
+        const size_t row_size = class_count_ + 1;
+        dense_.assign(dense_count_ * row_size, 0);
+        for (uint32_t node = 0; node < dense_count_; ++node) {
+            uint32_t* row = &dense_[node * row_size];
+            if (node != 0) {
+                // Failure targets are shallower, so their rows are complete
+                const uint32_t* fail_row = &dense_[nodes_[node].fail * row_size];
+                std::copy(fail_row, fail_row + row_size, row);
+            }
+            for (uint32_t e = nodes_[node].edges; e < nodes_[node + 1].edges; ++e) {
+                row[edges_[e].c] = edges_[e].target;
+            }
+        }
+
+        build_nodes_.clear();
+        build_nodes_.shrink_to_fit();
+    }
+
+    // Call |visit| with the rule of every literal occurrence in |text|
+    template <typename Visitor>
+    void Scan(std::string_view text, Visitor&& visit) const {
+        uint32_t node = 0;
+        for (char c : text) {
+            node = Next(node, classes_[static_cast<unsigned char>(c)]);
+            uint32_t match = HasOutputs(node) ? node : nodes_[node].dict;
+            for (; match != kNoRule; match = nodes_[match].dict) {
+                for (uint32_t i = nodes_[match].outputs; i < nodes_[match + 1].outputs; ++i) {
+                    visit(outputs_[i]);
+                }
+            }
+        }
+    }
+
+private:
+    // Nodes this shallow get a full transition row, up to a limit
+    static constexpr size_t kDenseDepth = 2;
+    static constexpr uint32_t kMaxDenseNodes = 4096;
+
+    struct BuildNode {
+        std::vector<std::pair<uint16_t, uint32_t>> children;
+        std::vector<uint32_t> outputs;
+    };
+
+    // Edges and outputs of node n are [n.edges, (n + 1).edges) and
+    // [n.outputs, (n + 1).outputs)
+    struct Node {
+        uint32_t edges = 0;
+        uint32_t outputs = 0;
+        uint32_t fail = 0;
+
+        // Nearest node on the failure chain with outputs, or kNoRule
+        uint32_t dict = kNoRule;
+    };
+
+    struct Edge {
+        uint16_t c;
+        uint32_t target;
+    };
+
+    uint32_t FindChild(uint32_t node, uint16_t c) const {
+        for (const auto& [child_char, child] : build_nodes_[node].children) {
+            if (child_char == c) {
+                return child;
+            }
+        }
+        return kNoRule;
+    }
+
+    uint32_t Next(uint32_t node, uint16_t c) const {
+        if (c == 0) {
+            return 0;
+        }
+        while (node >= dense_count_) {
+            // Most nodes have one or two edges, so a linear scan is fastest
+            for (uint32_t e = nodes_[node].edges; e < nodes_[node + 1].edges; ++e) {
+                if (edges_[e].c == c) {
+                    return edges_[e].target;
+                }
+            }
+            node = nodes_[node].fail;
+        }
+        return dense_[node * (class_count_ + 1) + c];
+    }
+
+    bool HasOutputs(uint32_t node) const {
+        return nodes_[node].outputs != nodes_[node + 1].outputs;
+    }
+
+    std::vector<BuildNode> build_nodes_;
+
+    uint16_t classes_[256] = {};
+    uint16_t class_count_ = 0;
+
+    // Breadth-first nodes plus a sentinel
+    std::vector<Node> nodes_;
+    std::vector<Edge> edges_;
+    std::vector<uint32_t> outputs_;
+
+    // Full transition rows of the first |dense_count_| nodes
+    std::vector<uint32_t> dense_;
+    size_t dense_count_ = 1;
+};
+
+// ============================================================================
+// ContentBlocker
+// ============================================================================
+
+ContentBlocker::ContentBlocker() = default;
+
+ContentBlocker::~ContentBlocker() = default;
+
+size_t ContentBlocker::AddRules(std::string_view list) {
+    size_t accepted = 0;
+    while (!list.empty()) {
+        size_t end = list.find('\n');
+        std::string_view line = list.substr(0, end);
+        list.remove_prefix(end == std::string_view::npos ? list.size() : end + 1);
+
+        Rule rule;
+        if (ParseRule(Trim(line), &rule)) {
+            rules_.push_back(std::move(rule));
+            ++accepted;
+        }
+    }
+    return accepted;
+}
+
+bool ContentBlocker::ParseRule(std::string_view line, Rule* rule) const {
+    // Comments, list headers and cosmetic filters
+    if (line.empty() || line[0] == '!' || line[0] == '[') {
+        return false;
+    }
+    for (const char* marker : {"##", "#@#", "#?#", "#$#"}) {
+        if (line.find(marker) != std::string_view::npos) {
+            return false;
+        }
+    }
+
+    rule->text = std::string(line);
+
+    if (line.substr(0, 2) == "@@") {
+        rule->exception = true;
+        line.remove_prefix(2);
+    }
+
+    size_t dollar = line.rfind('$');
+    if (dollar != std::string_view::npos) {
+        std::string options;
+        ToLower(line.substr(dollar + 1), &options);
+        line = line.substr(0, dollar);
+
+        uint32_t included = 0;
+        uint32_t excluded = 0;
+        std::string_view rest = options;
+        while (!rest.empty()) {
+            size_t comma = rest.find(',');
+            std::string_view option = Trim(rest.substr(0, comma));
+            rest.remove_prefix(comma == std::string_view::npos ? rest.size() : comma + 1);
+
+            bool negated = !option.empty() && option[0] == '~';
+            std::string_view name = negated ? option.substr(1) : option;
+
+            if (uint32_t type = GetContentTypeByName(name)) {
+                (negated ? excluded : included) |= type;
+            } else if (name == "third-party" || name == "3p") {
+                rule->party = negated ? Rule::Party::kFirst : Rule::Party::kThird;
+            } else if (name == "first-party" || name == "1p") {
+                rule->party = negated ? Rule::Party::kThird : Rule::Party::kFirst;
+            } else if (!negated && name.substr(0, 7) == "domain=") {
+                std::string_view domains = name.substr(7);
+                while (!domains.empty()) {
+                    size_t bar = domains.find('|');
+                    std::string_view domain = domains.substr(0, bar);
+                    domains.remove_prefix(bar == std::string_view::npos ? domains.size()
+                                                                        : bar + 1);
+                    if (!domain.empty() && domain[0] == '~') {
+                        rule->excluded_domains.emplace_back(domain.substr(1));
+                    } else if (!domain.empty()) {
+                        rule->domains.emplace_back(domain);
+                    }
+                }
+            } else if (name == "match-case") {
+                // Matching is always case-insensitive; a superset is fine
+            } else {
+                return false;
+            }
+        }
+
+        rule->types = (included ? included : kContentDefaultTypes) & ~excluded;
+        if (rule->types == 0) {
+            return false;
+        }
+    }
+
+    // Regular expressions
+    if (line.size() > 1 && line.front() == '/' && line.back() == '/') {
+        return false;
+    }
+
+    if (line.substr(0, 2) == "||") {
+        rule->host_anchor = true;
+        line.remove_prefix(2);
+    } else if (line.substr(0, 1) == "|") {
+        rule->start_anchor = true;
+        line.remove_prefix(1);
+    }
+    if (!line.empty() && line.back() == '|') {
+        rule->end_anchor = true;
+        line.remove_suffix(1);
+    }
+
+    ToLower(line, &rule->pattern);
+
+    // A pattern that matches everything needs options to narrow it down
+    if (rule->pattern.find_first_not_of('*') == std::string::npos &&
+        rule->types == kContentDefaultTypes && rule->party == Rule::Party::kAny &&
+        rule->domains.empty()) {
+        return false;
+    }
+    return true;
+}
+
+void ContentBlocker::Compile() {
+    hits_ = std::make_unique<std::atomic<uint64_t>[]>(rules_.size());
+    for (size_t i = 0; i < rules_.size(); ++i) {
+        hits_[i].store(0, std::memory_order_relaxed);
+    }
+
+    unindexed_rules_.clear();
+    automaton_ = std::make_unique<Automaton>();
+    std::vector<HostEntry> host_entries;
+
+    for (size_t i = 0; i < rules_.size(); ++i) {
+        const Rule& rule = rules_[i];
+        const uint32_t index = static_cast<uint32_t>(i);
+        std::string_view pattern = rule.pattern;
+
+        // "||host^" matches exactly the requests to host and its subdomains
+        if (rule.host_anchor && !rule.end_anchor && pattern.size() > 1 && pattern.back() == '^' &&
+            std::all_of(pattern.begin(), pattern.end() - 1, IsHostChar)) {
+            host_entries.push_back({HashHost(pattern.substr(0, pattern.size() - 1)), index});
+            continue;
+        }
+
+        std::string_view literal = LongestLiteral(pattern);
+        if (literal.size() < kMinLiteralLength) {
+            unindexed_rules_.push_back(index);
+        } else {
+            automaton_->Add(literal, index);
+        }
+    }
+
+    automaton_->Build();
+
+    // At most half full, so probe sequences stay short
+    size_t table_size = 16;
+    while (table_size < host_entries.size() * 2) {
+        table_size *= 2;
+    }
+    host_table_.assign(table_size, HostEntry());
+    for (const HostEntry& entry : host_entries) {
+        size_t slot = entry.hash & (table_size - 1);
+        while (host_table_[slot].rule != kNoRule) {
+            slot = (slot + 1) & (table_size - 1);
+        }
+        host_table_[slot] = entry;
+    }
+}
+
+bool ContentBlocker::ShouldBlock(const ContentRequest& request) const {
+    if (!automaton_) {
+        return false;
+    }
+    requests_.fetch_add(1, std::memory_order_relaxed);
+
+    // Reused per thread so matching does not allocate
+    thread_local std::string url_buffer;
+    thread_local std::string document_buffer;
+    thread_local std::vector<uint32_t> exceptions;
+
+    ToLower(request.url, &url_buffer);
+    ToLower(request.document_url, &document_buffer);
+    const std::string_view url = url_buffer;
+    const std::string_view host = GetHost(url);
+    const std::string_view document_host = GetHost(document_buffer);
+
+    // Block with the first matching rule; exceptions are only checked if a
+    // rule matched
+    uint32_t blocking = kNoRule;
+    exceptions.clear();
+    auto consider = [&](uint32_t index) {
+        const Rule& rule = rules_[index];
+        if (rule.exception) {
+            exceptions.push_back(index);
+        } else if (blocking == kNoRule && Matches(rule, request, url, host, document_host)) {
+            blocking = index;
+        }
+    };
+
+    // Probe the host and each parent domain
+    const size_t mask = host_table_.size() - 1;
+    std::string_view domain = host;
+    while (!domain.empty()) {
+        const uint64_t hash = HashHost(domain);
+        for (size_t slot = hash & mask; host_table_[slot].rule != kNoRule;
+             slot = (slot + 1) & mask) {
+            if (host_table_[slot].hash == hash) {
+                consider(host_table_[slot].rule);
+            }
+        }
+        size_t dot = domain.find('.');
+        domain.remove_prefix(dot == std::string_view::npos ? domain.size() : dot + 1);
+    }
+
+    automaton_->Scan(url, consider);
+    for (uint32_t index : unindexed_rules_) {
+        consider(index);
+    }
+
+    if (blocking == kNoRule) {
+        return false;
+    }
+
+    for (uint32_t index : exceptions) {
+        if (Matches(rules_[index], request, url, host, document_host)) {
+            hits_[index].fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    hits_[blocking].fetch_add(1, std::memory_order_relaxed);
+    blocked_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ContentBlocker::Matches(const Rule& rule, const ContentRequest& request, std::string_view url,
+                             std::string_view host, std::string_view document_host) const {
+    // Cheap checks first
+    if (!(rule.types & request.type)) {
+        return false;
+    }
+
+    if (rule.party != Rule::Party::kAny) {
+        if (document_host.empty()) {
+            return false;
+        }
+        bool third_party = IsThirdParty(host, document_host);
+        if (third_party != (rule.party == Rule::Party::kThird)) {
+            return false;
+        }
+    }
+
+    if (!rule.domains.empty() || !rule.excluded_domains.empty()) {
+        for (const std::string& domain : rule.excluded_domains) {
+            if (IsSameOrSubdomain(document_host, domain)) {
+                return false;
+            }
+        }
+        if (!rule.domains.empty() &&
+            std::none_of(rule.domains.begin(), rule.domains.end(),
+                         [&](const std::string& domain) {
+                             return IsSameOrSubdomain(document_host, domain);
+                         })) {
+            return false;
+        }
+    }
+
+    if (rule.start_anchor) {
+        return MatchGlob(rule.pattern, url, false, rule.end_anchor);
+    }
+
+    if (rule.host_anchor) {
+        // Match at the start of the host or of any of its labels
+        if (host.empty()) {
+            return false;
+        }
+        const size_t host_begin = host.data() - url.data();
+        const size_t host_end = host_begin + host.size();
+        for (size_t start = host_begin; start < host_end;) {
+            if (MatchGlob(rule.pattern, url.substr(start), false, rule.end_anchor)) {
+                return true;
+            }
+            size_t dot = url.find('.', start);
+            if (dot == std::string_view::npos || dot >= host_end) {
+                break;
+            }
+            start = dot + 1;
+        }
+        return false;
+    }
+
+    return MatchGlob(rule.pattern, url, true, rule.end_anchor);
+}
+
+size_t ContentBlocker::rule_count() const {
+    return rules_.size();
+}
+
+uint64_t ContentBlocker::rule_hits(size_t index) const {
+    return hits_ ? hits_[index].load(std::memory_order_relaxed) : 0;
+}
+
+const std::string& ContentBlocker::rule_text(size_t index) const {
+    return rules_[index].text;
+}
+
+void ContentBlocker::WriteJson(JsonWriter& writer) const {
+    std::vector<std::pair<uint64_t, size_t>> hit_rules;
+    for (size_t i = 0; i < rules_.size(); ++i) {
+        uint64_t hits = rule_hits(i);
+        if (hits > 0) {
+            hit_rules.emplace_back(hits, i);
+        }
+    }
+    std::sort(hit_rules.begin(), hit_rules.end(),
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    writer.BeginObject();
+    writer.Key("requests").Uint(requests_.load(std::memory_order_relaxed));
+    writer.Key("blocked").Uint(blocked_.load(std::memory_order_relaxed));
+    writer.Key("rules").BeginArray();
+    for (const auto& [hits, index] : hit_rules) {
+        writer.BeginObject();
+        writer.Key("rule").String(rules_[index].text);
+        writer.Key("hits").Uint(hits);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+}
+
+uint32_t GetContentTypeByName(std::string_view name) {
+    auto type = std::find_if(std::begin(kTypeOptions), std::end(kTypeOptions),
+                             [name](const TypeOption& t) { return name == t.name; });
+    return type != std::end(kTypeOptions) ? type->type : 0;
+}
+
+std::string_view ContentBlocker::GetHost(std::string_view url) {
+    size_t scheme_end = url.find("://");
+    if (scheme_end == std::string_view::npos) {
+        return {};
+    }
+    std::string_view authority = url.substr(scheme_end + 3);
+    authority = authority.substr(0, authority.find_first_of("/?#"));
+
+    size_t at = authority.rfind('@');
+    if (at != std::string_view::npos) {
+        authority.remove_prefix(at + 1);
+    }
+
+    // IPv6 literals keep their brackets
+    if (!authority.empty() && authority[0] == '[') {
+        size_t close = authority.find(']');
+        return close == std::string_view::npos ? authority : authority.substr(0, close + 1);
+    }
+    return authority.substr(0, authority.find(':'));
+}
+
+bool ContentBlocker::IsThirdParty(std::string_view host, std::string_view other) {
+    if (host.empty() || other.empty()) {
+        return false;
+    }
+    return GetSite(host) != GetSite(other);
+}
@@ -0,0 +1,116 @@
+// CEF Browser - Content Blocking Request Handler Implementation
+#include "content_blocking_handler.h"
+#include "mapped_file.h"
+
+#include <memory>
+
+#include "include/base/cef_logging.h"
+
+namespace {
+
+std::unique_ptr<ContentBlocker> g_blocker;
+CefRefPtr<ContentBlockingHandler> g_handler;
+
+}  // namespace
+
+ContentBlockingHandler::ContentBlockingHandler(const ContentBlocker* blocker)
+    : blocker_(blocker) {}
+
+CefResourceRequestHandler::ReturnValue ContentBlockingHandler::OnBeforeResourceLoad(
+    CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request,
+    CefRefPtr<CefCallback> callback) {
+    return IsBlocked(*blocker_, frame, request) ? RV_CANCEL : RV_CONTINUE;
+}
+
+bool ContentBlockingHandler::IsBlocked(const ContentBlocker& blocker, CefRefPtr<CefFrame> frame,
+                                       CefRefPtr<CefRequest> request) {
+    const cef_resource_type_t resource_type = request->GetResourceType();
+
+    // Documents are never blocked, only what they load
+    if (resource_type == RT_MAIN_FRAME) {
+        return false;
+    }
+
+    // A subframe's own request belongs to its parent document
+    CefRefPtr<CefFrame> document = frame;
+    if (document && resource_type == RT_SUB_FRAME && document->GetParent()) {
+        document = document->GetParent();
+    }
+
+    const std::string url = request->GetURL().ToString();
+    const std::string document_url =
+        document ? document->GetURL().ToString() : request->GetReferrerURL().ToString();
+
+    ContentRequest content_request;
+    content_request.url = url;
+    content_request.document_url = document_url;
+    content_request.type = GetContentType(resource_type, url);
+
+    return blocker.ShouldBlock(content_request);
+}
+
+ContentType ContentBlockingHandler::GetContentType(cef_resource_type_t resource_type,
+                                                   const std::string& url) {
+    if (url.rfind("ws://", 0) == 0 || url.rfind("wss://", 0) == 0) {
+        return kContentWebSocket;
+    }
+
+    switch (resource_type) {
+        case RT_SUB_FRAME:
+            return kContentSubdocument;
+        case RT_STYLESHEET:
+            return kContentStylesheet;
+        case RT_SCRIPT:
+        case RT_WORKER:
+        case RT_SHARED_WORKER:
+        case RT_SERVICE_WORKER:
+            return kContentScript;
+        case RT_IMAGE:
+        case RT_FAVICON:
+            return kContentImage;
+        case RT_FONT_RESOURCE:
+            return kContentFont;
+        case RT_MEDIA:
+            return kContentMedia;
+        case RT_OBJECT:
+        case RT_PLUGIN_RESOURCE:
+            return kContentObject;
+        case RT_XHR:
+            return kContentXmlHttpRequest;
+        case RT_PING:
+        case RT_CSP_REPORT:
+            return kContentPing;
+        default:
+            return kContentOther;
+    }
+}
+
+bool InitContentBlocker(const std::vector<std::string>& paths) {
+    auto blocker = std::make_unique<ContentBlocker>();
+    size_t rules = 0;
+    for (const std::string& path : paths) {
+        MappedFile file;
+        if (!file.Open(path)) {
+            LOG(WARNING) << "Cannot read filter list " << path;
+            continue;
+        }
+        rules += blocker->AddRules(std::string_view(file.data(), file.size()));
+    }
+
+    if (rules == 0) {
+        return false;
+    }
+
+    blocker->Compile();
+    g_blocker = std::move(blocker);
+    g_handler = new ContentBlockingHandler(g_blocker.get());
+    return true;
+}
+
+const ContentBlocker* GetContentBlocker() {
+    return g_blocker.get();
+}
+
+CefRefPtr<CefResourceRequestHandler> GetContentBlockingHandler() {
+    return g_handler;
+}
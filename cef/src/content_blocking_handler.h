@@ -0,0 +1,49 @@
+// CEF Browser - Content Blocking Request Handler
+#ifndef CEF_BROWSER_CONTENT_BLOCKING_HANDLER_H_
+#define CEF_BROWSER_CONTENT_BLOCKING_HANDLER_H_
+
+#include <string>
+#include <vector>
+
+#include "include/cef_resource_request_handler.h"
+
+#include "content_blocker.h"
+
+// Cancels subresource requests that the process-wide ContentBlocker blocks.
+// Called on the IO thread; the blocker is immutable once initialized.
+class ContentBlockingHandler : public CefResourceRequestHandler {
+public:
+    explicit ContentBlockingHandler(const ContentBlocker* blocker);
+
+    // CefResourceRequestHandler methods
+    ReturnValue OnBeforeResourceLoad(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                     CefRefPtr<CefRequest> request,
+                                     CefRefPtr<CefCallback> callback) override;
+
+    // Whether |blocker| blocks |request|, made by |frame|. Main frame requests
+    // are never blocked.
+    static bool IsBlocked(const ContentBlocker& blocker, CefRefPtr<CefFrame> frame,
+                          CefRefPtr<CefRequest> request);
+
+    // Filter rule type of a request of |resource_type| to |url|
+    static ContentType GetContentType(cef_resource_type_t resource_type, const std::string& url);
+
+private:
+    const ContentBlocker* blocker_;
+
+    IMPLEMENT_REFCOUNTING(ContentBlockingHandler);
+    DISALLOW_COPY_AND_ASSIGN(ContentBlockingHandler);
+};
+
+// Load and compile the filter lists at |paths|. Called once in the browser
+// process before any browser is created. Returns false if no rules could be
+// loaded, in which case blocking stays disabled.
+bool InitContentBlocker(const std::vector<std::string>& paths);
+
+// Get the process-wide content blocker, or nullptr if blocking is disabled
+const ContentBlocker* GetContentBlocker();
+
+// Get the shared request handler, or nullptr if blocking is disabled
+CefRefPtr<CefResourceRequestHandler> GetContentBlockingHandler();
+
+#endif  // CEF_BROWSER_CONTENT_BLOCKING_HANDLER_H_
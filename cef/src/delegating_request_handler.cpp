@@ -0,0 +1,67 @@
+// CEF Browser - Delegating Resource Request Handler Implementation
+#include "delegating_request_handler.h"
+
+DelegatingRequestHandler::DelegatingRequestHandler(CefRefPtr<CefResourceRequestHandler> handler)
+    : handler_(handler) {}
+
+CefRefPtr<CefCookieAccessFilter> DelegatingRequestHandler::GetCookieAccessFilter(
+    CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request) {
+    return handler_ ? handler_->GetCookieAccessFilter(browser, frame, request) : nullptr;
+}
+
+CefResourceRequestHandler::ReturnValue DelegatingRequestHandler::OnBeforeResourceLoad(
+    CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request,
+    CefRefPtr<CefCallback> callback) {
+    return handler_ ? handler_->OnBeforeResourceLoad(browser, frame, request, callback)
+                    : RV_CONTINUE;
+}
+
+CefRefPtr<CefResourceHandler> DelegatingRequestHandler::GetResourceHandler(
+    CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request) {
+    return handler_ ? handler_->GetResourceHandler(browser, frame, request) : nullptr;
+}
+
+void DelegatingRequestHandler::OnResourceRedirect(CefRefPtr<CefBrowser> browser,
+                                                  CefRefPtr<CefFrame> frame,
+                                                  CefRefPtr<CefRequest> request,
+                                                  CefRefPtr<CefResponse> response,
+                                                  CefString& new_url) {
+    if (handler_) {
+        handler_->OnResourceRedirect(browser, frame, request, response, new_url);
+    }
+}
+
+bool DelegatingRequestHandler::OnResourceResponse(CefRefPtr<CefBrowser> browser,
+                                                  CefRefPtr<CefFrame> frame,
+                                                  CefRefPtr<CefRequest> request,
+                                                  CefRefPtr<CefResponse> response) {
+    return handler_ ? handler_->OnResourceResponse(browser, frame, request, response) : false;
+}
+
+CefRefPtr<CefResponseFilter> DelegatingRequestHandler::GetResourceResponseFilter(
+    CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request,
+    CefRefPtr<CefResponse> response) {
+    return handler_ ? handler_->GetResourceResponseFilter(browser, frame, request, response)
+                    : nullptr;
+}
+
+void DelegatingRequestHandler::OnResourceLoadComplete(CefRefPtr<CefBrowser> browser,
+                                                      CefRefPtr<CefFrame> frame,
+                                                      CefRefPtr<CefRequest> request,
+                                                      CefRefPtr<CefResponse> response,
+                                                      URLRequestStatus status,
+                                                      int64_t received_content_length) {
+    if (handler_) {
+        handler_->OnResourceLoadComplete(browser, frame, request, response, status,
+                                         received_content_length);
+    }
+}
+
+void DelegatingRequestHandler::OnProtocolExecution(CefRefPtr<CefBrowser> browser,
+                                                   CefRefPtr<CefFrame> frame,
+                                                   CefRefPtr<CefRequest> request,
+                                                   bool& allow_os_execution) {
+    if (handler_) {
+        handler_->OnProtocolExecution(browser, frame, request, allow_os_execution);
+    }
+}
@@ -0,0 +1,45 @@
+// CEF Browser - Delegating Resource Request Handler
+#ifndef CEF_BROWSER_DELEGATING_REQUEST_HANDLER_H_
+#define CEF_BROWSER_DELEGATING_REQUEST_HANDLER_H_
+
+#include "include/cef_resource_request_handler.h"
+
+// Resource request handler that forwards every call to another handler, or
+// does what CEF does without one if that is null. Handlers that observe or
+// alter some requests derive from it so they can be chained with the archive
+// and blocking handlers.
+class DelegatingRequestHandler : public CefResourceRequestHandler {
+public:
+    explicit DelegatingRequestHandler(CefRefPtr<CefResourceRequestHandler> handler);
+
+    // CefResourceRequestHandler methods
+    CefRefPtr<CefCookieAccessFilter> GetCookieAccessFilter(CefRefPtr<CefBrowser> browser,
+                                                           CefRefPtr<CefFrame> frame,
+                                                           CefRefPtr<CefRequest> request) override;
+    ReturnValue OnBeforeResourceLoad(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                     CefRefPtr<CefRequest> request,
+                                     CefRefPtr<CefCallback> callback) override;
+    CefRefPtr<CefResourceHandler> GetResourceHandler(CefRefPtr<CefBrowser> browser,
+                                                     CefRefPtr<CefFrame> frame,
+                                                     CefRefPtr<CefRequest> request) override;
+    void OnResourceRedirect(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                            CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response,
+                            CefString& new_url) override;
+    bool OnResourceResponse(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                            CefRefPtr<CefRequest> request,
+                            CefRefPtr<CefResponse> response) override;
+    CefRefPtr<CefResponseFilter> GetResourceResponseFilter(
+        CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request,
+        CefRefPtr<CefResponse> response) override;
+    void OnResourceLoadComplete(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response,
+                                URLRequestStatus status,
+                                int64_t received_content_length) override;
+    void OnProtocolExecution(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                             CefRefPtr<CefRequest> request, bool& allow_os_execution) override;
+
+protected:
+    CefRefPtr<CefResourceRequestHandler> handler_;
+};
+
+#endif  // CEF_BROWSER_DELEGATING_REQUEST_HANDLER_H_
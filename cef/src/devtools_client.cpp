@@ -0,0 +1,538 @@
+// CEF Browser - In-process DevTools Client Implementation
+#include "devtools_client.h"
+#include "devtools_message.h"
+
+#include <utility>
+
+#include "include/cef_devtools_message_observer.h"
+#include "include/cef_parser.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace {
+
+CefRefPtr<CefDictionaryValue> ParseObject(std::string_view json) {
+    if (json.empty()) {
+        return nullptr;
+    }
+    CefRefPtr<CefValue> value = CefParseJSON(json.data(), json.size(), JSON_PARSER_RFC);
+    if (!value || value->GetType() != VTYPE_DICTIONARY) {
+        return nullptr;
+    }
+    return value->GetDictionary();
+}
+
+// Protocol numbers may arrive as integers or doubles
+double GetNumber(CefRefPtr<CefDictionaryValue> dict, const char* key) {
+    switch (dict->GetType(key)) {
+        case VTYPE_INT:
+            return dict->GetInt(key);
+        case VTYPE_DOUBLE:
+            return dict->GetDouble(key);
+        default:
+            return 0;
+    }
+}
+
+std::string GetString(CefRefPtr<CefDictionaryValue> dict, const char* key) {
+    return dict->GetType(key) == VTYPE_STRING ? dict->GetString(key).ToString() : std::string();
+}
+
+CefRefPtr<CefDictionaryValue> GetObject(CefRefPtr<CefDictionaryValue> dict, const char* key) {
+    return dict->GetType(key) == VTYPE_DICTIONARY ? dict->GetDictionary(key) : nullptr;
+}
+
+// Message of a Runtime exceptionDetails object
+std::string ExceptionText(CefRefPtr<CefDictionaryValue> details) {
+    if (CefRefPtr<CefDictionaryValue> exception = GetObject(details, "exception")) {
+        std::string description = GetString(exception, "description");
+        if (!description.empty()) {
+            return description;
+        }
+    }
+    return GetString(details, "text");
+}
+
+CefRefPtr<CefDictionaryValue> NewParams() {
+    return CefDictionaryValue::Create();
+}
+
+}  // namespace
+
+// Forwards a browser's DevTools messages to the client, if it still exists
+class DevToolsClient::Observer : public CefDevToolsMessageObserver {
+public:
+    explicit Observer(DevToolsClient* client) : client_(client) {}
+
+    void Detach() { client_ = nullptr; }
+
+    bool OnDevToolsMessage(CefRefPtr<CefBrowser> browser, const void* message,
+                           size_t message_size) override {
+        if (client_) {
+            client_->OnMessage(
+                std::string_view(static_cast<const char*>(message), message_size));
+        }
+        // Handled: CEF does not parse the message into results and events
+        return true;
+    }
+
+    void OnDevToolsAgentDetached(CefRefPtr<CefBrowser> browser) override {
+        if (client_) {
+            client_->OnAgentDetached();
+        }
+    }
+
+private:
+    DevToolsClient* client_;
+
+    IMPLEMENT_REFCOUNTING(Observer);
+};
+
+DevToolsClient::DevToolsClient(CefRefPtr<CefBrowser> browser)
+    : browser_(browser),
+      observer_(new Observer(this)),
+      alive_(std::make_shared<bool>(true)),
+      page_(this),
+      runtime_(this),
+      network_(this),
+      storage_(this),
+      emulation_(this) {
+    CEF_REQUIRE_UI_THREAD();
+    registration_ = browser_->GetHost()->AddDevToolsMessageObserver(observer_);
+}
+
+DevToolsClient::~DevToolsClient() {
+    CEF_REQUIRE_UI_THREAD();
+    *alive_ = false;
+    observer_->Detach();
+
+    // Releasing the registration removes the observer
+    registration_ = nullptr;
+}
+
+bool DevToolsClient::Execute(const std::string& method, CefRefPtr<CefDictionaryValue> params,
+                             DevToolsResultCallback callback) {
+    CEF_REQUIRE_UI_THREAD();
+    // Results arrive in a later task, so the id is recorded in time
+    const int id = browser_->GetHost()->ExecuteDevToolsMethod(0, method, params);
+    if (id == 0) {
+        return false;
+    }
+    pending_[id] = std::move(callback);
+    return true;
+}
+
+int DevToolsClient::Subscribe(const std::string& event, DevToolsEventCallback callback) {
+    CEF_REQUIRE_UI_THREAD();
+    const int id = next_subscription_++;
+    subscriptions_[event].push_back({id, std::move(callback)});
+    return id;
+}
+
+void DevToolsClient::Unsubscribe(int subscription) {
+    CEF_REQUIRE_UI_THREAD();
+    for (auto it = subscriptions_.begin(); it != subscriptions_.end(); ++it) {
+        std::vector<Subscription>& subscribers = it->second;
+        for (auto entry = subscribers.begin(); entry != subscribers.end(); ++entry) {
+            if (entry->id == subscription) {
+                subscribers.erase(entry);
+                if (subscribers.empty()) {
+                    subscriptions_.erase(it);
+                }
+                return;
+            }
+        }
+    }
+}
+
+void DevToolsClient::OnMessage(std::string_view message) {
+    DevToolsMessageView view;
+    if (!ScanDevToolsMessage(message, &view)) {
+        return;
+    }
+
+    if (view.id != 0) {
+        auto it = pending_.find(view.id);
+        if (it == pending_.end()) {
+            // Result of another client's call
+            return;
+        }
+        DevToolsResultCallback callback = std::move(it->second);
+        pending_.erase(it);
+        if (!callback) {
+            return;
+        }
+
+        DevToolsResult result;
+        if (!view.error.empty()) {
+            CefRefPtr<CefDictionaryValue> error = ParseObject(view.error);
+            result.error = error ? GetString(error, "message") : "Malformed error";
+        } else {
+            result.value = ParseObject(view.result);
+            result.success = result.value != nullptr;
+            if (!result.success) {
+                result.error = "Malformed result";
+            }
+        }
+        callback(result);
+        return;
+    }
+
+    // Events nobody subscribed to are dropped before their params are parsed
+    auto it = subscriptions_.find(view.method);
+    if (it == subscriptions_.end()) {
+        return;
+    }
+    CefRefPtr<CefDictionaryValue> params = ParseObject(view.params);
+    if (!params) {
+        params = NewParams();
+    }
+
+    // Callbacks may subscribe, unsubscribe or destroy the client
+    const std::string method(view.method);
+    const std::vector<Subscription> subscribers = it->second;
+    std::shared_ptr<bool> alive = alive_;
+    for (const Subscription& subscriber : subscribers) {
+        if (!*alive) {
+            return;
+        }
+        auto current = subscriptions_.find(method);
+        if (current == subscriptions_.end()) {
+            return;
+        }
+        bool subscribed = false;
+        for (const Subscription& entry : current->second) {
+            subscribed |= entry.id == subscriber.id;
+        }
+        if (subscribed) {
+            subscriber.callback(params);
+        }
+    }
+}
+
+void DevToolsClient::OnAgentDetached() {
+    std::map<int, DevToolsResultCallback> pending;
+    pending.swap(pending_);
+
+    DevToolsResult result;
+    result.error = "DevTools agent detached";
+    std::shared_ptr<bool> alive = alive_;
+    for (auto& entry : pending) {
+        if (!*alive) {
+            return;
+        }
+        if (entry.second) {
+            entry.second(result);
+        }
+    }
+}
+
+// Page
+
+void DevToolsPage::Enable(DevToolsResultCallback callback) {
+    client_->Execute("Page.enable", nullptr, std::move(callback));
+}
+
+void DevToolsPage::Navigate(const std::string& url,
+                            std::function<void(const NavigateResult&)> callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetString("url", url);
+    client_->Execute("Page.navigate", params, [callback](const DevToolsResult& result) {
+        NavigateResult navigate;
+        if (result.success) {
+            navigate.frame_id = GetString(result.value, "frameId");
+            navigate.loader_id = GetString(result.value, "loaderId");
+            navigate.error = GetString(result.value, "errorText");
+            navigate.success = navigate.error.empty();
+        } else {
+            navigate.error = result.error;
+        }
+        if (callback) {
+            callback(navigate);
+        }
+    });
+}
+
+void DevToolsPage::Reload(bool ignore_cache, DevToolsResultCallback callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetBool("ignoreCache", ignore_cache);
+    client_->Execute("Page.reload", params, std::move(callback));
+}
+
+void DevToolsPage::SetLifecycleEventsEnabled(bool enabled, DevToolsResultCallback callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetBool("enabled", enabled);
+    client_->Execute("Page.setLifecycleEventsEnabled", params, std::move(callback));
+}
+
+void DevToolsPage::AddScriptToEvaluateOnNewDocument(const std::string& source,
+                                                    DevToolsResultCallback callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetString("source", source);
+    client_->Execute("Page.addScriptToEvaluateOnNewDocument", params, std::move(callback));
+}
+
+void DevToolsPage::CaptureScreenshot(const ScreenshotParams& screenshot,
+                                     std::function<void(const std::string& data)> callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetString("format", screenshot.format);
+    if (screenshot.quality >= 0) {
+        params->SetInt("quality", screenshot.quality);
+    }
+    params->SetBool("fromSurface", screenshot.from_surface);
+    client_->Execute("Page.captureScreenshot", params, [callback](const DevToolsResult& result) {
+        if (callback) {
+            callback(result.success ? GetString(result.value, "data") : std::string());
+        }
+    });
+}
+
+int DevToolsPage::OnLoadEventFired(std::function<void(double timestamp)> callback) {
+    return client_->Subscribe("Page.loadEventFired",
+                              [callback](CefRefPtr<CefDictionaryValue> params) {
+                                  callback(GetNumber(params, "timestamp"));
+                              });
+}
+
+int DevToolsPage::OnDomContentEventFired(std::function<void(double timestamp)> callback) {
+    return client_->Subscribe("Page.domContentEventFired",
+                              [callback](CefRefPtr<CefDictionaryValue> params) {
+                                  callback(GetNumber(params, "timestamp"));
+                              });
+}
+
+int DevToolsPage::OnFrameNavigated(
+    std::function<void(const std::string& frame_id, const std::string& url)> callback) {
+    return client_->Subscribe("Page.frameNavigated",
+                              [callback](CefRefPtr<CefDictionaryValue> params) {
+                                  CefRefPtr<CefDictionaryValue> frame = GetObject(params, "frame");
+                                  if (frame) {
+                                      callback(GetString(frame, "id"), GetString(frame, "url"));
+                                  }
+                              });
+}
+
+int DevToolsPage::OnLifecycleEvent(
+    std::function<void(const std::string& name, const std::string& frame_id, double timestamp)>
+        callback) {
+    return client_->Subscribe("Page.lifecycleEvent",
+                              [callback](CefRefPtr<CefDictionaryValue> params) {
+                                  callback(GetString(params, "name"),
+                                           GetString(params, "frameId"),
+                                           GetNumber(params, "timestamp"));
+                              });
+}
+
+// Runtime
+
+void DevToolsRuntime::Enable(DevToolsResultCallback callback) {
+    client_->Execute("Runtime.enable", nullptr, std::move(callback));
+}
+
+void DevToolsRuntime::Evaluate(const EvaluateParams& evaluate,
+                               std::function<void(const EvaluateResult&)> callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetString("expression", evaluate.expression);
+    params->SetBool("awaitPromise", evaluate.await_promise);
+    params->SetBool("returnByValue", evaluate.return_by_value);
+    client_->Execute("Runtime.evaluate", params, [callback](const DevToolsResult& result) {
+        EvaluateResult evaluated;
+        if (!result.success) {
+            evaluated.error = result.error;
+        } else if (CefRefPtr<CefDictionaryValue> details =
+                       GetObject(result.value, "exceptionDetails")) {
+            evaluated.error = ExceptionText(details);
+        } else if (CefRefPtr<CefDictionaryValue> object = GetObject(result.value, "result")) {
+            evaluated.success = true;
+            evaluated.type = GetString(object, "type");
+            if (object->HasKey("value")) {
+                evaluated.value = object->GetValue("value");
+            }
+        } else {
+            evaluated.error = "Malformed result";
+        }
+        if (callback) {
+            callback(evaluated);
+        }
+    });
+}
+
+int DevToolsRuntime::OnConsoleApiCalled(
+    std::function<void(const std::string& type, CefRefPtr<CefListValue> args)> callback) {
+    return client_->Subscribe("Runtime.consoleAPICalled",
+                              [callback](CefRefPtr<CefDictionaryValue> params) {
+                                  CefRefPtr<CefListValue> args =
+                                      params->GetType("args") == VTYPE_LIST
+                                          ? params->GetList("args")
+                                          : CefListValue::Create();
+                                  callback(GetString(params, "type"), args);
+                              });
+}
+
+int DevToolsRuntime::OnExceptionThrown(std::function<void(const std::string& text)> callback) {
+    return client_->Subscribe("Runtime.exceptionThrown",
+                              [callback](CefRefPtr<CefDictionaryValue> params) {
+                                  CefRefPtr<CefDictionaryValue> details =
+                                      GetObject(params, "exceptionDetails");
+                                  callback(details ? ExceptionText(details) : std::string());
+                              });
+}
+
+// Network
+
+void DevToolsNetwork::Enable(DevToolsResultCallback callback) {
+    client_->Execute("Network.enable", nullptr, std::move(callback));
+}
+
+void DevToolsNetwork::Disable(DevToolsResultCallback callback) {
+    client_->Execute("Network.disable", nullptr, std::move(callback));
+}
+
+void DevToolsNetwork::SetCacheDisabled(bool disabled, DevToolsResultCallback callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetBool("cacheDisabled", disabled);
+    client_->Execute("Network.setCacheDisabled", params, std::move(callback));
+}
+
+void DevToolsNetwork::ClearBrowserCache(DevToolsResultCallback callback) {
+    client_->Execute("Network.clearBrowserCache", nullptr, std::move(callback));
+}
+
+void DevToolsNetwork::SetExtraHttpHeaders(const std::map<std::string, std::string>& headers,
+                                          DevToolsResultCallback callback) {
+    CefRefPtr<CefDictionaryValue> values = CefDictionaryValue::Create();
+    for (const auto& header : headers) {
+        values->SetString(header.first, header.second);
+    }
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetDictionary("headers", values);
+    client_->Execute("Network.setExtraHTTPHeaders", params, std::move(callback));
+}
+
+void DevToolsNetwork::SetBlockedUrls(const std::vector<std::string>& patterns,
+                                     DevToolsResultCallback callback) {
+    CefRefPtr<CefListValue> urls = CefListValue::Create();
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        urls->SetString(i, patterns[i]);
+    }
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetList("urls", urls);
+    client_->Execute("Network.setBlockedURLs", params, std::move(callback));
+}
+
+void DevToolsNetwork::EmulateConditions(const Conditions& conditions,
+                                        DevToolsResultCallback callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetBool("offline", conditions.offline);
+    params->SetDouble("latency", conditions.latency_ms);
+    params->SetDouble("downloadThroughput", conditions.download_throughput);
+    params->SetDouble("uploadThroughput", conditions.upload_throughput);
+    client_->Execute("Network.emulateNetworkConditions", params, std::move(callback));
+}
+
+int DevToolsNetwork::OnRequestWillBeSent(
+    std::function<void(const std::string& request_id, const std::string& url,
+                       const std::string& type)>
+        callback) {
+    return client_->Subscribe("Network.requestWillBeSent",
+                              [callback](CefRefPtr<CefDictionaryValue> params) {
+                                  CefRefPtr<CefDictionaryValue> request =
+                                      GetObject(params, "request");
+                                  callback(GetString(params, "requestId"),
+                                           request ? GetString(request, "url") : std::string(),
+                                           GetString(params, "type"));
+                              });
+}
+
+int DevToolsNetwork::OnLoadingFinished(
+    std::function<void(const std::string& request_id, double encoded_length)> callback) {
+    return client_->Subscribe("Network.loadingFinished",
+                              [callback](CefRefPtr<CefDictionaryValue> params) {
+                                  callback(GetString(params, "requestId"),
+                                           GetNumber(params, "encodedDataLength"));
+                              });
+}
+
+int DevToolsNetwork::OnLoadingFailed(
+    std::function<void(const std::string& request_id, const std::string& error)> callback) {
+    return client_->Subscribe("Network.loadingFailed",
+                              [callback](CefRefPtr<CefDictionaryValue> params) {
+                                  callback(GetString(params, "requestId"),
+                                           GetString(params, "errorText"));
+                              });
+}
+
+// Storage
+
+void DevToolsStorage::ClearDataForOrigin(const std::string& origin,
+                                         const std::string& storage_types,
+                                         DevToolsResultCallback callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetString("origin", origin);
+    params->SetString("storageTypes", storage_types);
+    client_->Execute("Storage.clearDataForOrigin", params, std::move(callback));
+}
+
+// Emulation
+
+void DevToolsEmulation::SetDeviceMetricsOverride(int width, int height,
+                                                 double device_scale_factor, bool mobile,
+                                                 DevToolsResultCallback callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetInt("width", width);
+    params->SetInt("height", height);
+    params->SetDouble("deviceScaleFactor", device_scale_factor);
+    params->SetBool("mobile", mobile);
+    client_->Execute("Emulation.setDeviceMetricsOverride", params, std::move(callback));
+}
+
+void DevToolsEmulation::ClearDeviceMetricsOverride(DevToolsResultCallback callback) {
+    client_->Execute("Emulation.clearDeviceMetricsOverride", nullptr, std::move(callback));
+}
+
+void DevToolsEmulation::SetUserAgentOverride(const std::string& user_agent,
+                                             DevToolsResultCallback callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetString("userAgent", user_agent);
+    client_->Execute("Emulation.setUserAgentOverride", params, std::move(callback));
+}
+
+void DevToolsEmulation::SetCpuThrottlingRate(double rate, DevToolsResultCallback callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetDouble("rate", rate);
+    client_->Execute("Emulation.setCPUThrottlingRate", params, std::move(callback));
+}
+
+void DevToolsEmulation::SetTimezoneOverride(const std::string& timezone_id,
+                                            DevToolsResultCallback callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetString("timezoneId", timezone_id);
+    client_->Execute("Emulation.setTimezoneOverride", params, std::move(callback));
+}
+
+void DevToolsEmulation::SetVirtualTimePolicy(
+    const VirtualTimePolicy& policy, std::function<void(double virtual_time_ticks_base)> callback) {
+    CefRefPtr<CefDictionaryValue> params = NewParams();
+    params->SetString("policy", policy.policy);
+    if (policy.budget_ms > 0) {
+        params->SetDouble("budget", policy.budget_ms);
+    }
+    if (policy.initial_virtual_time > 0) {
+        params->SetDouble("initialVirtualTime", policy.initial_virtual_time);
+    }
+    if (policy.max_task_starvation_count > 0) {
+        params->SetInt("maxVirtualTimeTaskStarvationCount", policy.max_task_starvation_count);
+    }
+    client_->Execute("Emulation.setVirtualTimePolicy", params,
+                     [callback](const DevToolsResult& result) {
+                         if (callback) {
+                             callback(result.success
+                                          ? GetNumber(result.value, "virtualTimeTicksBase")
+                                          : 0);
+                         }
+                     });
+}
+
+int DevToolsEmulation::OnVirtualTimeBudgetExpired(std::function<void()> callback) {
+    return client_->Subscribe("Emulation.virtualTimeBudgetExpired",
+                              [callback](CefRefPtr<CefDictionaryValue>) { callback(); });
+}
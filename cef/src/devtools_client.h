@@ -0,0 +1,279 @@
+// CEF Browser - In-process DevTools Client
+#ifndef CEF_BROWSER_DEVTOOLS_CLIENT_H_
+#define CEF_BROWSER_DEVTOOLS_CLIENT_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "include/cef_browser.h"
+#include "include/cef_values.h"
+
+class DevToolsClient;
+
+// Completion of a DevTools method
+struct DevToolsResult {
+    bool success = false;
+
+    // "result" of the method on success
+    CefRefPtr<CefDictionaryValue> value;
+
+    // Protocol error message on failure
+    std::string error;
+};
+
+using DevToolsResultCallback = std::function<void(const DevToolsResult& result)>;
+using DevToolsEventCallback = std::function<void(CefRefPtr<CefDictionaryValue> params)>;
+
+// Page domain
+class DevToolsPage {
+public:
+    struct NavigateResult {
+        bool success = false;
+        std::string frame_id;
+        std::string loader_id;
+
+        // Network error of the navigation, or the protocol error
+        std::string error;
+    };
+
+    struct ScreenshotParams {
+        // "png", "jpeg" or "webp"
+        std::string format = "png";
+
+        // Compression quality of jpeg and webp, 0-100; -1 for the default
+        int quality = -1;
+
+        bool from_surface = true;
+    };
+
+    explicit DevToolsPage(DevToolsClient* client) : client_(client) {}
+
+    void Enable(DevToolsResultCallback callback = nullptr);
+    void Navigate(const std::string& url, std::function<void(const NavigateResult&)> callback);
+    void Reload(bool ignore_cache, DevToolsResultCallback callback = nullptr);
+    void SetLifecycleEventsEnabled(bool enabled, DevToolsResultCallback callback = nullptr);
+
+    // Evaluate |source| in every new document before its own scripts
+    void AddScriptToEvaluateOnNewDocument(const std::string& source,
+                                          DevToolsResultCallback callback = nullptr);
+
+    // |data| is the base64 encoded image; empty on failure
+    void CaptureScreenshot(const ScreenshotParams& params,
+                           std::function<void(const std::string& data)> callback);
+
+    // Events; Enable() must have been called. Return a subscription id.
+    int OnLoadEventFired(std::function<void(double timestamp)> callback);
+    int OnDomContentEventFired(std::function<void(double timestamp)> callback);
+    int OnFrameNavigated(
+        std::function<void(const std::string& frame_id, const std::string& url)> callback);
+    int OnLifecycleEvent(std::function<void(const std::string& name, const std::string& frame_id,
+                                            double timestamp)>
+                             callback);
+
+private:
+    DevToolsClient* client_;
+};
+
+// Runtime domain
+class DevToolsRuntime {
+public:
+    struct EvaluateParams {
+        std::string expression;
+        bool await_promise = false;
+        bool return_by_value = true;
+    };
+
+    struct EvaluateResult {
+        bool success = false;
+
+        // Remote object type, e.g. "number" or "object"
+        std::string type;
+
+        // The value when returned by value
+        CefRefPtr<CefValue> value;
+
+        // Exception text when the expression threw, or the protocol error
+        std::string error;
+    };
+
+    explicit DevToolsRuntime(DevToolsClient* client) : client_(client) {}
+
+    void Enable(DevToolsResultCallback callback = nullptr);
+    void Evaluate(const EvaluateParams& params,
+                  std::function<void(const EvaluateResult&)> callback);
+
+    // Events; Enable() must have been called. Return a subscription id.
+    int OnConsoleApiCalled(
+        std::function<void(const std::string& type, CefRefPtr<CefListValue> args)> callback);
+    int OnExceptionThrown(std::function<void(const std::string& text)> callback);
+
+private:
+    DevToolsClient* client_;
+};
+
+// Network domain
+class DevToolsNetwork {
+public:
+    struct Conditions {
+        bool offline = false;
+        double latency_ms = 0;
+
+        // Bytes per second; -1 disables throttling
+        double download_throughput = -1;
+        double upload_throughput = -1;
+    };
+
+    explicit DevToolsNetwork(DevToolsClient* client) : client_(client) {}
+
+    void Enable(DevToolsResultCallback callback = nullptr);
+    void Disable(DevToolsResultCallback callback = nullptr);
+    void SetCacheDisabled(bool disabled, DevToolsResultCallback callback = nullptr);
+    void ClearBrowserCache(DevToolsResultCallback callback = nullptr);
+    void SetExtraHttpHeaders(const std::map<std::string, std::string>& headers,
+                             DevToolsResultCallback callback = nullptr);
+    void SetBlockedUrls(const std::vector<std::string>& patterns,
+                        DevToolsResultCallback callback = nullptr);
+    void EmulateConditions(const Conditions& conditions,
+                           DevToolsResultCallback callback = nullptr);
+
+    // Events; Enable() must have been called. Return a subscription id.
+    int OnRequestWillBeSent(std::function<void(const std::string& request_id,
+                                               const std::string& url, const std::string& type)>
+                                callback);
+    int OnLoadingFinished(
+        std::function<void(const std::string& request_id, double encoded_length)> callback);
+    int OnLoadingFailed(
+        std::function<void(const std::string& request_id, const std::string& error)> callback);
+
+private:
+    DevToolsClient* client_;
+};
+
+// Storage domain
+class DevToolsStorage {
+public:
+    explicit DevToolsStorage(DevToolsClient* client) : client_(client) {}
+
+    // |storage_types| is a comma-separated list such as "local_storage,
+    // indexeddb", or "all"
+    void ClearDataForOrigin(const std::string& origin, const std::string& storage_types,
+                            DevToolsResultCallback callback = nullptr);
+
+private:
+    DevToolsClient* client_;
+};
+
+// Emulation domain
+class DevToolsEmulation {
+public:
+    struct VirtualTimePolicy {
+        // "advance", "pause" or "pauseIfNetworkFetchesPending"
+        std::string policy = "pause";
+
+        // Virtual milliseconds to run before Emulation.virtualTimeBudgetExpired;
+        // 0 for no budget
+        double budget_ms = 0;
+
+        // Starting virtual time in seconds since the epoch; 0 for the current time
+        double initial_virtual_time = 0;
+
+        // Tasks run before virtual time is forced forward; 0 for no limit
+        int max_task_starvation_count = 0;
+    };
+
+    explicit DevToolsEmulation(DevToolsClient* client) : client_(client) {}
+
+    void SetDeviceMetricsOverride(int width, int height, double device_scale_factor,
+                                  bool mobile, DevToolsResultCallback callback = nullptr);
+    void ClearDeviceMetricsOverride(DevToolsResultCallback callback = nullptr);
+    void SetUserAgentOverride(const std::string& user_agent,
+                              DevToolsResultCallback callback = nullptr);
+    void SetCpuThrottlingRate(double rate, DevToolsResultCallback callback = nullptr);
+    void SetTimezoneOverride(const std::string& timezone_id,
+                             DevToolsResultCallback callback = nullptr);
+
+    // |virtual_time_ticks_base| is 0 on failure
+    void SetVirtualTimePolicy(const VirtualTimePolicy& policy,
+                              std::function<void(double virtual_time_ticks_base)> callback);
+
+    // Event; returns a subscription id
+    int OnVirtualTimeBudgetExpired(std::function<void()> callback);
+
+private:
+    DevToolsClient* client_;
+};
+
+// DevTools protocol client for a browser in this process, built on
+// CefBrowserHost::ExecuteDevToolsMethod() without a socket or a port.
+//
+// Messages are scanned with ScanDevToolsMessage() and only results of this
+// client's calls and events it subscribed to are parsed into values, so a
+// busy Network domain costs nothing beyond the scan for events nobody
+// listens to. All clients of a browser share its DevTools agent and see each
+// other's events; results of other clients' calls are ignored.
+//
+// Created, used and destroyed on the UI thread; callbacks run there too and
+// may destroy the client. Pending callbacks fail when the agent detaches and
+// never run once the client is destroyed.
+class DevToolsClient {
+public:
+    explicit DevToolsClient(CefRefPtr<CefBrowser> browser);
+    ~DevToolsClient();
+
+    DevToolsClient(const DevToolsClient&) = delete;
+    DevToolsClient& operator=(const DevToolsClient&) = delete;
+
+    // Call |method| with |params| (may be null). Returns false, without
+    // running |callback|, if the method could not be sent.
+    bool Execute(const std::string& method, CefRefPtr<CefDictionaryValue> params,
+                 DevToolsResultCallback callback = nullptr);
+
+    // Run |callback| for each |event|, e.g. "Page.loadEventFired". Returns a
+    // subscription id for Unsubscribe().
+    int Subscribe(const std::string& event, DevToolsEventCallback callback);
+    void Unsubscribe(int subscription);
+
+    DevToolsPage& Page() { return page_; }
+    DevToolsRuntime& Runtime() { return runtime_; }
+    DevToolsNetwork& Network() { return network_; }
+    DevToolsStorage& Storage() { return storage_; }
+    DevToolsEmulation& Emulation() { return emulation_; }
+
+    // Calls still waiting for a result
+    size_t pending_count() const { return pending_.size(); }
+
+private:
+    class Observer;
+    friend class Observer;
+
+    struct Subscription {
+        int id;
+        DevToolsEventCallback callback;
+    };
+
+    void OnMessage(std::string_view message);
+    void OnAgentDetached();
+
+    CefRefPtr<CefBrowser> browser_;
+    CefRefPtr<Observer> observer_;
+    CefRefPtr<CefRegistration> registration_;
+
+    std::map<int, DevToolsResultCallback> pending_;
+    std::map<std::string, std::vector<Subscription>, std::less<>> subscriptions_;
+    int next_subscription_ = 1;
+
+    // Cleared on destruction so a callback may destroy the client
+    std::shared_ptr<bool> alive_;
+
+    DevToolsPage page_;
+    DevToolsRuntime runtime_;
+    DevToolsNetwork network_;
+    DevToolsStorage storage_;
+    DevToolsEmulation emulation_;
+};
+
+#endif  // CEF_BROWSER_DEVTOOLS_CLIENT_H_
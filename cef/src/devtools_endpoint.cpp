@@ -0,0 +1,115 @@
+// CEF Browser - DevTools Endpoint Implementation
+#include "devtools_endpoint.h"
+#include "json_writer.h"
+
+#include <cstdio>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+bool IsDevToolsTransport(std::string_view transport) {
+    return transport == "tcp" || transport == "pipe" || transport == "off";
+}
+
+int ListenOnLoopback(int port, int* bound_port) {
+    if (port < 0 || port > 65535) {
+        return -1;
+    }
+#if defined(_WIN32)
+    // Sockets are only needed by the bridge and port probing, which are POSIX
+    // only
+    return -1;
+#else
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    // Only a listener in TIME_WAIT from an earlier instance may be reused,
+    // not one that is listening
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    socklen_t length = sizeof(address);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), length) != 0 || listen(fd, 16) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        close(fd);
+        return -1;
+    }
+    *bound_port = ntohs(address.sin_port);
+    return fd;
+#endif
+}
+
+void CloseSocket(int socket) {
+#if !defined(_WIN32)
+    if (socket >= 0) {
+        close(socket);
+    }
+#endif
+}
+
+int FindFreeLoopbackPort() {
+    int port = 0;
+    int fd = ListenOnLoopback(0, &port);
+    if (fd < 0) {
+        return 0;
+    }
+    CloseSocket(fd);
+    return port;
+}
+
+bool HasDevToolsPipe() {
+#if defined(_WIN32)
+    return false;
+#else
+    return fcntl(kDevToolsPipeReadFd, F_GETFD) != -1 && fcntl(kDevToolsPipeWriteFd, F_GETFD) != -1;
+#endif
+}
+
+std::string FormatDevToolsDiscovery(const DevToolsEndpoint& endpoint, int pid) {
+    JsonWriter writer;
+    writer.BeginObject();
+    writer.Key("pid").Int(pid);
+    writer.Key("transport").String(endpoint.transport);
+    if (endpoint.transport == "tcp") {
+        writer.Key("host").String("127.0.0.1");
+        writer.Key("port").Int(endpoint.port);
+        writer.Key("url").String("http://127.0.0.1:" + std::to_string(endpoint.port));
+        writer.Key("lazy").Bool(endpoint.lazy);
+    } else if (endpoint.transport == "pipe") {
+        writer.Key("read_fd").Int(kDevToolsPipeReadFd);
+        writer.Key("write_fd").Int(kDevToolsPipeWriteFd);
+    }
+    writer.EndObject();
+    return writer.Release();
+}
+
+bool WriteDevToolsDiscoveryFile(const std::string& path, const std::string& contents) {
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out.write(contents.data(), contents.size());
+        if (!out) {
+            return false;
+        }
+    }
+#if defined(_WIN32)
+    std::remove(path.c_str());
+#endif
+    return std::rename(temp_path.c_str(), path.c_str()) == 0;
+}
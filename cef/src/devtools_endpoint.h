@@ -0,0 +1,57 @@
+// CEF Browser - DevTools Endpoint
+#ifndef CEF_BROWSER_DEVTOOLS_ENDPOINT_H_
+#define CEF_BROWSER_DEVTOOLS_ENDPOINT_H_
+
+#include <string>
+#include <string_view>
+
+// File descriptors of the pipe transport, as in Chromium's
+// --remote-debugging-pipe: the client writes to fd 3 and reads fd 4
+constexpr int kDevToolsPipeReadFd = 3;
+constexpr int kDevToolsPipeWriteFd = 4;
+
+// Where this instance serves the DevTools protocol
+struct DevToolsEndpoint {
+    // "tcp", "pipe" or "off"
+    std::string transport = "off";
+
+    // Loopback port of the tcp transport
+    int port = 0;
+
+    // Served by the in-process bridge, which attaches to a browser only when
+    // a client connects, instead of Chromium's DevTools server
+    bool lazy = false;
+
+    // Port for CefSettings.remote_debugging_port: the tcp port when Chromium
+    // serves it, otherwise 0, which disables Chromium's server
+    int ChromiumPort() const { return transport == "tcp" && !lazy ? port : 0; }
+};
+
+// Whether |transport| is "tcp", "pipe" or "off"
+bool IsDevToolsTransport(std::string_view transport);
+
+// Listen on 127.0.0.1:|port|, or on a free port when |port| is 0. Returns the
+// socket and sets |bound_port|, or returns -1 if the port is taken.
+int ListenOnLoopback(int port, int* bound_port);
+
+// Close a socket returned by ListenOnLoopback()
+void CloseSocket(int socket);
+
+// Find a free loopback port for a server started later, e.g. by Chromium.
+// The port is released on return, so it is only unlikely to be taken by then.
+// Returns 0 on failure.
+int FindFreeLoopbackPort();
+
+// Whether this process inherited open descriptors 3 and 4 for the pipe
+// transport
+bool HasDevToolsPipe();
+
+// JSON describing |endpoint| of process |pid| for launchers that need to find
+// it: the transport, and the port and HTTP URL, or the pipe descriptors
+std::string FormatDevToolsDiscovery(const DevToolsEndpoint& endpoint, int pid);
+
+// Write |contents| to |path| through a rename, so readers never see a partial
+// file
+bool WriteDevToolsDiscoveryFile(const std::string& path, const std::string& contents);
+
+#endif  // CEF_BROWSER_DEVTOOLS_ENDPOINT_H_
@@ -0,0 +1,139 @@
+// CEF Browser - DevTools Protocol Message Scanner Implementation
+#include "devtools_message.h"
+
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+void SkipWhitespace(std::string_view text, size_t* pos) {
+    while (*pos < text.size() && (text[*pos] == ' ' || text[*pos] == '\t' ||
+                                  text[*pos] == '\n' || text[*pos] == '\r')) {
+        ++*pos;
+    }
+}
+
+// Advance past the string starting at |pos|, which must be a quote
+bool SkipString(std::string_view text, size_t* pos) {
+    for (size_t i = *pos + 1; i < text.size(); ++i) {
+        if (text[i] == '\\') {
+            ++i;
+        } else if (text[i] == '"') {
+            *pos = i + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Advance past the value starting at |pos|
+bool SkipValue(std::string_view text, size_t* pos) {
+    if (*pos >= text.size()) {
+        return false;
+    }
+    const char first = text[*pos];
+    if (first == '"') {
+        return SkipString(text, pos);
+    }
+    if (first == '{' || first == '[') {
+        int depth = 0;
+        size_t i = *pos;
+        while (i < text.size()) {
+            const char c = text[i];
+            if (c == '"') {
+                if (!SkipString(text, &i)) {
+                    return false;
+                }
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    *pos = i + 1;
+                    return true;
+                }
+            }
+            ++i;
+        }
+        return false;
+    }
+
+    // Number, true, false or null
+    size_t i = *pos;
+    while (i < text.size() && text[i] != ',' && text[i] != '}' && text[i] != ']' &&
+           text[i] != ' ' && text[i] != '\n' && text[i] != '\r' && text[i] != '\t') {
+        ++i;
+    }
+    if (i == *pos) {
+        return false;
+    }
+    *pos = i;
+    return true;
+}
+
+}  // namespace
+
+bool ScanDevToolsMessage(std::string_view message, DevToolsMessageView* view) {
+    DevToolsMessageView result;
+    size_t pos = 0;
+    SkipWhitespace(message, &pos);
+    if (pos >= message.size() || message[pos] != '{') {
+        return false;
+    }
+    ++pos;
+    SkipWhitespace(message, &pos);
+    if (pos < message.size() && message[pos] == '}') {
+        *view = result;
+        return true;
+    }
+
+    while (pos < message.size()) {
+        SkipWhitespace(message, &pos);
+        const size_t key_start = pos;
+        if (pos >= message.size() || message[pos] != '"' || !SkipString(message, &pos)) {
+            return false;
+        }
+        // Protocol member names contain no escapes
+        const std::string_view key = message.substr(key_start + 1, pos - key_start - 2);
+
+        SkipWhitespace(message, &pos);
+        if (pos >= message.size() || message[pos] != ':') {
+            return false;
+        }
+        ++pos;
+        SkipWhitespace(message, &pos);
+        const size_t value_start = pos;
+        if (!SkipValue(message, &pos)) {
+            return false;
+        }
+        const std::string_view value = message.substr(value_start, pos - value_start);
+
+        if (key == "id") {
+            result.id = std::atoi(std::string(value).c_str());
+        } else if (key == "method") {
+            if (value.size() < 2 || value.front() != '"') {
+                return false;
+            }
+            result.method = value.substr(1, value.size() - 2);
+        } else if (key == "result") {
+            result.result = value;
+        } else if (key == "error") {
+            result.error = value;
+        } else if (key == "params") {
+            result.params = value;
+        }
+
+        SkipWhitespace(message, &pos);
+        if (pos < message.size() && message[pos] == ',') {
+            ++pos;
+            continue;
+        }
+        if (pos < message.size() && message[pos] == '}') {
+            *view = result;
+            return true;
+        }
+        return false;
+    }
+    return false;
+}
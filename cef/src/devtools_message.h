@@ -0,0 +1,30 @@
+// CEF Browser - DevTools Protocol Message Scanner
+#ifndef CEF_BROWSER_DEVTOOLS_MESSAGE_H_
+#define CEF_BROWSER_DEVTOOLS_MESSAGE_H_
+
+#include <string_view>
+
+// Top-level members of a DevTools protocol message, as views into the
+// message. Values are raw JSON; nothing below the top level is parsed.
+struct DevToolsMessageView {
+    // "id" of a method result; 0 for events
+    int id = 0;
+
+    // "method" of an event, without quotes; empty for results
+    std::string_view method;
+
+    // "result" of a successful call, "error" of a failed one and "params" of an
+    // event; empty when absent
+    std::string_view result;
+    std::string_view error;
+    std::string_view params;
+
+    bool is_event() const { return id == 0 && !method.empty(); }
+};
+
+// Find the top-level members of |message| by skipping over nested values
+// without building them, so messages nobody handles cost a single scan.
+// Returns false if |message| is not a JSON object.
+bool ScanDevToolsMessage(std::string_view message, DevToolsMessageView* view);
+
+#endif  // CEF_BROWSER_DEVTOOLS_MESSAGE_H_
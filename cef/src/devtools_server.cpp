@@ -0,0 +1,791 @@
+// CEF Browser - DevTools Server Implementation
+#include "devtools_server.h"
+#include "browser_client.h"
+#include "json_writer.h"
+#include "process_memory.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "include/base/cef_callback.h"
+#include "include/base/cef_logging.h"
+#include "include/cef_devtools_message_observer.h"
+#include "include/cef_task.h"
+#include "include/cef_version.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+#if defined(OS_LINUX)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <thread>
+#include <unordered_map>
+
+#include "event_loop.h"
+#include "websocket.h"
+#endif
+
+namespace {
+
+DevToolsEndpoint g_endpoint;
+std::string g_discovery_path;
+
+// Listener of a lazy tcp endpoint until the bridge takes it
+int g_listener = -1;
+
+#if defined(OS_LINUX)
+
+constexpr char kPagePath[] = "/devtools/page/";
+
+// A browser as listed by /json/list
+struct TargetInfo {
+    int id = 0;
+    std::string url;
+    std::string title;
+};
+
+void ListTargetsOnUI(uint64_t connection_id);
+void AttachOnUI(uint64_t connection_id, int browser_id);
+void SendOnUI(uint64_t connection_id, const std::string& message);
+void DetachOnUI(uint64_t connection_id);
+
+// Serves DevTools clients on its own thread: HTTP discovery and page
+// WebSockets on the loopback listener, or NUL-delimited messages on the pipe.
+// Protocol messages are passed to and from the UI thread, where the browser
+// sessions live. The public methods may be called from any thread.
+class DevToolsBridge {
+public:
+    ~DevToolsBridge() { Stop(); }
+
+    // Serve |listen_fd|, which the bridge then owns, and/or the pipe
+    bool Start(int listen_fd, bool pipe) {
+        if (!loop_.Init()) {
+            CloseSocket(listen_fd);
+            return false;
+        }
+        loop_.PostTask([this, listen_fd, pipe] {
+            if (listen_fd >= 0) {
+                listen_fd_ = listen_fd;
+                fcntl(listen_fd_, F_SETFL, fcntl(listen_fd_, F_GETFL) | O_NONBLOCK);
+                loop_.AddFd(listen_fd_, EPOLLIN, [this](uint32_t) { Accept(); });
+            }
+            if (pipe) {
+                Connection* connection = AddConnection(kDevToolsPipeReadFd, kDevToolsPipeWriteFd);
+                connection->pipe = true;
+                connection->state = State::kSession;
+                connection->attached = true;
+                CefPostTask(TID_UI, base::BindOnce(&AttachOnUI, connection->id, 0));
+            }
+        });
+        thread_ = std::thread([this] { loop_.Run(); });
+        return true;
+    }
+
+    void Stop() {
+        if (!thread_.joinable()) {
+            return;
+        }
+        loop_.Quit();
+        thread_.join();
+        for (auto& entry : connections_) {
+            CloseFds(entry.second.get());
+        }
+        connections_.clear();
+        CloseSocket(listen_fd_);
+        listen_fd_ = -1;
+    }
+
+    // Send a protocol message from the browser to the client
+    void Deliver(uint64_t connection_id, std::string message) {
+        loop_.PostTask([this, connection_id, message = std::move(message)] {
+            Connection* connection = Find(connection_id);
+            if (!connection || connection->state != State::kSession) {
+                return;
+            }
+            if (connection->pipe) {
+                connection->output.append(message);
+                connection->output.push_back('\0');
+            } else {
+                EncodeWebSocketFrame(kWebSocketText, message, &connection->output);
+            }
+            Flush(connection);
+        });
+    }
+
+    // Answer a /json/list request
+    void RespondTargets(uint64_t connection_id, std::vector<TargetInfo> targets) {
+        loop_.PostTask([this, connection_id, targets = std::move(targets)] {
+            Connection* connection = Find(connection_id);
+            if (!connection) {
+                return;
+            }
+            JsonWriter writer;
+            writer.BeginArray();
+            for (const TargetInfo& target : targets) {
+                const std::string id = std::to_string(target.id);
+                writer.BeginObject();
+                writer.Key("description").String("");
+                writer.Key("id").String(id);
+                writer.Key("title").String(target.title);
+                writer.Key("type").String("page");
+                writer.Key("url").String(target.url);
+                writer.Key("webSocketDebuggerUrl")
+                    .String("ws://127.0.0.1:" + std::to_string(g_endpoint.port) + kPagePath + id);
+                writer.EndObject();
+            }
+            writer.EndArray();
+            Respond(connection, 200, "OK", writer.str());
+        });
+    }
+
+    // Complete or refuse a WebSocket upgrade once the UI thread has attached
+    // the session, or not
+    void OnAttached(uint64_t connection_id, bool attached) {
+        loop_.PostTask([this, connection_id, attached] {
+            Connection* connection = Find(connection_id);
+            if (!connection || connection->state != State::kAttaching) {
+                return;
+            }
+            if (!attached) {
+                connection->attached = false;
+                Respond(connection, 404, "Not Found", "No such target, or it has a client\n");
+                return;
+            }
+            connection->state = State::kSession;
+            connection->output.append(connection->handshake);
+            connection->handshake.clear();
+            Flush(connection);
+            if (Find(connection_id)) {
+                ProcessInput(connection);
+            }
+        });
+    }
+
+    // Close a connection whose browser or DevTools agent went away
+    void Disconnect(uint64_t connection_id) {
+        loop_.PostTask([this, connection_id] {
+            if (Connection* connection = Find(connection_id)) {
+                Close(connection, false);
+            }
+        });
+    }
+
+private:
+    enum class State {
+        // Reading an HTTP request
+        kHttp,
+        // Waiting for the UI thread to attach a WebSocket session
+        kAttaching,
+        // Exchanging protocol messages
+        kSession,
+        // Writing the final response
+        kClosing,
+    };
+
+    struct Connection {
+        uint64_t id = 0;
+        int read_fd = -1;
+        int write_fd = -1;
+        bool pipe = false;
+        State state = State::kHttp;
+        std::string input;
+        std::string output;
+
+        // 101 response sent once the session is attached
+        std::string handshake;
+
+        // Text of a fragmented WebSocket message
+        std::string fragments;
+
+        // A session may exist on the UI thread
+        bool attached = false;
+    };
+
+    Connection* AddConnection(int read_fd, int write_fd) {
+        auto connection = std::make_unique<Connection>();
+        connection->id = next_connection_id_++;
+        connection->read_fd = read_fd;
+        connection->write_fd = write_fd;
+        fcntl(read_fd, F_SETFL, fcntl(read_fd, F_GETFL) | O_NONBLOCK);
+        fcntl(write_fd, F_SETFL, fcntl(write_fd, F_GETFL) | O_NONBLOCK);
+
+        Connection* result = connection.get();
+        connections_[result->id] = std::move(connection);
+        UpdateWatches(result);
+        return result;
+    }
+
+    Connection* Find(uint64_t connection_id) {
+        auto it = connections_.find(connection_id);
+        return it == connections_.end() ? nullptr : it->second.get();
+    }
+
+    void Accept() {
+        while (true) {
+            int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;
+            }
+            AddConnection(fd, fd);
+        }
+    }
+
+    // Watch for input, and for writability while output is pending
+    void UpdateWatches(Connection* connection) {
+        const uint64_t id = connection->id;
+        const bool writing = !connection->output.empty();
+        if (connection->read_fd == connection->write_fd) {
+            loop_.AddFd(connection->read_fd, EPOLLIN | (writing ? EPOLLOUT : 0u),
+                        [this, id](uint32_t events) { OnEvents(id, events); });
+            return;
+        }
+        loop_.AddFd(connection->read_fd, EPOLLIN, [this, id](uint32_t events) {
+            OnEvents(id, events & ~static_cast<uint32_t>(EPOLLOUT));
+        });
+        if (writing) {
+            loop_.AddFd(connection->write_fd, EPOLLOUT,
+                        [this, id](uint32_t events) { OnEvents(id, EPOLLOUT); });
+        } else {
+            loop_.RemoveFd(connection->write_fd);
+        }
+    }
+
+    void OnEvents(uint64_t connection_id, uint32_t events) {
+        Connection* connection = Find(connection_id);
+        if (connection && (events & EPOLLOUT)) {
+            Flush(connection);
+            connection = Find(connection_id);
+        }
+        if (connection && (events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+            Read(connection);
+        }
+    }
+
+    void Read(Connection* connection) {
+        char buffer[64 * 1024];
+        while (true) {
+            ssize_t bytes = read(connection->read_fd, buffer, sizeof(buffer));
+            if (bytes > 0) {
+                connection->input.append(buffer, bytes);
+                continue;
+            }
+            if (bytes < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            // The client went away
+            Close(connection, true);
+            return;
+        }
+        ProcessInput(connection);
+    }
+
+    void ProcessInput(Connection* connection) {
+        switch (connection->state) {
+            case State::kHttp:
+                ProcessHttp(connection);
+                break;
+            case State::kSession:
+                if (connection->pipe) {
+                    ProcessPipe(connection);
+                } else {
+                    ProcessWebSocket(connection);
+                }
+                break;
+            case State::kAttaching:
+                // Frames sent right after the upgrade wait for the session
+                break;
+            case State::kClosing:
+                connection->input.clear();
+                break;
+        }
+    }
+
+    void ProcessHttp(Connection* connection) {
+        HttpRequestHead head;
+        size_t consumed = 0;
+        ParseStatus status = ParseHttpRequestHead(connection->input, &head, &consumed);
+        if (status == ParseStatus::kIncomplete) {
+            return;
+        }
+        if (status == ParseStatus::kError) {
+            Respond(connection, 400, "Bad Request", "");
+            return;
+        }
+        connection->input.erase(0, consumed);
+
+        // Refuse pages that reach the port through DNS rebinding
+        const std::string host = head.Header("host");
+        const std::string host_name = host.substr(0, host.rfind(':'));
+        if (host_name != "127.0.0.1" && host_name != "localhost") {
+            Respond(connection, 403, "Forbidden", "Host must be 127.0.0.1 or localhost\n");
+            return;
+        }
+
+        const std::string path = head.path.substr(0, head.path.find('?'));
+        if (path == "/json/version") {
+            JsonWriter writer;
+            writer.BeginObject();
+            writer.Key("Browser").String("CEF/" CEF_VERSION);
+            writer.Key("Protocol-Version").String("1.3");
+            writer.EndObject();
+            Respond(connection, 200, "OK", writer.str());
+        } else if (path == "/json" || path == "/json/list") {
+            connection->state = State::kClosing;
+            CefPostTask(TID_UI, base::BindOnce(&ListTargetsOnUI, connection->id));
+        } else if (path.rfind(kPagePath, 0) == 0 && IsWebSocketUpgrade(head) &&
+                   std::atoi(path.c_str() + sizeof(kPagePath) - 1) > 0) {
+            connection->state = State::kAttaching;
+            connection->handshake = FormatWebSocketHandshake(head);
+            connection->attached = true;
+            CefPostTask(TID_UI,
+                        base::BindOnce(&AttachOnUI, connection->id,
+                                       std::atoi(path.c_str() + sizeof(kPagePath) - 1)));
+        } else {
+            Respond(connection, 404, "Not Found", "");
+        }
+    }
+
+    void ProcessPipe(Connection* connection) {
+        size_t begin = 0;
+        size_t end;
+        while ((end = connection->input.find('\0', begin)) != std::string::npos) {
+            CefPostTask(TID_UI, base::BindOnce(&SendOnUI, connection->id,
+                                               connection->input.substr(begin, end - begin)));
+            begin = end + 1;
+        }
+        connection->input.erase(0, begin);
+    }
+
+    void ProcessWebSocket(Connection* connection) {
+        const uint64_t id = connection->id;
+        size_t begin = 0;
+        while (true) {
+            WebSocketFrame frame;
+            size_t consumed = 0;
+            ParseStatus status = DecodeWebSocketFrame(
+                std::string_view(connection->input).substr(begin), &frame, &consumed);
+            if (status == ParseStatus::kIncomplete) {
+                break;
+            }
+            if (status == ParseStatus::kError) {
+                Close(connection, true);
+                return;
+            }
+            begin += consumed;
+
+            switch (frame.opcode) {
+                case kWebSocketText:
+                case kWebSocketBinary:
+                case kWebSocketContinuation:
+                    connection->fragments.append(frame.payload);
+                    if (frame.fin) {
+                        CefPostTask(TID_UI, base::BindOnce(&SendOnUI, id,
+                                                           std::move(connection->fragments)));
+                        connection->fragments.clear();
+                    }
+                    break;
+                case kWebSocketPing:
+                    EncodeWebSocketFrame(kWebSocketPong, frame.payload, &connection->output);
+                    break;
+                case kWebSocketClose:
+                    EncodeWebSocketFrame(kWebSocketClose, "", &connection->output);
+                    connection->state = State::kClosing;
+                    DetachSession(connection);
+                    connection->input.clear();
+                    Flush(connection);
+                    return;
+                default:
+                    break;
+            }
+        }
+        connection->input.erase(0, begin);
+        Flush(connection);
+    }
+
+    // Queue an HTTP response and close once it is written
+    void Respond(Connection* connection, int status, const char* reason,
+                 const std::string& body) {
+        connection->output.append(FormatHttpResponse(
+            status, reason, status == 200 ? "application/json; charset=UTF-8" : "text/plain",
+            body));
+        connection->state = State::kClosing;
+        connection->input.clear();
+        Flush(connection);
+    }
+
+    // Write pending output. May close |connection|.
+    void Flush(Connection* connection) {
+        while (!connection->output.empty()) {
+            ssize_t bytes =
+                write(connection->write_fd, connection->output.data(), connection->output.size());
+            if (bytes > 0) {
+                connection->output.erase(0, bytes);
+                continue;
+            }
+            if (bytes < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            Close(connection, true);
+            return;
+        }
+        if (connection->output.empty() && connection->state == State::kClosing &&
+            !connection->attached) {
+            Close(connection, false);
+            return;
+        }
+        UpdateWatches(connection);
+    }
+
+    void DetachSession(Connection* connection) {
+        if (connection->attached) {
+            connection->attached = false;
+            CefPostTask(TID_UI, base::BindOnce(&DetachOnUI, connection->id));
+        }
+    }
+
+    // Drop |connection|, detaching its session unless the UI thread closed it
+    void Close(Connection* connection, bool detach) {
+        if (detach) {
+            DetachSession(connection);
+        }
+        CloseFds(connection);
+        connections_.erase(connection->id);
+    }
+
+    void CloseFds(Connection* connection) {
+        loop_.RemoveFd(connection->read_fd);
+        close(connection->read_fd);
+        if (connection->write_fd != connection->read_fd) {
+            loop_.RemoveFd(connection->write_fd);
+            close(connection->write_fd);
+        }
+    }
+
+    EventLoop loop_;
+    std::thread thread_;
+
+    // Loop thread only
+    int listen_fd_ = -1;
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections_;
+    uint64_t next_connection_id_ = 1;
+};
+
+std::unique_ptr<DevToolsBridge> g_bridge;
+
+// Forwards a browser's DevTools messages to a bridge connection. UI thread.
+class BridgeObserver : public CefDevToolsMessageObserver {
+public:
+    explicit BridgeObserver(uint64_t connection_id) : connection_id_(connection_id) {}
+
+    bool OnDevToolsMessage(CefRefPtr<CefBrowser> browser, const void* message,
+                           size_t message_size) override {
+        if (g_bridge) {
+            g_bridge->Deliver(connection_id_,
+                              std::string(static_cast<const char*>(message), message_size));
+        }
+        // Handled: the message is not parsed into results and events
+        return true;
+    }
+
+    void OnDevToolsAgentDetached(CefRefPtr<CefBrowser> browser) override {
+        DetachOnUI(connection_id_);
+        if (g_bridge) {
+            g_bridge->Disconnect(connection_id_);
+        }
+    }
+
+private:
+    const uint64_t connection_id_;
+
+    IMPLEMENT_REFCOUNTING(BridgeObserver);
+};
+
+// DevTools session of a bridge connection
+struct Session {
+    // Attached browser; 0 while the pipe waits for the first browser
+    int browser_id = 0;
+    CefRefPtr<CefRegistration> registration;
+
+    // Messages received before a browser was attached
+    std::vector<std::string> pending;
+};
+
+// UI thread only. Every browser in the BrowserRegistry is a target.
+std::map<uint64_t, Session> g_sessions;
+
+// The browser with the lowest identifier, the first one created, or nullptr
+CefRefPtr<CefBrowser> GetFirstTarget() {
+    CefRefPtr<CefBrowser> first;
+    GetBrowserRegistry().ForEach(
+        [&first](const BrowserRecord& record, const CefRefPtr<CefBrowser>& browser) {
+            if (!first || record.browser_id < first->GetIdentifier()) {
+                first = browser;
+            }
+        });
+    return first;
+}
+
+bool HasSession(int browser_id) {
+    for (const auto& entry : g_sessions) {
+        if (entry.second.browser_id == browser_id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BindSession(uint64_t connection_id, Session* session, CefRefPtr<CefBrowser> browser) {
+    CefRefPtr<CefBrowserHost> host = browser->GetHost();
+    session->browser_id = browser->GetIdentifier();
+    session->registration = host->AddDevToolsMessageObserver(new BridgeObserver(connection_id));
+    for (const std::string& message : session->pending) {
+        host->SendDevToolsMessage(message.data(), message.size());
+    }
+    session->pending.clear();
+}
+
+void ListTargetsOnUI(uint64_t connection_id) {
+    CEF_REQUIRE_UI_THREAD();
+    if (!g_bridge) {
+        return;
+    }
+
+    std::vector<TargetInfo> targets;
+    GetBrowserRegistry().ForEach(
+        [&targets](const BrowserRecord& record, const CefRefPtr<CefBrowser>& browser) {
+            TargetInfo target;
+            target.id = record.browser_id;
+            target.url = browser->GetMainFrame()->GetURL().ToString();
+            if (CefRefPtr<CefNavigationEntry> navigation =
+                    browser->GetHost()->GetVisibleNavigationEntry()) {
+                target.title = navigation->GetTitle().ToString();
+            }
+            targets.push_back(std::move(target));
+        });
+    std::sort(targets.begin(), targets.end(),
+              [](const TargetInfo& a, const TargetInfo& b) { return a.id < b.id; });
+    g_bridge->RespondTargets(connection_id, std::move(targets));
+}
+
+// Attach connection |connection_id| to |browser_id|, or for the pipe (0) to
+// the first browser once there is one
+void AttachOnUI(uint64_t connection_id, int browser_id) {
+    CEF_REQUIRE_UI_THREAD();
+    if (!g_bridge) {
+        return;
+    }
+
+    if (browser_id == 0) {
+        Session& session = g_sessions[connection_id];
+        if (CefRefPtr<CefBrowser> first = GetFirstTarget()) {
+            BindSession(connection_id, &session, first);
+        }
+        return;
+    }
+
+    CefRefPtr<CefBrowser> browser = GetBrowserRegistry().GetBrowser(browser_id);
+    const bool attached = browser && !HasSession(browser_id);
+    if (attached) {
+        BindSession(connection_id, &g_sessions[connection_id], browser);
+    }
+    g_bridge->OnAttached(connection_id, attached);
+}
+
+void SendOnUI(uint64_t connection_id, const std::string& message) {
+    CEF_REQUIRE_UI_THREAD();
+
+    auto session = g_sessions.find(connection_id);
+    if (session == g_sessions.end()) {
+        return;
+    }
+    if (session->second.browser_id == 0) {
+        session->second.pending.push_back(message);
+        return;
+    }
+    CefRefPtr<CefBrowser> target = GetBrowserRegistry().GetBrowser(session->second.browser_id);
+    if (target) {
+        target->GetHost()->SendDevToolsMessage(message.data(), message.size());
+    }
+}
+
+void DetachOnUI(uint64_t connection_id) {
+    CEF_REQUIRE_UI_THREAD();
+
+    // Releasing the registration removes the observer
+    g_sessions.erase(connection_id);
+}
+
+#endif  // OS_LINUX
+
+}  // namespace
+
+const DevToolsEndpoint& InitDevToolsEndpoint(const BrowserConfig& config) {
+    DevToolsEndpoint endpoint;
+    endpoint.transport = config.devtools_transport;
+    if (!IsDevToolsTransport(endpoint.transport)) {
+        LOG(WARNING) << "Unknown DevTools transport " << endpoint.transport << ", using tcp";
+        endpoint.transport = "tcp";
+    }
+
+#if defined(OS_LINUX)
+    endpoint.lazy = config.devtools_lazy;
+    if (endpoint.transport == "pipe" && !HasDevToolsPipe()) {
+        LOG(ERROR) << "The DevTools pipe needs inherited descriptors " << kDevToolsPipeReadFd
+                   << " and " << kDevToolsPipeWriteFd << "; DevTools is disabled";
+        endpoint.transport = "off";
+    }
+#else
+    if (config.devtools_lazy) {
+        LOG(WARNING) << "Lazy DevTools is only supported on Linux";
+    }
+    if (endpoint.transport == "pipe") {
+        LOG(WARNING) << "The DevTools pipe is only supported on Linux; DevTools is disabled";
+        endpoint.transport = "off";
+    }
+#endif
+
+    if (endpoint.transport == "tcp") {
+#if defined(OS_WIN)
+        // Free ports are found by binding a socket, which is POSIX only here
+        endpoint.port = config.devtools_port ? config.devtools_port : 9222;
+#else
+        // Probe the port so a second instance moves to a free one instead of
+        // silently failing to bind
+        int listener = ListenOnLoopback(config.devtools_port, &endpoint.port);
+        if (listener < 0 && config.devtools_port != 0) {
+            LOG(WARNING) << "DevTools port " << config.devtools_port
+                         << " is taken, using a free port";
+            listener = ListenOnLoopback(0, &endpoint.port);
+        }
+        if (listener < 0) {
+            LOG(ERROR) << "Cannot bind a DevTools port; DevTools is disabled";
+            endpoint.transport = "off";
+            endpoint.port = 0;
+        } else if (endpoint.lazy) {
+            g_listener = listener;
+        } else {
+            // Chromium binds it again during CefInitialize()
+            CloseSocket(listener);
+        }
+#endif
+    }
+
+    if (endpoint.transport == "off") {
+        endpoint.lazy = false;
+    }
+    g_endpoint = endpoint;
+    return g_endpoint;
+}
+
+const DevToolsEndpoint& GetDevToolsEndpoint() {
+    return g_endpoint;
+}
+
+void StartDevToolsServer() {
+    CEF_REQUIRE_UI_THREAD();
+    if (g_endpoint.transport == "off") {
+        return;
+    }
+
+#if defined(OS_LINUX)
+    if (g_endpoint.lazy || g_endpoint.transport == "pipe") {
+        auto bridge = std::make_unique<DevToolsBridge>();
+        const int listener = g_listener;
+        g_listener = -1;
+        if (!bridge->Start(listener, g_endpoint.transport == "pipe")) {
+            LOG(ERROR) << "Cannot start the DevTools bridge; DevTools is disabled";
+            g_endpoint = DevToolsEndpoint();
+            return;
+        }
+        g_bridge = std::move(bridge);
+    }
+#endif
+
+    const BrowserConfig& config = GetBrowserConfig();
+    g_discovery_path = config.devtools_discovery_file.empty()
+                           ? config.user_data_dir + "/DevToolsEndpoint.json"
+                           : config.devtools_discovery_file;
+    if (!WriteDevToolsDiscoveryFile(g_discovery_path, FormatDevToolsDiscovery(
+                                                          g_endpoint,
+                                                          GetCurrentProcessIdentifier()))) {
+        LOG(WARNING) << "Cannot write the DevTools discovery file " << g_discovery_path;
+        g_discovery_path.clear();
+    }
+
+    if (g_endpoint.transport == "pipe") {
+        LOG(INFO) << "DevTools on the pipe, descriptors " << kDevToolsPipeReadFd << " and "
+                  << kDevToolsPipeWriteFd;
+    } else {
+        LOG(INFO) << "DevTools at http://127.0.0.1:" << g_endpoint.port
+                  << (g_endpoint.lazy ? " (lazy)" : "");
+    }
+}
+
+void StopDevToolsServer() {
+    CEF_REQUIRE_UI_THREAD();
+
+#if defined(OS_LINUX)
+    if (g_bridge) {
+        g_bridge->Stop();
+        g_bridge.reset();
+    }
+    g_sessions.clear();
+#endif
+    CloseSocket(g_listener);
+    g_listener = -1;
+
+    if (!g_discovery_path.empty()) {
+        std::remove(g_discovery_path.c_str());
+        g_discovery_path.clear();
+    }
+}
+
+void AddDevToolsTarget(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+#if defined(OS_LINUX)
+    if (!g_bridge) {
+        return;
+    }
+
+    // The pipe attaches to the first browser
+    for (auto& entry : g_sessions) {
+        if (entry.second.browser_id == 0) {
+            BindSession(entry.first, &entry.second, browser);
+        }
+    }
+#endif
+}
+
+void RemoveDevToolsTarget(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+#if defined(OS_LINUX)
+    const int browser_id = browser->GetIdentifier();
+    for (auto it = g_sessions.begin(); it != g_sessions.end();) {
+        if (it->second.browser_id == browser_id) {
+            if (g_bridge) {
+                g_bridge->Disconnect(it->first);
+            }
+            it = g_sessions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+#endif
+}
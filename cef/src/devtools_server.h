@@ -0,0 +1,38 @@
+// CEF Browser - DevTools Server
+#ifndef CEF_BROWSER_DEVTOOLS_SERVER_H_
+#define CEF_BROWSER_DEVTOOLS_SERVER_H_
+
+#include "include/cef_browser.h"
+
+#include "browser_config.h"
+#include "devtools_endpoint.h"
+
+// Choose where DevTools is served: the configured port, a free loopback port
+// when it is 0 or taken, the inherited pipe, or nowhere. A lazy tcp endpoint
+// is bound here and later served by the in-process bridge. Called once in the
+// browser process before CefInitialize(); ChromiumPort() of the result is the
+// value for CefSettings.remote_debugging_port.
+const DevToolsEndpoint& InitDevToolsEndpoint(const BrowserConfig& config);
+
+// Get the endpoint chosen by InitDevToolsEndpoint()
+const DevToolsEndpoint& GetDevToolsEndpoint();
+
+// Start the bridge for lazy tcp or pipe endpoints and write the discovery
+// file. Called on the UI thread after CefInitialize().
+//
+// The bridge serves /json/version, /json/list and page WebSockets at
+// /devtools/page/<browser id>, or NUL-delimited messages on the pipe for the
+// first browser, through CefBrowserHost::SendDevToolsMessage(). No DevTools
+// agent is attached to a browser until a client connects to it. Each browser
+// has a single session, so a second client of the same page is refused.
+void StartDevToolsServer();
+
+// Stop the bridge and remove the discovery file. Called on the UI thread
+// before CefShutdown().
+void StopDevToolsServer();
+
+// Browsers the bridge can attach to. Called on the UI thread.
+void AddDevToolsTarget(CefRefPtr<CefBrowser> browser);
+void RemoveDevToolsTarget(CefRefPtr<CefBrowser> browser);
+
+#endif  // CEF_BROWSER_DEVTOOLS_SERVER_H_
@@ -0,0 +1,35 @@
+// CEF Browser - Browser Event Log Implementation
+#include "event_log.h"
+#include "json_writer.h"
+
+namespace {
+
+// Lines are flushed when this much has been buffered and when the log closes
+constexpr size_t kBufferSize = 64 * 1024;
+
+}  // namespace
+
+std::unique_ptr<EventLog> EventLog::Open(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "ab");
+    if (!file) {
+        return nullptr;
+    }
+    setvbuf(file, nullptr, _IOFBF, kBufferSize);
+    return std::unique_ptr<EventLog>(new EventLog(file));
+}
+
+EventLog::EventLog(FILE* file) : epoch_(BrowserEvent::Clock::now()), file_(file) {}
+
+EventLog::~EventLog() {
+    fclose(file_);
+}
+
+void EventLog::OnBrowserEvent(const BrowserEvent& event) {
+    JsonWriter writer;
+    event.WriteJson(writer, epoch_);
+    std::string line = writer.Release();
+    line += '\n';
+
+    std::lock_guard<std::mutex> lock(lock_);
+    fwrite(line.data(), 1, line.size(), file_);
+}
@@ -0,0 +1,38 @@
+// CEF Browser - Browser Event Log
+#ifndef CEF_BROWSER_EVENT_LOG_H_
+#define CEF_BROWSER_EVENT_LOG_H_
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "event_pipeline.h"
+
+// Appends every browser event to a file as one JSON object per line
+// (--event-log). Runs on the pipeline workers, so the UI thread never waits
+// on the disk.
+class EventLog : public BrowserEventObserver {
+public:
+    // Open |path| for appending; nullptr if it cannot be opened
+    static std::unique_ptr<EventLog> Open(const std::string& path);
+    ~EventLog() override;
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    // BrowserEventObserver methods
+    void OnBrowserEvent(const BrowserEvent& event) override;
+
+private:
+    explicit EventLog(FILE* file);
+
+    // Event times are written relative to this
+    const BrowserEvent::Clock::time_point epoch_;
+
+    // Workers write whole lines under the lock
+    std::mutex lock_;
+    FILE* file_;
+};
+
+#endif  // CEF_BROWSER_EVENT_LOG_H_
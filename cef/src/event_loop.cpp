@@ -0,0 +1,196 @@
+// CEF Browser - epoll Event Loop Implementation (Linux)
+#include "event_loop.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace {
+
+constexpr int kMaxEvents = 64;
+
+void CloseFd(int* fd) {
+    if (*fd >= 0) {
+        close(*fd);
+        *fd = -1;
+    }
+}
+
+}  // namespace
+
+EventLoop::EventLoop() = default;
+
+EventLoop::~EventLoop() {
+    CloseFd(&timer_fd_);
+    CloseFd(&event_fd_);
+    CloseFd(&epoll_fd_);
+}
+
+bool EventLoop::Init() {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epoll_fd_ < 0 || event_fd_ < 0 || timer_fd_ < 0) {
+        return false;
+    }
+
+    for (int fd : {event_fd_, timer_fd_}) {
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool EventLoop::AddFd(int fd, uint32_t events, FdCallback callback) {
+    epoll_event event = {};
+    event.events = events;
+    event.data.fd = fd;
+    const int op = watches_.count(fd) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(epoll_fd_, op, fd, &event) != 0) {
+        return false;
+    }
+    watches_[fd] = std::make_shared<FdCallback>(std::move(callback));
+    return true;
+}
+
+void EventLoop::RemoveFd(int fd) {
+    if (watches_.erase(fd)) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    }
+}
+
+void EventLoop::PostTask(Task task) {
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(task_lock_);
+        // Only the first task since the last drain needs to wake the loop
+        wake = tasks_.empty();
+        tasks_.push_back(std::move(task));
+    }
+    if (wake) {
+        uint64_t one = 1;
+        ssize_t written = write(event_fd_, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+uint64_t EventLoop::AddTimer(Clock::duration delay, Task task) {
+    const uint64_t id = next_timer_id_++;
+    const Clock::time_point deadline = Clock::now() + delay;
+    timers_.emplace(std::make_pair(deadline, id), std::move(task));
+    timer_deadlines_.emplace(id, deadline);
+    ArmTimer();
+    return id;
+}
+
+void EventLoop::CancelTimer(uint64_t id) {
+    auto it = timer_deadlines_.find(id);
+    if (it == timer_deadlines_.end()) {
+        return;
+    }
+    timers_.erase(std::make_pair(it->second, id));
+    timer_deadlines_.erase(it);
+    ArmTimer();
+}
+
+void EventLoop::Run() {
+    epoll_event events[kMaxEvents];
+    while (!quit_.load(std::memory_order_acquire)) {
+        int count = epoll_wait(epoll_fd_, events, kMaxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        ++wakeups_;
+
+        for (int i = 0; i < count; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == event_fd_) {
+                RunPostedTasks();
+            } else if (fd == timer_fd_) {
+                RunDueTimers();
+            } else {
+                auto it = watches_.find(fd);
+                if (it != watches_.end()) {
+                    std::shared_ptr<FdCallback> callback = it->second;
+                    (*callback)(events[i].events);
+                }
+            }
+        }
+    }
+
+    // Honor the guarantee that tasks posted before Quit() run
+    RunPostedTasks();
+}
+
+void EventLoop::Quit() {
+    quit_.store(true, std::memory_order_release);
+    uint64_t one = 1;
+    ssize_t written = write(event_fd_, &one, sizeof(one));
+    (void)written;
+}
+
+void EventLoop::RunPostedTasks() {
+    uint64_t counter;
+    ssize_t bytes = read(event_fd_, &counter, sizeof(counter));
+    (void)bytes;
+
+    std::vector<Task> tasks;
+    {
+        std::lock_guard<std::mutex> lock(task_lock_);
+        tasks.swap(tasks_);
+    }
+    for (Task& task : tasks) {
+        task();
+    }
+}
+
+void EventLoop::RunDueTimers() {
+    uint64_t expirations;
+    ssize_t bytes = read(timer_fd_, &expirations, sizeof(expirations));
+    (void)bytes;
+    armed_deadline_ = Clock::time_point::max();
+
+    const Clock::time_point now = Clock::now();
+    while (!timers_.empty() && timers_.begin()->first.first <= now) {
+        auto it = timers_.begin();
+        Task task = std::move(it->second);
+        timer_deadlines_.erase(it->first.second);
+        timers_.erase(it);
+        task();
+    }
+    ArmTimer();
+}
+
+void EventLoop::ArmTimer() {
+    const Clock::time_point deadline =
+        timers_.empty() ? Clock::time_point::max() : timers_.begin()->first.first;
+    if (deadline == armed_deadline_) {
+        return;
+    }
+    armed_deadline_ = deadline;
+
+    // steady_clock is CLOCK_MONOTONIC, so deadlines are armed as absolute
+    // times; a zero it_value disarms the timer
+    itimerspec spec = {};
+    if (deadline != Clock::time_point::max()) {
+        auto since_epoch = deadline.time_since_epoch();
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+        spec.it_value.tv_sec = seconds.count();
+        spec.it_value.tv_nsec =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - seconds).count();
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+            spec.it_value.tv_nsec = 1;
+        }
+    }
+    timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
@@ -0,0 +1,83 @@
+// CEF Browser - epoll Event Loop (Linux)
+#ifndef CEF_BROWSER_EVENT_LOOP_H_
+#define CEF_BROWSER_EVENT_LOOP_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Single-threaded event loop over epoll. Cross-thread tasks wake it through an
+// eventfd and timers through one timerfd armed for the earliest deadline, so
+// an idle loop sleeps in epoll_wait() without periodic wakeups.
+//
+// Run() and the fd and timer methods must be called on the loop thread;
+// PostTask() and Quit() may be called from any thread.
+class EventLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Task = std::function<void()>;
+
+    // Receives the epoll events (EPOLLIN, EPOLLOUT, EPOLLERR, ...) of a watch
+    using FdCallback = std::function<void(uint32_t events)>;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // Create the epoll, event and timer descriptors
+    bool Init();
+
+    // Watch |fd| for |events|, replacing any existing watch of |fd|. The loop
+    // does not take ownership of |fd|.
+    bool AddFd(int fd, uint32_t events, FdCallback callback);
+    void RemoveFd(int fd);
+
+    // Run |task| on the loop thread. Tasks posted before Quit() still run.
+    void PostTask(Task task);
+
+    // Run |task| once after |delay|. Returns an id for CancelTimer().
+    uint64_t AddTimer(Clock::duration delay, Task task);
+    void CancelTimer(uint64_t id);
+
+    // Dispatch events until Quit() is called
+    void Run();
+    void Quit();
+
+    // Number of times epoll_wait() returned
+    uint64_t wakeups() const { return wakeups_; }
+
+private:
+    void RunPostedTasks();
+    void RunDueTimers();
+    void ArmTimer();
+
+    int epoll_fd_ = -1;
+    int event_fd_ = -1;
+    int timer_fd_ = -1;
+
+    std::mutex task_lock_;
+    std::vector<Task> tasks_;
+
+    std::atomic<bool> quit_{false};
+    uint64_t wakeups_ = 0;
+
+    // Shared so a callback can remove its own watch while running
+    std::unordered_map<int, std::shared_ptr<FdCallback>> watches_;
+
+    // Pending timers ordered by deadline, and each timer's deadline by id
+    std::map<std::pair<Clock::time_point, uint64_t>, Task> timers_;
+    std::unordered_map<uint64_t, Clock::time_point> timer_deadlines_;
+    uint64_t next_timer_id_ = 1;
+    Clock::time_point armed_deadline_ = Clock::time_point::max();
+};
+
+#endif  // CEF_BROWSER_EVENT_LOOP_H_
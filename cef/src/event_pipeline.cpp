@@ -0,0 +1,400 @@
+// CEF Browser - Browser Event Pipeline Implementation
+#include "event_pipeline.h"
+#include "json_writer.h"
+#include "utf16.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Events a worker delivers between checks for coalesced events
+constexpr size_t kDrainBatch = 256;
+
+// Empty polls of its ring before a worker sleeps
+constexpr int kIdlePolls = 200;
+
+const char* GetDownloadStateName(DownloadState state) {
+    switch (state) {
+        case DownloadState::kInProgress:
+            return "in_progress";
+        case DownloadState::kComplete:
+            return "complete";
+        case DownloadState::kCancelled:
+            return "cancelled";
+    }
+    return "unknown";
+}
+
+std::unique_ptr<EventPipeline> g_pipeline;
+std::atomic<EventPipeline*> g_pipeline_ptr{nullptr};
+
+}  // namespace
+
+const char* GetBrowserEventTypeName(BrowserEventType type) {
+    switch (type) {
+        case BrowserEventType::kLoadStart:
+            return "load_start";
+        case BrowserEventType::kLoadEnd:
+            return "load_end";
+        case BrowserEventType::kLoadError:
+            return "load_error";
+        case BrowserEventType::kAddressChange:
+            return "address_change";
+        case BrowserEventType::kTitleChange:
+            return "title_change";
+        case BrowserEventType::kConsoleMessage:
+            return "console_message";
+        case BrowserEventType::kDownloadProgress:
+            return "download_progress";
+        case BrowserEventType::kRendererRecovery:
+            return "renderer_recovery";
+        case BrowserEventType::kRendererHang:
+            return "renderer_hang";
+    }
+    return "unknown";
+}
+
+BrowserEvent::BrowserEvent(BrowserEventType type, int browser_id)
+    : time(Clock::now()), browser_id(browser_id), type(type) {}
+
+void BrowserEvent::SetText(std::string_view text, std::string_view secondary) {
+    const size_t text_length = std::min(text.size(), kTextCapacity);
+    const size_t secondary_length = std::min(secondary.size(), kTextCapacity - text_length);
+    memcpy(text_, text.data(), text_length);
+    memcpy(text_ + text_length, secondary.data(), secondary_length);
+    text_length_ = static_cast<uint8_t>(text_length);
+    secondary_length_ = static_cast<uint8_t>(secondary_length);
+    truncated_ = text_length < text.size() || secondary_length < secondary.size();
+    utf16_ = false;
+}
+
+void BrowserEvent::SetText(std::u16string_view text, std::u16string_view secondary) {
+    constexpr size_t kUnits = kTextCapacity / sizeof(char16_t);
+    const size_t text_length = Utf16PrefixLength(text, kUnits);
+    const size_t secondary_length = Utf16PrefixLength(secondary, kUnits - text_length);
+    memcpy(text_, text.data(), text_length * sizeof(char16_t));
+    memcpy(text_ + text_length * sizeof(char16_t), secondary.data(),
+           secondary_length * sizeof(char16_t));
+    text_length_ = static_cast<uint8_t>(text_length * sizeof(char16_t));
+    secondary_length_ = static_cast<uint8_t>(secondary_length * sizeof(char16_t));
+    truncated_ = text_length < text.size() || secondary_length < secondary.size();
+    utf16_ = true;
+}
+
+std::string BrowserEvent::text() const {
+    return ReadText(0, text_length_);
+}
+
+std::string BrowserEvent::secondary_text() const {
+    return ReadText(text_length_, secondary_length_);
+}
+
+std::string BrowserEvent::ReadText(size_t offset, size_t length) const {
+    if (!utf16_) {
+        return std::string(text_ + offset, length);
+    }
+    char16_t units[kTextCapacity / sizeof(char16_t)];
+    memcpy(units, text_ + offset, length);
+    return Utf16ToUtf8(std::u16string_view(units, length / sizeof(char16_t)));
+}
+
+void BrowserEvent::WriteJson(JsonWriter& writer, Clock::time_point epoch) const {
+    writer.BeginObject();
+    writer.Key("type").String(GetBrowserEventTypeName(type));
+    writer.Key("browser").Int(browser_id);
+    writer.Key("time_us").Int(
+        std::chrono::duration_cast<std::chrono::microseconds>(time - epoch).count());
+    switch (type) {
+        case BrowserEventType::kLoadStart:
+        case BrowserEventType::kAddressChange:
+            writer.Key("url").String(text());
+            break;
+        case BrowserEventType::kLoadEnd:
+            writer.Key("status").Int(code);
+            break;
+        case BrowserEventType::kLoadError:
+            writer.Key("error").Int(code);
+            writer.Key("url").String(text());
+            break;
+        case BrowserEventType::kTitleChange:
+            writer.Key("title").String(text());
+            break;
+        case BrowserEventType::kConsoleMessage:
+            writer.Key("level").Int(code);
+            writer.Key("message").String(text());
+            writer.Key("source").String(secondary_text());
+            writer.Key("line").Int(value);
+            break;
+        case BrowserEventType::kDownloadProgress:
+            writer.Key("id").Uint(id);
+            writer.Key("file").String(text());
+            writer.Key("percent").Int(code);
+            writer.Key("received").Int(value);
+            writer.Key("total").Int(total);
+            writer.Key("state").String(GetDownloadStateName(state));
+            break;
+        case BrowserEventType::kRendererRecovery:
+            writer.Key("url").String(text());
+            writer.Key("exit").String(secondary_text());
+            writer.Key("attempt").Uint(id);
+            writer.Key("url_exits").Int(total);
+            writer.Key("quarantined").Bool(code != 0);
+            if (value >= 0) {
+                writer.Key("reload_ms").Int(value);
+            }
+            break;
+        case BrowserEventType::kRendererHang:
+            writer.Key("url").String(text());
+            writer.Key("pid").Int(value);
+            writer.Key("closing").Bool(code != 0);
+            break;
+    }
+    if (truncated_) {
+        writer.Key("truncated").Bool(true);
+    }
+    writer.EndObject();
+}
+
+uint64_t EventPipelineStats::total_dropped() const {
+    uint64_t total = 0;
+    for (uint64_t count : dropped) {
+        total += count;
+    }
+    return total;
+}
+
+void EventPipelineStats::WriteJson(JsonWriter& writer) const {
+    writer.BeginObject();
+    writer.Key("published").Uint(published);
+    writer.Key("delivered").Uint(delivered);
+    writer.Key("coalesced").Uint(coalesced);
+    writer.Key("dropped").BeginObject();
+    for (size_t i = 0; i < kBrowserEventTypeCount; ++i) {
+        if (dropped[i]) {
+            writer.Key(GetBrowserEventTypeName(static_cast<BrowserEventType>(i))).Uint(dropped[i]);
+        }
+    }
+    writer.EndObject();
+    writer.EndObject();
+}
+
+EventPipeline::EventPipeline(const EventPipelineOptions& options) : options_(options) {
+    const size_t count = std::max<size_t>(options_.workers, 1);
+    for (size_t i = 0; i < count; ++i) {
+        workers_.push_back(std::make_unique<Worker>(options_.queue_size));
+    }
+}
+
+EventPipeline::~EventPipeline() {
+    Stop();
+}
+
+void EventPipeline::Start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    for (auto& worker : workers_) {
+        Worker* w = worker.get();
+        worker->thread = std::thread([this, w] { Run(*w); });
+    }
+}
+
+void EventPipeline::Stop() {
+    if (!running_.load() || stopping_.exchange(true)) {
+        return;
+    }
+    for (auto& worker : workers_) {
+        {
+            std::lock_guard<std::mutex> lock(worker->wake_lock);
+            worker->sleeping.store(false);
+        }
+        worker->wake.notify_one();
+    }
+    for (auto& worker : workers_) {
+        worker->thread.join();
+    }
+}
+
+bool EventPipeline::Publish(const BrowserEvent& event) {
+    published_.fetch_add(1, std::memory_order_relaxed);
+    if (stopping_.load(std::memory_order_relaxed)) {
+        dropped_[static_cast<size_t>(event.type)].fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Worker& worker =
+        *workers_[static_cast<unsigned int>(event.browser_id) % workers_.size()];
+
+    // The worker delivers the overflow after its ring, so with events waiting
+    // there the lock decides where |event| goes
+    if (worker.has_overflow.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(worker.overflow_lock);
+        return PublishLocked(worker, event);
+    }
+    if (worker.ring.TryPush(event)) {
+        Wake(worker);
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(worker.overflow_lock);
+    return PublishLocked(worker, event);
+}
+
+bool EventPipeline::PublishLocked(Worker& worker, const BrowserEvent& event) {
+    // An event behind waiting events of its browser must not overtake them
+    const bool behind = std::any_of(worker.overflow.begin(), worker.overflow.end(),
+                                    [&event](const BrowserEvent& queued) {
+                                        return queued.browser_id == event.browser_id;
+                                    });
+    if (!behind && worker.ring.TryPush(event)) {
+        Wake(worker);
+        return true;
+    }
+    if (behind || event.coalescible()) {
+        return Overflow(worker, event);
+    }
+    dropped_[static_cast<size_t>(event.type)].fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool EventPipeline::Overflow(Worker& worker, const BrowserEvent& event) {
+    // The earlier event of the key moves to the end rather than taking the
+    // new value in place, which would deliver it ahead of events in between
+    if (event.coalescible()) {
+        auto it = std::find_if(worker.overflow.begin(), worker.overflow.end(),
+                               [&event](const BrowserEvent& queued) {
+                                   return queued.SameKey(event);
+                               });
+        if (it != worker.overflow.end()) {
+            worker.overflow.erase(it);
+            worker.overflow.push_back(event);
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    if (worker.overflow.size() < options_.max_coalesced) {
+        worker.overflow.push_back(event);
+        worker.has_overflow.store(true, std::memory_order_release);
+        Wake(worker);
+        return true;
+    }
+    dropped_[static_cast<size_t>(event.type)].fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void EventPipeline::Wake(Worker& worker) {
+    // Pairs with the fence in Run(): either the worker sees the new event or
+    // this sees it sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!worker.sleeping.load(std::memory_order_relaxed)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(worker.wake_lock);
+        worker.sleeping.store(false, std::memory_order_relaxed);
+    }
+    worker.wake.notify_one();
+}
+
+void EventPipeline::Run(Worker& worker) {
+    std::vector<BrowserEvent> overflow;
+    int idle_polls = 0;
+    for (;;) {
+        size_t count = worker.ring.Drain(
+            [this](const BrowserEvent& event) { Deliver(event); }, kDrainBatch);
+
+        // Waiting events are newer than anything left in the ring of their
+        // browser, so they go once the ring has drained
+        if (count < kDrainBatch && worker.has_overflow.load(std::memory_order_acquire)) {
+            {
+                std::lock_guard<std::mutex> lock(worker.overflow_lock);
+                overflow.swap(worker.overflow);
+                worker.has_overflow.store(false, std::memory_order_release);
+            }
+            for (const BrowserEvent& event : overflow) {
+                Deliver(event);
+            }
+            count += overflow.size();
+            overflow.clear();
+        }
+        if (count > 0) {
+            idle_polls = 0;
+            continue;
+        }
+
+        // Callbacks come in bursts; polling a little longer spares the
+        // publisher a wakeup for the next event of the burst
+        if (++idle_polls < kIdlePolls && !stopping_.load(std::memory_order_relaxed)) {
+            std::this_thread::yield();
+            continue;
+        }
+        idle_polls = 0;
+
+        std::unique_lock<std::mutex> lock(worker.wake_lock);
+        if (stopping_.load()) {
+            break;
+        }
+        worker.sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!worker.ring.empty() || worker.has_overflow.load(std::memory_order_relaxed)) {
+            worker.sleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        worker.wake.wait(lock, [&worker] {
+            return !worker.sleeping.load(std::memory_order_relaxed);
+        });
+    }
+}
+
+void EventPipeline::Deliver(const BrowserEvent& event) {
+    {
+        std::shared_lock<std::shared_mutex> lock(observers_lock_);
+        for (BrowserEventObserver* observer : observers_) {
+            observer->OnBrowserEvent(event);
+        }
+    }
+    delivered_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventPipeline::AddObserver(BrowserEventObserver* observer) {
+    std::unique_lock<std::shared_mutex> lock(observers_lock_);
+    observers_.push_back(observer);
+    has_observers_.store(true, std::memory_order_relaxed);
+}
+
+void EventPipeline::RemoveObserver(BrowserEventObserver* observer) {
+    std::unique_lock<std::shared_mutex> lock(observers_lock_);
+    observers_.erase(std::remove(observers_.begin(), observers_.end(), observer),
+                     observers_.end());
+    has_observers_.store(!observers_.empty(), std::memory_order_relaxed);
+}
+
+EventPipelineStats EventPipeline::GetStats() const {
+    EventPipelineStats stats;
+    stats.published = published_.load(std::memory_order_relaxed);
+    stats.delivered = delivered_.load(std::memory_order_relaxed);
+    stats.coalesced = coalesced_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kBrowserEventTypeCount; ++i) {
+        stats.dropped[i] = dropped_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+EventPipeline* InitEventPipeline(const EventPipelineOptions& options) {
+    if (!g_pipeline) {
+        g_pipeline = std::make_unique<EventPipeline>(options);
+        g_pipeline->Start();
+        g_pipeline_ptr.store(g_pipeline.get(), std::memory_order_release);
+    }
+    return g_pipeline.get();
+}
+
+EventPipeline* GetEventPipeline() {
+    return g_pipeline_ptr.load(std::memory_order_acquire);
+}
+
+void ShutdownEventPipeline() {
+    if (g_pipeline) {
+        g_pipeline->Stop();
+    }
+}
@@ -0,0 +1,238 @@
+// CEF Browser - Browser Event Pipeline
+#ifndef CEF_BROWSER_EVENT_PIPELINE_H_
+#define CEF_BROWSER_EVENT_PIPELINE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "mpsc_ring.h"
+
+class JsonWriter;
+
+enum class BrowserEventType : uint8_t {
+    kLoadStart,         // text: URL
+    kLoadEnd,           // code: HTTP status
+    kLoadError,         // code: error code; text: URL
+    kAddressChange,     // text: URL
+    kTitleChange,       // text: title
+    kConsoleMessage,    // code: severity; value: line; text: message, source
+    kDownloadProgress,  // id; code: percent or -1; value/total: bytes; state; text: path
+    kRendererRecovery,  // id: attempt; code: 1 if quarantined; value: reload delay in ms or
+                        // -1; total: exits on the URL; text: URL, exit reason
+    kRendererHang,      // code: 1 if the browser is closed; value: renderer pid; text: URL
+};
+
+// BrowserEvent::state of kDownloadProgress
+enum class DownloadState : uint8_t {
+    kInProgress,
+    kComplete,
+    kCancelled,
+};
+
+constexpr size_t kBrowserEventTypeCount = 9;
+
+// Name of |type| as written to JSON, e.g. "load_start"
+const char* GetBrowserEventTypeName(BrowserEventType type);
+
+// Fixed-size record of one BrowserClient callback, copied into a ring slot
+// without allocating. Strings are truncated to fit.
+struct BrowserEvent {
+    using Clock = std::chrono::steady_clock;
+
+    BrowserEvent() = default;
+    BrowserEvent(BrowserEventType type, int browser_id);
+
+    // Store |text| and |secondary| one after the other, truncating |secondary|
+    // first
+    void SetText(std::string_view text, std::string_view secondary = {});
+
+    // Same for UTF-16 text, which is stored as is and converted when read so
+    // that the publishing thread never converts
+    void SetText(std::u16string_view text, std::u16string_view secondary = {});
+
+    // The stored text as UTF-8
+    std::string text() const;
+    std::string secondary_text() const;
+
+    // Whether SetText() had to cut anything
+    bool truncated() const { return truncated_; }
+
+    // Events that replace earlier ones of the same key when coalescing
+    bool coalescible() const {
+        return type == BrowserEventType::kTitleChange ||
+               type == BrowserEventType::kDownloadProgress;
+    }
+    bool SameKey(const BrowserEvent& other) const {
+        return type == other.type && browser_id == other.browser_id && id == other.id;
+    }
+
+    // Write {"type", "browser", ...} with the fields |type| uses; |time| is
+    // in microseconds since |epoch|
+    void WriteJson(JsonWriter& writer, Clock::time_point epoch) const;
+
+    static constexpr size_t kTextCapacity = 200;
+
+    Clock::time_point time;
+    int64_t value = 0;
+    int64_t total = 0;
+    int browser_id = 0;
+    int code = 0;
+    uint32_t id = 0;
+    BrowserEventType type = BrowserEventType::kLoadStart;
+    DownloadState state = DownloadState::kInProgress;
+
+private:
+    std::string ReadText(size_t offset, size_t length) const;
+
+    bool truncated_ = false;
+    bool utf16_ = false;
+
+    // In bytes
+    uint8_t text_length_ = 0;
+    uint8_t secondary_length_ = 0;
+    char text_[kTextCapacity];
+};
+
+// Receives events on a pipeline worker thread. Events of one browser arrive
+// in order on one worker, where a coalesced event stands in for the earlier
+// ones of its key; events of different browsers may arrive concurrently on
+// different workers.
+class BrowserEventObserver {
+public:
+    virtual ~BrowserEventObserver() = default;
+
+    virtual void OnBrowserEvent(const BrowserEvent& event) = 0;
+};
+
+struct EventPipelineOptions {
+    // Worker threads; browsers are spread across them by identifier
+    size_t workers = 2;
+
+    // Ring slots per worker
+    size_t queue_size = 4096;
+
+    // Events kept per worker while its ring is full: coalescible events, and
+    // any later events of their browsers
+    size_t max_coalesced = 64;
+};
+
+struct EventPipelineStats {
+    uint64_t published = 0;
+    uint64_t delivered = 0;
+
+    // Replaced by a later event of the same key while the ring was full
+    uint64_t coalesced = 0;
+
+    // Dropped because the ring was full, per BrowserEventType
+    uint64_t dropped[kBrowserEventTypeCount] = {};
+
+    uint64_t total_dropped() const;
+
+    // Write {"published", "delivered", "coalesced", "dropped": {type: n}}
+    void WriteJson(JsonWriter& writer) const;
+};
+
+// Moves work triggered by browser callbacks off the CEF UI thread. Publish()
+// copies an event into a lock-free ring owned by one of the worker threads,
+// which hand it to every observer. A full ring never blocks the publisher:
+// title and download progress events are coalesced, keeping the latest per
+// key, and everything else is dropped and counted. Once a browser has
+// coalesced events waiting, its later events queue behind them.
+class EventPipeline {
+public:
+    explicit EventPipeline(const EventPipelineOptions& options);
+    ~EventPipeline();
+
+    EventPipeline(const EventPipeline&) = delete;
+    EventPipeline& operator=(const EventPipeline&) = delete;
+
+    // Start the workers
+    void Start();
+
+    // Deliver what is queued, then stop the workers. Later events are dropped.
+    void Stop();
+
+    // Queue |event| for the observers. Returns false if it was dropped. Any
+    // thread; never blocks unless the ring of |event|'s browser is full.
+    bool Publish(const BrowserEvent& event);
+
+    // |observer| must stay alive until it is removed or the pipeline stops.
+    // RemoveObserver() waits for deliveries to |observer| in progress. Any
+    // thread except a worker.
+    void AddObserver(BrowserEventObserver* observer);
+    void RemoveObserver(BrowserEventObserver* observer);
+
+    // Whether publishing is worth the copy
+    bool has_observers() const { return has_observers_.load(std::memory_order_relaxed); }
+
+    EventPipelineStats GetStats() const;
+
+private:
+    struct Worker {
+        explicit Worker(size_t queue_size) : ring(queue_size) {}
+
+        MpscRing<BrowserEvent> ring;
+
+        // Events waiting for ring space, oldest first: coalesced events and
+        // the events of their browsers published after them
+        std::mutex overflow_lock;
+        std::vector<BrowserEvent> overflow;
+        std::atomic<bool> has_overflow{false};
+
+        // Set while the thread waits for events
+        std::mutex wake_lock;
+        std::condition_variable wake;
+        std::atomic<bool> sleeping{false};
+
+        std::thread thread;
+    };
+
+    void Run(Worker& worker);
+    void Wake(Worker& worker);
+    void Deliver(const BrowserEvent& event);
+
+    // Queue |event| behind its browser's waiting events, if it has any; push
+    // it to the ring otherwise, then coalesce or drop it if the ring is full.
+    // Called with |overflow_lock| held.
+    bool PublishLocked(Worker& worker, const BrowserEvent& event);
+
+    // Append |event| to the overflow, replacing an earlier event of its key.
+    // Called with |overflow_lock| held.
+    bool Overflow(Worker& worker, const BrowserEvent& event);
+
+    const EventPipelineOptions options_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopping_{false};
+
+    mutable std::shared_mutex observers_lock_;
+    std::vector<BrowserEventObserver*> observers_;
+    std::atomic<bool> has_observers_{false};
+
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> coalesced_{0};
+    std::atomic<uint64_t> dropped_[kBrowserEventTypeCount] = {};
+};
+
+// Create and start the process-wide pipeline, or return it if it exists
+EventPipeline* InitEventPipeline(const EventPipelineOptions& options);
+
+// The process-wide pipeline, or nullptr if none was created. Any thread.
+EventPipeline* GetEventPipeline();
+
+// Deliver what is queued and stop the process-wide pipeline; it stays valid
+// and drops later events
+void ShutdownEventPipeline();
+
+#endif  // CEF_BROWSER_EVENT_PIPELINE_H_
@@ -0,0 +1,36 @@
+// CEF Browser - Off-screen Frame Buffer Implementation
+#include "frame_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+bool FrameBuffer::Resize(const void* buffer, int width, int height) {
+    if (width == width_ && height == height_) {
+        return false;
+    }
+
+    const uint8_t* src = static_cast<const uint8_t*>(buffer);
+    width_ = width;
+    height_ = height;
+    pixels_.assign(src, src + stride() * height);
+    return true;
+}
+
+void FrameBuffer::CopyRect(const void* buffer, int x, int y, int width, int height) {
+    // Clip to the view in case CEF reports a rect from a previous size
+    int x0 = std::max(x, 0);
+    int y0 = std::max(y, 0);
+    int x1 = std::min(x + width, width_);
+    int y1 = std::min(y + height, height_);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    const uint8_t* src = static_cast<const uint8_t*>(buffer);
+    const size_t offset = static_cast<size_t>(x0) * kBytesPerPixel;
+    const size_t count = static_cast<size_t>(x1 - x0) * kBytesPerPixel;
+    for (int row = y0; row < y1; ++row) {
+        const size_t start = row * stride() + offset;
+        memcpy(&pixels_[start], src + start, count);
+    }
+}
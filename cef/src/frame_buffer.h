@@ -0,0 +1,51 @@
+// CEF Browser - Off-screen Frame Buffer
+#ifndef CEF_BROWSER_FRAME_BUFFER_H_
+#define CEF_BROWSER_FRAME_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// CPU-side BGRA copy of an off-screen browser view. Updated from OnPaint on
+// the UI thread; only dirty rectangles are copied once the size is stable.
+class FrameBuffer {
+public:
+    FrameBuffer() = default;
+
+    // Copy the |dirty| rects of a |width| x |height| BGRA |buffer|. The whole
+    // buffer is copied when the size changes. |dirty| is any list of rects
+    // with x, y, width and height members, such as CefRenderHandler::RectList.
+    template <typename RectList>
+    void Paint(const void* buffer, int width, int height, const RectList& dirty) {
+        if (!Resize(buffer, width, height)) {
+            for (const auto& rect : dirty) {
+                CopyRect(buffer, rect.x, rect.y, rect.width, rect.height);
+            }
+        }
+        ++frame_count_;
+    }
+
+    const uint8_t* data() const { return pixels_.data(); }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    size_t stride() const { return static_cast<size_t>(width_) * kBytesPerPixel; }
+
+    // Number of paints received so far
+    uint64_t frame_count() const { return frame_count_; }
+
+    static constexpr int kBytesPerPixel = 4;
+
+private:
+    // Copy all of |buffer| if the size changed. Returns false otherwise.
+    bool Resize(const void* buffer, int width, int height);
+
+    // Copy one rect from |buffer|, which has the current size
+    void CopyRect(const void* buffer, int x, int y, int width, int height);
+
+    std::vector<uint8_t> pixels_;
+    int width_ = 0;
+    int height_ = 0;
+    uint64_t frame_count_ = 0;
+};
+
+#endif  // CEF_BROWSER_FRAME_BUFFER_H_
@@ -0,0 +1,292 @@
+// CEF Browser - GPU Detection Implementation
+#include "gpu_detection.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+#if defined(__linux__)
+#include <dlfcn.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool ContainsIgnoreCase(std::string_view text, std::string_view part) {
+    return std::search(text.begin(), text.end(), part.begin(), part.end(), [](char a, char b) {
+               return std::tolower(static_cast<unsigned char>(a)) ==
+                      std::tolower(static_cast<unsigned char>(b));
+           }) != text.end();
+}
+
+#if defined(__linux__)
+
+// The EGL subset the probe needs, so no EGL headers or libraries are required
+// at build time
+using EGLDisplay = void*;
+using EGLContext = void*;
+using EGLBoolean = unsigned int;
+using EGLenum = unsigned int;
+using EGLint = int32_t;
+
+constexpr EGLenum kEglPlatformSurfacelessMesa = 0x31DD;
+constexpr EGLint kEglNone = 0x3038;
+constexpr EGLint kEglContextClientVersion = 0x3098;
+constexpr EGLenum kEglOpenGlEsApi = 0x30A0;
+constexpr unsigned int kGlRenderer = 0x1F01;
+
+using EglGetProcAddress = void* (*)(const char*);
+using EglGetPlatformDisplay = EGLDisplay (*)(EGLenum, void*, const EGLint*);
+using EglGetDisplay = EGLDisplay (*)(void*);
+using EglInitialize = EGLBoolean (*)(EGLDisplay, EGLint*, EGLint*);
+using EglBindApi = EGLBoolean (*)(EGLenum);
+using EglCreateContext = EGLContext (*)(EGLDisplay, void*, EGLContext, const EGLint*);
+using EglMakeCurrent = EGLBoolean (*)(EGLDisplay, void*, void*, EGLContext);
+using GlGetString = const unsigned char* (*)(unsigned int);
+
+// Create a surfaceless GLES context and return GL_RENDERER, or "!" and the
+// failing step. Runs in the forked child.
+std::string ProbeEglRenderer() {
+    void* egl = dlopen("libEGL.so.1", RTLD_NOW | RTLD_LOCAL);
+    if (!egl) {
+        return "!libEGL.so.1 not found";
+    }
+    auto get_proc = reinterpret_cast<EglGetProcAddress>(dlsym(egl, "eglGetProcAddress"));
+    if (!get_proc) {
+        return "!eglGetProcAddress missing";
+    }
+
+    auto get_platform_display =
+        reinterpret_cast<EglGetPlatformDisplay>(get_proc("eglGetPlatformDisplayEXT"));
+    auto get_display = reinterpret_cast<EglGetDisplay>(dlsym(egl, "eglGetDisplay"));
+    auto initialize = reinterpret_cast<EglInitialize>(dlsym(egl, "eglInitialize"));
+    auto bind_api = reinterpret_cast<EglBindApi>(dlsym(egl, "eglBindAPI"));
+    auto create_context = reinterpret_cast<EglCreateContext>(dlsym(egl, "eglCreateContext"));
+    auto make_current = reinterpret_cast<EglMakeCurrent>(dlsym(egl, "eglMakeCurrent"));
+    if (!get_display || !initialize || !bind_api || !create_context || !make_current) {
+        return "!EGL entry points missing";
+    }
+
+    // Surfaceless needs no display server; the default display may need one
+    EGLDisplay display = nullptr;
+    if (get_platform_display) {
+        display = get_platform_display(kEglPlatformSurfacelessMesa, nullptr, nullptr);
+    }
+    EGLint major = 0;
+    EGLint minor = 0;
+    if (!display || !initialize(display, &major, &minor)) {
+        display = get_display(nullptr);
+        if (!display || !initialize(display, &major, &minor)) {
+            return "!eglInitialize failed";
+        }
+    }
+
+    const EGLint attributes[] = {kEglContextClientVersion, 2, kEglNone};
+    if (!bind_api(kEglOpenGlEsApi)) {
+        return "!eglBindAPI failed";
+    }
+    EGLContext context = create_context(display, nullptr, nullptr, attributes);
+    if (!context || !make_current(display, nullptr, nullptr, context)) {
+        return "!no surfaceless GLES context";
+    }
+
+    auto get_string = reinterpret_cast<GlGetString>(get_proc("glGetString"));
+    if (!get_string) {
+        void* gles = dlopen("libGLESv2.so.2", RTLD_NOW | RTLD_LOCAL);
+        get_string = gles ? reinterpret_cast<GlGetString>(dlsym(gles, "glGetString")) : nullptr;
+    }
+    const unsigned char* renderer = get_string ? get_string(kGlRenderer) : nullptr;
+    if (!renderer) {
+        return "!glGetString(GL_RENDERER) failed";
+    }
+    return reinterpret_cast<const char*>(renderer);
+}
+
+// Run ProbeEglRenderer() in a child process so a hanging or crashing driver
+// cannot take the browser down and its libraries are not loaded here
+std::string ProbeEglRendererInChild(int timeout_ms) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return "!pipe failed";
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return "!fork failed";
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        std::string result = ProbeEglRenderer();
+        ssize_t written = write(fds[1], result.data(), result.size());
+        (void)written;
+        _exit(0);
+    }
+
+    close(fds[1]);
+    std::string result;
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        int remaining = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now())
+                .count());
+        pollfd pfd = {fds[0], POLLIN, 0};
+        if (remaining <= 0 || poll(&pfd, 1, remaining) <= 0) {
+            kill(pid, SIGKILL);
+            result = "!timed out";
+            break;
+        }
+        char buffer[256];
+        ssize_t bytes = read(fds[0], buffer, sizeof(buffer));
+        if (bytes <= 0) {
+            if (result.empty()) {
+                result = "!probe process failed";
+            }
+            break;
+        }
+        result.append(buffer, bytes);
+    }
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return result;
+}
+
+#endif  // __linux__
+
+double MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+std::vector<DrmRenderNode> FindRenderNodes(const std::string& dev_dir, const std::string& sys_dir) {
+    std::vector<DrmRenderNode> nodes;
+    std::error_code error;
+    for (const fs::directory_entry& entry : fs::directory_iterator(dev_dir, error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("renderD", 0) != 0) {
+            continue;
+        }
+
+        DrmRenderNode node;
+        node.path = entry.path().string();
+
+        // /sys/class/drm/renderD128/device/driver links to the driver
+        fs::path driver = fs::read_symlink(fs::path(sys_dir) / name / "device" / "driver", error);
+        if (!error) {
+            node.driver = driver.filename().string();
+        }
+#if defined(__linux__)
+        node.accessible = access(node.path.c_str(), R_OK | W_OK) == 0;
+#endif
+        nodes.push_back(std::move(node));
+    }
+    std::sort(nodes.begin(), nodes.end(),
+              [](const DrmRenderNode& a, const DrmRenderNode& b) { return a.path < b.path; });
+    return nodes;
+}
+
+bool IsSoftwareDrmDriver(std::string_view driver) {
+    return driver == "vgem" || driver == "vkms";
+}
+
+bool IsSoftwareGlRenderer(std::string_view renderer) {
+    for (const char* name : {"llvmpipe", "softpipe", "swiftshader", "software rasterizer"}) {
+        if (ContainsIgnoreCase(renderer, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+GpuProbeResult ProbeGpu(int timeout_ms) {
+    GpuProbeResult result;
+    const Clock::time_point start = Clock::now();
+
+#if defined(__linux__)
+    result.render_nodes = FindRenderNodes();
+
+    const DrmRenderNode* candidate = nullptr;
+    const DrmRenderNode* inaccessible = nullptr;
+    for (const DrmRenderNode& node : result.render_nodes) {
+        if (IsSoftwareDrmDriver(node.driver)) {
+            continue;
+        }
+        if (node.accessible) {
+            candidate = &node;
+            break;
+        }
+        inaccessible = &node;
+    }
+
+    if (!candidate) {
+        if (inaccessible) {
+            result.reason = "no access to " + inaccessible->path;
+        } else if (!result.render_nodes.empty()) {
+            result.reason = "only virtual DRM render nodes";
+        } else {
+            result.reason = "no DRM render node";
+        }
+    } else {
+        std::string renderer = ProbeEglRendererInChild(timeout_ms);
+        if (!renderer.empty() && renderer[0] == '!') {
+            result.reason = "EGL probe: " + renderer.substr(1);
+        } else {
+            result.gl_renderer = renderer;
+            result.hardware = !IsSoftwareGlRenderer(renderer);
+            result.reason = (result.hardware ? "" : "software ") + std::string("GL renderer ") +
+                            renderer + " on " + candidate->path +
+                            (candidate->driver.empty() ? "" : " (" + candidate->driver + ")");
+        }
+    }
+#else
+    result.hardware = true;
+    result.reason = "assumed on this platform";
+#endif
+
+    result.elapsed_ms = MillisecondsSince(start);
+    return result;
+}
+
+bool GetRenderingConfig(std::string_view name, RenderingConfig* config) {
+    RenderingConfig result;
+    result.name = std::string(name);
+    if (name == "gpu") {
+        result.switches = {{"enable-gpu", ""},
+                           {"enable-gpu-rasterization", ""},
+                           {"enable-zero-copy", ""},
+                           {"ignore-gpu-blocklist", ""}};
+    } else if (name == "software") {
+        // Tiles are rastered by the renderer's raster threads (sized by the
+        // performance profile) and composited in software by the display
+        // compositor; WebGL gets no SwiftShader context to spin on
+        result.switches = {{"disable-gpu", ""},
+                           {"disable-gpu-compositing", ""},
+                           {"disable-software-rasterizer", ""}};
+    } else if (name == "swiftshader") {
+        result.switches = {{"use-gl", "angle"},
+                           {"use-angle", "swiftshader"},
+                           {"enable-unsafe-swiftshader", ""},
+                           {"enable-gpu-rasterization", ""},
+                           {"ignore-gpu-blocklist", ""}};
+    } else {
+        return false;
+    }
+    *config = std::move(result);
+    return true;
+}
+
+std::vector<std::string> GetRenderingConfigNames() {
+    return {"gpu", "software", "swiftshader"};
+}
@@ -0,0 +1,72 @@
+// CEF Browser - GPU Detection
+#ifndef CEF_BROWSER_GPU_DETECTION_H_
+#define CEF_BROWSER_GPU_DETECTION_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "performance_profile.h"
+
+// A DRM render node, e.g. /dev/dri/renderD128
+struct DrmRenderNode {
+    std::string path;
+
+    // Kernel driver, e.g. "i915", "amdgpu" or "vgem"; empty if unknown
+    std::string driver;
+
+    // Whether this process may open the node
+    bool accessible = false;
+};
+
+// Render nodes in |dev_dir| with their drivers from |sys_dir|, sorted by path
+std::vector<DrmRenderNode> FindRenderNodes(const std::string& dev_dir = "/dev/dri",
+                                           const std::string& sys_dir = "/sys/class/drm");
+
+// Whether |driver| is a virtual DRM driver without acceleration
+bool IsSoftwareDrmDriver(std::string_view driver);
+
+// Whether |renderer|, a GL_RENDERER string, names a CPU rasterizer such as
+// llvmpipe or SwiftShader
+bool IsSoftwareGlRenderer(std::string_view renderer);
+
+struct GpuProbeResult {
+    // A hardware GPU is usable
+    bool hardware = false;
+
+    std::vector<DrmRenderNode> render_nodes;
+
+    // GL_RENDERER of the EGL probe; empty if it did not run or failed
+    std::string gl_renderer;
+
+    // Why |hardware| was decided, for logging
+    std::string reason;
+
+    double elapsed_ms = 0;
+};
+
+// Probe for a usable GPU. On Linux, render nodes with hardware drivers are
+// looked up first; only when one is accessible does a forked child create a
+// surfaceless EGL context and read GL_RENDERER, giving up after |timeout_ms|.
+// The child keeps the GL driver out of this process. Call while the process is
+// single-threaded. Other platforms are assumed to have a GPU.
+GpuProbeResult ProbeGpu(int timeout_ms = 2000);
+
+// Named set of Chromium rendering switches:
+//   gpu          hardware compositing and GPU rasterization
+//   software     CPU raster and software compositing in the browser process,
+//                with no SwiftShader fallback, for hosts without a GPU
+//   swiftshader  GPU compositing and rasterization on SwiftShader, what
+//                Chromium falls back to when the GPU switches meet no GPU
+struct RenderingConfig {
+    std::string name;
+    std::vector<CommandLineSwitch> switches;
+};
+
+// Get rendering configuration |name|. Returns false for unknown names.
+bool GetRenderingConfig(std::string_view name, RenderingConfig* config);
+
+// Names accepted by GetRenderingConfig()
+std::vector<std::string> GetRenderingConfigNames();
+
+#endif  // CEF_BROWSER_GPU_DETECTION_H_
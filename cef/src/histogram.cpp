@@ -0,0 +1,128 @@
+// CEF Browser - High Dynamic Range Histogram Implementation
+#include "histogram.h"
+#include "json_writer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Values below kLinearCount get one bucket each. Above that every power of two
+// is split into kSubBuckets linear buckets.
+constexpr int kSubBucketBits = 6;
+constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+constexpr uint64_t kLinearCount = kSubBuckets * 2;
+
+int HighestBit(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+}  // namespace
+
+Histogram::Histogram() : counts_(BucketIndex(kMaxValue) + 1, 0) {}
+
+size_t Histogram::BucketIndex(uint64_t value) {
+    if (value < kLinearCount) {
+        return static_cast<size_t>(value);
+    }
+    // value >> shift lands in [kSubBuckets, 2 * kSubBuckets)
+    const int shift = HighestBit(value) - kSubBucketBits;
+    return static_cast<size_t>((shift + 1) * kSubBuckets + ((value >> shift) - kSubBuckets));
+}
+
+uint64_t Histogram::BucketUpperBound(size_t index) {
+    if (index < kLinearCount) {
+        return index;
+    }
+    const int shift = static_cast<int>(index / kSubBuckets) - 1;
+    const uint64_t sub_bucket = index % kSubBuckets + kSubBuckets;
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+void Histogram::RecordCount(uint64_t value, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    value = std::min(value, kMaxValue);
+    counts_[BucketIndex(value)] += count;
+
+    if (count_ == 0 || value < min_) {
+        min_ = value;
+    }
+    max_ = std::max(max_, value);
+    count_ += count;
+    sum_ += value * count;
+}
+
+void Histogram::Merge(const Histogram& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+    }
+
+    if (count_ == 0 || other.min_ < min_) {
+        min_ = other.min_;
+    }
+    max_ = std::max(max_, other.max_);
+    count_ += other.count_;
+    sum_ += other.sum_;
+}
+
+void Histogram::Reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = 0;
+    max_ = 0;
+}
+
+double Histogram::mean() const {
+    return count_ ? static_cast<double>(sum_) / count_ : 0.0;
+}
+
+uint64_t Histogram::ValueAtPercentile(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    const uint64_t rank =
+        std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * count_)));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            // Never report beyond what was actually recorded
+            return std::min(BucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+void Histogram::WriteJson(JsonWriter& writer) const {
+    writer.BeginObject();
+    writer.Key("count").Uint(count_);
+    writer.Key("min").Uint(min());
+    writer.Key("mean").Double(mean());
+    writer.Key("p50").Uint(ValueAtPercentile(50.0));
+    writer.Key("p90").Uint(ValueAtPercentile(90.0));
+    writer.Key("p99").Uint(ValueAtPercentile(99.0));
+    writer.Key("p999").Uint(ValueAtPercentile(99.9));
+    writer.Key("max").Uint(max_);
+    writer.EndObject();
+}
@@ -0,0 +1,54 @@
+// CEF Browser - High Dynamic Range Histogram
+#ifndef CEF_BROWSER_HISTOGRAM_H_
+#define CEF_BROWSER_HISTOGRAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class JsonWriter;
+
+// Log-linear histogram of non-negative integer values (e.g. microseconds).
+// Values up to kMaxValue are recorded with 64 sub-buckets per power of two,
+// i.e. within 1.6% relative error, in constant time and a fixed 18 KB. Not
+// thread-safe; each histogram is owned by one thread.
+class Histogram {
+public:
+    Histogram();
+
+    // Record |value|, clamped to kMaxValue
+    void Record(uint64_t value) { RecordCount(value, 1); }
+    void RecordCount(uint64_t value, uint64_t count);
+
+    // Add all values of |other|
+    void Merge(const Histogram& other);
+
+    void Reset();
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const;
+
+    // Smallest recorded value such that |percentile| percent of values are at
+    // or below it, reported as the upper bound of its bucket. 0 when empty.
+    uint64_t ValueAtPercentile(double percentile) const;
+
+    // Write {"count", "min", "mean", "p50", "p90", "p99", "p999", "max"}
+    void WriteJson(JsonWriter& writer) const;
+
+    static constexpr uint64_t kMaxValue = (uint64_t{1} << 40) - 1;
+
+    // Bucket layout, exposed for tests
+    static size_t BucketIndex(uint64_t value);
+    static uint64_t BucketUpperBound(size_t index);
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = 0;
+    uint64_t max_ = 0;
+};
+
+#endif  // CEF_BROWSER_HISTOGRAM_H_
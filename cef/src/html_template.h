@@ -0,0 +1,123 @@
+// CEF Browser - Compile-time HTML Templates
+#ifndef CEF_BROWSER_HTML_TEMPLATE_H_
+#define CEF_BROWSER_HTML_TEMPLATE_H_
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Count the {{slot}} markers in a template source
+constexpr size_t CountTemplateSlots(std::string_view source) {
+    size_t count = 0;
+    for (size_t pos = source.find("{{"); pos != std::string_view::npos;
+         pos = source.find("{{", pos + 2)) {
+        ++count;
+    }
+    return count;
+}
+
+// Get the length of |value| after HTML escaping
+inline size_t HtmlEscapedLength(std::string_view value) {
+    size_t length = value.size();
+    for (char c : value) {
+        switch (c) {
+            case '&':
+                length += 4;  // &amp;
+                break;
+            case '<':
+            case '>':
+                length += 3;  // &lt; &gt;
+                break;
+            case '"':
+            case '\'':
+                length += 4;  // &#34; &#39;
+                break;
+            default:
+                break;
+        }
+    }
+    return length;
+}
+
+// Append |value| to |out| with HTML special characters escaped
+inline void AppendHtmlEscaped(std::string_view value, std::string* out) {
+    for (char c : value) {
+        switch (c) {
+            case '&':
+                out->append("&amp;");
+                break;
+            case '<':
+                out->append("&lt;");
+                break;
+            case '>':
+                out->append("&gt;");
+                break;
+            case '"':
+                out->append("&#34;");
+                break;
+            case '\'':
+                out->append("&#39;");
+                break;
+            default:
+                out->push_back(c);
+        }
+    }
+}
+
+// HTML template whose static fragments are split around {{slot}} markers at
+// compile time. Slot values are HTML-escaped and the page is rendered into a
+// single exactly-sized allocation.
+//
+//   constexpr std::string_view kSource = "<p>{{name}}</p>";
+//   constexpr HtmlTemplate<CountTemplateSlots(kSource)> kPage(kSource);
+//   std::string html = kPage.Render({name});
+template <size_t kSlots>
+class HtmlTemplate {
+public:
+    constexpr explicit HtmlTemplate(std::string_view source) : fragments_{}, names_{} {
+        size_t pos = 0;
+        for (size_t i = 0; i < kSlots; ++i) {
+            size_t open = source.find("{{", pos);
+            size_t close = source.find("}}", open);
+            fragments_[i] = source.substr(pos, open - pos);
+            names_[i] = source.substr(open + 2, close - open - 2);
+            pos = close + 2;
+        }
+        fragments_[kSlots] = source.substr(pos);
+
+        for (std::string_view fragment : fragments_) {
+            static_size_ += fragment.size();
+        }
+    }
+
+    // Total size of the static fragments
+    constexpr size_t static_size() const { return static_size_; }
+
+    // Name of slot |index|, in order of appearance
+    constexpr std::string_view slot_name(size_t index) const { return names_[index]; }
+
+    // Render the template with |values| in slot order
+    std::string Render(const std::array<std::string_view, kSlots>& values) const {
+        size_t size = static_size_;
+        for (std::string_view value : values) {
+            size += HtmlEscapedLength(value);
+        }
+
+        std::string result;
+        result.reserve(size);
+        for (size_t i = 0; i < kSlots; ++i) {
+            result.append(fragments_[i]);
+            AppendHtmlEscaped(values[i], &result);
+        }
+        result.append(fragments_[kSlots]);
+        return result;
+    }
+
+private:
+    std::array<std::string_view, kSlots + 1> fragments_;
+    std::array<std::string_view, kSlots> names_;
+    size_t static_size_ = 0;
+};
+
+#endif  // CEF_BROWSER_HTML_TEMPLATE_H_
@@ -0,0 +1,342 @@
+// CEF Browser - HTTP Record/Replay Archive Implementation
+#include "http_archive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace {
+
+constexpr uint64_t kBodyAlignment = 16;
+
+// Query parameters that only defeat caches and never select content
+constexpr std::string_view kNoiseParameters[] = {
+    "_", "cb", "cachebuster", "nocache", "rand", "random", "rnd", "ts", "timestamp", "_t",
+    "correlator", "nonce",
+};
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+std::vector<std::string_view> SplitQuery(std::string_view query) {
+    std::vector<std::string_view> parameters;
+    while (!query.empty()) {
+        size_t amp = query.find('&');
+        std::string_view parameter = query.substr(0, amp);
+        query.remove_prefix(amp == std::string_view::npos ? query.size() : amp + 1);
+        if (!parameter.empty()) {
+            parameters.push_back(parameter);
+        }
+    }
+    return parameters;
+}
+
+std::string_view GetParameterName(std::string_view parameter) {
+    return parameter.substr(0, parameter.find('='));
+}
+
+// Similarity of two sorted, normalized queries: two points per identical
+// parameter and one per parameter name present in both
+int ScoreQuery(const std::vector<std::string_view>& request,
+               const std::vector<std::string_view>& recorded) {
+    int score = 0;
+    for (std::string_view parameter : recorded) {
+        if (std::binary_search(request.begin(), request.end(), parameter)) {
+            score += 2;
+            continue;
+        }
+        std::string_view name = GetParameterName(parameter);
+        if (std::any_of(request.begin(), request.end(), [name](std::string_view p) {
+                return GetParameterName(p) == name;
+            })) {
+            score += 1;
+        }
+    }
+    return score;
+}
+
+}  // namespace
+
+std::string GetHttpArchiveKey(std::string_view method, std::string_view url,
+                              std::string* normalized_query) {
+    url = url.substr(0, url.find('#'));
+    size_t question = url.find('?');
+    std::string_view query =
+        question == std::string_view::npos ? std::string_view() : url.substr(question + 1);
+    url = url.substr(0, question);
+
+    std::string key;
+    key.reserve(method.size() + 1 + url.size());
+    key.append(method);
+    key.push_back(' ');
+
+    // Scheme and host are case-insensitive; the path is not
+    size_t authority = url.find("://");
+    size_t path = url.find('/', authority == std::string_view::npos ? 0 : authority + 3);
+    if (path == std::string_view::npos) {
+        path = url.size();
+    }
+    for (size_t i = 0; i < path; ++i) {
+        char c = url[i];
+        key.push_back((c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c);
+    }
+    key.append(url.substr(path));
+    if (path == url.size()) {
+        key.push_back('/');
+    }
+
+    if (normalized_query) {
+        std::vector<std::string_view> parameters = SplitQuery(query);
+        parameters.erase(std::remove_if(parameters.begin(), parameters.end(),
+                                        [](std::string_view parameter) {
+                                            std::string_view name = GetParameterName(parameter);
+                                            return std::find(std::begin(kNoiseParameters),
+                                                             std::end(kNoiseParameters),
+                                                             name) != std::end(kNoiseParameters);
+                                        }),
+                         parameters.end());
+        std::sort(parameters.begin(), parameters.end());
+
+        normalized_query->clear();
+        for (std::string_view parameter : parameters) {
+            if (!normalized_query->empty()) {
+                normalized_query->push_back('&');
+            }
+            normalized_query->append(parameter);
+        }
+    }
+
+    return key;
+}
+
+// ============================================================================
+// HttpArchive
+// ============================================================================
+
+bool HttpArchive::Open(const std::string& path) {
+    index_ = nullptr;
+    entry_count_ = 0;
+    served_.reset();
+
+    if (!file_.Open(path) || file_.size() < sizeof(HttpArchiveHeader)) {
+        return false;
+    }
+
+    HttpArchiveHeader header;
+    memcpy(&header, file_.data(), sizeof(header));
+    if (memcmp(header.magic, kHttpArchiveMagic, sizeof(header.magic)) != 0 ||
+        header.version != kHttpArchiveVersion) {
+        return false;
+    }
+
+    uint64_t index_end =
+        sizeof(HttpArchiveHeader) + uint64_t{header.entry_count} * sizeof(HttpArchiveEntry);
+    if (index_end > file_.size()) {
+        return false;
+    }
+
+    // Validate every entry up front so lookups never bounds-check
+    auto* index = reinterpret_cast<const HttpArchiveEntry*>(file_.data() + sizeof(header));
+    const uint64_t size = file_.size();
+    for (uint32_t i = 0; i < header.entry_count; ++i) {
+        const HttpArchiveEntry& entry = index[i];
+        if (uint64_t{entry.key_offset} + entry.key_length > size ||
+            uint64_t{entry.query_offset} + entry.query_length > size ||
+            uint64_t{entry.url_offset} + entry.url_length > size ||
+            uint64_t{entry.status_text_offset} + entry.status_text_length > size ||
+            uint64_t{entry.mime_type_offset} + entry.mime_type_length > size ||
+            uint64_t{entry.headers_offset} + entry.headers_length > size ||
+            entry.body_offset > size || entry.body_size > size - entry.body_offset) {
+            return false;
+        }
+    }
+
+    index_ = index;
+    entry_count_ = header.entry_count;
+    served_ = std::make_unique<std::atomic<uint32_t>[]>(entry_count_);
+    for (uint32_t i = 0; i < entry_count_; ++i) {
+        served_[i].store(0, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool HttpArchive::Lookup(std::string_view method, std::string_view url,
+                         HttpArchiveResponse* response) const {
+    if (!index_) {
+        return false;
+    }
+
+    std::string query;
+    const std::string key = GetHttpArchiveKey(method, url, &query);
+
+    const HttpArchiveEntry* end = index_ + entry_count_;
+    const HttpArchiveEntry* first =
+        std::lower_bound(index_, end, key, [this](const HttpArchiveEntry& entry,
+                                                  std::string_view k) {
+            return GetString(entry.key_offset, entry.key_length) < k;
+        });
+    const HttpArchiveEntry* last = first;
+    while (last != end && GetString(last->key_offset, last->key_length) == key) {
+        ++last;
+    }
+    if (first == last) {
+        return false;
+    }
+
+    // Candidates with the best query match, in recording order
+    const std::vector<std::string_view> parameters = SplitQuery(query);
+    std::vector<uint32_t> best;
+    int best_score = -1;
+    for (const HttpArchiveEntry* it = first; it != last; ++it) {
+        std::string_view recorded = GetString(it->query_offset, it->query_length);
+        int score = recorded == query ? std::numeric_limits<int>::max()
+                                      : ScoreQuery(parameters, SplitQuery(recorded));
+        if (score > best_score) {
+            best.clear();
+            best_score = score;
+        }
+        if (score == best_score) {
+            best.push_back(static_cast<uint32_t>(it - index_));
+        }
+    }
+
+    // Serve repeated requests in recording order, then repeat the last
+    uint32_t chosen = best.back();
+    for (uint32_t candidate : best) {
+        uint32_t unserved = 0;
+        if (served_[candidate].compare_exchange_strong(unserved, 1, std::memory_order_relaxed)) {
+            chosen = candidate;
+            break;
+        }
+    }
+
+    const HttpArchiveEntry& entry = index_[chosen];
+    response->url = GetString(entry.url_offset, entry.url_length);
+    response->status = static_cast<int>(entry.status);
+    response->status_text = GetString(entry.status_text_offset, entry.status_text_length);
+    response->mime_type = GetString(entry.mime_type_offset, entry.mime_type_length);
+    response->body = std::string_view(file_.data() + entry.body_offset, entry.body_size);
+
+    response->headers.clear();
+    std::string_view headers = GetString(entry.headers_offset, entry.headers_length);
+    while (!headers.empty()) {
+        size_t newline = headers.find('\n');
+        std::string_view line = headers.substr(0, newline);
+        headers.remove_prefix(newline == std::string_view::npos ? headers.size() : newline + 1);
+        size_t colon = line.find(": ");
+        if (colon != std::string_view::npos) {
+            response->headers.emplace_back(line.substr(0, colon), line.substr(colon + 2));
+        }
+    }
+    return true;
+}
+
+std::string_view HttpArchive::GetString(uint32_t offset, uint32_t length) const {
+    return std::string_view(file_.data() + offset, length);
+}
+
+// ============================================================================
+// HttpArchiveWriter
+// ============================================================================
+
+void HttpArchiveWriter::Add(HttpExchange exchange) {
+    std::lock_guard<std::mutex> lock(lock_);
+    exchanges_.push_back(std::move(exchange));
+}
+
+size_t HttpArchiveWriter::GetExchangeCount() const {
+    std::lock_guard<std::mutex> lock(lock_);
+    return exchanges_.size();
+}
+
+bool HttpArchiveWriter::Write(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(lock_);
+
+    // Keys and flattened headers, in recording order
+    const size_t count = exchanges_.size();
+    std::vector<std::string> keys(count);
+    std::vector<std::string> queries(count);
+    std::vector<std::string> headers(count);
+    for (size_t i = 0; i < count; ++i) {
+        const HttpExchange& exchange = exchanges_[i];
+        keys[i] = GetHttpArchiveKey(exchange.method, exchange.url, &queries[i]);
+        for (const auto& [name, value] : exchange.headers) {
+            headers[i].append(name).append(": ").append(value).push_back('\n');
+        }
+    }
+
+    // Sort by key; stable, so repeated requests stay in recording order
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+    std::vector<HttpArchiveEntry> index(count);
+    std::string strings;
+    const uint64_t strings_offset = sizeof(HttpArchiveHeader) + count * sizeof(HttpArchiveEntry);
+    auto add_string = [&](std::string_view value, uint32_t* offset, uint32_t* length) {
+        *offset = static_cast<uint32_t>(strings_offset + strings.size());
+        *length = static_cast<uint32_t>(value.size());
+        strings.append(value);
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t source = order[i];
+        const HttpExchange& exchange = exchanges_[source];
+        HttpArchiveEntry& entry = index[i];
+        entry = {};
+        add_string(keys[source], &entry.key_offset, &entry.key_length);
+        add_string(queries[source], &entry.query_offset, &entry.query_length);
+        add_string(exchange.url, &entry.url_offset, &entry.url_length);
+        add_string(exchange.status_text, &entry.status_text_offset, &entry.status_text_length);
+        add_string(exchange.mime_type, &entry.mime_type_offset, &entry.mime_type_length);
+        add_string(headers[source], &entry.headers_offset, &entry.headers_length);
+        entry.status = static_cast<uint32_t>(exchange.status);
+        entry.sequence = source;
+        entry.start_us = exchange.start_us;
+        entry.response_us = exchange.response_us;
+        entry.complete_us = exchange.complete_us;
+    }
+
+    // String offsets are 32-bit
+    if (strings_offset + strings.size() > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+
+    uint64_t offset = strings_offset + strings.size();
+    for (size_t i = 0; i < count; ++i) {
+        offset = AlignUp(offset, kBodyAlignment);
+        index[i].body_offset = offset;
+        index[i].body_size = exchanges_[order[i]].body.size();
+        offset += index[i].body_size;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    HttpArchiveHeader header = {};
+    memcpy(header.magic, kHttpArchiveMagic, sizeof(header.magic));
+    header.version = kHttpArchiveVersion;
+    header.entry_count = static_cast<uint32_t>(count);
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(index.data()),
+              static_cast<std::streamsize>(index.size() * sizeof(HttpArchiveEntry)));
+    out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+    static const char kPadding[kBodyAlignment] = {};
+    for (size_t i = 0; i < count; ++i) {
+        const std::string& body = exchanges_[order[i]].body;
+        uint64_t position = static_cast<uint64_t>(out.tellp());
+        out.write(kPadding, static_cast<std::streamsize>(index[i].body_offset - position));
+        out.write(body.data(), static_cast<std::streamsize>(body.size()));
+    }
+
+    return out.good();
+}
@@ -0,0 +1,157 @@
+// CEF Browser - HTTP Record/Replay Archive
+#ifndef CEF_BROWSER_HTTP_ARCHIVE_H_
+#define CEF_BROWSER_HTTP_ARCHIVE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "mapped_file.h"
+
+// On-disk layout: header, index sorted by request key and recording order,
+// string table, then response bodies. All offsets are relative to the start
+// of the file.
+struct HttpArchiveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+};
+
+struct HttpArchiveEntry {
+    // "METHOD scheme://host/path", see GetHttpArchiveKey()
+    uint32_t key_offset;
+    uint32_t key_length;
+
+    // Normalized query string
+    uint32_t query_offset;
+    uint32_t query_length;
+
+    uint32_t url_offset;
+    uint32_t url_length;
+    uint32_t status_text_offset;
+    uint32_t status_text_length;
+    uint32_t mime_type_offset;
+    uint32_t mime_type_length;
+
+    // "Name: value\n" lines
+    uint32_t headers_offset;
+    uint32_t headers_length;
+
+    uint32_t status;
+
+    // Position in recording order
+    uint32_t sequence;
+
+    uint64_t body_offset;
+    uint64_t body_size;
+
+    // Microseconds from the start of the recording to the request, and from
+    // the request to its response headers and to its last body byte
+    uint64_t start_us;
+    uint64_t response_us;
+    uint64_t complete_us;
+};
+
+constexpr char kHttpArchiveMagic[4] = {'C', 'B', 'H', 'A'};
+constexpr uint32_t kHttpArchiveVersion = 1;
+
+// One recorded request and its response
+struct HttpExchange {
+    std::string method = "GET";
+    std::string url;
+
+    int status = 200;
+    std::string status_text;
+    std::string mime_type;
+    std::vector<std::pair<std::string, std::string>> headers;
+
+    // Decoded response body as delivered to the page
+    std::string body;
+
+    uint64_t start_us = 0;
+    uint64_t response_us = 0;
+    uint64_t complete_us = 0;
+};
+
+// A response served from an archive. Views point into the archive mapping.
+struct HttpArchiveResponse {
+    std::string_view url;
+    int status = 0;
+    std::string_view status_text;
+    std::string_view mime_type;
+    std::vector<std::pair<std::string_view, std::string_view>> headers;
+    std::string_view body;
+};
+
+// Split |url| into the archive key of a |method| request, "METHOD
+// scheme://host/path" with the scheme and host lower-cased, and its query
+// string normalized for matching: fragment removed, cache-busting parameters
+// such as "_" or "cb" dropped, and the remaining parameters sorted.
+std::string GetHttpArchiveKey(std::string_view method, std::string_view url,
+                              std::string* normalized_query);
+
+// Read-only view over a memory-mapped archive.
+//
+// A request is answered by the recorded response with the same key and
+// normalized query. If there is none, the response of the same key whose query
+// shares the most parameters is used, so changing session ids or timestamps do
+// not cause misses. Requests repeated during recording are answered in
+// recording order, and the last response is repeated after that.
+//
+// Lookup() is thread-safe.
+class HttpArchive {
+public:
+    HttpArchive() = default;
+
+    HttpArchive(const HttpArchive&) = delete;
+    HttpArchive& operator=(const HttpArchive&) = delete;
+
+    // Map and validate the archive at |path|
+    bool Open(const std::string& path);
+
+    bool IsValid() const { return index_ != nullptr; }
+    size_t GetEntryCount() const { return entry_count_; }
+
+    // Find the response to a |method| request for |url|
+    bool Lookup(std::string_view method, std::string_view url,
+                HttpArchiveResponse* response) const;
+
+private:
+    std::string_view GetString(uint32_t offset, uint32_t length) const;
+
+    MappedFile file_;
+    const HttpArchiveEntry* index_ = nullptr;
+    uint32_t entry_count_ = 0;
+
+    // Times each entry has been served
+    std::unique_ptr<std::atomic<uint32_t>[]> served_;
+};
+
+// Collects exchanges during a recording and writes them as an archive.
+// Add() is thread-safe.
+class HttpArchiveWriter {
+public:
+    HttpArchiveWriter() = default;
+
+    HttpArchiveWriter(const HttpArchiveWriter&) = delete;
+    HttpArchiveWriter& operator=(const HttpArchiveWriter&) = delete;
+
+    void Add(HttpExchange exchange);
+
+    size_t GetExchangeCount() const;
+
+    // Write every exchange added so far to |path|
+    bool Write(const std::string& path) const;
+
+private:
+    mutable std::mutex lock_;
+    std::vector<HttpExchange> exchanges_;
+};
+
+#endif  // CEF_BROWSER_HTTP_ARCHIVE_H_
@@ -0,0 +1,264 @@
+// CEF Browser - HTTP Record/Replay Request Handlers Implementation
+#include "http_archive_handler.h"
+#include "content_blocking_handler.h"
+#include "http_archive.h"
+#include "scheme_handler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <memory>
+
+#include "include/base/cef_logging.h"
+#include "include/cef_parser.h"
+#include "include/cef_response_filter.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string g_record_path;
+std::unique_ptr<HttpArchiveWriter> g_writer;
+Clock::time_point g_record_start;
+
+std::unique_ptr<HttpArchive> g_archive;
+std::atomic<uint64_t> g_replay_hits{0};
+std::atomic<uint64_t> g_replay_misses{0};
+
+uint64_t MicrosecondsBetween(Clock::time_point from, Clock::time_point to) {
+    return to > from ? std::chrono::duration_cast<std::chrono::microseconds>(to - from).count()
+                     : 0;
+}
+
+bool IsHttpURL(const std::string& url) {
+    return url.rfind("http://", 0) == 0 || url.rfind("https://", 0) == 0;
+}
+
+// Whether the content blocker cancels |request|
+bool IsBlockedRequest(CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request) {
+    const ContentBlocker* blocker = GetContentBlocker();
+    return blocker && ContentBlockingHandler::IsBlocked(*blocker, frame, request);
+}
+
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) ==
+                      std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+// Bodies are recorded after content decoding, so headers describing the
+// transfer no longer apply on replay
+bool IsTransferHeader(std::string_view name) {
+    return EqualsIgnoreCase(name, "Content-Encoding") ||
+           EqualsIgnoreCase(name, "Content-Length") ||
+           EqualsIgnoreCase(name, "Transfer-Encoding");
+}
+
+// Passes the response body through unchanged while keeping a copy
+class RecordingResponseFilter : public CefResponseFilter {
+public:
+    RecordingResponseFilter() = default;
+
+    bool InitFilter() override { return true; }
+
+    FilterStatus Filter(void* data_in, size_t data_in_size, size_t& data_in_read, void* data_out,
+                        size_t data_out_size, size_t& data_out_written) override {
+        const size_t count = std::min(data_in_size, data_out_size);
+        if (count > 0) {
+            memcpy(data_out, data_in, count);
+            body_.append(static_cast<const char*>(data_in), count);
+        }
+        data_in_read = count;
+        data_out_written = count;
+        return data_in ? RESPONSE_FILTER_NEED_MORE_DATA : RESPONSE_FILTER_DONE;
+    }
+
+    std::string TakeBody() { return std::move(body_); }
+
+private:
+    std::string body_;
+
+    IMPLEMENT_REFCOUNTING(RecordingResponseFilter);
+    DISALLOW_COPY_AND_ASSIGN(RecordingResponseFilter);
+};
+
+// Records one request; a new handler is created per request
+class RecordingRequestHandler : public CefResourceRequestHandler {
+public:
+    RecordingRequestHandler() = default;
+
+    ReturnValue OnBeforeResourceLoad(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                     CefRefPtr<CefRequest> request,
+                                     CefRefPtr<CefCallback> callback) override {
+        if (IsBlockedRequest(frame, request)) {
+            return RV_CANCEL;
+        }
+        start_ = Clock::now();
+        return RV_CONTINUE;
+    }
+
+    void OnResourceRedirect(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                            CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response,
+                            CefString& new_url) override {
+        // Each hop is replayed as its own exchange
+        Record(request, response, std::string());
+        start_ = Clock::now();
+    }
+
+    CefRefPtr<CefResponseFilter> GetResourceResponseFilter(
+        CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request,
+        CefRefPtr<CefResponse> response) override {
+        response_time_ = Clock::now();
+        filter_ = new RecordingResponseFilter();
+        return filter_;
+    }
+
+    void OnResourceLoadComplete(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response,
+                                URLRequestStatus status,
+                                int64_t received_content_length) override {
+        if (status != UR_SUCCESS) {
+            return;
+        }
+        Record(request, response, filter_ ? filter_->TakeBody() : std::string());
+    }
+
+private:
+    void Record(CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response,
+                std::string body) {
+        const Clock::time_point now = Clock::now();
+
+        HttpExchange exchange;
+        exchange.method = request->GetMethod().ToString();
+        exchange.url = request->GetURL().ToString();
+        exchange.status = response->GetStatus();
+        exchange.status_text = response->GetStatusText().ToString();
+        exchange.mime_type = response->GetMimeType().ToString();
+
+        CefResponse::HeaderMap headers;
+        response->GetHeaderMap(headers);
+        for (const auto& [name, value] : headers) {
+            exchange.headers.emplace_back(name.ToString(), value.ToString());
+        }
+
+        exchange.body = std::move(body);
+        exchange.start_us = MicrosecondsBetween(g_record_start, start_);
+        exchange.response_us = MicrosecondsBetween(
+            start_, response_time_ == Clock::time_point() ? now : response_time_);
+        exchange.complete_us = MicrosecondsBetween(start_, now);
+        g_writer->Add(std::move(exchange));
+    }
+
+    Clock::time_point start_ = Clock::now();
+    Clock::time_point response_time_;
+    CefRefPtr<RecordingResponseFilter> filter_;
+
+    IMPLEMENT_REFCOUNTING(RecordingRequestHandler);
+    DISALLOW_COPY_AND_ASSIGN(RecordingRequestHandler);
+};
+
+// Serves requests from the archive; shared by all requests
+class ReplayRequestHandler : public CefResourceRequestHandler {
+public:
+    ReplayRequestHandler() = default;
+
+    ReturnValue OnBeforeResourceLoad(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                     CefRefPtr<CefRequest> request,
+                                     CefRefPtr<CefCallback> callback) override {
+        return IsBlockedRequest(frame, request) ? RV_CANCEL : RV_CONTINUE;
+    }
+
+    CefRefPtr<CefResourceHandler> GetResourceHandler(CefRefPtr<CefBrowser> browser,
+                                                     CefRefPtr<CefFrame> frame,
+                                                     CefRefPtr<CefRequest> request) override {
+        CEF_REQUIRE_IO_THREAD();
+
+        HttpArchiveResponse response;
+        if (!g_archive->Lookup(request->GetMethod().ToString(), request->GetURL().ToString(),
+                               &response)) {
+            g_replay_misses.fetch_add(1, std::memory_order_relaxed);
+            static const char kNotFound[] = "Not in archive";
+            CefRefPtr<BufferResourceHandler> handler =
+                new BufferResourceHandler(std::string_view(kNotFound), "text/plain");
+            handler->SetStatus(404, "Not Found");
+            return handler;
+        }
+        g_replay_hits.fetch_add(1, std::memory_order_relaxed);
+
+        // The body is served straight from the archive mapping
+        CefRefPtr<BufferResourceHandler> handler =
+            new BufferResourceHandler(response.body, std::string(response.mime_type));
+        handler->SetStatus(response.status, std::string(response.status_text));
+        for (const auto& [name, value] : response.headers) {
+            if (IsTransferHeader(name)) {
+                continue;
+            }
+            if (response.status >= 300 && response.status < 400 &&
+                EqualsIgnoreCase(name, "Location")) {
+                // Location may be relative to the request
+                CefString location;
+                if (CefResolveURL(request->GetURL(), std::string(value), location)) {
+                    handler->SetRedirect(location.ToString());
+                }
+            }
+            handler->AddHeader(std::string(name), std::string(value));
+        }
+        return handler;
+    }
+
+private:
+    IMPLEMENT_REFCOUNTING(ReplayRequestHandler);
+    DISALLOW_COPY_AND_ASSIGN(ReplayRequestHandler);
+};
+
+CefRefPtr<ReplayRequestHandler> g_replay_handler;
+
+}  // namespace
+
+void InitHttpArchiveRecording(const std::string& path) {
+    g_record_path = path;
+    g_writer = std::make_unique<HttpArchiveWriter>();
+    g_record_start = Clock::now();
+}
+
+bool InitHttpArchiveReplay(const std::string& path) {
+    auto archive = std::make_unique<HttpArchive>();
+    if (!archive->Open(path)) {
+        LOG(ERROR) << "Cannot open HTTP archive " << path;
+        return false;
+    }
+    g_archive = std::move(archive);
+    g_replay_handler = new ReplayRequestHandler();
+    return true;
+}
+
+CefRefPtr<CefResourceRequestHandler> GetHttpArchiveHandler(CefRefPtr<CefRequest> request) {
+    if (!g_replay_handler && !g_writer) {
+        return nullptr;
+    }
+    if (!IsHttpURL(request->GetURL().ToString())) {
+        return nullptr;
+    }
+    if (g_replay_handler) {
+        return g_replay_handler;
+    }
+    return new RecordingRequestHandler();
+}
+
+void FinishHttpArchive() {
+    if (g_writer) {
+        if (!g_writer->Write(g_record_path)) {
+            LOG(ERROR) << "Cannot write HTTP archive " << g_record_path;
+        }
+        LOG(INFO) << "Recorded " << g_writer->GetExchangeCount() << " exchanges to "
+                  << g_record_path;
+    }
+    if (g_archive) {
+        LOG(INFO) << "Replayed " << g_replay_hits.load() << " requests, "
+                  << g_replay_misses.load() << " not in archive";
+    }
+}
@@ -0,0 +1,30 @@
+// CEF Browser - HTTP Record/Replay Request Handlers
+#ifndef CEF_BROWSER_HTTP_ARCHIVE_HANDLER_H_
+#define CEF_BROWSER_HTTP_ARCHIVE_HANDLER_H_
+
+#include <string>
+
+#include "include/cef_request.h"
+#include "include/cef_resource_request_handler.h"
+
+// Record every HTTP(S) exchange into an archive written to |path| by
+// FinishHttpArchive(). Called once in the browser process before any browser
+// is created.
+void InitHttpArchiveRecording(const std::string& path);
+
+// Serve every HTTP(S) request from the archive at |path| instead of the
+// network; requests missing from the archive fail with 404. Called once in the
+// browser process before any browser is created. Returns false if the archive
+// cannot be opened, in which case requests use the network.
+bool InitHttpArchiveReplay(const std::string& path);
+
+// Request handler that records or replays |request|, or nullptr if neither
+// mode is active or the request is not HTTP(S). Also applies the content
+// blocker. Called on the IO thread.
+CefRefPtr<CefResourceRequestHandler> GetHttpArchiveHandler(CefRefPtr<CefRequest> request);
+
+// Write the recording, if any, and report replay misses. Called once after
+// the message loop has quit.
+void FinishHttpArchive();
+
+#endif  // CEF_BROWSER_HTTP_ARCHIVE_HANDLER_H_
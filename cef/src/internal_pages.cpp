@@ -0,0 +1,178 @@
+// CEF Browser - Internal Pages Implementation
+#include "internal_pages.h"
+#include "html_template.h"
+
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
+const char kInternalScheme[] = "app";
+const char kInternalHost[] = "internal";
+
+namespace {
+
+const char kErrorPagePath[] = "error.html";
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+std::string UnescapeQueryValue(const std::string& value) {
+    std::string result;
+    result.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '+') {
+            result.push_back(' ');
+        } else if (value[i] == '%' && i + 2 < value.size() && HexValue(value[i + 1]) >= 0 &&
+                   HexValue(value[i + 2]) >= 0) {
+            int byte = HexValue(value[i + 1]) * 16 + HexValue(value[i + 2]);
+            result.push_back(static_cast<char>(byte));
+            i += 2;
+        } else {
+            result.push_back(value[i]);
+        }
+    }
+    return result;
+}
+
+constexpr std::string_view kErrorPageSource = R"html(<!DOCTYPE html>
+<html><head><meta charset="utf-8"><title>Load Error</title>
+<style>
+body { font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', Roboto, sans-serif;
+       padding: 50px; text-align: center; background: #f5f5f5; }
+h1 { color: #333; }
+.error-code { color: #666; font-size: 14px; }
+.url { color: #0066cc; word-break: break-all; }
+.retry-btn { margin-top: 20px; padding: 10px 20px;
+             background: #0066cc; color: white; border: none;
+             border-radius: 5px; cursor: pointer; font-size: 16px; }
+.retry-btn:hover { background: #0055aa; }
+</style></head><body>
+<h1>This page isn't working</h1>
+<p class="error-code">Error: {{error_text}} ({{error_code}})</p>
+<p class="url" id="url"></p>
+<button class="retry-btn" id="retry">Retry</button>
+<script>
+const url = new URLSearchParams(location.search).get('url') || '';
+document.getElementById('url').textContent = url;
+document.getElementById('retry').onclick = () => {
+    if (/^(https?|file):/i.test(url)) {
+        location.replace(url);
+    } else {
+        history.back();
+    }
+};
+</script>
+</body></html>
+)html";
+
+constexpr HtmlTemplate<CountTemplateSlots(kErrorPageSource)> kErrorPage(kErrorPageSource);
+static_assert(kErrorPage.slot_name(0) == "error_text" && kErrorPage.slot_name(1) == "error_code",
+              "Error page slots are rendered in this order");
+
+// The failed URL is filled in by the page itself, so a rendered error page
+// depends only on the error and can be shared by every load that hits it.
+class ErrorPageCache {
+public:
+    std::shared_ptr<const std::string> Get(int error_code, const std::string& error_text) {
+        std::lock_guard<std::mutex> lock(lock_);
+
+        auto it = entries_.find(error_code);
+        if (it != entries_.end() && it->second.error_text == error_text) {
+            return it->second.page;
+        }
+
+        if (entries_.size() >= kMaxEntries) {
+            entries_.clear();
+        }
+
+        Entry& entry = entries_[error_code];
+        entry.error_text = error_text;
+        entry.page = Render(error_code, error_text);
+        return entry.page;
+    }
+
+private:
+    static constexpr size_t kMaxEntries = 256;
+
+    struct Entry {
+        std::string error_text;
+        std::shared_ptr<const std::string> page;
+    };
+
+    static std::shared_ptr<const std::string> Render(int error_code,
+                                                     const std::string& error_text) {
+        const std::string code = std::to_string(error_code);
+        return std::make_shared<const std::string>(kErrorPage.Render({error_text, code}));
+    }
+
+    std::mutex lock_;
+    std::unordered_map<int, Entry> entries_;
+};
+
+}  // namespace
+
+std::string GetInternalURL(const std::string& path) {
+    return std::string(kInternalScheme) + "://" + kInternalHost + "/" + path;
+}
+
+std::string GetErrorPageURL(int error_code, const std::string& error_text,
+                            const std::string& failed_url) {
+    return GetInternalURL(kErrorPagePath) + "?code=" + std::to_string(error_code) +
+           "&text=" + EscapeQueryValue(error_text) + "&url=" + EscapeQueryValue(failed_url);
+}
+
+std::shared_ptr<const std::string> BuildInternalPage(const std::string& path,
+                                                     const std::string& query) {
+    if (path == kErrorPagePath) {
+        static ErrorPageCache* cache = new ErrorPageCache();
+        return cache->Get(std::atoi(GetQueryValue(query, "code").c_str()),
+                          GetQueryValue(query, "text"));
+    }
+    return nullptr;
+}
+
+std::string EscapeQueryValue(const std::string& value) {
+    static const char kHex[] = "0123456789ABCDEF";
+
+    std::string result;
+    result.reserve(value.size());
+    for (unsigned char c : value) {
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '_' || c == '.' || c == '~') {
+            result.push_back(static_cast<char>(c));
+        } else {
+            result.push_back('%');
+            result.push_back(kHex[c >> 4]);
+            result.push_back(kHex[c & 0xF]);
+        }
+    }
+    return result;
+}
+
+std::string GetQueryValue(const std::string& query, const std::string& key) {
+    size_t pos = 0;
+    while (pos <= query.size()) {
+        size_t end = query.find('&', pos);
+        if (end == std::string::npos) {
+            end = query.size();
+        }
+
+        size_t eq = query.find('=', pos);
+        if (eq != std::string::npos && eq < end && query.compare(pos, eq - pos, key) == 0) {
+            return UnescapeQueryValue(query.substr(eq + 1, end - eq - 1));
+        }
+
+        pos = end + 1;
+    }
+    return std::string();
+}
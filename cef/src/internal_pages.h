@@ -0,0 +1,31 @@
+// CEF Browser - Internal Pages
+#ifndef CEF_BROWSER_INTERNAL_PAGES_H_
+#define CEF_BROWSER_INTERNAL_PAGES_H_
+
+#include <memory>
+#include <string>
+
+// Scheme and host that serve internal pages, e.g. app://internal/blank.html
+extern const char kInternalScheme[];
+extern const char kInternalHost[];
+
+// Get the URL of the internal page or packed resource at |path|
+std::string GetInternalURL(const std::string& path);
+
+// Get the URL of the error page for a failed load
+std::string GetErrorPageURL(int error_code, const std::string& error_text,
+                            const std::string& failed_url);
+
+// Get the generated internal page at |path| for its |query| string. Returns
+// nullptr if |path| is not a generated page, in which case it is served from
+// the resource pack under "internal/". Pages may be shared from a cache.
+std::shared_ptr<const std::string> BuildInternalPage(const std::string& path,
+                                                     const std::string& query);
+
+// Percent-encode |value| for use in a URL query string
+std::string EscapeQueryValue(const std::string& value);
+
+// Get the decoded value of |key| from |query|, or an empty string
+std::string GetQueryValue(const std::string& query, const std::string& key);
+
+#endif  // CEF_BROWSER_INTERNAL_PAGES_H_
@@ -0,0 +1,134 @@
+// CEF Browser - Streaming JSON Writer Implementation
+#include "json_writer.h"
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+
+void JsonWriter::BeforeValue() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (!has_value_.empty()) {
+        if (has_value_.back()) {
+            out_ += ',';
+        }
+        has_value_.back() = true;
+    }
+}
+
+JsonWriter& JsonWriter::BeginObject() {
+    BeforeValue();
+    out_ += '{';
+    has_value_.push_back(false);
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndObject() {
+    has_value_.pop_back();
+    out_ += '}';
+    return *this;
+}
+
+JsonWriter& JsonWriter::BeginArray() {
+    BeforeValue();
+    out_ += '[';
+    has_value_.push_back(false);
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndArray() {
+    has_value_.pop_back();
+    out_ += ']';
+    return *this;
+}
+
+JsonWriter& JsonWriter::Key(std::string_view key) {
+    BeforeValue();
+    AppendQuoted(key, &out_);
+    out_ += ':';
+    after_key_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::String(std::string_view value) {
+    BeforeValue();
+    AppendQuoted(value, &out_);
+    return *this;
+}
+
+JsonWriter& JsonWriter::Int(int64_t value) {
+    BeforeValue();
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "%" PRId64, value);
+    out_ += buffer;
+    return *this;
+}
+
+JsonWriter& JsonWriter::Uint(uint64_t value) {
+    BeforeValue();
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "%" PRIu64, value);
+    out_ += buffer;
+    return *this;
+}
+
+JsonWriter& JsonWriter::Double(double value) {
+    if (!std::isfinite(value)) {
+        return Null();
+    }
+    BeforeValue();
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.10g", value);
+    out_ += buffer;
+    return *this;
+}
+
+JsonWriter& JsonWriter::Bool(bool value) {
+    BeforeValue();
+    out_ += value ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::Null() {
+    BeforeValue();
+    out_ += "null";
+    return *this;
+}
+
+void JsonWriter::AppendQuoted(std::string_view value, std::string* out) {
+    static const char kHex[] = "0123456789abcdef";
+
+    out->reserve(out->size() + value.size() + 2);
+    *out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"':
+                *out += "\\\"";
+                break;
+            case '\\':
+                *out += "\\\\";
+                break;
+            case '\n':
+                *out += "\\n";
+                break;
+            case '\r':
+                *out += "\\r";
+                break;
+            case '\t':
+                *out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    *out += "\\u00";
+                    *out += kHex[(c >> 4) & 0xF];
+                    *out += kHex[c & 0xF];
+                } else {
+                    *out += c;
+                }
+                break;
+        }
+    }
+    *out += '"';
+}
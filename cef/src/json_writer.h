@@ -0,0 +1,50 @@
+// CEF Browser - Streaming JSON Writer
+#ifndef CEF_BROWSER_JSON_WRITER_H_
+#define CEF_BROWSER_JSON_WRITER_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Appends compact JSON to a string, inserting separators automatically.
+// Callers are responsible for balancing Begin/End calls and for calling Key()
+// before each value inside an object.
+class JsonWriter {
+public:
+    JsonWriter() = default;
+
+    JsonWriter& BeginObject();
+    JsonWriter& EndObject();
+    JsonWriter& BeginArray();
+    JsonWriter& EndArray();
+
+    JsonWriter& Key(std::string_view key);
+
+    JsonWriter& String(std::string_view value);
+    JsonWriter& Int(int64_t value);
+    JsonWriter& Uint(uint64_t value);
+    // Non-finite values are written as null
+    JsonWriter& Double(double value);
+    JsonWriter& Bool(bool value);
+    JsonWriter& Null();
+
+    const std::string& str() const { return out_; }
+    std::string Release() { return std::move(out_); }
+
+    // Append |value| to |out| as a quoted JSON string
+    static void AppendQuoted(std::string_view value, std::string* out);
+
+private:
+    // Emit a separator if this is not the first value in its container
+    void BeforeValue();
+
+    std::string out_;
+
+    // One entry per open container: true once it has a value
+    std::vector<bool> has_value_;
+    bool after_key_ = false;
+};
+
+#endif  // CEF_BROWSER_JSON_WRITER_H_
@@ -0,0 +1,489 @@
+// CEF Browser - Console Log Sink Implementation
+#include "log_sink.h"
+#include "json_writer.h"
+#include "utf16.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#if defined(HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace {
+
+// Size of the compressor's output buffer
+constexpr size_t kDeflateChunk = 64 * 1024;
+
+std::atomic<uint64_t> g_next_sink_id{1};
+
+std::unique_ptr<LogSink> g_sink;
+std::atomic<LogSink*> g_sink_ptr{nullptr};
+
+// Name of a cef_log_severity_t
+const char* GetSeverityName(int severity) {
+    switch (severity) {
+        case 1:
+            return "VERBOSE";
+        case 2:
+            return "INFO";
+        case 3:
+            return "WARNING";
+        case 4:
+            return "ERROR";
+        case 5:
+            return "FATAL";
+    }
+    return "LOG";
+}
+
+bool EndsWith(const std::string& value, const char* suffix) {
+    const size_t length = strlen(suffix);
+    return value.size() >= length && value.compare(value.size() - length, length, suffix) == 0;
+}
+
+// Append "2024-05-01T12:00:00.123Z"
+void AppendTime(LogRecord::Clock::time_point time, std::string* out) {
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch());
+    const std::time_t seconds = static_cast<std::time_t>(ms.count() / 1000);
+    std::tm utc = {};
+#if defined(_WIN32)
+    gmtime_s(&utc, &seconds);
+#else
+    gmtime_r(&seconds, &utc);
+#endif
+
+    char text[80];
+    snprintf(text, sizeof(text), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", utc.tm_year + 1900,
+             utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec,
+             static_cast<int>(ms.count() % 1000));
+    out->append(text);
+}
+
+// Append "<time> <SEVERITY> [<browser>] <source>:<line> "
+void AppendPrefix(const LogRecord& record, LogRecord::Clock::time_point time, std::string* out) {
+    AppendTime(time, out);
+    out->push_back(' ');
+    out->append(GetSeverityName(record.severity));
+    out->append(" [");
+    out->append(std::to_string(record.browser_id));
+    out->append("] ");
+    AppendUtf8(record.source(), out);
+    out->push_back(':');
+    out->append(std::to_string(record.line));
+    out->push_back(' ');
+}
+
+// Append |text| as UTF-8 on one line: line breaks are written as \n and \r
+void AppendOneLine(std::u16string_view text, std::string* out) {
+    const size_t start = out->size();
+    AppendUtf8(text, out);
+    if (std::find_if(out->begin() + start, out->end(),
+                     [](char c) { return c == '\n' || c == '\r'; }) == out->end()) {
+        return;
+    }
+    std::string escaped;
+    for (size_t i = start; i < out->size(); ++i) {
+        const char c = (*out)[i];
+        if (c == '\n') {
+            escaped.append("\\n");
+        } else if (c == '\r') {
+            escaped.append("\\r");
+        } else {
+            escaped.push_back(c);
+        }
+    }
+    out->resize(start);
+    out->append(escaped);
+}
+
+}  // namespace
+
+// The current file: plain text, or a gzip stream flushed at the end of each
+// batch so that the file can be read while it is written. Reopening appends a
+// new gzip member, which gzip readers concatenate.
+class LogSink::File {
+public:
+    static std::unique_ptr<File> Open(const std::string& path, bool compress) {
+        FILE* file = fopen(path.c_str(), "ab");
+        if (!file) {
+            return nullptr;
+        }
+        fseek(file, 0, SEEK_END);
+        const long size = ftell(file);
+        std::unique_ptr<File> result(new File(file, size > 0 ? size : 0));
+#if defined(HAVE_ZLIB)
+        if (compress) {
+            // 16 added to the window bits selects the gzip wrapper
+            result->compress_ = deflateInit2(&result->stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                                             15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+        }
+#else
+        (void)compress;
+#endif
+        return result;
+    }
+
+    ~File() {
+#if defined(HAVE_ZLIB)
+        if (compress_) {
+            Deflate(nullptr, 0, Z_FINISH);
+            deflateEnd(&stream_);
+        }
+#endif
+        fclose(file_);
+    }
+
+    // Write |data| and flush it to the file
+    void Write(const std::string& data) {
+#if defined(HAVE_ZLIB)
+        if (compress_) {
+            Deflate(data.data(), data.size(), Z_SYNC_FLUSH);
+            fflush(file_);
+            return;
+        }
+#endif
+        size_ += fwrite(data.data(), 1, data.size(), file_);
+        fflush(file_);
+    }
+
+    // Bytes on disk
+    uint64_t size() const { return size_; }
+
+private:
+    File(FILE* file, uint64_t size) : file_(file), size_(size) {}
+
+#if defined(HAVE_ZLIB)
+    void Deflate(const char* data, size_t size, int flush) {
+        unsigned char out[kDeflateChunk];
+        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream_.avail_in = static_cast<uInt>(size);
+        do {
+            stream_.next_out = out;
+            stream_.avail_out = sizeof(out);
+            if (deflate(&stream_, flush) == Z_STREAM_ERROR) {
+                return;
+            }
+            size_ += fwrite(out, 1, sizeof(out) - stream_.avail_out, file_);
+        } while (stream_.avail_out == 0);
+    }
+
+    z_stream stream_ = {};
+    bool compress_ = false;
+#endif
+
+    FILE* file_;
+    uint64_t size_;
+};
+
+void LogRecord::SetText(std::u16string_view message, std::u16string_view source) {
+    size_t source_length = Utf16PrefixLength(source, kSourceReserve);
+    const size_t message_length = Utf16PrefixLength(message, kTextCapacity - source_length);
+    source_length = Utf16PrefixLength(source, kTextCapacity - message_length);
+    memcpy(text_, message.data(), message_length * sizeof(char16_t));
+    memcpy(text_ + message_length, source.data(), source_length * sizeof(char16_t));
+    message_length_ = static_cast<uint16_t>(message_length);
+    source_length_ = static_cast<uint16_t>(source_length);
+    truncated_ = message_length < message.size() || source_length < source.size();
+}
+
+void LogSinkStats::WriteJson(JsonWriter& writer) const {
+    writer.BeginObject();
+    writer.Key("appended").Uint(appended);
+    writer.Key("written").Uint(written);
+    writer.Key("rate_limited").Uint(rate_limited);
+    writer.Key("deduplicated").Uint(deduplicated);
+    writer.Key("dropped").Uint(dropped);
+    writer.Key("bytes_written").Uint(bytes_written);
+    writer.Key("rotations").Uint(rotations);
+    writer.EndObject();
+}
+
+uint64_t GetLogLocationKey(std::u16string_view source, int line) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (char16_t unit : source) {
+        hash = (hash ^ unit) * 1099511628211ull;
+    }
+    hash = (hash ^ static_cast<uint32_t>(line)) * 1099511628211ull;
+    return hash ? hash : 1;
+}
+
+std::string GetRotatedLogPath(const std::string& path, int index) {
+    if (index == 0) {
+        return path;
+    }
+    const std::string suffix = "." + std::to_string(index);
+    if (EndsWith(path, ".gz")) {
+        return path.substr(0, path.size() - 3) + suffix + ".gz";
+    }
+    return path + suffix;
+}
+
+std::unique_ptr<LogSink> LogSink::Open(const LogSinkOptions& options) {
+    std::unique_ptr<File> file = File::Open(options.path, options.compress);
+    if (!file) {
+        return nullptr;
+    }
+    return std::unique_ptr<LogSink>(new LogSink(options, std::move(file)));
+}
+
+LogSink::LogSink(const LogSinkOptions& options, std::unique_ptr<File> file)
+    : options_(options), id_(g_next_sink_id.fetch_add(1)), file_(std::move(file)) {
+    thread_ = std::thread([this] { Run(); });
+}
+
+LogSink::~LogSink() {
+    Stop();
+}
+
+bool LogSink::Append(int browser_id, int severity, std::u16string_view message,
+                     std::u16string_view source, int line) {
+    appended_.fetch_add(1, std::memory_order_relaxed);
+    if (stopped_.load(std::memory_order_relaxed)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Producer& producer = GetProducer();
+    const LogRecord::Clock::time_point now = LogRecord::Clock::now();
+    uint32_t suppressed = 0;
+    if (!Admit(producer, GetLogLocationKey(source, line), now, &suppressed)) {
+        rate_limited_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    const bool queued = producer.ring.TryPushWith([&](LogRecord& record) {
+        record.time = now;
+        record.browser_id = browser_id;
+        record.severity = severity;
+        record.line = line;
+        record.suppressed = suppressed;
+        record.SetText(message, source);
+    });
+    if (!queued) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return queued;
+}
+
+LogSink::Producer& LogSink::GetProducer() {
+    // The sink a thread last logged to, which is nearly always the only one
+    thread_local uint64_t cached_id = 0;
+    thread_local Producer* cached = nullptr;
+    if (cached_id == id_) {
+        return *cached;
+    }
+
+    std::lock_guard<std::mutex> lock(lock_);
+    std::unique_ptr<Producer>& producer = producers_[std::this_thread::get_id()];
+    if (!producer) {
+        producer = std::make_unique<Producer>(options_.ring_size);
+    }
+    cached_id = id_;
+    cached = producer.get();
+    return *cached;
+}
+
+bool LogSink::Admit(Producer& producer, uint64_t key, LogRecord::Clock::time_point now,
+                    uint32_t* suppressed) {
+    Limit* set = producer.limits[key % kLimitSets];
+    Limit* found = nullptr;
+    for (size_t way = 0; way < kLimitWays; ++way) {
+        if (set[way].key == key) {
+            found = &set[way];
+            break;
+        }
+    }
+
+    if (found) {
+        const double elapsed =
+            std::max(std::chrono::duration<double>(now - found->refilled).count(), 0.0);
+        found->tokens = std::min(options_.burst, found->tokens + elapsed * options_.rate);
+    } else {
+        // A location seen for the first time, or again after it was evicted,
+        // takes an unused way or the least recently used one
+        found = &set[0];
+        for (size_t way = 0; way < kLimitWays && found->key != 0; ++way) {
+            if (set[way].key == 0 || set[way].refilled < found->refilled) {
+                found = &set[way];
+            }
+        }
+        found->key = key;
+        found->tokens = options_.burst;
+        found->suppressed = 0;
+    }
+    Limit& limit = *found;
+    limit.refilled = now;
+
+    if (limit.tokens < 1) {
+        limit.suppressed++;
+        return false;
+    }
+    limit.tokens -= 1;
+    *suppressed = limit.suppressed;
+    limit.suppressed = 0;
+    return true;
+}
+
+void LogSink::Flush() {
+    std::unique_lock<std::mutex> lock(lock_);
+    if (stopping_) {
+        return;
+    }
+    const uint64_t ticket = ++flush_requested_;
+    wake_.notify_one();
+    flushed_.wait(lock, [this, ticket] { return flush_completed_ >= ticket; });
+}
+
+void LogSink::Stop() {
+    if (stopped_.exchange(true)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+    file_.reset();
+}
+
+LogSinkStats LogSink::GetStats() const {
+    LogSinkStats stats;
+    stats.appended = appended_.load(std::memory_order_relaxed);
+    stats.written = written_.load(std::memory_order_relaxed);
+    stats.rate_limited = rate_limited_.load(std::memory_order_relaxed);
+    stats.deduplicated = deduplicated_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+    stats.rotations = rotations_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void LogSink::Run() {
+    std::vector<Producer*> producers;
+    std::unique_lock<std::mutex> lock(lock_);
+    for (;;) {
+        wake_.wait_for(lock, options_.flush_interval,
+                       [this] { return stopping_ || flush_requested_ != flush_completed_; });
+        const bool stopping = stopping_;
+        const uint64_t requested = flush_requested_;
+        producers.clear();
+        for (const auto& entry : producers_) {
+            producers.push_back(entry.second.get());
+        }
+        lock.unlock();
+
+        size_t count = 0;
+        for (Producer* producer : producers) {
+            count += producer->ring.Drain([this](const LogRecord& record) { Format(record); },
+                                          producer->ring.capacity());
+        }
+
+        // A quiet interval ends a run of repeats, as does a flush
+        if (count == 0 || stopping || requested != flush_completed_) {
+            FormatRepeats();
+        }
+        WriteQueued();
+
+        lock.lock();
+        flush_completed_ = requested;
+        flushed_.notify_all();
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+void LogSink::WriteQueued() {
+    if (batch_.empty()) {
+        return;
+    }
+    if (!file_) {
+        // Reopening after a rotation failed; try again with this batch
+        file_ = File::Open(options_.path, options_.compress);
+        if (!file_) {
+            batch_.clear();
+            return;
+        }
+    }
+    const uint64_t before = file_->size();
+    file_->Write(batch_);
+    bytes_written_.fetch_add(file_->size() - before, std::memory_order_relaxed);
+    batch_.clear();
+
+    if (file_->size() >= options_.max_file_bytes) {
+        Rotate();
+    }
+}
+
+void LogSink::Format(const LogRecord& record) {
+    if (has_last_ && record.browser_id == last_.browser_id &&
+        record.severity == last_.severity && record.line == last_.line &&
+        record.message() == last_.message() && record.source() == last_.source()) {
+        repeats_++;
+        last_.time = record.time;
+        deduplicated_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    FormatRepeats();
+
+    AppendPrefix(record, record.time, &batch_);
+    AppendOneLine(record.message(), &batch_);
+    if (record.truncated()) {
+        batch_.append(" [truncated]");
+    }
+    if (record.suppressed) {
+        batch_.append(" [rate limited: ");
+        batch_.append(std::to_string(record.suppressed));
+        batch_.append(" dropped]");
+    }
+    batch_.push_back('\n');
+    written_.fetch_add(1, std::memory_order_relaxed);
+
+    last_ = record;
+    has_last_ = true;
+}
+
+void LogSink::FormatRepeats() {
+    if (repeats_ == 0) {
+        return;
+    }
+    AppendPrefix(last_, last_.time, &batch_);
+    batch_.append("last message repeated ");
+    batch_.append(std::to_string(repeats_));
+    batch_.append(repeats_ == 1 ? " time\n" : " times\n");
+    repeats_ = 0;
+}
+
+void LogSink::Rotate() {
+    file_.reset();
+    std::remove(GetRotatedLogPath(options_.path, options_.max_files).c_str());
+    for (int index = options_.max_files - 1; index >= 0; --index) {
+        std::rename(GetRotatedLogPath(options_.path, index).c_str(),
+                    GetRotatedLogPath(options_.path, index + 1).c_str());
+    }
+    file_ = File::Open(options_.path, options_.compress);
+    rotations_.fetch_add(1, std::memory_order_relaxed);
+}
+
+LogSink* InitLogSink(const LogSinkOptions& options) {
+    if (!g_sink) {
+        g_sink = LogSink::Open(options);
+        g_sink_ptr.store(g_sink.get(), std::memory_order_release);
+    }
+    return g_sink.get();
+}
+
+LogSink* GetLogSink() {
+    return g_sink_ptr.load(std::memory_order_acquire);
+}
+
+void ShutdownLogSink() {
+    if (g_sink) {
+        g_sink->Stop();
+    }
+}
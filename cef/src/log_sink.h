@@ -0,0 +1,228 @@
+// CEF Browser - Console Log Sink
+#ifndef CEF_BROWSER_LOG_SINK_H_
+#define CEF_BROWSER_LOG_SINK_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "mpsc_ring.h"
+
+class JsonWriter;
+
+// One console message as queued by the thread that logged it. The text stays
+// UTF-16 until the writer thread formats it; the source keeps up to
+// kSourceReserve units and the message gets the rest.
+struct LogRecord {
+    using Clock = std::chrono::system_clock;
+
+    void SetText(std::u16string_view message, std::u16string_view source);
+    std::u16string_view message() const { return std::u16string_view(text_, message_length_); }
+    std::u16string_view source() const {
+        return std::u16string_view(text_ + message_length_, source_length_);
+    }
+
+    // Whether SetText() had to cut anything
+    bool truncated() const { return truncated_; }
+
+    static constexpr size_t kTextCapacity = 480;
+    static constexpr size_t kSourceReserve = 96;
+
+    Clock::time_point time;
+    int browser_id = 0;
+
+    // A cef_log_severity_t
+    int severity = 0;
+    int line = 0;
+
+    // Messages from the same source location dropped by the rate limit since
+    // the previous record from it
+    uint32_t suppressed = 0;
+
+private:
+    bool truncated_ = false;
+    uint16_t message_length_ = 0;
+    uint16_t source_length_ = 0;
+    char16_t text_[kTextCapacity];
+};
+
+struct LogSinkOptions {
+    // The file written to. Rotated files get ".1", ".2", ... before a ".gz"
+    // extension, or at the end; ".1" is the newest.
+    std::string path;
+
+    // Rotate once the current file holds this many bytes on disk
+    uint64_t max_file_bytes = 10 * 1024 * 1024;
+
+    // Rotated files kept besides the current one
+    int max_files = 5;
+
+    // Messages per second sustained per source location, and the burst let
+    // through before the rate applies
+    double rate = 20;
+    double burst = 50;
+
+    // Ring slots of each logging thread
+    size_t ring_size = 1024;
+
+    // How often the writer thread drains the rings
+    std::chrono::milliseconds flush_interval{250};
+
+    // Write gzip, when built with zlib
+    bool compress = true;
+};
+
+struct LogSinkStats {
+    uint64_t appended = 0;
+    uint64_t written = 0;
+
+    // Over the rate of their source location
+    uint64_t rate_limited = 0;
+
+    // Identical to the message before and counted in a "repeated" line
+    uint64_t deduplicated = 0;
+
+    // The logging thread's ring was full
+    uint64_t dropped = 0;
+
+    uint64_t bytes_written = 0;
+    uint64_t rotations = 0;
+
+    // Write {"appended", "written", "rate_limited", ...}
+    void WriteJson(JsonWriter& writer) const;
+};
+
+// Get the key of a source location, which LogSink rate limits by; never 0
+uint64_t GetLogLocationKey(std::u16string_view source, int line);
+
+// Get the path of rotated file |index| of |path|, e.g. console.log.gz and 2
+// give console.log.2.gz; index 0 is |path| itself
+std::string GetRotatedLogPath(const std::string& path, int index);
+
+// Writes console messages to size-rotated, optionally gzip-compressed files
+// without costing the logging thread more than a copy. Append() checks a
+// per-thread token bucket for the message's source location and copies the
+// record, still in UTF-16, into a ring owned by the calling thread. A writer
+// thread wakes every flush interval, drains all rings, collapses runs of
+// identical messages into "repeated" lines, converts and compresses the
+// batch and writes it with one call.
+class LogSink {
+public:
+    // Open the current file for appending and start the writer thread;
+    // nullptr if the file cannot be opened
+    static std::unique_ptr<LogSink> Open(const LogSinkOptions& options);
+    ~LogSink();
+
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    // Queue a console message. Returns false if it was rate limited or
+    // dropped. Any thread; never blocks, allocates only on a thread's first
+    // call, and does no conversion or I/O.
+    bool Append(int browser_id, int severity, std::u16string_view message,
+                std::u16string_view source, int line);
+
+    // Wait until everything appended before the call is on disk
+    void Flush();
+
+    // Write what is queued, close the file and stop the writer. Later
+    // messages are dropped.
+    void Stop();
+
+    LogSinkStats GetStats() const;
+
+private:
+    class File;
+
+    // A token bucket per source location, in a set-associative table. A
+    // location keeps its bucket while others share its set, up to the number
+    // of ways; then the least recently used location of the set makes room.
+    struct Limit {
+        // 0 if unused
+        uint64_t key = 0;
+        double tokens = 0;
+        LogRecord::Clock::time_point refilled;
+        uint32_t suppressed = 0;
+    };
+    static constexpr size_t kLimitSets = 64;
+    static constexpr size_t kLimitWays = 4;
+
+    // State of one logging thread. The ring is filled by that thread only;
+    // the limits are never touched by another.
+    struct Producer {
+        explicit Producer(size_t ring_size) : ring(ring_size) {}
+
+        MpscRing<LogRecord> ring;
+        Limit limits[kLimitSets][kLimitWays];
+    };
+
+    LogSink(const LogSinkOptions& options, std::unique_ptr<File> file);
+
+    Producer& GetProducer();
+
+    // Take a token for |key|; otherwise count the message as suppressed.
+    // |suppressed| gets the count to report with an admitted message.
+    bool Admit(Producer& producer, uint64_t key, LogRecord::Clock::time_point now,
+               uint32_t* suppressed);
+
+    // Writer thread
+    void Run();
+    void WriteQueued();
+    void Format(const LogRecord& record);
+    void FormatRepeats();
+    void Rotate();
+
+    const LogSinkOptions options_;
+
+    // Distinguishes sinks in the per-thread producer cache
+    const uint64_t id_;
+
+    // Guards the producer list, the flush counters and stopping_
+    std::mutex lock_;
+    std::condition_variable wake_;
+    std::condition_variable flushed_;
+    std::unordered_map<std::thread::id, std::unique_ptr<Producer>> producers_;
+    uint64_t flush_requested_ = 0;
+    uint64_t flush_completed_ = 0;
+    bool stopping_ = false;
+    std::atomic<bool> stopped_{false};
+
+    // Writer thread only
+    std::unique_ptr<File> file_;
+    std::string batch_;
+    LogRecord last_;
+    bool has_last_ = false;
+    uint32_t repeats_ = 0;
+
+    std::atomic<uint64_t> appended_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> rate_limited_{0};
+    std::atomic<uint64_t> deduplicated_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> bytes_written_{0};
+    std::atomic<uint64_t> rotations_{0};
+
+    std::thread thread_;
+};
+
+// Open the process-wide sink for console messages, or return it if it
+// exists; nullptr if its file cannot be opened
+LogSink* InitLogSink(const LogSinkOptions& options);
+
+// The process-wide sink, or nullptr if none was opened. Any thread.
+LogSink* GetLogSink();
+
+// Write what is queued and stop the process-wide sink; it stays valid and
+// drops later messages
+void ShutdownLogSink();
+
+#endif  // CEF_BROWSER_LOG_SINK_H_
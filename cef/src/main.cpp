@@ -1,18 +1,36 @@
 // CEF Browser - Main Entry Point
 // A production-ready web browser using Chromium Embedded Framework
 
+#include <algorithm>
+
+#include "include/base/cef_logging.h"
 #include "include/cef_app.h"
 #include "include/cef_browser.h"
 #include "include/cef_command_line.h"
 
 #include "app.h"
+#include "browser_config.h"
+#include "browser_pool.h"
 #include "browser_window.h"
+#include "content_blocking_handler.h"
+#include "devtools_server.h"
+#include "event_log.h"
+#include "http_archive_handler.h"
+#include "log_sink.h"
+#include "message_pump.h"
+#include "metrics_reporter.h"
+#include "renderer_recovery_handler.h"
+#include "rendering_config.h"
+#include "resource_policy_handler.h"
+#include "resource_util.h"
+#include "trace_capture.h"
+#include "watchdog_handler.h"
 
 #if defined(OS_WIN)
 #include <windows.h>
 #endif
 
-#if defined(OS_LINUX)
+#if defined(OS_LINUX) && !defined(CEF_BROWSER_HEADLESS_ONLY)
 #include <X11/Xlib.h>
 #endif
 
@@ -20,9 +38,18 @@ namespace {
 
 // Returns the main application entry point.
 int RunMain(int argc, char* argv[]) {
-#if defined(OS_LINUX)
-    // Initialize X11 threading support
-    XInitThreads();
+    // Parse command line arguments
+    CefRefPtr<CefCommandLine> command_line = CefCommandLine::CreateCommandLine();
+    command_line->InitFromArgv(argc, argv);
+    InitBrowserConfig(command_line);
+    const BrowserConfig& config = GetBrowserConfig();
+
+#if defined(OS_LINUX) && !defined(CEF_BROWSER_HEADLESS_ONLY)
+    // Initialize X11 threading support. Off-screen rendering runs on the
+    // headless ozone platform and never opens a display.
+    if (!config.off_screen) {
+        XInitThreads();
+    }
 #endif
 
     // Create main args
@@ -38,28 +65,42 @@ int RunMain(int argc, char* argv[]) {
         return exit_code;
     }
 
-    // Parse command line arguments
-    CefRefPtr<CefCommandLine> command_line = CefCommandLine::CreateCommandLine();
-    command_line->InitFromArgv(argc, argv);
+    // Choose GPU or software rendering. The EGL probe forks, so this runs
+    // before CefInitialize() starts any threads.
+    InitRenderingConfig(config.rendering);
+
+    // Pick the DevTools port or pipe before Chromium is told about it
+    const DevToolsEndpoint& devtools = InitDevToolsEndpoint(config);
+
+    // Map the resource pack once, before any browser can request internal pages
+    GetResourcePack();
 
     // Configure CEF settings
     CefSettings settings;
 
-    // Enable GPU acceleration
-    settings.windowless_rendering_enabled = false;
+    // Off-screen rendering paints into BrowserClient::OnPaint instead of a window
+    settings.windowless_rendering_enabled = config.off_screen;
 
-    // Use hardware acceleration
-    settings.chrome_runtime = true;
+    // The Chrome runtime manages its own windows; off-screen rendering
+    // requires the Alloy runtime
+    settings.chrome_runtime = !config.off_screen;
 
-    // Set cache path
-    CefString(&settings.cache_path).FromASCII("./cache");
+    // The cache lives in the user data dir, next to everything else the
+    // browser writes; Chromium's own profile data goes there too
+    const std::string& user_data_dir = config.user_data_dir;
+    CreateDirectory(user_data_dir);
+    CefString(&settings.root_cache_path).FromString(user_data_dir);
+    CefString(&settings.cache_path).FromString(user_data_dir + "/cache");
 
-    // Set log file
-    CefString(&settings.log_file).FromASCII("./cef_debug.log");
-    settings.log_severity = LOGSEVERITY_INFO;
+    // Chromium writes its log on the thread that logs, UI thread included, so
+    // only warnings and errors by default. Page console messages go to the
+    // console log instead. --log-severity and --log-file override these.
+    CefString(&settings.log_file).FromString(user_data_dir + "/cef_debug.log");
+    settings.log_severity = LOGSEVERITY_WARNING;
 
-    // Remote debugging (optional - useful for development)
-    settings.remote_debugging_port = 9222;
+    // Remote debugging through Chromium's server; 0 when DevTools is off or
+    // served by the in-process bridge
+    settings.remote_debugging_port = devtools.ChromiumPort();
 
     // Locale
     CefString(&settings.locale).FromASCII("en-US");
@@ -67,20 +108,147 @@ int RunMain(int argc, char* argv[]) {
     // Background color (white)
     settings.background_color = CefColorSetARGB(255, 255, 255, 255);
 
-    // Multi-threaded message loop
+    // CEF runs on the main thread, either in CefRunMessageLoop() or scheduled
+    // onto the epoll loop through OnScheduleMessagePumpWork
     settings.multi_threaded_message_loop = false;
-    settings.external_message_pump = false;
+    settings.external_message_pump = InitMessagePump(config.external_message_pump);
 
     // Initialize CEF
     if (!CefInitialize(main_args, settings, app, nullptr)) {
         return 1;
     }
 
+    // Serve lazy and pipe DevTools sessions and publish the endpoint
+    StartDevToolsServer();
+
+    // Periodically dump navigation timing to the user data directory
+    StartMetricsReporter(user_data_dir + "/navigation_metrics.json", config.metrics_interval);
+
+    // Log browser events from worker threads rather than the UI thread
+    std::unique_ptr<EventLog> event_log;
+    if (!config.event_log_path.empty()) {
+        event_log = EventLog::Open(config.event_log_path);
+        if (event_log) {
+            EventPipelineOptions event_options;
+            event_options.workers = config.event_workers;
+            InitEventPipeline(event_options)->AddObserver(event_log.get());
+        } else {
+            LOG(WARNING) << "Cannot open --event-log=" << config.event_log_path;
+        }
+    }
+
+    // Write page console messages from a background thread
+    if (config.console_log_path != "off") {
+        LogSinkOptions log_options;
+        log_options.path = config.console_log_path;
+        if (log_options.path.empty()) {
+#if defined(HAVE_ZLIB)
+            log_options.path = user_data_dir + "/console.log.gz";
+#else
+            log_options.path = user_data_dir + "/console.log";
+#endif
+        }
+        log_options.max_file_bytes = static_cast<uint64_t>(config.console_log_max_mb) * 1024 * 1024;
+        log_options.max_files = config.console_log_files;
+        log_options.rate = config.console_log_rate;
+        log_options.burst = config.console_log_rate * 2.0;
+        if (!InitLogSink(log_options)) {
+            LOG(WARNING) << "Cannot open console log " << log_options.path;
+        }
+    }
+
+    // Reload pages whose renderer crashed or hung. The pings are the
+    // watchdog's renderer heartbeats too, so they run while either is on.
+    if (config.crash_reload_limit > 0 || config.watchdog_interval_ms > 0) {
+        RendererRecoveryOptions recovery_options;
+        recovery_options.recover = config.crash_reload_limit > 0;
+        recovery_options.quarantine_threshold = config.crash_reload_limit;
+        // Without recovery a killed renderer's page would stay dead, so hung
+        // renderers are left alone
+        recovery_options.hang_timeout =
+            std::chrono::seconds(recovery_options.recover ? config.renderer_hang_timeout : 0);
+        // Renderers are pinged every watchdog interval, 1 s by default rather
+        // than 5 s, so that a stall is found as soon as a thread's would be
+        if (config.watchdog_interval_ms > 0) {
+            recovery_options.ping_interval =
+                std::min(recovery_options.ping_interval,
+                         std::chrono::milliseconds(config.watchdog_interval_ms));
+        }
+        InitRendererRecovery(recovery_options);
+    }
+
+    // Trace matching page loads, and renderer stalls the watchdog finds if
+    // asked to, into the user data dir
+    const bool trace_stalls = config.watchdog_interval_ms > 0 && config.watchdog_trace;
+    if (!config.trace_pattern.empty() || trace_stalls) {
+        TraceCaptureOptions trace_options;
+        trace_options.pattern = config.trace_pattern;
+        trace_options.categories = config.trace_categories;
+        trace_options.sample_rate = config.trace_sample_rate;
+        trace_options.settle_ms = config.trace_settle_ms;
+        trace_options.dir = user_data_dir;
+        trace_options.max_bytes = static_cast<uint64_t>(config.trace_max_mb) * 1024 * 1024;
+        InitTraceCapture(trace_options);
+    }
+
+    // Report stalls of the UI and IO threads and the renderers
+    if (config.watchdog_interval_ms > 0) {
+        WatchdogOptions watchdog_options;
+        watchdog_options.interval = std::chrono::milliseconds(config.watchdog_interval_ms);
+        watchdog_options.stall_threshold = std::chrono::milliseconds(config.watchdog_stall_ms);
+        StartWatchdog(watchdog_options, user_data_dir + "/stalls.log", trace_stalls);
+    }
+
+    // Compile the subresource filter lists before any request can be made
+    if (!config.block_lists.empty()) {
+        InitContentBlocker(config.block_lists);
+    }
+
+    // Suppress resources that headless jobs don't need, e.g. images
+    if (!config.suppress_resources.empty()) {
+        ResourcePolicy policy;
+        if (ParseResourcePolicy(config.suppress_resources, &policy)) {
+            SetDefaultResourcePolicy(policy);
+        } else {
+            LOG(WARNING) << "Ignoring malformed --suppress-resources="
+                         << config.suppress_resources;
+        }
+    }
+
+    // Record or replay HTTP traffic for deterministic offline runs
+    if (!config.replay_path.empty()) {
+        InitHttpArchiveReplay(config.replay_path);
+    } else if (!config.record_path.empty()) {
+        InitHttpArchiveRecording(config.record_path);
+    }
+
     // Create the browser window
     BrowserWindow::Create();
 
+    // Pre-warm pooled off-screen browsers
+    if (config.off_screen && config.pool_min_size > 0) {
+        BrowserPoolOptions pool_options;
+        pool_options.min_size = config.pool_min_size;
+        pool_options.max_size = config.pool_max_size;
+        pool_options.max_uses = config.pool_max_uses;
+        pool_options.idle_timeout = std::chrono::seconds(config.pool_idle_timeout);
+        InitBrowserPool(pool_options);
+    }
+
     // Run the CEF message loop
-    CefRunMessageLoop();
+    RunMainMessageLoop();
+
+    // Nothing runs heartbeats once the message loop has exited
+    StopWatchdog();
+
+    // Deliver the last events before the log closes
+    ShutdownEventPipeline();
+    ShutdownLogSink();
+
+    // Write the final metrics before the browser process goes away
+    StopMetricsReporter();
+    FinishHttpArchive();
+    StopDevToolsServer();
 
     // Shutdown CEF
     CefShutdown();
@@ -0,0 +1,35 @@
+// CEF Browser - Read-only Memory-Mapped File
+#ifndef CEF_BROWSER_MAPPED_FILE_H_
+#define CEF_BROWSER_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+// Maps a file read-only into memory for the lifetime of the object
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file at |path|, replacing any existing mapping
+    bool Open(const std::string& path);
+
+    // Unmap the file
+    void Close();
+
+    bool IsValid() const { return data_ != nullptr; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#if defined(_WIN32)
+    void* mapping_ = nullptr;
+#endif
+};
+
+#endif  // CEF_BROWSER_MAPPED_FILE_H_
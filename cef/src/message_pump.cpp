@@ -0,0 +1,198 @@
+// CEF Browser - Main Message Loop Implementation
+#include "message_pump.h"
+#include "histogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "include/base/cef_logging.h"
+#include "include/cef_app.h"
+
+#if defined(OS_LINUX)
+#include <sys/resource.h>
+
+#include "event_loop.h"
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t MicrosecondsSince(Clock::time_point start) {
+    Clock::time_point now = Clock::now();
+    return now > start ? std::chrono::duration_cast<std::chrono::microseconds>(now - start).count()
+                       : 0;
+}
+
+// CPU time consumed by the calling thread, or 0 where unavailable
+uint64_t GetThreadCpuMicroseconds() {
+#if defined(OS_LINUX)
+    rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+        return 0;
+    }
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * uint64_t{1000000} +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#else
+    return 0;
+#endif
+}
+
+#if defined(OS_LINUX)
+
+// Calls CefDoMessageLoopWork() from an EventLoop exactly when CEF schedules
+// it: immediately for delays <= 0, otherwise from a timer that replaces any
+// pending one. There is no polling, so an idle browser does not wake up.
+class MessagePump {
+public:
+    bool Init() { return loop_.Init(); }
+
+    EventLoop* loop() { return &loop_; }
+
+    // Called on any thread
+    void Schedule(int64_t delay_ms) {
+        if (delay_ms <= 0) {
+            // Requests made before the pending work runs are covered by it
+            if (work_pending_.exchange(true)) {
+                return;
+            }
+            const Clock::time_point requested = Clock::now();
+            loop_.PostTask([this, requested] {
+                work_pending_ = false;
+                work_latency_us_.Record(MicrosecondsSince(requested));
+                CancelTimer();
+                DoWork();
+            });
+        } else {
+            const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(delay_ms);
+            loop_.PostTask([this, deadline] { SetTimer(deadline); });
+        }
+    }
+
+    void Run() {
+        loop_.Run();
+
+        // Browsers closing at quit may still have work queued; CEF does not
+        // report when it is idle, so run it a few more times
+        for (int i = 0; i < 10; ++i) {
+            CefDoMessageLoopWork();
+        }
+    }
+
+    void Quit() { loop_.Quit(); }
+
+    void LogStats() const {
+        LOG(INFO) << "External message pump: " << loop_.wakeups() << " wakeups, " << work_count_
+                  << " work calls, immediate work latency p50 "
+                  << work_latency_us_.ValueAtPercentile(50) << " us p99 "
+                  << work_latency_us_.ValueAtPercentile(99) << " us, timer lateness p50 "
+                  << timer_lateness_us_.ValueAtPercentile(50) << " us p99 "
+                  << timer_lateness_us_.ValueAtPercentile(99) << " us";
+    }
+
+private:
+    void SetTimer(Clock::time_point deadline) {
+        CancelTimer();
+        Clock::duration delay = deadline - Clock::now();
+        timer_id_ = loop_.AddTimer(delay, [this, deadline] {
+            timer_id_ = 0;
+            timer_lateness_us_.Record(MicrosecondsSince(deadline));
+            DoWork();
+        });
+    }
+
+    void CancelTimer() {
+        if (timer_id_) {
+            loop_.CancelTimer(timer_id_);
+            timer_id_ = 0;
+        }
+    }
+
+    void DoWork() {
+        ++work_count_;
+        CefDoMessageLoopWork();
+    }
+
+    EventLoop loop_;
+    std::atomic<bool> work_pending_{false};
+
+    // Loop thread only
+    uint64_t timer_id_ = 0;
+    uint64_t work_count_ = 0;
+    Histogram work_latency_us_;
+    Histogram timer_lateness_us_;
+};
+
+std::unique_ptr<MessagePump> g_pump;
+
+#endif  // OS_LINUX
+
+}  // namespace
+
+bool InitMessagePump(bool external) {
+    if (!external) {
+        return false;
+    }
+#if defined(OS_LINUX)
+    auto pump = std::make_unique<MessagePump>();
+    if (!pump->Init()) {
+        LOG(ERROR) << "Cannot create the epoll event loop, using CefRunMessageLoop()";
+        return false;
+    }
+    g_pump = std::move(pump);
+    return true;
+#else
+    LOG(WARNING) << "The external message pump is only supported on Linux";
+    return false;
+#endif
+}
+
+void ScheduleMessagePumpWork(int64_t delay_ms) {
+#if defined(OS_LINUX)
+    if (g_pump) {
+        g_pump->Schedule(delay_ms);
+    }
+#endif
+}
+
+void RunMainMessageLoop() {
+    const Clock::time_point start = Clock::now();
+    const uint64_t cpu_start = GetThreadCpuMicroseconds();
+
+#if defined(OS_LINUX)
+    if (g_pump) {
+        g_pump->Run();
+    } else {
+        CefRunMessageLoop();
+    }
+#else
+    CefRunMessageLoop();
+#endif
+
+    LOG(INFO) << "Main message loop ran " << MicrosecondsSince(start) / 1000 << " ms using "
+              << (GetThreadCpuMicroseconds() - cpu_start) / 1000 << " ms of UI thread CPU";
+#if defined(OS_LINUX)
+    if (g_pump) {
+        g_pump->LogStats();
+    }
+#endif
+}
+
+void QuitMainMessageLoop() {
+#if defined(OS_LINUX)
+    if (g_pump) {
+        g_pump->Quit();
+        return;
+    }
+#endif
+    CefQuitMessageLoop();
+}
+
+EventLoop* GetMainEventLoop() {
+#if defined(OS_LINUX)
+    return g_pump ? g_pump->loop() : nullptr;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,32 @@
+// CEF Browser - Main Message Loop
+#ifndef CEF_BROWSER_MESSAGE_PUMP_H_
+#define CEF_BROWSER_MESSAGE_PUMP_H_
+
+#include <cstdint>
+
+class EventLoop;
+
+// Select the loop that drives CEF on the main thread. With |external|, CEF
+// work is scheduled through OnScheduleMessagePumpWork onto an epoll event
+// loop that native subsystems can share; otherwise CefRunMessageLoop() is
+// used. Called once before CefInitialize(). Returns whether the external
+// pump is active, i.e. the value of CefSettings.external_message_pump. The
+// external pump is only available on Linux.
+bool InitMessagePump(bool external);
+
+// Forwarded from CefBrowserProcessHandler::OnScheduleMessagePumpWork. Called
+// on any thread.
+void ScheduleMessagePumpWork(int64_t delay_ms);
+
+// Run the main message loop until QuitMainMessageLoop(), then log its UI
+// thread CPU time and, for the external pump, its wakeup latency
+void RunMainMessageLoop();
+
+// Quit the main message loop. Called on the UI thread.
+void QuitMainMessageLoop();
+
+// Event loop of the external pump, on which fds and timers are serviced on the
+// UI thread, or nullptr when CefRunMessageLoop() drives CEF
+EventLoop* GetMainEventLoop();
+
+#endif  // CEF_BROWSER_MESSAGE_PUMP_H_
@@ -0,0 +1,115 @@
+// CEF Browser - Metrics Reporter Implementation
+#include "metrics_reporter.h"
+#include "content_blocking_handler.h"
+#include "event_pipeline.h"
+#include "json_writer.h"
+#include "log_sink.h"
+#include "renderer_recovery_handler.h"
+#include "resource_policy_handler.h"
+#include "watchdog_handler.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "include/base/cef_callback.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace {
+
+std::string g_path;
+int g_interval_seconds = 0;
+bool g_running = false;
+
+// Replace |path| so readers never observe a partial file
+void WriteFileAtomically(const std::string& path, const std::string& data) {
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return;
+        }
+        out.write(data.data(), data.size());
+        if (!out) {
+            return;
+        }
+    }
+#if defined(OS_WIN)
+    std::remove(path.c_str());
+#endif
+    std::rename(temp_path.c_str(), path.c_str());
+}
+
+std::string Snapshot() {
+    JsonWriter writer;
+    writer.BeginObject();
+    writer.Key("navigation");
+    GetNavigationMetrics().WriteJson(writer);
+    if (const ContentBlocker* blocker = GetContentBlocker()) {
+        writer.Key("content_blocker");
+        blocker->WriteJson(writer);
+    }
+    if (IsResourcePolicyEnabled()) {
+        writer.Key("resource_policy");
+        GetTotalResourcePolicyCounts().WriteJson(writer);
+    }
+    if (const EventPipeline* events = GetEventPipeline()) {
+        writer.Key("event_pipeline");
+        events->GetStats().WriteJson(writer);
+    }
+    if (const LogSink* sink = GetLogSink()) {
+        writer.Key("console_log");
+        sink->GetStats().WriteJson(writer);
+    }
+    if (const RendererRecovery* recovery = GetRendererRecovery()) {
+        writer.Key("renderer_recovery");
+        recovery->stats().WriteJson(writer);
+    }
+    if (const Watchdog* watchdog = GetWatchdog()) {
+        writer.Key("watchdog");
+        watchdog->GetStats().WriteJson(writer);
+    }
+    writer.EndObject();
+    return writer.Release();
+}
+
+void ReportMetrics() {
+    if (!g_running) {
+        return;
+    }
+
+    CefPostTask(TID_FILE_BACKGROUND, base::BindOnce(&WriteFileAtomically, g_path, Snapshot()));
+    CefPostDelayedTask(TID_UI, base::BindOnce(&ReportMetrics),
+                       static_cast<int64_t>(g_interval_seconds) * 1000);
+}
+
+}  // namespace
+
+NavigationMetrics& GetNavigationMetrics() {
+    static NavigationMetrics metrics;
+    return metrics;
+}
+
+void StartMetricsReporter(const std::string& path, int interval_seconds) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (g_running || path.empty() || interval_seconds <= 0) {
+        return;
+    }
+
+    g_path = path;
+    g_interval_seconds = interval_seconds;
+    g_running = true;
+    CefPostDelayedTask(TID_UI, base::BindOnce(&ReportMetrics),
+                       static_cast<int64_t>(interval_seconds) * 1000);
+}
+
+void StopMetricsReporter() {
+    if (!g_running) {
+        return;
+    }
+
+    g_running = false;
+    WriteFileAtomically(g_path, Snapshot());
+}
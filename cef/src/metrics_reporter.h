@@ -0,0 +1,19 @@
+// CEF Browser - Metrics Reporter
+#ifndef CEF_BROWSER_METRICS_REPORTER_H_
+#define CEF_BROWSER_METRICS_REPORTER_H_
+
+#include <string>
+
+#include "navigation_metrics.h"
+
+// Navigation timing for all browsers. UI thread only.
+NavigationMetrics& GetNavigationMetrics();
+
+// Write the metrics as JSON to |path| every |interval_seconds|. Snapshots are
+// taken on the UI thread and written on the background file thread.
+void StartMetricsReporter(const std::string& path, int interval_seconds);
+
+// Stop reporting and write a final snapshot synchronously
+void StopMetricsReporter();
+
+#endif  // CEF_BROWSER_METRICS_REPORTER_H_
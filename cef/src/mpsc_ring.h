@@ -0,0 +1,112 @@
+// CEF Browser - Bounded Multi-Producer Single-Consumer Ring
+#ifndef CEF_BROWSER_MPSC_RING_H_
+#define CEF_BROWSER_MPSC_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Fixed-capacity queue of preallocated T slots. Any number of threads may
+// push; one thread pops. Neither side ever blocks or allocates: a full ring
+// rejects the push. Each slot carries a sequence number that says whether it
+// is free for the producer that claimed its position or filled for the
+// consumer (Vyukov's bounded queue), so producers contend only on the
+// enqueue position.
+template <typename T>
+class MpscRing {
+public:
+    // |capacity| is rounded up to a power of two
+    explicit MpscRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_ = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // Copy |value| into a free slot. Returns false if the ring is full. Any
+    // thread.
+    bool TryPush(const T& value) {
+        return TryPushWith([&value](T& slot) { slot = value; });
+    }
+
+    // Claim a free slot and let |fill| write the value into it in place,
+    // which spares large values a copy. Returns false without calling |fill|
+    // if the ring is full. Any thread.
+    template <typename Fill>
+    bool TryPushWith(Fill&& fill) {
+        size_t position = enqueue_position_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[position & mask_];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff =
+                static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+                if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                            std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // The consumer has not freed this slot since the last lap
+                return false;
+            } else {
+                position = enqueue_position_.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(cell->value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pass up to |max| values to |consume| in push order per producer, each
+    // by const reference to its slot. Returns how many were consumed.
+    // Consumer thread.
+    template <typename Consume>
+    size_t Drain(Consume&& consume, size_t max) {
+        size_t count = 0;
+        while (count < max) {
+            Cell& cell = cells_[dequeue_position_ & mask_];
+            if (cell.sequence.load(std::memory_order_acquire) != dequeue_position_ + 1) {
+                break;
+            }
+            consume(static_cast<const T&>(cell.value));
+            cell.sequence.store(dequeue_position_ + mask_ + 1, std::memory_order_release);
+            ++dequeue_position_;
+            ++count;
+        }
+        return count;
+    }
+
+    // Whether the next slot is still unfilled. Consumer thread.
+    bool empty() const {
+        const Cell& cell = cells_[dequeue_position_ & mask_];
+        return cell.sequence.load(std::memory_order_acquire) != dequeue_position_ + 1;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+
+    // Kept on separate cache lines so producers do not slow the consumer
+    alignas(64) std::atomic<size_t> enqueue_position_{0};
+    alignas(64) size_t dequeue_position_ = 0;
+};
+
+#endif  // CEF_BROWSER_MPSC_RING_H_
@@ -0,0 +1,182 @@
+// CEF Browser - Navigation Timing Metrics Implementation
+#include "navigation_metrics.h"
+#include "json_writer.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+// net::ERR_ABORTED
+constexpr int kErrorAborted = -3;
+
+}  // namespace
+
+void NavigationMetrics::OnNavigationStart(int browser_id, std::string_view url, TimePoint now) {
+    Finish(browser_id, true);
+
+    Navigation& navigation = navigations_[browser_id];
+    navigation.id = next_navigation_id_++;
+    navigation.host = GetHost(url);
+    navigation.start = now;
+}
+
+void NavigationMetrics::OnCommit(int browser_id, std::string_view url, TimePoint now) {
+    auto it = navigations_.find(browser_id);
+    if (it == navigations_.end() || it->second.committed) {
+        // Same-document navigations change the address without a load
+        return;
+    }
+
+    Navigation& navigation = it->second;
+    navigation.committed = true;
+    navigation.host = GetHost(url);
+    GetHostStats(navigation.host).commit.Record(ElapsedMicros(navigation.start, now));
+}
+
+void NavigationMetrics::OnLoadEnd(int browser_id, TimePoint now) {
+    auto it = navigations_.find(browser_id);
+    if (it == navigations_.end() || it->second.load_ended) {
+        return;
+    }
+
+    Navigation& navigation = it->second;
+    navigation.load_ended = true;
+    GetHostStats(navigation.host).load_end.Record(ElapsedMicros(navigation.start, now));
+}
+
+void NavigationMetrics::OnLoadError(int browser_id, int error_code, TimePoint now) {
+    if (error_code == kErrorAborted) {
+        return;
+    }
+
+    auto it = navigations_.find(browser_id);
+    if (it == navigations_.end() || it->second.failed) {
+        return;
+    }
+
+    Navigation& navigation = it->second;
+    navigation.failed = true;
+    HostStats& stats = GetHostStats(navigation.host);
+    stats.errors++;
+    stats.error.Record(ElapsedMicros(navigation.start, now));
+}
+
+void NavigationMetrics::OnLoadingIdle(int browser_id, TimePoint now) {
+    auto it = navigations_.find(browser_id);
+    if (it == navigations_.end()) {
+        return;
+    }
+
+    const Navigation& navigation = it->second;
+    GetHostStats(navigation.host).idle.Record(ElapsedMicros(navigation.start, now));
+    Finish(browser_id, false);
+}
+
+void NavigationMetrics::OnBrowserClosed(int browser_id) {
+    Finish(browser_id, true);
+}
+
+void NavigationMetrics::Finish(int browser_id, bool abandoned) {
+    auto it = navigations_.find(browser_id);
+    if (it == navigations_.end()) {
+        return;
+    }
+
+    HostStats& stats = GetHostStats(it->second.host);
+    stats.navigations++;
+    if (abandoned) {
+        stats.abandoned++;
+    }
+    navigations_.erase(it);
+}
+
+NavigationMetrics::HostStats& NavigationMetrics::GetHostStats(const std::string& host) {
+    auto it = hosts_.find(host);
+    if (it != hosts_.end()) {
+        return *it->second;
+    }
+
+    // Bound memory on crawls over many hosts
+    const std::string& key = hosts_.size() < kMaxHosts ? host : std::string(kOtherHost);
+    std::unique_ptr<HostStats>& stats = hosts_[key];
+    if (!stats) {
+        stats = std::make_unique<HostStats>();
+    }
+    return *stats;
+}
+
+uint64_t NavigationMetrics::ElapsedMicros(TimePoint start, TimePoint end) {
+    if (end <= start) {
+        return 0;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+std::string NavigationMetrics::GetHost(std::string_view url) {
+    size_t scheme_end = url.find("://");
+    if (scheme_end == std::string_view::npos) {
+        return std::string();
+    }
+
+    std::string_view authority = url.substr(scheme_end + 3);
+    authority = authority.substr(0, authority.find_first_of("/?#"));
+
+    size_t at = authority.rfind('@');
+    if (at != std::string_view::npos) {
+        authority = authority.substr(at + 1);
+    }
+
+    // Keep IPv6 literals intact, e.g. [::1]:8080
+    size_t port = authority.rfind(':');
+    if (port != std::string_view::npos && authority.find(']', port) == std::string_view::npos) {
+        authority = authority.substr(0, port);
+    }
+
+    std::string host(authority);
+    std::transform(host.begin(), host.end(), host.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return host;
+}
+
+void NavigationMetrics::HostStats::Merge(const HostStats& other) {
+    navigations += other.navigations;
+    errors += other.errors;
+    abandoned += other.abandoned;
+    commit.Merge(other.commit);
+    load_end.Merge(other.load_end);
+    idle.Merge(other.idle);
+    error.Merge(other.error);
+}
+
+void NavigationMetrics::HostStats::WriteJson(JsonWriter& writer) const {
+    writer.BeginObject();
+    writer.Key("navigations").Uint(navigations);
+    writer.Key("errors").Uint(errors);
+    writer.Key("abandoned").Uint(abandoned);
+    writer.Key("commit_us");
+    commit.WriteJson(writer);
+    writer.Key("load_end_us");
+    load_end.WriteJson(writer);
+    writer.Key("idle_us");
+    idle.WriteJson(writer);
+    writer.Key("error_us");
+    error.WriteJson(writer);
+    writer.EndObject();
+}
+
+void NavigationMetrics::WriteJson(JsonWriter& writer) const {
+    HostStats all;
+
+    writer.BeginObject();
+    writer.Key("hosts").BeginObject();
+    for (const auto& it : hosts_) {
+        writer.Key(it.first);
+        it.second->WriteJson(writer);
+        all.Merge(*it.second);
+    }
+    writer.EndObject();
+    writer.Key("all");
+    all.WriteJson(writer);
+    writer.EndObject();
+}
@@ -0,0 +1,101 @@
+// CEF Browser - Navigation Timing Metrics
+#ifndef CEF_BROWSER_NAVIGATION_METRICS_H_
+#define CEF_BROWSER_NAVIGATION_METRICS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "histogram.h"
+
+class JsonWriter;
+
+// Per-host latency of main frame navigations. Each navigation is timed from
+// its start to commit, main frame load end, loading idle and error, and the
+// durations are recorded in microsecond histograms.
+//
+// Owned by the UI thread, where all CEF load events arrive, so recording is
+// lock-free. Timestamps are passed in to keep the class clock-agnostic.
+class NavigationMetrics {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    NavigationMetrics() = default;
+
+    NavigationMetrics(const NavigationMetrics&) = delete;
+    NavigationMetrics& operator=(const NavigationMetrics&) = delete;
+
+    // A main frame navigation to |url| started. Any navigation still in
+    // progress in |browser_id| is abandoned.
+    void OnNavigationStart(int browser_id, std::string_view url, TimePoint now);
+
+    // The main frame committed |url|; attributes the navigation to its host
+    void OnCommit(int browser_id, std::string_view url, TimePoint now);
+
+    // The main frame finished loading
+    void OnLoadEnd(int browser_id, TimePoint now);
+
+    // The main frame failed with |error_code|. Aborted loads are ignored since
+    // they are usually replaced by the next navigation.
+    void OnLoadError(int browser_id, int error_code, TimePoint now);
+
+    // The browser stopped loading; completes the current navigation
+    void OnLoadingIdle(int browser_id, TimePoint now);
+
+    void OnBrowserClosed(int browser_id);
+
+    // Write {"hosts": {host: stats}, "all": stats}
+    void WriteJson(JsonWriter& writer) const;
+
+    // Host of |url| in lower case, without user info or port
+    static std::string GetHost(std::string_view url);
+
+    // Hosts beyond this many are recorded under kOtherHost
+    static constexpr size_t kMaxHosts = 256;
+    static constexpr const char* kOtherHost = "(other)";
+
+private:
+    struct HostStats {
+        uint64_t navigations = 0;
+        uint64_t errors = 0;
+        uint64_t abandoned = 0;
+        Histogram commit;
+        Histogram load_end;
+        Histogram idle;
+        Histogram error;
+
+        void Merge(const HostStats& other);
+        void WriteJson(JsonWriter& writer) const;
+    };
+
+    struct Navigation {
+        uint64_t id = 0;
+        std::string host;
+        TimePoint start;
+        bool committed = false;
+        bool load_ended = false;
+        bool failed = false;
+    };
+
+    // Finish the current navigation of |browser_id|, if any
+    void Finish(int browser_id, bool abandoned);
+
+    HostStats& GetHostStats(const std::string& host);
+
+    static uint64_t ElapsedMicros(TimePoint start, TimePoint end);
+
+    // In-progress navigation per browser
+    std::unordered_map<int, Navigation> navigations_;
+
+    // Sorted so dumps are stable
+    std::map<std::string, std::unique_ptr<HostStats>> hosts_;
+
+    uint64_t next_navigation_id_ = 1;
+};
+
+#endif  // CEF_BROWSER_NAVIGATION_METRICS_H_
@@ -0,0 +1,98 @@
+// CEF Browser - Page Readiness Implementation
+#include "page_readiness.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+constexpr std::string_view kDomContentLoadedPrefix = "domcontentloaded+";
+
+// Consume |prefix| from the front of |text|
+bool ConsumePrefix(std::string_view* text, std::string_view prefix) {
+    if (text->substr(0, prefix.size()) != prefix) {
+        return false;
+    }
+    text->remove_prefix(prefix.size());
+    return true;
+}
+
+// Consume a decimal number of at most |max_value| from the front of |text|
+bool ConsumeNumber(std::string_view* text, int max_value, int* value) {
+    const char* end = text->data() + text->size();
+    auto [next, error] = std::from_chars(text->data(), end, *value);
+    if (error != std::errc() || *value < 0 || *value > max_value) {
+        return false;
+    }
+    text->remove_prefix(next - text->data());
+    return true;
+}
+
+}  // namespace
+
+bool ParsePageReadyCondition(std::string_view spec, PageReadyCondition* condition) {
+    PageReadyCondition parsed = *condition;
+    parsed.dom_content_loaded = ConsumePrefix(&spec, kDomContentLoadedPrefix);
+
+    if (parsed.dom_content_loaded && spec == "idle") {
+        parsed.max_inflight = 0;
+        parsed.quiet_ms = 500;
+        *condition = parsed;
+        return true;
+    }
+
+    if (!ConsumePrefix(&spec, "network-idle-") ||
+        !ConsumeNumber(&spec, 1000, &parsed.max_inflight) || !ConsumePrefix(&spec, "-for-") ||
+        !ConsumeNumber(&spec, 600000, &parsed.quiet_ms) || spec != "-ms") {
+        return false;
+    }
+    *condition = parsed;
+    return true;
+}
+
+void PageLoadState::OnNavigation(TimePoint now) {
+    page_++;
+    page_start_ = now;
+    dom_content_loaded_ = false;
+}
+
+void PageLoadState::OnRequestStarted(uint64_t request_id) {
+    inflight_.insert(request_id);
+}
+
+void PageLoadState::OnRequestFinished(uint64_t request_id, TimePoint now) {
+    if (inflight_.erase(request_id) == 0) {
+        return;
+    }
+    const size_t count = inflight_.size();
+    if (at_most_since_.size() <= count) {
+        at_most_since_.resize(count + 1, TimePoint::min());
+    }
+    at_most_since_[count] = now;
+}
+
+void PageLoadState::OnDomContentLoaded(TimePoint now) {
+    if (!dom_content_loaded_) {
+        dom_content_loaded_ = true;
+        dom_content_loaded_at_ = now;
+    }
+}
+
+PageLoadState::TimePoint PageLoadState::ReadyAt(const PageReadyCondition& condition) const {
+    const size_t max_inflight = static_cast<size_t>(std::max(condition.max_inflight, 0));
+    if (inflight_.size() > max_inflight || (condition.dom_content_loaded && !dom_content_loaded_)) {
+        return TimePoint::max();
+    }
+
+    // Quiet time counts from the navigation at the earliest
+    TimePoint quiet_since = page_start_;
+    if (max_inflight < at_most_since_.size()) {
+        quiet_since = std::max(quiet_since, at_most_since_[max_inflight]);
+    }
+
+    TimePoint ready = quiet_since + std::chrono::milliseconds(condition.quiet_ms);
+    if (condition.dom_content_loaded) {
+        ready = std::max(ready, dom_content_loaded_at_);
+    }
+    return ready;
+}
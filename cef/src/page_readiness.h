@@ -0,0 +1,83 @@
+// CEF Browser - Page Readiness
+#ifndef CEF_BROWSER_PAGE_READINESS_H_
+#define CEF_BROWSER_PAGE_READINESS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// When a page counts as ready, e.g. for a screenshot or for moving on to the
+// next page of a batch
+struct PageReadyCondition {
+    // Requests that may still be in flight, e.g. a long poll or a stream
+    int max_inflight = 0;
+
+    // How long no more than |max_inflight| requests must have been in flight
+    int quiet_ms = 500;
+
+    // Also wait for DOMContentLoaded
+    bool dom_content_loaded = false;
+
+    // Give up on a page this long after its navigation committed; 0 waits
+    // forever
+    int timeout_ms = 30000;
+};
+
+// Parse "network-idle-N-for-T-ms", optionally prefixed with
+// "domcontentloaded+", where "domcontentloaded+idle" is short for
+// "domcontentloaded+network-idle-0-for-500-ms". Returns false, leaving
+// |condition| unchanged, if |spec| is malformed.
+bool ParsePageReadyCondition(std::string_view spec, PageReadyCondition* condition);
+
+// Requests in flight and DOMContentLoaded of the page in one browser, and when
+// a PageReadyCondition holds for it.
+//
+// Requests are identified so a completion without a start, e.g. of a request
+// that started before tracking did, is ignored. Requests of the previous page
+// that outlive its navigation still count since they keep the network busy.
+// Timestamps are passed in to keep the class clock-agnostic.
+class PageLoadState {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    PageLoadState() = default;
+
+    // A main frame navigation committed a new page
+    void OnNavigation(TimePoint now);
+
+    // Starting a request again, e.g. on a redirect, is ignored
+    void OnRequestStarted(uint64_t request_id);
+    void OnRequestFinished(uint64_t request_id, TimePoint now);
+
+    void OnDomContentLoaded(TimePoint now);
+
+    // When |condition| holds for the current page if no further request
+    // starts; TimePoint::max() while more requests are in flight or
+    // DOMContentLoaded is pending
+    TimePoint ReadyAt(const PageReadyCondition& condition) const;
+
+    // Number of the current page, counting navigations from 1; 0 before the
+    // first one
+    uint64_t page() const { return page_; }
+    TimePoint page_start() const { return page_start_; }
+
+    size_t inflight() const { return inflight_.size(); }
+    bool dom_content_loaded() const { return dom_content_loaded_; }
+
+private:
+    std::unordered_set<uint64_t> inflight_;
+
+    // [n] is when the in-flight count last dropped to n, and is valid while
+    // n >= inflight(). The count never exceeded n if there is no entry.
+    std::vector<TimePoint> at_most_since_;
+
+    uint64_t page_ = 0;
+    TimePoint page_start_;
+    bool dom_content_loaded_ = false;
+    TimePoint dom_content_loaded_at_;
+};
+
+#endif  // CEF_BROWSER_PAGE_READINESS_H_
@@ -0,0 +1,287 @@
+// CEF Browser - Page Readiness Tracking Implementation
+#include "page_readiness_handler.h"
+#include "browser_client.h"
+#include "browser_config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "include/base/cef_callback.h"
+#include "include/base/cef_logging.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace {
+
+using TimePoint = PageLoadState::TimePoint;
+
+struct Watch {
+    CefRefPtr<CefBrowser> browser;
+    int browser_id = 0;
+    PageReadyCondition condition;
+    PageReadyCallback callback;
+
+    // Pages before this one had committed when the watch was added
+    uint64_t first_page = 0;
+
+    // Last page the callback ran for
+    uint64_t reported_page = 0;
+};
+
+// Set by the first watch; read on the IO thread. Pages and requests are
+// tracked in the BrowserRecord of every browser from then on.
+std::atomic<bool> g_tracking{false};
+
+// UI thread state, keyed by watch identifier. Checks posted for a browser
+// that has closed since are ignored.
+std::map<int, Watch> g_watches;
+int g_next_watch = 1;
+
+void Evaluate(SlotHandle handle);
+
+void CheckPage(SlotHandle handle, TimePoint check_at) {
+    // Superseded by an earlier check
+    bool current = false;
+    GetBrowserRegistry().Update(handle, [check_at, &current](BrowserRecord& record) {
+        if (record.ready_check_at == check_at) {
+            record.ready_check_at = TimePoint::max();
+            current = true;
+        }
+    });
+    if (current) {
+        Evaluate(handle);
+    }
+}
+
+void ScheduleCheck(SlotHandle handle, TimePoint at, TimePoint now) {
+    bool earlier = false;
+    GetBrowserRegistry().Update(handle, [at, &earlier](BrowserRecord& record) {
+        if (at < record.ready_check_at) {
+            record.ready_check_at = at;
+            earlier = true;
+        }
+    });
+    if (!earlier) {
+        return;
+    }
+
+    // Round up so the check does not run just before the deadline
+    const auto delay = std::chrono::ceil<std::chrono::milliseconds>(at - now);
+    CefPostDelayedTask(TID_UI, base::BindOnce(&CheckPage, handle, at),
+                       std::max<int64_t>(delay.count(), 0));
+}
+
+// Report the watches of |handle|'s browser that are due and schedule a check
+// for the next one to become due
+void Evaluate(SlotHandle handle) {
+    const BrowserRecord* record = GetBrowserRegistry().Find(handle);
+    if (!record) {
+        return;
+    }
+
+    const TimePoint now = PageLoadState::Clock::now();
+    const PageLoadState& state = record->page_load;
+    TimePoint next_check = TimePoint::max();
+
+    // Due watches and whether each timed out. Worked out before any callback
+    // runs, since callbacks may open or close browsers and so move |record|.
+    std::vector<std::pair<int, bool>> due;
+    for (const auto& it : g_watches) {
+        const Watch& watch = it.second;
+        if (watch.browser_id != record->browser_id || state.page() < watch.first_page ||
+            watch.reported_page == state.page()) {
+            continue;
+        }
+        const TimePoint ready_at = state.ReadyAt(watch.condition);
+        const TimePoint deadline =
+            watch.condition.timeout_ms > 0
+                ? state.page_start() + std::chrono::milliseconds(watch.condition.timeout_ms)
+                : TimePoint::max();
+        if (ready_at <= now || deadline <= now) {
+            due.emplace_back(it.first, ready_at > now);
+        } else {
+            next_check = std::min({next_check, ready_at, deadline});
+        }
+    }
+
+    PageReadyEvent event;
+    event.inflight = state.inflight();
+    event.elapsed_ms =
+        std::chrono::duration<double, std::milli>(now - state.page_start()).count();
+    const uint64_t page = state.page();
+    for (const auto& [id, timed_out] : due) {
+        // An earlier callback may have cancelled the watch
+        auto it = g_watches.find(id);
+        if (it == g_watches.end()) {
+            continue;
+        }
+        Watch& watch = it->second;
+        watch.reported_page = page;
+        event.timed_out = timed_out;
+        event.url = watch.browser->GetMainFrame()->GetURL().ToString();
+
+        // Copied since the callback may cancel its own watch
+        CefRefPtr<CefBrowser> browser = watch.browser;
+        PageReadyCallback callback = watch.callback;
+        callback(browser, event);
+    }
+
+    if (next_check != TimePoint::max()) {
+        ScheduleCheck(handle, next_check, now);
+    }
+}
+
+void OnRequestStarted(int browser_id, uint64_t request_id) {
+    GetBrowserRegistry().Update(browser_id, [request_id](BrowserRecord& record) {
+        record.page_load.OnRequestStarted(request_id);
+    });
+}
+
+void OnRequestFinished(int browser_id, uint64_t request_id, TimePoint now) {
+    const SlotHandle handle = GetBrowserRegistry().HandleOf(browser_id);
+    if (GetBrowserRegistry().Update(handle, [request_id, now](BrowserRecord& record) {
+            record.page_load.OnRequestFinished(request_id, now);
+        })) {
+        Evaluate(handle);
+    }
+}
+
+}  // namespace
+
+PageReadinessHandler::PageReadinessHandler(int browser_id,
+                                           CefRefPtr<CefResourceRequestHandler> handler)
+    : DelegatingRequestHandler(handler), browser_id_(browser_id) {}
+
+CefResourceRequestHandler::ReturnValue PageReadinessHandler::OnBeforeResourceLoad(
+    CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request,
+    CefRefPtr<CefCallback> callback) {
+    // Cancelled requests complete too, so they are counted either way
+    CefPostTask(TID_UI, base::BindOnce(&OnRequestStarted, browser_id_, request->GetIdentifier()));
+    return DelegatingRequestHandler::OnBeforeResourceLoad(browser, frame, request, callback);
+}
+
+void PageReadinessHandler::OnResourceLoadComplete(CefRefPtr<CefBrowser> browser,
+                                                  CefRefPtr<CefFrame> frame,
+                                                  CefRefPtr<CefRequest> request,
+                                                  CefRefPtr<CefResponse> response,
+                                                  URLRequestStatus status,
+                                                  int64_t received_content_length) {
+    DelegatingRequestHandler::OnResourceLoadComplete(browser, frame, request, response, status,
+                                                     received_content_length);
+    CefPostTask(TID_UI, base::BindOnce(&OnRequestFinished, browser_id_, request->GetIdentifier(),
+                                       PageLoadState::Clock::now()));
+}
+
+CefRefPtr<CefResourceRequestHandler> TrackPageReadiness(
+    CefRefPtr<CefBrowser> browser, CefRefPtr<CefRequest> request,
+    CefRefPtr<CefResourceRequestHandler> handler) {
+    if (!g_tracking.load(std::memory_order_relaxed) || !browser) {
+        return handler;
+    }
+
+    // WebSockets stay open for the life of the page
+    const std::string url = request->GetURL().ToString();
+    if (url.rfind("ws://", 0) == 0 || url.rfind("wss://", 0) == 0) {
+        return handler;
+    }
+
+    return new PageReadinessHandler(browser->GetIdentifier(), handler);
+}
+
+int WatchPageReady(CefRefPtr<CefBrowser> browser, const PageReadyCondition& condition,
+                   PageReadyCallback callback) {
+    CEF_REQUIRE_UI_THREAD();
+
+    g_tracking.store(true, std::memory_order_relaxed);
+
+    const int id = g_next_watch++;
+    Watch& watch = g_watches[id];
+    watch.browser = browser;
+    watch.browser_id = browser->GetIdentifier();
+    watch.condition = condition;
+    watch.callback = std::move(callback);
+    const BrowserRecord* record = GetBrowserRegistry().Find(watch.browser_id);
+    watch.first_page = (record ? record->page_load.page() : 0) + 1;
+    return id;
+}
+
+void CancelPageReadyWatch(int watch) {
+    CEF_REQUIRE_UI_THREAD();
+
+    g_watches.erase(watch);
+}
+
+void OnPageReadinessLoadStart(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (!g_tracking.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const SlotHandle handle = GetBrowserRegistry().HandleOf(browser->GetIdentifier());
+    if (GetBrowserRegistry().Update(handle, [](BrowserRecord& record) {
+            record.page_load.OnNavigation(PageLoadState::Clock::now());
+        })) {
+        Evaluate(handle);
+    }
+}
+
+void OnPageReadinessDomContentLoaded(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (!g_tracking.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const SlotHandle handle = GetBrowserRegistry().HandleOf(browser->GetIdentifier());
+    if (GetBrowserRegistry().Update(handle, [](BrowserRecord& record) {
+            record.page_load.OnDomContentLoaded(PageLoadState::Clock::now());
+        })) {
+        Evaluate(handle);
+    }
+}
+
+void OnPageReadinessBrowserClosed(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    // The pages go with the browser's BrowserRecord
+    const int browser_id = browser->GetIdentifier();
+    for (auto it = g_watches.begin(); it != g_watches.end();) {
+        if (it->second.browser_id == browser_id) {
+            it = g_watches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool WatchConfiguredPageReady(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    const std::string& spec = GetBrowserConfig().ready_when;
+    if (spec.empty()) {
+        return false;
+    }
+
+    PageReadyCondition condition;
+    if (!ParsePageReadyCondition(spec, &condition)) {
+        LOG(WARNING) << "Ignoring malformed --ready-when=" << spec;
+        return false;
+    }
+
+    WatchPageReady(browser, condition, [](CefRefPtr<CefBrowser>, const PageReadyEvent& event) {
+        if (event.timed_out) {
+            LOG(WARNING) << event.url << " not ready after " << event.elapsed_ms << " ms with "
+                         << event.inflight << " requests in flight";
+            return;
+        }
+        LOG(INFO) << event.url << " ready after " << event.elapsed_ms << " ms";
+        // Launchers wait for this line before capturing the page
+        printf("ready %s\n", event.url.c_str());
+        fflush(stdout);
+    });
+    return true;
+}
@@ -0,0 +1,79 @@
+// CEF Browser - Page Readiness Tracking
+#ifndef CEF_BROWSER_PAGE_READINESS_HANDLER_H_
+#define CEF_BROWSER_PAGE_READINESS_HANDLER_H_
+
+#include <functional>
+#include <string>
+
+#include "include/cef_browser.h"
+#include "include/cef_resource_request_handler.h"
+
+#include "delegating_request_handler.h"
+#include "page_readiness.h"
+
+// A page that met, or timed out waiting for, a PageReadyCondition
+struct PageReadyEvent {
+    std::string url;
+
+    // The condition did not hold within its timeout
+    bool timed_out = false;
+
+    // Requests still in flight
+    size_t inflight = 0;
+
+    // Milliseconds from the page's navigation to the event
+    double elapsed_ms = 0;
+};
+
+using PageReadyCallback =
+    std::function<void(CefRefPtr<CefBrowser> browser, const PageReadyEvent& event)>;
+
+// Counts a browser's requests for page readiness while delegating to the
+// handler that would otherwise have been used, which may be null. Created per
+// request on the IO thread; the counts are kept in the browser's BrowserRecord
+// on the UI thread.
+class PageReadinessHandler : public DelegatingRequestHandler {
+public:
+    PageReadinessHandler(int browser_id, CefRefPtr<CefResourceRequestHandler> handler);
+
+    // CefResourceRequestHandler methods
+    ReturnValue OnBeforeResourceLoad(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                     CefRefPtr<CefRequest> request,
+                                     CefRefPtr<CefCallback> callback) override;
+    void OnResourceLoadComplete(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response,
+                                URLRequestStatus status,
+                                int64_t received_content_length) override;
+
+private:
+    const int browser_id_;
+
+    IMPLEMENT_REFCOUNTING(PageReadinessHandler);
+    DISALLOW_COPY_AND_ASSIGN(PageReadinessHandler);
+};
+
+// |handler| wrapped to count |browser|'s request once page readiness is
+// watched; |handler| itself otherwise. IO thread.
+CefRefPtr<CefResourceRequestHandler> TrackPageReadiness(
+    CefRefPtr<CefBrowser> browser, CefRefPtr<CefRequest> request,
+    CefRefPtr<CefResourceRequestHandler> handler);
+
+// Run |callback| for each page of |browser| whose navigation commits after
+// this call, once it meets |condition| or its timeout expires. Returns a
+// watch id for CancelPageReadyWatch(). The first watch turns request counting
+// on; requests that started before are not counted. UI thread; |callback|
+// runs there and may cancel watches.
+int WatchPageReady(CefRefPtr<CefBrowser> browser, const PageReadyCondition& condition,
+                   PageReadyCallback callback);
+void CancelPageReadyWatch(int watch);
+
+// Load events of BrowserClient. UI thread.
+void OnPageReadinessLoadStart(CefRefPtr<CefBrowser> browser);
+void OnPageReadinessDomContentLoaded(CefRefPtr<CefBrowser> browser);
+void OnPageReadinessBrowserClosed(CefRefPtr<CefBrowser> browser);
+
+// Watch the main browser for --ready-when and print "ready <url>" to stdout
+// for every page that meets it. Returns false when it is not set. UI thread.
+bool WatchConfiguredPageReady(CefRefPtr<CefBrowser> browser);
+
+#endif  // CEF_BROWSER_PAGE_READINESS_HANDLER_H_
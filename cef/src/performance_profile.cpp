@@ -0,0 +1,344 @@
+// CEF Browser - Performance Profiles Implementation
+#include "performance_profile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#include <sys/types.h>
+#else
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr uint64_t kMegabyte = 1024 * 1024;
+
+// Memory assumed when it cannot be detected
+constexpr uint64_t kDefaultMemoryMb = 4096;
+
+// Below this, "auto" selects the low-memory profile
+constexpr uint64_t kLowMemoryThresholdMb = 3072;
+
+// Memory budgeted per renderer process when sizing the process limit
+constexpr uint64_t kRendererBudgetMb = 512;
+
+std::string_view Trim(std::string_view text) {
+    const char* whitespace = " \t\r\n";
+    size_t begin = text.find_first_not_of(whitespace);
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    size_t end = text.find_last_not_of(whitespace);
+    return text.substr(begin, end - begin + 1);
+}
+
+bool ParseUint64(std::string_view text, uint64_t* value) {
+    text = Trim(text);
+    auto result = std::from_chars(text.data(), text.data() + text.size(), *value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+int64_t Clamp(int64_t value, int64_t min_value, int64_t max_value) {
+    return std::clamp(value, min_value, max_value);
+}
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream file(path);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// Path of the cgroup v2 hierarchy of this process, e.g. "/user.slice", or
+// empty unless /sys/fs/cgroup is a cgroup v2 mount. Hybrid hosts list a "0::"
+// hierarchy too but keep their controllers on v1.
+std::string GetCgroupV2Path() {
+    if (!std::ifstream("/sys/fs/cgroup/cgroup.controllers")) {
+        return {};
+    }
+    std::istringstream lines(ReadFile("/proc/self/cgroup"));
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.rfind("0::", 0) == 0) {
+            return line.substr(3);
+        }
+    }
+    return {};
+}
+
+// Lower |current| to |limit| if |limit| is set
+template <typename T>
+void ApplyLimit(T limit, T* current) {
+    if (limit > 0 && (*current == 0 || limit < *current)) {
+        *current = limit;
+    }
+}
+
+#endif
+
+}  // namespace
+
+HostResources DetectHostResources() {
+    HostResources resources;
+    resources.cpu_count = std::max(1u, std::thread::hardware_concurrency());
+
+#if defined(_WIN32)
+    MEMORYSTATUSEX status = {};
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status)) {
+        resources.memory_bytes = status.ullTotalPhys;
+    }
+#elif defined(__APPLE__)
+    uint64_t memory = 0;
+    size_t size = sizeof(memory);
+    if (sysctlbyname("hw.memsize", &memory, &size, nullptr, 0) == 0) {
+        resources.memory_bytes = memory;
+    }
+#else
+    cpu_set_t affinity;
+    CPU_ZERO(&affinity);
+    if (sched_getaffinity(0, sizeof(affinity), &affinity) == 0 && CPU_COUNT(&affinity) > 0) {
+        resources.cpu_count = CPU_COUNT(&affinity);
+    }
+
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long page_size = sysconf(_SC_PAGE_SIZE);
+    if (pages > 0 && page_size > 0) {
+        resources.memory_bytes = static_cast<uint64_t>(pages) * page_size;
+    }
+
+    int cgroup_cpus = 0;
+    uint64_t cgroup_memory = 0;
+    const std::string v2_path = GetCgroupV2Path();
+    if (!v2_path.empty()) {
+        // Limits of every ancestor apply; the tightest one wins
+        std::string dir = "/sys/fs/cgroup" + (v2_path == "/" ? std::string() : v2_path);
+        while (true) {
+            ApplyLimit(ParseCgroupCpuQuota(ReadFile(dir + "/cpu.max")), &cgroup_cpus);
+            ApplyLimit(ParseCgroupMemoryLimit(ReadFile(dir + "/memory.max")), &cgroup_memory);
+            size_t slash = dir.rfind('/');
+            if (dir == "/sys/fs/cgroup" || slash == std::string::npos) {
+                break;
+            }
+            dir.resize(slash);
+        }
+    } else {
+        for (const char* dir : {"/sys/fs/cgroup/cpu,cpuacct", "/sys/fs/cgroup/cpu"}) {
+            std::string quota = ReadFile(std::string(dir) + "/cpu.cfs_quota_us");
+            std::string period = ReadFile(std::string(dir) + "/cpu.cfs_period_us");
+            if (!quota.empty()) {
+                cgroup_cpus = ParseCgroupCpuQuota(std::string(Trim(quota)) + " " +
+                                                  std::string(Trim(period)));
+                break;
+            }
+        }
+        cgroup_memory =
+            ParseCgroupMemoryLimit(ReadFile("/sys/fs/cgroup/memory/memory.limit_in_bytes"));
+    }
+
+    ApplyLimit(cgroup_cpus, &resources.cpu_count);
+    ApplyLimit(cgroup_memory, &resources.memory_bytes);
+#endif
+
+    return resources;
+}
+
+int ParseCgroupCpuQuota(std::string_view text) {
+    text = Trim(text);
+    size_t space = text.find(' ');
+    if (space == std::string_view::npos) {
+        return 0;
+    }
+    uint64_t quota = 0;
+    uint64_t period = 0;
+    if (!ParseUint64(text.substr(0, space), &quota) ||
+        !ParseUint64(text.substr(space + 1), &period) || quota == 0 || period == 0) {
+        // "max" and "-1" mean unlimited
+        return 0;
+    }
+    return static_cast<int>(std::min<uint64_t>((quota + period - 1) / period, 1 << 20));
+}
+
+uint64_t ParseCgroupMemoryLimit(std::string_view text) {
+    uint64_t limit = 0;
+    if (!ParseUint64(text, &limit)) {
+        return 0;
+    }
+    // cgroup v1 reports "no limit" as INT64_MAX rounded down to a page
+    return limit >= (uint64_t{1} << 62) ? 0 : limit;
+}
+
+const CommandLineSwitch* PerformanceProfile::Find(std::string_view name) const {
+    for (const CommandLineSwitch& entry : switches) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void PerformanceProfile::Set(const std::string& name, const std::string& value) {
+    for (CommandLineSwitch& entry : switches) {
+        if (entry.name == name) {
+            entry.value = value;
+            return;
+        }
+    }
+    switches.push_back({name, value});
+}
+
+void PerformanceProfile::Remove(std::string_view name) {
+    switches.erase(std::remove_if(switches.begin(), switches.end(),
+                                  [name](const CommandLineSwitch& entry) {
+                                      return entry.name == name;
+                                  }),
+                   switches.end());
+}
+
+std::string PerformanceProfile::ToString() const {
+    std::string text;
+    for (const CommandLineSwitch& entry : switches) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += entry.name;
+        if (!entry.value.empty()) {
+            text += '=';
+            text += entry.value;
+        }
+    }
+    return text;
+}
+
+bool GetPerformanceProfile(std::string_view name, const HostResources& resources,
+                           bool off_screen, PerformanceProfile* profile) {
+    const int64_t cores = std::max(resources.cpu_count, 1);
+    const int64_t memory_mb =
+        resources.memory_bytes ? resources.memory_bytes / kMegabyte : kDefaultMemoryMb;
+
+    if (name == "auto") {
+        if (memory_mb < static_cast<int64_t>(kLowMemoryThresholdMb)) {
+            name = "low-memory";
+        } else {
+            name = off_screen ? "throughput" : "low-latency";
+        }
+    }
+
+    PerformanceProfile result;
+    result.name = std::string(name);
+    const int64_t memory_renderers = std::max<int64_t>(memory_mb / kRendererBudgetMb, 1);
+
+    if (name == "throughput") {
+        // One renderer per core as far as memory allows, each with an equal
+        // share of the remaining cores for raster and half its memory for V8
+        int64_t renderers = Clamp(std::min(cores, memory_renderers), 1, 64);
+        result.Set("renderer-process-limit", std::to_string(renderers));
+        result.Set("num-raster-threads", std::to_string(Clamp(cores / renderers, 1, 4)));
+        result.Set("js-flags", "--max-old-space-size=" +
+                                   std::to_string(Clamp(memory_mb / renderers / 2, 128, 4096)));
+
+        // Pages loaded in the background must not be throttled
+        result.Set("disable-renderer-backgrounding", "");
+        result.Set("disable-background-timer-throttling", "");
+        result.Set("disable-backgrounding-occluded-windows", "");
+    } else if (name == "low-latency") {
+        // Leave half the cores to the browser, GPU and raster threads
+        int64_t renderers = Clamp(std::min(cores / 2, memory_renderers), 1, 16);
+        result.Set("renderer-process-limit", std::to_string(renderers));
+        result.Set("num-raster-threads", std::to_string(Clamp(cores / 2, 1, 4)));
+        result.Set("js-flags", "--max-old-space-size=" +
+                                   std::to_string(Clamp(memory_mb / renderers / 2, 256, 4096)));
+
+        // Scroll and input land in the next frame instead of animating
+        result.Set("disable-smooth-scrolling", "");
+        result.Set("disable-renderer-backgrounding", "");
+    } else if (name == "low-memory") {
+        result.Set("renderer-process-limit", std::to_string(Clamp(memory_mb / 1024, 1, 2)));
+        result.Set("num-raster-threads", "1");
+        result.Set("js-flags", "--max-old-space-size=" +
+                                   std::to_string(Clamp(memory_mb / 8, 64, 512)) +
+                                   " --optimize-for-size");
+        result.Set("enable-low-end-device-mode", "");
+        result.Set("enable-tab-discarding", "");
+    } else {
+        return false;
+    }
+
+    *profile = std::move(result);
+    return true;
+}
+
+bool ParsePerformanceProfileConfig(std::string_view text, PerformanceProfileConfig* config,
+                                   int* error_line) {
+    PerformanceProfileConfig result;
+    int line_number = 0;
+    size_t begin = 0;
+    while (begin <= text.size()) {
+        size_t end = text.find('\n', begin);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view line = Trim(text.substr(begin, end - begin));
+        begin = end + 1;
+        ++line_number;
+
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        bool removal = line[0] == '!';
+        if (removal) {
+            line = Trim(line.substr(1));
+        }
+
+        std::string_view key = line;
+        std::string_view value;
+        size_t equals = line.find('=');
+        if (equals != std::string_view::npos) {
+            key = Trim(line.substr(0, equals));
+            value = Trim(line.substr(equals + 1));
+        }
+
+        // Switches may be written as on the command line
+        while (!key.empty() && key[0] == '-') {
+            key.remove_prefix(1);
+        }
+        if (key.empty()) {
+            if (error_line) {
+                *error_line = line_number;
+            }
+            return false;
+        }
+
+        if (removal) {
+            result.removals.emplace_back(key);
+        } else if (key == "profile") {
+            result.profile = std::string(value);
+        } else {
+            result.overrides.push_back({std::string(key), std::string(value)});
+        }
+    }
+
+    *config = std::move(result);
+    return true;
+}
+
+void ApplyPerformanceProfileConfig(const PerformanceProfileConfig& config,
+                                   PerformanceProfile* profile) {
+    for (const std::string& name : config.removals) {
+        profile->Remove(name);
+    }
+    for (const CommandLineSwitch& entry : config.overrides) {
+        profile->Set(entry.name, entry.value);
+    }
+}
@@ -0,0 +1,89 @@
+// CEF Browser - Performance Profiles
+#ifndef CEF_BROWSER_PERFORMANCE_PROFILE_H_
+#define CEF_BROWSER_PERFORMANCE_PROFILE_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Hardware available to the browser after affinity and cgroup limits
+struct HostResources {
+    // Usable cores
+    int cpu_count = 1;
+
+    // Physical memory or the cgroup memory limit, whichever is lower
+    uint64_t memory_bytes = 0;
+};
+
+// Detect the cores and memory the browser may use. On Linux the CPU affinity
+// mask and cgroup v1/v2 CPU quota and memory limit are applied.
+HostResources DetectHostResources();
+
+// Cores granted by a cgroup CPU quota, rounded up: "200000 100000" from
+// cgroup v2 cpu.max, or cgroup v1 cpu.cfs_quota_us and cpu.cfs_period_us
+// joined by a space. 0 when unlimited ("max" or "-1") or unparsable.
+int ParseCgroupCpuQuota(std::string_view text);
+
+// Bytes of a cgroup v2 memory.max or v1 memory.limit_in_bytes value. 0 when
+// unlimited ("max" or a page-rounded INT64_MAX) or unparsable.
+uint64_t ParseCgroupMemoryLimit(std::string_view text);
+
+// A command line switch; flags have an empty value
+struct CommandLineSwitch {
+    std::string name;
+    std::string value;
+
+    bool operator==(const CommandLineSwitch& other) const {
+        return name == other.name && value == other.value;
+    }
+};
+
+// Named set of Chromium switches derived from the host
+struct PerformanceProfile {
+    std::string name;
+    std::vector<CommandLineSwitch> switches;
+
+    // Value of switch |name|, or nullptr if the profile does not set it
+    const CommandLineSwitch* Find(std::string_view name) const;
+
+    // Set switch |name| to |value|, replacing any existing value
+    void Set(const std::string& name, const std::string& value);
+    void Remove(std::string_view name);
+
+    // "name=value name ..." for logging
+    std::string ToString() const;
+};
+
+// Profile names: "throughput" sizes renderer processes, raster threads and V8
+// heaps for many parallel pages and keeps background pages running at full
+// speed, "low-latency" favors one interactive page, and "low-memory" caps
+// processes and heaps for small devices. "auto" picks low-memory below 3 GB,
+// throughput for off-screen rendering and low-latency otherwise.
+constexpr char kDefaultPerformanceProfile[] = "auto";
+
+// Derive profile |name| for |resources|. Returns false for unknown names.
+bool GetPerformanceProfile(std::string_view name, const HostResources& resources,
+                           bool off_screen, PerformanceProfile* profile);
+
+// Profile config file: one entry per line, "#" starts a comment.
+//   profile = low-memory       selects the profile
+//   renderer-process-limit = 3 sets a switch, replacing the profile value
+//   enable-low-end-device-mode sets a flag
+//   !disable-smooth-scrolling  removes a switch set by the profile
+struct PerformanceProfileConfig {
+    std::string profile;
+    std::vector<CommandLineSwitch> overrides;
+    std::vector<std::string> removals;
+};
+
+// Parse |text| into |config|. Returns false, with the 1-based line number in
+// |error_line|, on a line without a switch name.
+bool ParsePerformanceProfileConfig(std::string_view text, PerformanceProfileConfig* config,
+                                   int* error_line);
+
+// Apply the overrides and removals of |config| to |profile|
+void ApplyPerformanceProfileConfig(const PerformanceProfileConfig& config,
+                                   PerformanceProfile* profile);
+
+#endif  // CEF_BROWSER_PERFORMANCE_PROFILE_H_
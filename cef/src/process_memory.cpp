@@ -0,0 +1,65 @@
+// CEF Browser - Process Memory Statistics Implementation
+#include "process_memory.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <libproc.h>
+#include <unistd.h>
+#else
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#endif
+
+int GetCurrentProcessIdentifier() {
+#if defined(_WIN32)
+    return static_cast<int>(GetCurrentProcessId());
+#else
+    return static_cast<int>(getpid());
+#endif
+}
+
+uint64_t GetPeakResidentBytes(int pid) {
+#if defined(_WIN32)
+    HANDLE process =
+        OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (!process) {
+        return 0;
+    }
+    PROCESS_MEMORY_COUNTERS counters = {};
+    uint64_t peak = 0;
+    if (GetProcessMemoryInfo(process, &counters, sizeof(counters))) {
+        peak = counters.PeakWorkingSetSize;
+    }
+    CloseHandle(process);
+    return peak;
+#elif defined(__APPLE__)
+    rusage_info_v4 info = {};
+    if (proc_pid_rusage(pid, RUSAGE_INFO_V4, reinterpret_cast<rusage_info_t*>(&info)) != 0) {
+        return 0;
+    }
+    return info.ri_lifetime_max_phys_footprint;
+#else
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return 0;
+    }
+
+    // "VmHWM:    123456 kB" is the resident high water mark
+    uint64_t peak = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        unsigned long long kilobytes = 0;
+        if (strncmp(line, "VmHWM:", 6) == 0 && sscanf(line + 6, "%llu", &kilobytes) == 1) {
+            peak = static_cast<uint64_t>(kilobytes) * 1024;
+            break;
+        }
+    }
+    fclose(file);
+    return peak;
+#endif
+}
@@ -0,0 +1,14 @@
+// CEF Browser - Process Memory Statistics
+#ifndef CEF_BROWSER_PROCESS_MEMORY_H_
+#define CEF_BROWSER_PROCESS_MEMORY_H_
+
+#include <cstdint>
+
+// Identifier of the calling process
+int GetCurrentProcessIdentifier();
+
+// Peak resident set size of process |pid| over its lifetime, in bytes, or 0 if
+// it cannot be read (e.g. the process has exited)
+uint64_t GetPeakResidentBytes(int pid);
+
+#endif  // CEF_BROWSER_PROCESS_MEMORY_H_
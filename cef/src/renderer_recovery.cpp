@@ -0,0 +1,236 @@
+// CEF Browser - Renderer Crash and Hang Recovery Implementation
+#include "renderer_recovery.h"
+#include "json_writer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+const char* GetRendererExitName(RendererExit exit) {
+    switch (exit) {
+        case RendererExit::kAbnormal:
+            return "abnormal";
+        case RendererExit::kKilled:
+            return "killed";
+        case RendererExit::kCrashed:
+            return "crashed";
+        case RendererExit::kOutOfMemory:
+            return "out_of_memory";
+        case RendererExit::kHung:
+            return "hung";
+    }
+    return "unknown";
+}
+
+ProcessStatus ParseProcessStatus(const std::string& status) {
+    ProcessStatus result;
+    std::istringstream in(status);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("PPid:", 0) == 0) {
+            result.ppid = std::atoi(line.c_str() + 5);
+        } else if (line.rfind("NSpid:", 0) == 0) {
+            std::istringstream fields(line.substr(6));
+            int pid;
+            while (fields >> pid) {
+                result.namespace_pid = pid;
+            }
+        }
+    }
+    return result;
+}
+
+void RendererRecoveryStats::WriteJson(JsonWriter& writer) const {
+    writer.BeginObject();
+    writer.Key("exits").BeginObject();
+    for (size_t i = 0; i < kRendererExitCount; ++i) {
+        if (exits[i]) {
+            writer.Key(GetRendererExitName(static_cast<RendererExit>(i))).Uint(exits[i]);
+        }
+    }
+    writer.EndObject();
+    writer.Key("reloads").Uint(reloads);
+    writer.Key("quarantined").Uint(quarantined);
+    writer.Key("refused").Uint(refused);
+    writer.Key("pings").Uint(pings);
+    writer.Key("pongs").Uint(pongs);
+    writer.Key("hangs").Uint(hangs);
+    writer.Key("kills_refused").Uint(kills_refused);
+    writer.Key("hang_closes").Uint(hang_closes);
+    writer.Key("round_trip_us");
+    round_trip_us.WriteJson(writer);
+    writer.EndObject();
+}
+
+RendererRecovery::RendererRecovery(const RendererRecoveryOptions& options) : options_(options) {}
+
+RecoveryDecision RendererRecovery::OnTerminated(int browser_id, const std::string& url,
+                                                RendererExit exit, Clock::time_point now) {
+    BrowserState& browser = browsers_[browser_id];
+    if (exit == RendererExit::kKilled && browser.hung) {
+        exit = RendererExit::kHung;
+    }
+    stats_.exits[static_cast<size_t>(exit)]++;
+
+    RecoveryDecision decision;
+    decision.exit = exit;
+    decision.attempt = ++browser.attempts;
+    decision.generation = ++browser.generation;
+
+    // The next renderer starts with a clean slate
+    browser.waiting = false;
+    browser.hung = false;
+    browser.refused_kills = 0;
+
+    if (url.empty()) {
+        return decision;
+    }
+
+    UrlState& state = urls_[UrlKey(url)];
+    while (!state.exits.empty() && now - state.exits.front() >= options_.quarantine_window) {
+        state.exits.pop_front();
+    }
+    state.exits.push_back(now);
+    decision.url_exits = static_cast<int>(state.exits.size());
+
+    if (now < state.quarantined_until) {
+        decision.quarantined = true;
+        return decision;
+    }
+    if (decision.url_exits >= options_.quarantine_threshold) {
+        state.quarantined_until = now + options_.quarantine_duration;
+        state.exits.clear();
+        stats_.quarantined++;
+        decision.quarantined = true;
+        return decision;
+    }
+
+    // initial_backoff * 2^(attempt - 1), capped
+    std::chrono::milliseconds delay = options_.initial_backoff;
+    for (int i = 1; i < decision.attempt && delay < options_.max_backoff; ++i) {
+        delay *= 2;
+    }
+    decision.delay = std::min(delay, options_.max_backoff);
+    decision.reload = true;
+    stats_.reloads++;
+    return decision;
+}
+
+bool RendererRecovery::IsCurrent(int browser_id, uint64_t generation) const {
+    auto it = browsers_.find(browser_id);
+    return it != browsers_.end() && it->second.generation == generation;
+}
+
+void RendererRecovery::OnLoadStart(int browser_id) {
+    auto it = browsers_.find(browser_id);
+    if (it != browsers_.end()) {
+        it->second.generation++;
+    }
+}
+
+void RendererRecovery::OnLoadEnd(int browser_id) {
+    auto it = browsers_.find(browser_id);
+    if (it != browsers_.end()) {
+        it->second.attempts = 0;
+    }
+}
+
+void RendererRecovery::OnBrowserClosed(int browser_id) {
+    browsers_.erase(browser_id);
+}
+
+bool RendererRecovery::IsQuarantined(const std::string& url, Clock::time_point now) {
+    if (urls_.empty()) {
+        return false;
+    }
+    auto it = urls_.find(UrlKey(url));
+    if (it == urls_.end()) {
+        return false;
+    }
+    if (now < it->second.quarantined_until) {
+        stats_.refused++;
+        return true;
+    }
+
+    // Forget URLs whose quarantine and exits have all expired
+    if (it->second.exits.empty() ||
+        now - it->second.exits.back() >= options_.quarantine_window) {
+        urls_.erase(it);
+    }
+    return false;
+}
+
+uint32_t RendererRecovery::StartPing(int browser_id, Clock::time_point now) {
+    BrowserState& browser = browsers_[browser_id];
+    if (!browser.waiting) {
+        browser.waiting = true;
+        browser.waiting_since = now;
+    }
+    browser.last_ping_sent = now;
+    stats_.pings++;
+    return ++browser.last_ping;
+}
+
+bool RendererRecovery::OnPong(int browser_id, uint32_t sequence, Clock::time_point now) {
+    auto it = browsers_.find(browser_id);
+    if (it == browsers_.end() || sequence == 0 || sequence > it->second.last_ping) {
+        return false;
+    }
+    BrowserState& browser = it->second;
+    stats_.pongs++;
+
+    // An older ping answered late still shows the renderer is alive, but only
+    // the latest one has a known send time
+    if (sequence == browser.last_ping) {
+        stats_.round_trip_us.Record(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - browser.last_ping_sent)
+                .count());
+    }
+    browser.waiting = false;
+    browser.hung = false;
+    browser.refused_kills = 0;
+    return true;
+}
+
+std::vector<int> RendererRecovery::FindHung(Clock::time_point now) {
+    std::vector<int> hung;
+    if (options_.hang_timeout.count() <= 0) {
+        return hung;
+    }
+    for (auto& entry : browsers_) {
+        BrowserState& browser = entry.second;
+        if (browser.waiting && !browser.hung &&
+            now - browser.waiting_since >= options_.hang_timeout) {
+            browser.hung = true;
+            // A hang reported again after a refused kill is the same hang
+            if (browser.refused_kills == 0) {
+                stats_.hangs++;
+            }
+            hung.push_back(entry.first);
+        }
+    }
+    std::sort(hung.begin(), hung.end());
+    return hung;
+}
+
+RefusedKill RendererRecovery::OnKillRefused(int browser_id, Clock::time_point now) {
+    auto it = browsers_.find(browser_id);
+    if (it == browsers_.end() || !it->second.hung) {
+        return RefusedKill::kIgnore;
+    }
+    BrowserState& browser = it->second;
+    stats_.kills_refused++;
+    if (++browser.refused_kills >= options_.hang_kill_attempts) {
+        stats_.hang_closes++;
+        return RefusedKill::kClose;
+    }
+
+    // Wait another hang timeout before trying again
+    browser.hung = false;
+    browser.waiting_since = now;
+    return RefusedKill::kRetry;
+}
+
+std::string RendererRecovery::UrlKey(const std::string& url) {
+    return url.substr(0, url.find('#'));
+}
@@ -0,0 +1,205 @@
+// CEF Browser - Renderer Crash and Hang Recovery
+#ifndef CEF_BROWSER_RENDERER_RECOVERY_H_
+#define CEF_BROWSER_RENDERER_RECOVERY_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "histogram.h"
+
+class JsonWriter;
+
+// Why a renderer went away
+enum class RendererExit : uint8_t {
+    kAbnormal,     // Non-zero exit code
+    kKilled,       // SIGKILL or task manager kill
+    kCrashed,      // Segmentation fault
+    kOutOfMemory,  // Out of memory
+    kHung,         // Killed by us after it stopped answering pings
+};
+
+constexpr size_t kRendererExitCount = 5;
+
+// Name of |exit| as written to JSON, e.g. "out_of_memory"
+const char* GetRendererExitName(RendererExit exit);
+
+// Fields of a Linux /proc/<pid>/status file
+struct ProcessStatus {
+    int ppid = 0;
+
+    // Process id in the innermost PID namespace of the process, the last on
+    // the NSpid line; 0 if the kernel does not report it
+    int namespace_pid = 0;
+};
+
+ProcessStatus ParseProcessStatus(const std::string& status);
+
+struct RendererRecoveryOptions {
+    // Whether exits are reloaded and URLs quarantined; without, renderers
+    // are only pinged, for the watchdog
+    bool recover = true;
+
+    // Delay before reloading a browser whose renderer exited, doubled for
+    // each further exit before a load completes
+    std::chrono::milliseconds initial_backoff{1000};
+    std::chrono::milliseconds max_backoff{60000};
+
+    // A URL whose renderer exits this often within the window is no longer
+    // reloaded or navigated to until the quarantine expires
+    int quarantine_threshold = 3;
+    std::chrono::seconds quarantine_window{600};
+    std::chrono::seconds quarantine_duration{3600};
+
+    // Renderers are pinged this often and reported hung when no ping has
+    // been answered for the timeout; a zero timeout disables hang reports
+    std::chrono::milliseconds ping_interval{5000};
+    std::chrono::milliseconds hang_timeout{30000};
+
+    // Refused kills of a hung renderer, e.g. when its process cannot be told
+    // apart from others, before its browser is closed instead
+    int hang_kill_attempts = 2;
+};
+
+// What to do about a browser whose renderer exited
+struct RecoveryDecision {
+    // Reload after |delay|; otherwise the URL is quarantined, or unknown
+    bool reload = false;
+    std::chrono::milliseconds delay{0};
+    bool quarantined = false;
+
+    // Exits of the browser's renderer since its last completed load, this
+    // one included
+    int attempt = 0;
+
+    // Exits on the URL within the quarantine window, this one included
+    int url_exits = 0;
+
+    // Pass to RendererRecovery::IsCurrent() before reloading
+    uint64_t generation = 0;
+
+    RendererExit exit = RendererExit::kAbnormal;
+};
+
+// What to do about a hung renderer whose kill was refused
+enum class RefusedKill {
+    kIgnore,  // It is no longer hung
+    kRetry,   // Wait for FindHung() to report it again
+    kClose,   // Close its browser; the kills have run out
+};
+
+struct RendererRecoveryStats {
+    uint64_t exits[kRendererExitCount] = {};
+    uint64_t reloads = 0;
+
+    // URLs put into quarantine, and navigations to them refused
+    uint64_t quarantined = 0;
+    uint64_t refused = 0;
+
+    uint64_t pings = 0;
+    uint64_t pongs = 0;
+    uint64_t hangs = 0;
+
+    // Kills of hung renderers refused, and browsers closed after them
+    uint64_t kills_refused = 0;
+    uint64_t hang_closes = 0;
+
+    // Ping round trips in microseconds
+    Histogram round_trip_us;
+
+    // Write {"exits": {exit: n}, "reloads", ..., "round_trip_us": {...}}
+    void WriteJson(JsonWriter& writer) const;
+};
+
+// Recovery policy for renderer exits and hangs, fed the browser events and
+// the clock by its caller. A browser whose renderer exits is reloaded with
+// exponential backoff until one of its loads completes; a URL that keeps
+// taking its renderer down is quarantined instead. Hangs are found by pinging
+// each renderer and waiting for an answer to any ping. Not thread-safe; the
+// browser process uses it on the UI thread.
+class RendererRecovery {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RendererRecovery(const RendererRecoveryOptions& options);
+
+    const RendererRecoveryOptions& options() const { return options_; }
+
+    // Decide how to recover |browser_id|, whose renderer exited with |exit|
+    // while showing |url|. A kill of a renderer reported hung counts as a
+    // hang.
+    RecoveryDecision OnTerminated(int browser_id, const std::string& url, RendererExit exit,
+                                  Clock::time_point now);
+
+    // Whether the reload of a decision with |generation| is still wanted,
+    // i.e. |browser_id| has neither navigated nor exited again since
+    bool IsCurrent(int browser_id, uint64_t generation) const;
+
+    // Main frame loads of |browser_id|. A completed load resets its backoff.
+    void OnLoadStart(int browser_id);
+    void OnLoadEnd(int browser_id);
+    void OnBrowserClosed(int browser_id);
+
+    // Whether |url| is quarantined; counts a refused navigation if so
+    bool IsQuarantined(const std::string& url, Clock::time_point now);
+
+    // Sequence number of a new ping of |browser_id|'s renderer
+    uint32_t StartPing(int browser_id, Clock::time_point now);
+
+    // Record the answer to ping |sequence|. Returns false if no such ping
+    // was sent.
+    bool OnPong(int browser_id, uint32_t sequence, Clock::time_point now);
+
+    // Browsers whose renderer has answered no ping for the hang timeout. A
+    // hang is reported once, until the renderer answers or exits, or its kill
+    // is refused.
+    std::vector<int> FindHung(Clock::time_point now);
+
+    // The kill of |browser_id|'s hung renderer was refused. The hang is
+    // reported again after another hang timeout, until |hang_kill_attempts|
+    // kills have been refused.
+    RefusedKill OnKillRefused(int browser_id, Clock::time_point now);
+
+    const RendererRecoveryStats& stats() const { return stats_; }
+
+private:
+    struct BrowserState {
+        // Exits since the last completed load
+        int attempts = 0;
+
+        // Bumped by every navigation and exit
+        uint64_t generation = 0;
+
+        uint32_t last_ping = 0;
+        Clock::time_point last_ping_sent;
+
+        // Since the oldest unanswered ping, if any
+        bool waiting = false;
+        Clock::time_point waiting_since;
+
+        bool hung = false;
+
+        // Kills refused since the renderer last answered or exited
+        int refused_kills = 0;
+    };
+
+    struct UrlState {
+        // Exits within the quarantine window, oldest first
+        std::deque<Clock::time_point> exits;
+        Clock::time_point quarantined_until;
+    };
+
+    // |url| without its fragment
+    static std::string UrlKey(const std::string& url);
+
+    const RendererRecoveryOptions options_;
+    std::unordered_map<int, BrowserState> browsers_;
+    std::unordered_map<std::string, UrlState> urls_;
+    RendererRecoveryStats stats_;
+};
+
+#endif  // CEF_BROWSER_RENDERER_RECOVERY_H_
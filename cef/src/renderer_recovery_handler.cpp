@@ -0,0 +1,316 @@
+// CEF Browser - Renderer Recovery Handler Implementation
+#include "renderer_recovery_handler.h"
+#include "app.h"
+#include "browser_client.h"
+#include "event_pipeline.h"
+#include "watchdog_handler.h"
+
+#include <memory>
+
+#include "include/base/cef_callback.h"
+#include "include/base/cef_logging.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+#if defined(OS_WIN)
+#include <windows.h>
+#else
+#include <signal.h>
+#endif
+
+#if defined(OS_LINUX)
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace {
+
+using Clock = RendererRecovery::Clock;
+
+// UI thread state; the URL and renderer of each browser are in its
+// BrowserRecord
+std::unique_ptr<RendererRecovery> g_recovery;
+
+RendererExit GetRendererExit(cef_termination_status_t status) {
+    switch (status) {
+        case TS_PROCESS_WAS_KILLED:
+            return RendererExit::kKilled;
+        case TS_PROCESS_CRASHED:
+            return RendererExit::kCrashed;
+        case TS_PROCESS_OOM:
+            return RendererExit::kOutOfMemory;
+        default:
+            return RendererExit::kAbnormal;
+    }
+}
+
+#if defined(OS_LINUX)
+std::string ReadProcFile(int pid, const char* name) {
+    std::ifstream in("/proc/" + std::to_string(pid) + "/" + name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+bool IsOwnDescendant(int pid) {
+    const int self = getpid();
+    // Bounded, in case of a cycle from pids reused while walking
+    for (int depth = 0; depth < 32 && pid > 1; ++depth) {
+        pid = ParseProcessStatus(ReadProcFile(pid, "status")).ppid;
+        if (pid == self) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Process id, in our PID namespace, of the renderer that reported
+// |reported_pid|. Inside the sandbox a renderer sees its pid in its own PID
+// namespace, which says nothing about other namespaces, so the process must
+// be the only descendant renderer of ours with that pid innermost. 0 if there
+// is none, more than one, or the kernel has no NSpid line to tell.
+int FindRendererProcess(int reported_pid) {
+    int found = 0;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/proc", error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.find_first_not_of("0123456789") != std::string::npos) {
+            continue;
+        }
+        const int pid = std::atoi(name.c_str());
+        if (ParseProcessStatus(ReadProcFile(pid, "status")).namespace_pid != reported_pid ||
+            ReadProcFile(pid, "cmdline").find("--type=renderer") == std::string::npos ||
+            !IsOwnDescendant(pid)) {
+            continue;
+        }
+        if (found) {
+            return 0;
+        }
+        found = pid;
+    }
+    return found;
+}
+#endif
+
+// Kill the renderer that reported |pid|. Refuses when that process cannot be
+// told apart from others.
+bool KillRendererProcess(int pid) {
+#if defined(OS_WIN)
+    HANDLE process = OpenProcess(PROCESS_TERMINATE, FALSE, static_cast<DWORD>(pid));
+    if (!process) {
+        return false;
+    }
+    // Exit code 1 is reported as TS_PROCESS_WAS_KILLED
+    const bool killed = TerminateProcess(process, 1) != 0;
+    CloseHandle(process);
+    return killed;
+#else
+#if defined(OS_LINUX)
+    pid = FindRendererProcess(pid);
+    if (!pid) {
+        return false;
+    }
+#endif
+    return kill(pid, SIGKILL) == 0;
+#endif
+}
+
+void PublishRecovery(int browser_id, const std::string& url, const RecoveryDecision& decision) {
+    EventPipeline* events = GetEventPipeline();
+    if (!events || !events->has_observers()) {
+        return;
+    }
+    BrowserEvent event(BrowserEventType::kRendererRecovery, browser_id);
+    event.id = static_cast<uint32_t>(decision.attempt);
+    event.code = decision.quarantined ? 1 : 0;
+    event.value = decision.reload ? decision.delay.count() : -1;
+    event.total = decision.url_exits;
+    event.SetText(url, GetRendererExitName(decision.exit));
+    events->Publish(event);
+}
+
+void Reload(SlotHandle handle, int browser_id, uint64_t generation) {
+    // Superseded by a navigation, another exit or the browser closing
+    if (!g_recovery || !g_recovery->IsCurrent(browser_id, generation)) {
+        return;
+    }
+    const CefBrowserRegistry& registry = GetBrowserRegistry();
+    const BrowserRecord* record = registry.Find(handle);
+    if (record && !record->url.empty()) {
+        registry.GetBrowser(handle)->GetMainFrame()->LoadURL(record->url);
+    }
+}
+
+// A hung renderer of |handle| that reported |pid| could not be killed, or
+// reported none. The hang is published, retried after another timeout, and
+// left to closing the browser once the kills run out. UI thread.
+void OnKillRefused(SlotHandle handle, int browser_id, int pid) {
+    const CefBrowserRegistry& registry = GetBrowserRegistry();
+    const BrowserRecord* record = registry.Find(handle);
+    if (!g_recovery || !record) {
+        return;
+    }
+    const RefusedKill action = g_recovery->OnKillRefused(browser_id, Clock::now());
+    if (action == RefusedKill::kIgnore) {
+        return;
+    }
+    const bool close = action == RefusedKill::kClose;
+    LOG(WARNING) << "Cannot kill renderer " << pid << " of " << record->url
+                 << (close ? "; closing the browser" : "; retrying");
+
+    EventPipeline* events = GetEventPipeline();
+    if (events && events->has_observers()) {
+        BrowserEvent event(BrowserEventType::kRendererHang, browser_id);
+        event.code = close ? 1 : 0;
+        event.value = pid;
+        event.SetText(record->url);
+        events->Publish(event);
+    }
+    if (close) {
+        registry.GetBrowser(handle)->GetHost()->CloseBrowser(true);
+    }
+}
+
+// Kill the hung renderer that reported |pid|, off the UI thread since finding
+// it reads /proc. A kill is recovered as a hang through
+// OnRenderProcessTerminated; a refusal goes back to the UI thread.
+void KillHungRenderer(SlotHandle handle, int browser_id, int pid) {
+    CEF_REQUIRE_FILE_USER_BLOCKING_THREAD();
+
+    if (!KillRendererProcess(pid)) {
+        CefPostTask(TID_UI, base::BindOnce(&OnKillRefused, handle, browser_id, pid));
+    }
+}
+
+// Kill the renderers that stopped answering, then ping every renderer. The
+// pings also serve as the watchdog's renderer heartbeats.
+void PingRenderers() {
+    if (!g_recovery) {
+        return;
+    }
+    CefPostDelayedTask(TID_UI, base::BindOnce(&PingRenderers),
+                       g_recovery->options().ping_interval.count());
+    if (g_recovery->options().hang_timeout.count() <= 0 && !GetWatchdog()) {
+        return;
+    }
+
+    const CefBrowserRegistry& registry = GetBrowserRegistry();
+    const Clock::time_point now = Clock::now();
+    for (int browser_id : g_recovery->FindHung(now)) {
+        const SlotHandle handle = registry.HandleOf(browser_id);
+        const BrowserRecord* record = registry.Find(handle);
+        if (!record) {
+            continue;
+        }
+
+        // A renderer paused in the debugger is not hung
+        if (registry.GetBrowser(handle)->GetHost()->HasDevTools()) {
+            continue;
+        }
+        if (record->renderer_pid == 0) {
+            OnKillRefused(handle, browser_id, 0);
+            continue;
+        }
+        LOG(WARNING) << "Renderer " << record->renderer_pid << " of " << record->url
+                     << " stopped answering; killing it";
+        CefPostTask(TID_FILE_USER_BLOCKING,
+                    base::BindOnce(&KillHungRenderer, handle, browser_id, record->renderer_pid));
+    }
+
+    registry.ForEach([now](const BrowserRecord& record, const CefRefPtr<CefBrowser>& browser) {
+        if (record.renderer_pid == 0 || browser->GetHost()->HasDevTools()) {
+            return;
+        }
+        CefRefPtr<CefProcessMessage> ping = CefProcessMessage::Create(kRendererPingMessage);
+        ping->GetArgumentList()->SetInt(
+            0, static_cast<int>(g_recovery->StartPing(record.browser_id, now)));
+        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, ping);
+        OnWatchdogRendererPing(browser);
+    });
+}
+
+}  // namespace
+
+void InitRendererRecovery(const RendererRecoveryOptions& options) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (g_recovery) {
+        return;
+    }
+    g_recovery = std::make_unique<RendererRecovery>(options);
+    CefPostDelayedTask(TID_UI, base::BindOnce(&PingRenderers), options.ping_interval.count());
+}
+
+const RendererRecovery* GetRendererRecovery() {
+    return g_recovery && g_recovery->options().recover ? g_recovery.get() : nullptr;
+}
+
+void OnRendererRecoveryBrowserClosed(CefRefPtr<CefBrowser> browser) {
+    if (g_recovery) {
+        g_recovery->OnBrowserClosed(browser->GetIdentifier());
+    }
+}
+
+void OnRendererRecoveryLoadStart(CefRefPtr<CefBrowser> browser) {
+    if (g_recovery) {
+        g_recovery->OnLoadStart(browser->GetIdentifier());
+    }
+}
+
+void OnRendererRecoveryLoadEnd(CefRefPtr<CefBrowser> browser) {
+    if (g_recovery) {
+        g_recovery->OnLoadEnd(browser->GetIdentifier());
+    }
+}
+
+bool IsRendererRecoveryQuarantined(const std::string& url) {
+    return GetRendererRecovery() && g_recovery->IsQuarantined(url, Clock::now());
+}
+
+bool RecoverRenderer(CefRefPtr<CefBrowser> browser, cef_termination_status_t status,
+                     RecoveryDecision* decision, std::string* url) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (!GetRendererRecovery()) {
+        return false;
+    }
+
+    const int browser_id = browser->GetIdentifier();
+    const CefBrowserRegistry& registry = GetBrowserRegistry();
+    const SlotHandle handle = registry.HandleOf(browser_id);
+    const BrowserRecord* record = registry.Find(handle);
+    *url = record ? record->url : std::string();
+
+    *decision = g_recovery->OnTerminated(browser_id, *url, GetRendererExit(status), Clock::now());
+    PublishRecovery(browser_id, *url, *decision);
+
+    if (decision->reload) {
+        LOG(WARNING) << "Renderer of " << *url << " exited ("
+                     << GetRendererExitName(decision->exit) << "); reloading in "
+                     << decision->delay.count() << " ms, attempt " << decision->attempt;
+        CefPostDelayedTask(TID_UI,
+                           base::BindOnce(&Reload, handle, browser_id, decision->generation),
+                           decision->delay.count());
+    } else if (decision->quarantined) {
+        LOG(WARNING) << "Renderer of " << *url << " exited ("
+                     << GetRendererExitName(decision->exit) << ") " << decision->url_exits
+                     << " times; quarantining the URL";
+    }
+    return true;
+}
+
+bool OnRendererRecoveryMessage(CefRefPtr<CefBrowser> browser,
+                               CefRefPtr<CefProcessMessage> message) {
+    if (message->GetName() != kRendererPongMessage) {
+        return false;
+    }
+    if (g_recovery &&
+        g_recovery->OnPong(browser->GetIdentifier(),
+                           static_cast<uint32_t>(message->GetArgumentList()->GetInt(0)),
+                           Clock::now())) {
+        OnWatchdogRendererPong(browser);
+    }
+    return true;
+}
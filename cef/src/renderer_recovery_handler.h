@@ -0,0 +1,46 @@
+// CEF Browser - Renderer Recovery Handler
+#ifndef CEF_BROWSER_RENDERER_RECOVERY_HANDLER_H_
+#define CEF_BROWSER_RENDERER_RECOVERY_HANDLER_H_
+
+#include <string>
+
+#include "include/cef_browser.h"
+#include "include/cef_process_message.h"
+
+#include "renderer_recovery.h"
+
+// Recover browsers whose renderer exits unless |options| turns recovery off,
+// and ping renderers to find hung ones when |options| has a hang timeout, or
+// for the watchdog when it runs. Hung
+// renderers are killed on the TID_FILE_USER_BLOCKING thread; a browser whose
+// renderer cannot be killed is published as a renderer_hang event and closed
+// once the kills run out. Called once on the UI thread after CefInitialize().
+void InitRendererRecovery(const RendererRecoveryOptions& options);
+
+// The recovery policy, or nullptr when recovery is off, even if renderers
+// are pinged for the watchdog. UI thread.
+const RendererRecovery* GetRendererRecovery();
+
+// Browser events of BrowserClient. UI thread. The last committed URL and the
+// renderer's process id are read from the browser's BrowserRecord.
+void OnRendererRecoveryBrowserClosed(CefRefPtr<CefBrowser> browser);
+void OnRendererRecoveryLoadStart(CefRefPtr<CefBrowser> browser);
+void OnRendererRecoveryLoadEnd(CefRefPtr<CefBrowser> browser);
+
+// Whether main frame navigations to |url| are refused because it keeps
+// taking its renderer down. UI thread.
+bool IsRendererRecoveryQuarantined(const std::string& url);
+
+// Decide how to recover |browser|, whose renderer exited with |status|, and
+// schedule the reload of its last committed URL if one is due. Publishes a
+// renderer_recovery event. Sets |url| to the URL the browser showed. Returns
+// false when recovery is off. UI thread.
+bool RecoverRenderer(CefRefPtr<CefBrowser> browser, cef_termination_status_t status,
+                     RecoveryDecision* decision, std::string* url);
+
+// Handle a kRendererPongMessage of |browser|. Returns false for other
+// messages. UI thread.
+bool OnRendererRecoveryMessage(CefRefPtr<CefBrowser> browser,
+                               CefRefPtr<CefProcessMessage> message);
+
+#endif  // CEF_BROWSER_RENDERER_RECOVERY_HANDLER_H_
@@ -0,0 +1,35 @@
+// CEF Browser - Rendering Configuration Implementation
+#include "rendering_config.h"
+
+#include "include/base/cef_logging.h"
+
+namespace {
+
+RenderingConfig g_config;
+bool g_initialized = false;
+
+}  // namespace
+
+void InitRenderingConfig(const std::string& mode) {
+    std::string name = mode;
+    if (mode == "auto") {
+        GpuProbeResult probe = ProbeGpu();
+        name = probe.hardware ? "gpu" : "software";
+        LOG(INFO) << "GPU probe (" << static_cast<int>(probe.elapsed_ms)
+                  << " ms): " << probe.reason << ", using " << name << " rendering";
+    }
+
+    if (!GetRenderingConfig(name, &g_config)) {
+        LOG(WARNING) << "Unknown rendering configuration " << name << ", using gpu";
+        GetRenderingConfig("gpu", &g_config);
+    }
+    g_initialized = true;
+}
+
+const RenderingConfig& GetActiveRenderingConfig() {
+    if (!g_initialized) {
+        GetRenderingConfig("gpu", &g_config);
+        g_initialized = true;
+    }
+    return g_config;
+}
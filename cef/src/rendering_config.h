@@ -0,0 +1,19 @@
+// CEF Browser - Rendering Configuration
+#ifndef CEF_BROWSER_RENDERING_CONFIG_H_
+#define CEF_BROWSER_RENDERING_CONFIG_H_
+
+#include <string>
+
+#include "gpu_detection.h"
+
+// Select the rendering switches: |mode| "auto" probes for a GPU and picks the
+// "gpu" or "software" configuration, any other name selects that
+// configuration. Called once in the browser process after CefExecuteProcess()
+// and before CefInitialize(), while the process is still single-threaded.
+void InitRenderingConfig(const std::string& mode);
+
+// Configuration selected by InitRenderingConfig(), or "gpu" if it was not
+// called
+const RenderingConfig& GetActiveRenderingConfig();
+
+#endif  // CEF_BROWSER_RENDERING_CONFIG_H_
@@ -0,0 +1,216 @@
+// CEF Browser - Indexed Resource Pack Implementation
+#include "resource_pack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace {
+
+constexpr uint64_t kDataAlignment = 16;
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+#if defined(HAVE_ZLIB)
+bool Deflate(const std::string& input, std::string* output) {
+    uLongf bound = compressBound(static_cast<uLong>(input.size()));
+    output->resize(bound);
+    if (compress2(reinterpret_cast<Bytef*>(&(*output)[0]), &bound,
+                  reinterpret_cast<const Bytef*>(input.data()), static_cast<uLong>(input.size()),
+                  Z_BEST_COMPRESSION) != Z_OK) {
+        return false;
+    }
+    output->resize(bound);
+    return true;
+}
+
+bool Inflate(std::string_view input, size_t size, std::string* output) {
+    output->resize(size);
+    uLongf out_size = static_cast<uLongf>(size);
+    if (uncompress(reinterpret_cast<Bytef*>(&(*output)[0]), &out_size,
+                   reinterpret_cast<const Bytef*>(input.data()),
+                   static_cast<uLong>(input.size())) != Z_OK) {
+        return false;
+    }
+    return out_size == size;
+}
+#endif
+
+}  // namespace
+
+bool ResourcePack::Open(const std::string& path) {
+    index_ = nullptr;
+    entry_count_ = 0;
+    inflated_.clear();
+
+    if (!file_.Open(path)) {
+        return false;
+    }
+
+    if (file_.size() < sizeof(ResourcePackHeader)) {
+        return false;
+    }
+
+    ResourcePackHeader header;
+    memcpy(&header, file_.data(), sizeof(header));
+    if (memcmp(header.magic, kResourcePackMagic, sizeof(header.magic)) != 0 ||
+        header.version != kResourcePackVersion) {
+        return false;
+    }
+
+    uint64_t index_end =
+        sizeof(ResourcePackHeader) + uint64_t{header.entry_count} * sizeof(ResourcePackEntry);
+    if (index_end > file_.size()) {
+        return false;
+    }
+
+    // Validate every entry up front so lookups never bounds-check. The
+    // offsets are compared without adding sizes, which a crafted pack could
+    // overflow.
+    const uint64_t file_size = file_.size();
+    auto* index = reinterpret_cast<const ResourcePackEntry*>(file_.data() + sizeof(header));
+    for (uint32_t i = 0; i < header.entry_count; ++i) {
+        const ResourcePackEntry& entry = index[i];
+        if (entry.name_offset > file_size || entry.name_length > file_size - entry.name_offset ||
+            entry.data_offset > file_size || entry.stored_size > file_size - entry.data_offset) {
+            return false;
+        }
+
+        // Lookups binary-search the names
+        if (i > 0 && std::string_view(file_.data() + index[i - 1].name_offset,
+                                      index[i - 1].name_length) >=
+                         std::string_view(file_.data() + entry.name_offset, entry.name_length)) {
+            return false;
+        }
+#if !defined(HAVE_ZLIB)
+        if (entry.flags & kResourcePackEntryDeflate) {
+            return false;
+        }
+#endif
+    }
+
+    index_ = index;
+    entry_count_ = header.entry_count;
+    inflated_.resize(entry_count_);
+    return true;
+}
+
+bool ResourcePack::Lookup(std::string_view name, std::string_view* data) const {
+    if (!index_) {
+        return false;
+    }
+
+    const ResourcePackEntry* end = index_ + entry_count_;
+    const ResourcePackEntry* it =
+        std::lower_bound(index_, end, name, [this](const ResourcePackEntry& entry,
+                                                   std::string_view key) {
+            return GetName(entry) < key;
+        });
+    if (it == end || GetName(*it) != name) {
+        return false;
+    }
+
+    std::string_view stored(file_.data() + it->data_offset, it->stored_size);
+    if (!(it->flags & kResourcePackEntryDeflate)) {
+        *data = stored;
+        return true;
+    }
+
+#if defined(HAVE_ZLIB)
+    std::lock_guard<std::mutex> lock(inflate_lock_);
+    std::unique_ptr<std::string>& inflated = inflated_[it - index_];
+    if (!inflated) {
+        auto buffer = std::make_unique<std::string>();
+        if (!Inflate(stored, it->size, buffer.get())) {
+            return false;
+        }
+        inflated = std::move(buffer);
+    }
+    *data = *inflated;
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string_view ResourcePack::GetName(const ResourcePackEntry& entry) const {
+    return std::string_view(file_.data() + entry.name_offset, entry.name_length);
+}
+
+bool WriteResourcePack(const std::string& path, std::vector<ResourcePackInput> inputs,
+                       bool compress) {
+    std::sort(inputs.begin(), inputs.end(),
+              [](const ResourcePackInput& a, const ResourcePackInput& b) { return a.name < b.name; });
+
+    for (size_t i = 1; i < inputs.size(); ++i) {
+        if (inputs[i].name == inputs[i - 1].name) {
+            return false;
+        }
+    }
+
+    std::vector<std::string> stored(inputs.size());
+    std::vector<ResourcePackEntry> index(inputs.size());
+
+    uint64_t offset = sizeof(ResourcePackHeader) + inputs.size() * sizeof(ResourcePackEntry);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        index[i] = {};
+        index[i].name_offset = static_cast<uint32_t>(offset);
+        index[i].name_length = static_cast<uint32_t>(inputs[i].name.size());
+        offset += inputs[i].name.size();
+    }
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const std::string& data = inputs[i].data;
+        index[i].size = data.size();
+#if defined(HAVE_ZLIB)
+        std::string deflated;
+        if (compress && Deflate(data, &deflated) &&
+            deflated.size() <= data.size() - data.size() / 8) {
+            stored[i] = std::move(deflated);
+            index[i].flags |= kResourcePackEntryDeflate;
+        }
+#else
+        (void)compress;
+#endif
+        if (!(index[i].flags & kResourcePackEntryDeflate)) {
+            stored[i] = data;
+        }
+
+        offset = AlignUp(offset, kDataAlignment);
+        index[i].data_offset = offset;
+        index[i].stored_size = stored[i].size();
+        offset += stored[i].size();
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    ResourcePackHeader header = {};
+    memcpy(header.magic, kResourcePackMagic, sizeof(header.magic));
+    header.version = kResourcePackVersion;
+    header.entry_count = static_cast<uint32_t>(inputs.size());
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(index.data()),
+              static_cast<std::streamsize>(index.size() * sizeof(ResourcePackEntry)));
+    for (const ResourcePackInput& input : inputs) {
+        out.write(input.name.data(), static_cast<std::streamsize>(input.name.size()));
+    }
+
+    static const char kPadding[kDataAlignment] = {};
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        uint64_t position = static_cast<uint64_t>(out.tellp());
+        out.write(kPadding, static_cast<std::streamsize>(index[i].data_offset - position));
+        out.write(stored[i].data(), static_cast<std::streamsize>(stored[i].size()));
+    }
+
+    return out.good();
+}
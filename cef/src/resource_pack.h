@@ -0,0 +1,78 @@
+// CEF Browser - Indexed Resource Pack
+#ifndef CEF_BROWSER_RESOURCE_PACK_H_
+#define CEF_BROWSER_RESOURCE_PACK_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.h"
+
+// On-disk layout: header, index sorted by name, name table, then entry data.
+// All offsets are relative to the start of the file.
+struct ResourcePackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+};
+
+struct ResourcePackEntry {
+    uint32_t name_offset;
+    uint32_t name_length;
+    uint64_t data_offset;
+    uint64_t stored_size;
+    uint64_t size;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+constexpr char kResourcePackMagic[4] = {'C', 'B', 'P', 'K'};
+constexpr uint32_t kResourcePackVersion = 1;
+constexpr uint32_t kResourcePackEntryDeflate = 1 << 0;
+
+// Read-only view over a memory-mapped resource pack
+class ResourcePack {
+public:
+    ResourcePack() = default;
+
+    ResourcePack(const ResourcePack&) = delete;
+    ResourcePack& operator=(const ResourcePack&) = delete;
+
+    // Map and validate the pack at |path|
+    bool Open(const std::string& path);
+
+    bool IsValid() const { return index_ != nullptr; }
+    size_t GetEntryCount() const { return entry_count_; }
+
+    // Look up a resource by its path relative to the resources directory.
+    // Stored entries point directly into the mapping; compressed entries are
+    // inflated once on first access and cached for the lifetime of the pack.
+    bool Lookup(std::string_view name, std::string_view* data) const;
+
+private:
+    std::string_view GetName(const ResourcePackEntry& entry) const;
+
+    MappedFile file_;
+    const ResourcePackEntry* index_ = nullptr;
+    uint32_t entry_count_ = 0;
+
+    mutable std::mutex inflate_lock_;
+    mutable std::vector<std::unique_ptr<std::string>> inflated_;
+};
+
+// Input for WriteResourcePack
+struct ResourcePackInput {
+    std::string name;
+    std::string data;
+};
+
+// Write |inputs| to |path| as a resource pack. When |compress| is set and zlib
+// is available, entries that shrink by at least an eighth are deflated.
+bool WriteResourcePack(const std::string& path, std::vector<ResourcePackInput> inputs,
+                       bool compress);
+
+#endif  // CEF_BROWSER_RESOURCE_PACK_H_
@@ -0,0 +1,137 @@
+// CEF Browser - Resource Suppression Policy Implementation
+#include "resource_policy.h"
+#include "json_writer.h"
+
+#include <algorithm>
+
+namespace {
+
+// Smallest valid GIF: one transparent pixel
+constexpr char kTransparentGif[] =
+    "GIF89a\x01\x00\x01\x00\x80\x00\x00\x00\x00\x00\x00\x00\x00"
+    "!\xf9\x04\x01\x00\x00\x00\x00"
+    ",\x00\x00\x00\x00\x01\x00\x01\x00\x00\x02\x02\x44\x01\x00;";
+
+std::string_view Trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+std::string ToLower(std::string_view s) {
+    std::string out(s);
+    std::transform(out.begin(), out.end(), out.begin(),
+                   [](char c) { return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c; });
+    return out;
+}
+
+// Whether |entry| looks like "type/subtype" or "type/*"
+bool IsMimeType(std::string_view entry) {
+    const size_t slash = entry.find('/');
+    return slash != std::string_view::npos && slash > 0 && slash + 1 < entry.size() &&
+           entry.find_first_of(" =;,", 0) == std::string_view::npos;
+}
+
+}  // namespace
+
+bool ResourcePolicy::BlocksMimeType(std::string_view mime_type) const {
+    if (blocked_mime_types.empty()) {
+        return false;
+    }
+    const std::string type = ToLower(Trim(mime_type.substr(0, mime_type.find(';'))));
+    for (const std::string& blocked : blocked_mime_types) {
+        if (blocked.size() >= 2 && blocked.compare(blocked.size() - 2, 2, "/*") == 0) {
+            // "video/*" matches "video/mp4" but not "video"
+            if (type.size() > blocked.size() - 1 &&
+                type.compare(0, blocked.size() - 1, blocked, 0, blocked.size() - 1) == 0) {
+                return true;
+            }
+        } else if (type == blocked) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ParseResourcePolicy(std::string_view spec, ResourcePolicy* policy) {
+    ResourcePolicy parsed = *policy;
+    while (!spec.empty()) {
+        const size_t comma = spec.find(',');
+        std::string_view entry = Trim(spec.substr(0, comma));
+        spec.remove_prefix(comma == std::string_view::npos ? spec.size() : comma + 1);
+        if (entry.empty()) {
+            continue;
+        }
+
+        if (IsMimeType(entry)) {
+            parsed.blocked_mime_types.push_back(ToLower(entry));
+            continue;
+        }
+
+        bool placeholder = false;
+        const size_t equals = entry.find('=');
+        if (equals != std::string_view::npos) {
+            const std::string_view action = entry.substr(equals + 1);
+            if (action == "placeholder") {
+                placeholder = true;
+            } else if (action != "cancel") {
+                return false;
+            }
+            entry = entry.substr(0, equals);
+        }
+
+        const uint32_t type = GetContentTypeByName(entry == "beacon" ? "ping" : entry);
+        if (type == 0) {
+            return false;
+        }
+        // The last entry for a type wins
+        parsed.cancel_types &= ~type;
+        parsed.placeholder_types &= ~type;
+        (placeholder ? parsed.placeholder_types : parsed.cancel_types) |= type;
+    }
+    *policy = std::move(parsed);
+    return true;
+}
+
+ResourcePlaceholder GetResourcePlaceholder(uint32_t type) {
+    ResourcePlaceholder placeholder;
+    switch (type) {
+        case kContentImage:
+            placeholder.mime_type = "image/gif";
+            placeholder.body = std::string_view(kTransparentGif, sizeof(kTransparentGif) - 1);
+            break;
+        case kContentPing:
+            placeholder.status = 204;
+            placeholder.status_text = "No Content";
+            break;
+        case kContentStylesheet:
+            placeholder.mime_type = "text/css";
+            break;
+        case kContentScript:
+            placeholder.mime_type = "text/javascript";
+            break;
+        case kContentSubdocument:
+            placeholder.mime_type = "text/html";
+            break;
+        case kContentXmlHttpRequest:
+            placeholder.mime_type = "text/plain";
+            break;
+        default:
+            placeholder.mime_type = "application/octet-stream";
+            break;
+    }
+    return placeholder;
+}
+
+void ResourcePolicyCounts::WriteJson(JsonWriter& writer) const {
+    writer.BeginObject();
+    writer.Key("cancelled").Uint(cancelled);
+    writer.Key("substituted").Uint(substituted);
+    writer.Key("aborted").Uint(aborted);
+    writer.Key("bytes_avoided").Uint(bytes_avoided);
+    writer.EndObject();
+}
@@ -0,0 +1,78 @@
+// CEF Browser - Resource Suppression Policy
+#ifndef CEF_BROWSER_RESOURCE_POLICY_H_
+#define CEF_BROWSER_RESOURCE_POLICY_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "content_blocker.h"
+
+class JsonWriter;
+
+// Subresources a browser does not need, e.g. images, fonts and media for text
+// extraction. Suppressed requests are either cancelled before they are sent
+// or answered locally with a placeholder; responses of blocked MIME types are
+// aborted once their headers arrive. Main frame documents are never
+// suppressed.
+struct ResourcePolicy {
+    // ContentType bits of requests to cancel
+    uint32_t cancel_types = 0;
+
+    // ContentType bits of requests to answer with a placeholder
+    uint32_t placeholder_types = 0;
+
+    // MIME types such as "application/pdf", or prefixes such as "video/*",
+    // of responses to abort. Lower case.
+    std::vector<std::string> blocked_mime_types;
+
+    bool empty() const {
+        return cancel_types == 0 && placeholder_types == 0 && blocked_mime_types.empty();
+    }
+
+    // Whether a response of |mime_type| is aborted. Parameters such as
+    // "; charset=utf-8" and case are ignored.
+    bool BlocksMimeType(std::string_view mime_type) const;
+};
+
+// Parse comma-separated entries into |policy|. An entry is a content type as
+// in filter list options ("image", "font", "media", "ping", ...; "beacon" is
+// short for "ping"), optionally suffixed with "=cancel" (the default) or
+// "=placeholder", or a MIME type or "type/*" prefix to abort. Returns false,
+// leaving |policy| unchanged, on unknown entries.
+bool ParseResourcePolicy(std::string_view spec, ResourcePolicy* policy);
+
+// Local response standing in for a suppressed request
+struct ResourcePlaceholder {
+    int status = 200;
+    const char* status_text = "OK";
+    const char* mime_type = "";
+    std::string_view body;
+};
+
+// Placeholder for a request of ContentType |type|: a 1x1 transparent GIF for
+// images, "204 No Content" for pings and an empty body of a fitting type
+// otherwise
+ResourcePlaceholder GetResourcePlaceholder(uint32_t type);
+
+// Requests and bytes a policy avoided
+struct ResourcePolicyCounts {
+    // Requests cancelled before they were sent
+    uint64_t cancelled = 0;
+
+    // Requests answered with a placeholder without touching the network
+    uint64_t substituted = 0;
+
+    // Responses aborted by MIME type after their headers
+    uint64_t aborted = 0;
+
+    // Declared Content-Length of the aborted responses; the size of requests
+    // that were never sent is unknown
+    uint64_t bytes_avoided = 0;
+
+    // Write {"cancelled", "substituted", "aborted", "bytes_avoided"}
+    void WriteJson(JsonWriter& writer) const;
+};
+
+#endif  // CEF_BROWSER_RESOURCE_POLICY_H_
@@ -0,0 +1,231 @@
+// CEF Browser - Resource Suppression Request Handler Implementation
+#include "resource_policy_handler.h"
+#include "browser_client.h"
+#include "content_blocking_handler.h"
+#include "delegating_request_handler.h"
+#include "scheme_handler.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+
+#include "include/cef_response_filter.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace {
+
+// Counts of one policy, updated from the IO thread
+struct PolicyCounters {
+    std::atomic<uint64_t> cancelled{0};
+    std::atomic<uint64_t> substituted{0};
+    std::atomic<uint64_t> aborted{0};
+    std::atomic<uint64_t> bytes_avoided{0};
+
+    ResourcePolicyCounts Load() const {
+        ResourcePolicyCounts counts;
+        counts.cancelled = cancelled.load(std::memory_order_relaxed);
+        counts.substituted = substituted.load(std::memory_order_relaxed);
+        counts.aborted = aborted.load(std::memory_order_relaxed);
+        counts.bytes_avoided = bytes_avoided.load(std::memory_order_relaxed);
+        return counts;
+    }
+};
+
+}  // namespace
+
+// A policy and what it avoided, kept in the BrowserRecord of a browser with
+// its own policy. Handlers keep their entry alive, so a request that outlives
+// its policy still counts somewhere.
+struct ResourcePolicyEntry {
+    explicit ResourcePolicyEntry(const ResourcePolicy& policy) : policy(policy) {}
+
+    const ResourcePolicy policy;
+    PolicyCounters counters;
+};
+
+namespace {
+
+// Guards |g_default_policy|
+std::mutex g_lock;
+std::shared_ptr<ResourcePolicyEntry> g_default_policy;
+PolicyCounters g_totals;
+
+// Set once a policy exists, so requests skip the lock until then
+std::atomic<bool> g_enabled{false};
+
+void Count(std::atomic<uint64_t> PolicyCounters::*counter, ResourcePolicyEntry& entry,
+           uint64_t value) {
+    (entry.counters.*counter).fetch_add(value, std::memory_order_relaxed);
+    (g_totals.*counter).fetch_add(value, std::memory_order_relaxed);
+}
+
+std::shared_ptr<ResourcePolicyEntry> FindPolicy(int browser_id) {
+    std::shared_ptr<ResourcePolicyEntry> entry;
+    GetBrowserRegistry().Lookup(browser_id, [&entry](const BrowserRecord& record) {
+        entry = record.resource_policy;
+    });
+    if (entry) {
+        return entry;
+    }
+    std::lock_guard<std::mutex> lock(g_lock);
+    return g_default_policy;
+}
+
+// Fails the request as soon as body data arrives, so the rest is not read
+class AbortingResponseFilter : public CefResponseFilter {
+public:
+    AbortingResponseFilter() = default;
+
+    bool InitFilter() override { return true; }
+
+    FilterStatus Filter(void* data_in, size_t data_in_size, size_t& data_in_read, void* data_out,
+                        size_t data_out_size, size_t& data_out_written) override {
+        data_in_read = 0;
+        data_out_written = 0;
+        return RESPONSE_FILTER_ERROR;
+    }
+
+private:
+    IMPLEMENT_REFCOUNTING(AbortingResponseFilter);
+    DISALLOW_COPY_AND_ASSIGN(AbortingResponseFilter);
+};
+
+// Applies a policy to one request; a new handler is created per request
+class SuppressingRequestHandler : public DelegatingRequestHandler {
+public:
+    enum class Action {
+        kCancel,       // Never sent
+        kPlaceholder,  // Answered locally
+        kCheckMime,    // Sent; aborted if the response type is blocked
+    };
+
+    SuppressingRequestHandler(CefRefPtr<CefResourceRequestHandler> handler,
+                              std::shared_ptr<ResourcePolicyEntry> entry, uint32_t type,
+                              Action action)
+        : DelegatingRequestHandler(handler), entry_(std::move(entry)), type_(type),
+          action_(action) {}
+
+    ReturnValue OnBeforeResourceLoad(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                     CefRefPtr<CefRequest> request,
+                                     CefRefPtr<CefCallback> callback) override {
+        if (action_ == Action::kCancel) {
+            Count(&PolicyCounters::cancelled, *entry_, 1);
+            return RV_CANCEL;
+        }
+        return DelegatingRequestHandler::OnBeforeResourceLoad(browser, frame, request, callback);
+    }
+
+    CefRefPtr<CefResourceHandler> GetResourceHandler(CefRefPtr<CefBrowser> browser,
+                                                     CefRefPtr<CefFrame> frame,
+                                                     CefRefPtr<CefRequest> request) override {
+        if (action_ != Action::kPlaceholder) {
+            return DelegatingRequestHandler::GetResourceHandler(browser, frame, request);
+        }
+        Count(&PolicyCounters::substituted, *entry_, 1);
+        const ResourcePlaceholder placeholder = GetResourcePlaceholder(type_);
+        CefRefPtr<BufferResourceHandler> handler =
+            new BufferResourceHandler(placeholder.body, placeholder.mime_type);
+        handler->SetStatus(placeholder.status, placeholder.status_text);
+        return handler;
+    }
+
+    CefRefPtr<CefResponseFilter> GetResourceResponseFilter(
+        CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request,
+        CefRefPtr<CefResponse> response) override {
+        if (action_ != Action::kCheckMime ||
+            !entry_->policy.BlocksMimeType(response->GetMimeType().ToString())) {
+            return DelegatingRequestHandler::GetResourceResponseFilter(browser, frame, request,
+                                                                       response);
+        }
+        Count(&PolicyCounters::aborted, *entry_, 1);
+        const std::string length = response->GetHeaderByName("Content-Length").ToString();
+        Count(&PolicyCounters::bytes_avoided, *entry_, std::strtoull(length.c_str(), nullptr, 10));
+        return new AbortingResponseFilter();
+    }
+
+private:
+    const std::shared_ptr<ResourcePolicyEntry> entry_;
+    const uint32_t type_;
+    const Action action_;
+
+    IMPLEMENT_REFCOUNTING(SuppressingRequestHandler);
+    DISALLOW_COPY_AND_ASSIGN(SuppressingRequestHandler);
+};
+
+}  // namespace
+
+void SetDefaultResourcePolicy(const ResourcePolicy& policy) {
+    std::lock_guard<std::mutex> lock(g_lock);
+    g_default_policy = policy.empty() ? nullptr : std::make_shared<ResourcePolicyEntry>(policy);
+    if (g_default_policy) {
+        g_enabled.store(true, std::memory_order_relaxed);
+    }
+}
+
+void SetResourcePolicy(int browser_id, const ResourcePolicy& policy) {
+    CEF_REQUIRE_UI_THREAD();
+
+    std::shared_ptr<ResourcePolicyEntry> entry = std::make_shared<ResourcePolicyEntry>(policy);
+    if (GetBrowserRegistry().Update(browser_id, [&entry](BrowserRecord& record) {
+            record.resource_policy = std::move(entry);
+        })) {
+        g_enabled.store(true, std::memory_order_relaxed);
+    }
+}
+
+void ClearResourcePolicy(int browser_id) {
+    CEF_REQUIRE_UI_THREAD();
+
+    GetBrowserRegistry().Update(browser_id,
+                                [](BrowserRecord& record) { record.resource_policy.reset(); });
+}
+
+ResourcePolicyCounts GetResourcePolicyCounts(int browser_id) {
+    CEF_REQUIRE_UI_THREAD();
+
+    const BrowserRecord* record = GetBrowserRegistry().Find(browser_id);
+    return record && record->resource_policy ? record->resource_policy->counters.Load()
+                                             : ResourcePolicyCounts();
+}
+
+ResourcePolicyCounts GetTotalResourcePolicyCounts() {
+    return g_totals.Load();
+}
+
+bool IsResourcePolicyEnabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+CefRefPtr<CefResourceRequestHandler> ApplyResourcePolicy(
+    CefRefPtr<CefBrowser> browser, CefRefPtr<CefRequest> request,
+    CefRefPtr<CefResourceRequestHandler> handler) {
+    if (!g_enabled.load(std::memory_order_relaxed) || !browser) {
+        return handler;
+    }
+
+    // Documents are never suppressed, only what they load
+    const cef_resource_type_t resource_type = request->GetResourceType();
+    if (resource_type == RT_MAIN_FRAME) {
+        return handler;
+    }
+
+    std::shared_ptr<ResourcePolicyEntry> entry = FindPolicy(browser->GetIdentifier());
+    if (!entry || entry->policy.empty()) {
+        return handler;
+    }
+
+    using Action = SuppressingRequestHandler::Action;
+    const uint32_t type =
+        ContentBlockingHandler::GetContentType(resource_type, request->GetURL().ToString());
+    if (entry->policy.cancel_types & type) {
+        return new SuppressingRequestHandler(nullptr, entry, type, Action::kCancel);
+    }
+    if (entry->policy.placeholder_types & type) {
+        return new SuppressingRequestHandler(nullptr, entry, type, Action::kPlaceholder);
+    }
+    if (!entry->policy.blocked_mime_types.empty()) {
+        return new SuppressingRequestHandler(handler, entry, type, Action::kCheckMime);
+    }
+    return handler;
+}
@@ -0,0 +1,41 @@
+// CEF Browser - Resource Suppression Request Handler
+#ifndef CEF_BROWSER_RESOURCE_POLICY_HANDLER_H_
+#define CEF_BROWSER_RESOURCE_POLICY_HANDLER_H_
+
+#include "include/cef_browser.h"
+#include "include/cef_request.h"
+#include "include/cef_resource_request_handler.h"
+
+#include "resource_policy.h"
+
+// Policy of browsers without their own (--suppress-resources). Called once in
+// the browser process before any browser is created.
+void SetDefaultResourcePolicy(const ResourcePolicy& policy);
+
+// Apply |policy| to the requests |browser_id| makes from now on, instead of
+// the default policy, e.g. for the duration of one job. Its counts start
+// from zero. The policy is kept in the browser's BrowserRecord and dropped
+// when the browser closes. UI thread.
+void SetResourcePolicy(int browser_id, const ResourcePolicy& policy);
+
+// Return |browser_id| to the default policy and drop its counts. UI thread.
+void ClearResourcePolicy(int browser_id);
+
+// What |browser_id|'s own policy avoided since it was set; zero without one.
+// UI thread.
+ResourcePolicyCounts GetResourcePolicyCounts(int browser_id);
+
+// What every policy avoided since startup. Any thread.
+ResourcePolicyCounts GetTotalResourcePolicyCounts();
+
+// Whether any policy has been set
+bool IsResourcePolicyEnabled();
+
+// |handler|, which may be null, wrapped to apply |browser|'s policy to
+// |request|; |handler| itself if the policy leaves the request alone.
+// Suppressed requests bypass |handler|. Called on the IO thread.
+CefRefPtr<CefResourceRequestHandler> ApplyResourcePolicy(
+    CefRefPtr<CefBrowser> browser, CefRefPtr<CefRequest> request,
+    CefRefPtr<CefResourceRequestHandler> handler);
+
+#endif  // CEF_BROWSER_RESOURCE_POLICY_HANDLER_H_
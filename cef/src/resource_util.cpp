@@ -1,10 +1,9 @@
 // CEF Browser - Resource Utilities Implementation
 #include "resource_util.h"
+#include "base64.h"
 
 #include <fstream>
-#include <sstream>
 
-#include "include/cef_parser.h"
 #include "include/wrapper/cef_helpers.h"
 
 #if defined(OS_WIN)
@@ -22,11 +21,38 @@
 #endif
 
 std::string GetDataURI(const std::string& data, const std::string& mime_type) {
-    return "data:" + mime_type + ";base64," +
-           CefURIEncode(CefBase64Encode(data.data(), data.size()), false).ToString();
+    static const char kScheme[] = "data:";
+    static const char kEncoding[] = ";base64,";
+
+    // Encoded and URI-escaped in one pass, straight into the final string,
+    // with the same output as CefURIEncode(CefBase64Encode(data), false)
+    std::string result;
+    result.reserve(sizeof(kScheme) - 1 + mime_type.size() + sizeof(kEncoding) - 1 +
+                   Base64UriEncodedMaxLength(data.size()));
+    result.append(kScheme).append(mime_type).append(kEncoding);
+
+    size_t offset = result.size();
+    result.resize(offset + Base64UriEncodedMaxLength(data.size()));
+    result.resize(offset + Base64UriEncode(data.data(), data.size(), &result[offset]));
+    return result;
+}
+
+bool LoadResource(const char* resource_name, std::string_view* resource_data) {
+    return GetResourcePack().Lookup(resource_name, resource_data);
 }
 
 bool LoadBinaryResource(const char* resource_name, std::string& resource_data) {
+    const ResourcePack& pack = GetResourcePack();
+    if (pack.IsValid()) {
+        std::string_view data;
+        if (!pack.Lookup(resource_name, &data)) {
+            return false;
+        }
+        resource_data.assign(data.data(), data.size());
+        return true;
+    }
+
+    // No pack installed (e.g. running from a source tree); read the file directly
     std::string path = GetResourcesDir() + "/" + resource_name;
 
     std::ifstream file(path, std::ios::binary | std::ios::ate);
@@ -45,42 +71,64 @@ bool LoadBinaryResource(const char* resource_name, std::string& resource_data) {
     return true;
 }
 
+const ResourcePack& GetResourcePack() {
+    static const ResourcePack* pack = [] {
+        auto* result = new ResourcePack();
+        result->Open(GetResourcePackPath());
+        return result;
+    }();
+    return *pack;
+}
+
+std::string GetResourcePackPath() {
+#if defined(OS_MAC)
+    return GetResourcesDir() + "/resources.pak";
+#else
+    return GetApplicationDir() + "/resources.pak";
+#endif
+}
+
 std::string GetApplicationDir() {
-    std::string result;
+    // The executable location never changes, so resolve it only once
+    static const std::string app_dir = [] {
+        std::string result;
 
 #if defined(OS_WIN)
-    char path[MAX_PATH];
-    if (GetModuleFileNameA(nullptr, path, MAX_PATH) > 0) {
-        result = path;
-        size_t pos = result.find_last_of("\\/");
-        if (pos != std::string::npos) {
-            result = result.substr(0, pos);
+        char path[MAX_PATH];
+        if (GetModuleFileNameA(nullptr, path, MAX_PATH) > 0) {
+            result = path;
+            size_t pos = result.find_last_of("\\/");
+            if (pos != std::string::npos) {
+                result = result.substr(0, pos);
+            }
         }
-    }
 #elif defined(OS_LINUX)
-    char path[4096];
-    ssize_t count = readlink("/proc/self/exe", path, sizeof(path) - 1);
-    if (count != -1) {
-        path[count] = '\0';
-        result = path;
-        size_t pos = result.find_last_of('/');
-        if (pos != std::string::npos) {
-            result = result.substr(0, pos);
+        char path[4096];
+        ssize_t count = readlink("/proc/self/exe", path, sizeof(path) - 1);
+        if (count != -1) {
+            path[count] = '\0';
+            result = path;
+            size_t pos = result.find_last_of('/');
+            if (pos != std::string::npos) {
+                result = result.substr(0, pos);
+            }
         }
-    }
 #elif defined(OS_MAC)
-    char path[4096];
-    uint32_t size = sizeof(path);
-    if (_NSGetExecutablePath(path, &size) == 0) {
-        result = path;
-        size_t pos = result.find_last_of('/');
-        if (pos != std::string::npos) {
-            result = result.substr(0, pos);
+        char path[4096];
+        uint32_t size = sizeof(path);
+        if (_NSGetExecutablePath(path, &size) == 0) {
+            result = path;
+            size_t pos = result.find_last_of('/');
+            if (pos != std::string::npos) {
+                result = result.substr(0, pos);
+            }
         }
-    }
 #endif
 
-    return result;
+        return result;
+    }();
+
+    return app_dir;
 }
 
 std::string GetResourcesDir() {
@@ -3,14 +3,27 @@
 #define CEF_BROWSER_RESOURCE_UTIL_H_
 
 #include <string>
+#include <string_view>
 #include "include/cef_base.h"
 
+#include "resource_pack.h"
+
 // Get the data URI for HTML content
 std::string GetDataURI(const std::string& data, const std::string& mime_type);
 
-// Load a resource from the filesystem
+// Load a resource from the resource pack without copying it
+bool LoadResource(const char* resource_name, std::string_view* resource_data);
+
+// Load a resource into |resource_data|. Compatibility shim over LoadResource()
+// that falls back to the filesystem when no resource pack is installed.
 bool LoadBinaryResource(const char* resource_name, std::string& resource_data);
 
+// Get the resource pack, mapping it on first use
+const ResourcePack& GetResourcePack();
+
+// Get the resource pack file path
+std::string GetResourcePackPath();
+
 // Get the application directory path
 std::string GetApplicationDir();
 
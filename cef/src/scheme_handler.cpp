@@ -0,0 +1,240 @@
+// CEF Browser - Internal Scheme Handler Implementation
+#include "scheme_handler.h"
+#include "internal_pages.h"
+#include "resource_util.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "include/cef_parser.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace {
+
+enum class RangeResult {
+    kNone,
+    kSatisfiable,
+    kNotSatisfiable,
+};
+
+bool ParseOffset(const std::string& text, size_t* value) {
+    if (text.empty() || text.size() > 19 ||
+        text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    *value = static_cast<size_t>(std::stoull(text));
+    return true;
+}
+
+// Parse a single "bytes=first-last" range. Multi-range and malformed headers
+// are ignored and the full body is served instead.
+RangeResult ParseRange(const std::string& header, size_t size, size_t* begin, size_t* end) {
+    static const char kPrefix[] = "bytes=";
+    if (header.compare(0, sizeof(kPrefix) - 1, kPrefix) != 0) {
+        return RangeResult::kNone;
+    }
+
+    std::string spec = header.substr(sizeof(kPrefix) - 1);
+    size_t dash = spec.find('-');
+    if (dash == std::string::npos || spec.find(',') != std::string::npos) {
+        return RangeResult::kNone;
+    }
+
+    std::string first = spec.substr(0, dash);
+    std::string last = spec.substr(dash + 1);
+    size_t first_value = 0;
+    size_t last_value = 0;
+
+    if (first.empty()) {
+        // Suffix range: the final |last| bytes
+        if (!ParseOffset(last, &last_value)) {
+            return RangeResult::kNone;
+        }
+        if (last_value == 0 || size == 0) {
+            return RangeResult::kNotSatisfiable;
+        }
+        *begin = size - std::min(last_value, size);
+        *end = size;
+        return RangeResult::kSatisfiable;
+    }
+
+    if (!ParseOffset(first, &first_value)) {
+        return RangeResult::kNone;
+    }
+    if (!last.empty() && (!ParseOffset(last, &last_value) || last_value < first_value)) {
+        return RangeResult::kNone;
+    }
+    if (first_value >= size) {
+        return RangeResult::kNotSatisfiable;
+    }
+
+    *begin = first_value;
+    *end = last.empty() ? size : std::min(last_value + 1, size);
+    return RangeResult::kSatisfiable;
+}
+
+std::string GetMimeTypeForPath(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    if (dot != std::string::npos) {
+        std::string mime_type = CefGetMimeType(path.substr(dot + 1)).ToString();
+        if (!mime_type.empty()) {
+            return mime_type;
+        }
+    }
+    return "application/octet-stream";
+}
+
+}  // namespace
+
+// ============================================================================
+// BufferResourceHandler
+// ============================================================================
+
+BufferResourceHandler::BufferResourceHandler(std::string_view data, const std::string& mime_type)
+    : data_(data), mime_type_(mime_type), end_(data.size()) {}
+
+BufferResourceHandler::BufferResourceHandler(std::shared_ptr<const std::string> data,
+                                             const std::string& mime_type)
+    : storage_(std::move(data)), data_(*storage_), mime_type_(mime_type), end_(data_.size()) {}
+
+void BufferResourceHandler::SetStatus(int status, const std::string& status_text) {
+    status_ = status;
+    status_text_ = status_text;
+}
+
+void BufferResourceHandler::AddHeader(const std::string& name, const std::string& value) {
+    headers_.insert(std::make_pair(name, value));
+}
+
+void BufferResourceHandler::SetRedirect(const std::string& url) {
+    redirect_url_ = url;
+}
+
+bool BufferResourceHandler::Open(CefRefPtr<CefRequest> request, bool& handle_request,
+                                 CefRefPtr<CefCallback> callback) {
+    // All data is in memory, so the request is always handled immediately
+    handle_request = true;
+
+    std::string range = request->GetHeaderByName("Range").ToString();
+    if (!range.empty() && status_ == 200) {
+        size_t begin = 0;
+        size_t end = 0;
+        switch (ParseRange(range, data_.size(), &begin, &end)) {
+            case RangeResult::kSatisfiable:
+                offset_ = begin;
+                end_ = end;
+                partial_ = true;
+                break;
+            case RangeResult::kNotSatisfiable:
+                offset_ = end_ = 0;
+                range_not_satisfiable_ = true;
+                break;
+            case RangeResult::kNone:
+                break;
+        }
+    }
+
+    return true;
+}
+
+void BufferResourceHandler::GetResponseHeaders(CefRefPtr<CefResponse> response,
+                                               int64_t& response_length, CefString& redirectUrl) {
+    response->SetMimeType(mime_type_);
+    response->SetHeaderMap(headers_);
+    if (!redirect_url_.empty()) {
+        redirectUrl = redirect_url_;
+    }
+    response->SetHeaderByName("Accept-Ranges", "bytes", true);
+
+    const std::string total = std::to_string(data_.size());
+    if (range_not_satisfiable_) {
+        response->SetStatus(416);
+        response->SetStatusText("Range Not Satisfiable");
+        response->SetHeaderByName("Content-Range", "bytes */" + total, true);
+    } else if (partial_) {
+        response->SetStatus(206);
+        response->SetStatusText("Partial Content");
+        response->SetHeaderByName(
+            "Content-Range",
+            "bytes " + std::to_string(offset_) + "-" + std::to_string(end_ - 1) + "/" + total,
+            true);
+    } else {
+        response->SetStatus(status_);
+        response->SetStatusText(status_text_);
+    }
+
+    response_length = static_cast<int64_t>(end_ - offset_);
+}
+
+bool BufferResourceHandler::Skip(int64_t bytes_to_skip, int64_t& bytes_skipped,
+                                 CefRefPtr<CefResourceSkipCallback> callback) {
+    size_t skip = std::min(static_cast<size_t>(bytes_to_skip), end_ - offset_);
+    offset_ += skip;
+    bytes_skipped = static_cast<int64_t>(skip);
+    return true;
+}
+
+bool BufferResourceHandler::Read(void* data_out, int bytes_to_read, int& bytes_read,
+                                 CefRefPtr<CefResourceReadCallback> callback) {
+    // Copy straight from the buffer in whatever chunk size CEF asks for
+    size_t count = std::min(static_cast<size_t>(bytes_to_read), end_ - offset_);
+    if (count == 0) {
+        bytes_read = 0;
+        return false;
+    }
+
+    memcpy(data_out, data_.data() + offset_, count);
+    offset_ += count;
+    bytes_read = static_cast<int>(count);
+    return true;
+}
+
+// ============================================================================
+// InternalSchemeHandlerFactory
+// ============================================================================
+
+CefRefPtr<CefResourceHandler> InternalSchemeHandlerFactory::Create(
+    CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, const CefString& scheme_name,
+    CefRefPtr<CefRequest> request) {
+    CEF_REQUIRE_IO_THREAD();
+
+    CefURLParts parts;
+    if (!CefParseURL(request->GetURL(), parts)) {
+        return nullptr;
+    }
+
+    std::string path = CefString(&parts.path).ToString();
+    if (!path.empty() && path[0] == '/') {
+        path.erase(0, 1);
+    }
+
+    std::shared_ptr<const std::string> page =
+        BuildInternalPage(path, CefString(&parts.query).ToString());
+    if (page) {
+        CefRefPtr<BufferResourceHandler> handler =
+            new BufferResourceHandler(std::move(page), "text/html");
+        handler->AddHeader("Cache-Control", "no-store");
+        return handler;
+    }
+
+    std::string_view data;
+    if (LoadResource(("internal/" + path).c_str(), &data)) {
+        return new BufferResourceHandler(data, GetMimeTypeForPath(path));
+    }
+
+    static const char kNotFound[] = "Not Found";
+    CefRefPtr<BufferResourceHandler> handler =
+        new BufferResourceHandler(std::string_view(kNotFound), "text/plain");
+    handler->SetStatus(404, "Not Found");
+    return handler;
+}
+
+void RegisterInternalSchemeHandlerFactory(CefRefPtr<CefRequestContext> request_context) {
+    if (request_context) {
+        request_context->RegisterSchemeHandlerFactory(kInternalScheme, kInternalHost,
+                                                      new InternalSchemeHandlerFactory());
+        return;
+    }
+    CefRegisterSchemeHandlerFactory(kInternalScheme, kInternalHost,
+                                    new InternalSchemeHandlerFactory());
+}
@@ -0,0 +1,83 @@
+// CEF Browser - Internal Scheme Handler
+#ifndef CEF_BROWSER_SCHEME_HANDLER_H_
+#define CEF_BROWSER_SCHEME_HANDLER_H_
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "include/cef_request_context.h"
+#include "include/cef_resource_handler.h"
+#include "include/cef_scheme.h"
+
+// Resource handler that serves an in-memory buffer with byte-range support.
+// The buffer is either shared with the handler or a view into memory that
+// outlives it, such as the resource pack mapping.
+class BufferResourceHandler : public CefResourceHandler {
+public:
+    // Serve |data| without copying it
+    BufferResourceHandler(std::string_view data, const std::string& mime_type);
+
+    // Serve |data|, keeping it alive for the lifetime of the handler
+    BufferResourceHandler(std::shared_ptr<const std::string> data, const std::string& mime_type);
+
+    // Set the response status for a full (non-range) response
+    void SetStatus(int status, const std::string& status_text);
+
+    // Add a response header
+    void AddHeader(const std::string& name, const std::string& value);
+
+    // Redirect to |url| instead of serving the buffer
+    void SetRedirect(const std::string& url);
+
+    // CefResourceHandler methods
+    bool Open(CefRefPtr<CefRequest> request, bool& handle_request,
+              CefRefPtr<CefCallback> callback) override;
+    void GetResponseHeaders(CefRefPtr<CefResponse> response, int64_t& response_length,
+                            CefString& redirectUrl) override;
+    bool Skip(int64_t bytes_to_skip, int64_t& bytes_skipped,
+              CefRefPtr<CefResourceSkipCallback> callback) override;
+    bool Read(void* data_out, int bytes_to_read, int& bytes_read,
+              CefRefPtr<CefResourceReadCallback> callback) override;
+    void Cancel() override {}
+
+private:
+    std::shared_ptr<const std::string> storage_;
+    std::string_view data_;
+    std::string mime_type_;
+    int status_ = 200;
+    std::string status_text_ = "OK";
+    CefResponse::HeaderMap headers_;
+    std::string redirect_url_;
+
+    // Byte range being served, as [offset_, end_)
+    size_t offset_ = 0;
+    size_t end_ = 0;
+    bool partial_ = false;
+    bool range_not_satisfiable_ = false;
+
+    IMPLEMENT_REFCOUNTING(BufferResourceHandler);
+    DISALLOW_COPY_AND_ASSIGN(BufferResourceHandler);
+};
+
+// Scheme handler factory for app://internal/ pages and packed resources
+class InternalSchemeHandlerFactory : public CefSchemeHandlerFactory {
+public:
+    InternalSchemeHandlerFactory() = default;
+
+    // CefSchemeHandlerFactory methods
+    CefRefPtr<CefResourceHandler> Create(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                         const CefString& scheme_name,
+                                         CefRefPtr<CefRequest> request) override;
+
+private:
+    IMPLEMENT_REFCOUNTING(InternalSchemeHandlerFactory);
+    DISALLOW_COPY_AND_ASSIGN(InternalSchemeHandlerFactory);
+};
+
+// Register the internal scheme handler factory with |request_context|, or with
+// the global context if it is null. Called in the browser process once the
+// context is initialized; custom request contexts need their own registration.
+void RegisterInternalSchemeHandlerFactory(CefRefPtr<CefRequestContext> request_context = nullptr);
+
+#endif  // CEF_BROWSER_SCHEME_HANDLER_H_
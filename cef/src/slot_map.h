@@ -0,0 +1,136 @@
+// CEF Browser - Generational Slot Map
+#ifndef CEF_BROWSER_SLOT_MAP_H_
+#define CEF_BROWSER_SLOT_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Stable reference to a SlotMap value. A handle to an erased value stays
+// invalid even after its slot is reused, since the slot's generation moves on.
+struct SlotHandle {
+    uint32_t index = 0;
+
+    // 0 is never a live generation, so a default handle is always invalid
+    uint32_t generation = 0;
+
+    bool operator==(const SlotHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+// Values kept in one dense array, addressed through a slot table of
+// generations. Erasing moves the last value into the gap, so iteration order
+// is not insertion order. Insert, Get and Erase are O(1). Not thread safe.
+template <typename T>
+class SlotMap {
+public:
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    SlotMap() = default;
+
+    SlotHandle Insert(T value) {
+        uint32_t index;
+        if (free_head_ != kNoSlot) {
+            index = free_head_;
+            free_head_ = slots_[index].position;
+        } else {
+            index = static_cast<uint32_t>(slots_.size());
+            slots_.push_back(Slot());
+        }
+
+        Slot& slot = slots_[index];
+        slot.position = static_cast<uint32_t>(values_.size());
+        values_.push_back(std::move(value));
+        value_slots_.push_back(index);
+        return SlotHandle{index, slot.generation};
+    }
+
+    // The value of |handle|, or nullptr once it has been erased
+    T* Get(SlotHandle handle) {
+        return Live(handle) ? &values_[slots_[handle.index].position] : nullptr;
+    }
+    const T* Get(SlotHandle handle) const {
+        return Live(handle) ? &values_[slots_[handle.index].position] : nullptr;
+    }
+
+    // Returns false if |handle| was already erased
+    bool Erase(SlotHandle handle) {
+        if (!Live(handle)) {
+            return false;
+        }
+
+        Slot& slot = slots_[handle.index];
+        const uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+        if (slot.position != last) {
+            values_[slot.position] = std::move(values_[last]);
+            value_slots_[slot.position] = value_slots_[last];
+            slots_[value_slots_[last]].position = slot.position;
+        }
+        values_.pop_back();
+        value_slots_.pop_back();
+
+        // Skip 0 when the generation wraps
+        if (++slot.generation == 0) {
+            slot.generation = 1;
+        }
+        slot.position = free_head_;
+        free_head_ = handle.index;
+        return true;
+    }
+
+    // Handle of the value at |it|
+    SlotHandle HandleOf(const_iterator it) const {
+        const uint32_t index = value_slots_[it - values_.begin()];
+        return SlotHandle{index, slots_[index].generation};
+    }
+
+    void Reserve(size_t count) {
+        slots_.reserve(count);
+        values_.reserve(count);
+        value_slots_.reserve(count);
+    }
+
+    void Clear() {
+        for (size_t i = values_.size(); i > 0; --i) {
+            const uint32_t index = value_slots_[i - 1];
+            Erase(SlotHandle{index, slots_[index].generation});
+        }
+    }
+
+    size_t size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+
+    iterator begin() { return values_.begin(); }
+    iterator end() { return values_.end(); }
+    const_iterator begin() const { return values_.begin(); }
+    const_iterator end() const { return values_.end(); }
+
+private:
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    struct Slot {
+        uint32_t generation = 1;
+
+        // Index into |values_| while live; next free slot otherwise
+        uint32_t position = 0;
+    };
+
+    bool Live(SlotHandle handle) const {
+        return handle.index < slots_.size() && handle.generation != 0 &&
+               slots_[handle.index].generation == handle.generation;
+    }
+
+    std::vector<Slot> slots_;
+    std::vector<T> values_;
+
+    // Slot of each value in |values_|
+    std::vector<uint32_t> value_slots_;
+
+    uint32_t free_head_ = kNoSlot;
+};
+
+#endif  // CEF_BROWSER_SLOT_MAP_H_
@@ -0,0 +1,130 @@
+// CEF Browser - Thread Stack Snapshots Implementation
+#include "stack_snapshot.h"
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <errno.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <stdlib.h>
+#endif
+
+#if defined(_WIN32)
+
+NativeThread GetCurrentNativeThread() {
+    return GetCurrentThreadId();
+}
+
+std::vector<std::string> CaptureThreadStack(NativeThread thread,
+                                            std::chrono::milliseconds timeout) {
+    return {};
+}
+
+#else
+
+namespace {
+
+// Rarely used, and ignored by default should it reach a thread without the
+// handler
+constexpr int kStackSignal = SIGURG;
+constexpr int kMaxFrames = 64;
+
+// Capture requests, numbered from 1. A signal can arrive after its capture
+// gave up, so the handler claims the open request by number, and only on the
+// thread it was meant for, before it writes the frames.
+std::atomic<uint64_t> g_open_request{0};
+std::atomic<NativeThread> g_target;
+std::atomic<uint64_t> g_done_request{0};
+uint64_t g_last_request = 0;
+
+// Written by the handler that claimed a request, before it sets
+// |g_done_request|
+void* g_frames[kMaxFrames];
+int g_frame_count = 0;
+
+// One capture at a time, since they share the state above
+std::mutex g_capture_lock;
+
+void OnStackSignal(int) {
+    uint64_t request = g_open_request.load(std::memory_order_acquire);
+    if (request == 0 || !pthread_equal(g_target.load(std::memory_order_relaxed), pthread_self()) ||
+        !g_open_request.compare_exchange_strong(request, 0, std::memory_order_acq_rel)) {
+        return;
+    }
+    const int saved_errno = errno;
+    g_frame_count = backtrace(g_frames, kMaxFrames);
+    g_done_request.store(request, std::memory_order_release);
+    errno = saved_errno;
+}
+
+bool InstallStackSignalHandler() {
+    static const bool installed = [] {
+        // The first backtrace() loads the unwinder, which must not happen in
+        // the signal handler
+        void* frame;
+        backtrace(&frame, 1);
+
+        struct sigaction action = {};
+        action.sa_handler = &OnStackSignal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        return sigaction(kStackSignal, &action, nullptr) == 0;
+    }();
+    return installed;
+}
+
+}  // namespace
+
+NativeThread GetCurrentNativeThread() {
+    return pthread_self();
+}
+
+std::vector<std::string> CaptureThreadStack(NativeThread thread,
+                                            std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(g_capture_lock);
+    std::vector<std::string> stack;
+    if (!InstallStackSignalHandler()) {
+        return stack;
+    }
+
+    const uint64_t request = ++g_last_request;
+    g_target.store(thread, std::memory_order_relaxed);
+    g_open_request.store(request, std::memory_order_release);
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    bool sent = pthread_kill(thread, kStackSignal) == 0;
+    while (g_done_request.load(std::memory_order_acquire) != request) {
+        if (!sent || std::chrono::steady_clock::now() >= deadline) {
+            // Withdraw the request, unless a handler has claimed it and is
+            // writing the frames
+            uint64_t open = request;
+            if (g_open_request.compare_exchange_strong(open, 0, std::memory_order_acq_rel)) {
+                return stack;
+            }
+            sent = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const int count = g_frame_count;
+    char** symbols = backtrace_symbols(g_frames, count);
+    for (int i = 0; i < count; ++i) {
+        if (symbols) {
+            stack.push_back(symbols[i]);
+        } else {
+            char address[32];
+            snprintf(address, sizeof(address), "[%p]", g_frames[i]);
+            stack.push_back(address);
+        }
+    }
+    free(symbols);
+    return stack;
+}
+
+#endif
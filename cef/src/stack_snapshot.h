@@ -0,0 +1,30 @@
+// CEF Browser - Thread Stack Snapshots
+#ifndef CEF_BROWSER_STACK_SNAPSHOT_H_
+#define CEF_BROWSER_STACK_SNAPSHOT_H_
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+// Thread whose stack CaptureThreadStack() can read
+#if defined(_WIN32)
+using NativeThread = unsigned long;
+#else
+using NativeThread = pthread_t;
+#endif
+
+NativeThread GetCurrentNativeThread();
+
+// Frames of |thread|'s stack, innermost first, as "module(symbol+offset)
+// [address]" where the symbol is known. |thread| is interrupted with SIGURG
+// and unwinds itself in the signal handler, so this works while it is stuck
+// in a task or a system call. Empty if |thread| does not answer within
+// |timeout|, and on Windows. Any thread but |thread|; captures are serialized.
+std::vector<std::string> CaptureThreadStack(NativeThread thread,
+                                            std::chrono::milliseconds timeout);
+
+#endif  // CEF_BROWSER_STACK_SNAPSHOT_H_
@@ -0,0 +1,130 @@
+// CEF Browser - Per-navigation Trace Capture Implementation
+#include "trace_capture.h"
+#include "trace_files.h"
+#include "url_pattern.h"
+
+#include <ctime>
+
+#include "include/base/cef_callback.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace {
+
+CefRefPtr<TraceCapture> g_trace_capture;
+
+void RotateTraces(const std::string& dir, uint64_t max_bytes) {
+    RotateTraceFiles(dir, max_bytes);
+}
+
+}  // namespace
+
+TraceCapture::TraceCapture(const TraceCaptureOptions& options)
+    : options_(options), random_(std::random_device{}()) {}
+
+void TraceCapture::OnLoadStart(CefRefPtr<CefBrowser> browser, const std::string& url) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (state_ != State::kIdle || options_.pattern.empty() ||
+        !MatchURLPattern(url, options_.pattern)) {
+        return;
+    }
+
+    if (options_.sample_rate < 1.0 &&
+        std::uniform_real_distribution<double>(0.0, 1.0)(random_) >= options_.sample_rate) {
+        return;
+    }
+
+    if (!CefBeginTracing(options_.categories, nullptr)) {
+        return;
+    }
+
+    state_ = State::kTracing;
+    browser_id_ = browser->GetIdentifier();
+    stall_ = false;
+
+    // Bound the trace in case the load never completes
+    CefPostDelayedTask(TID_UI, base::BindOnce(&TraceCapture::EndTrace, this, ++generation_),
+                       options_.max_duration_ms);
+}
+
+void TraceCapture::OnLoadEnd(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (state_ != State::kTracing || stall_ || browser->GetIdentifier() != browser_id_) {
+        return;
+    }
+
+    state_ = State::kSettling;
+    CefPostDelayedTask(TID_UI, base::BindOnce(&TraceCapture::EndTrace, this, generation_),
+                       options_.settle_ms);
+}
+
+void TraceCapture::OnStallStart(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (state_ != State::kIdle || !CefBeginTracing(options_.categories, nullptr)) {
+        return;
+    }
+
+    state_ = State::kTracing;
+    browser_id_ = browser->GetIdentifier();
+    stall_ = true;
+
+    // Bound the trace in case the renderer never recovers
+    CefPostDelayedTask(TID_UI, base::BindOnce(&TraceCapture::EndTrace, this, ++generation_),
+                       options_.max_duration_ms);
+}
+
+void TraceCapture::OnStallEnd(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (state_ != State::kTracing || !stall_ || browser->GetIdentifier() != browser_id_) {
+        return;
+    }
+
+    state_ = State::kSettling;
+    CefPostDelayedTask(TID_UI, base::BindOnce(&TraceCapture::EndTrace, this, generation_),
+                       options_.settle_ms);
+}
+
+void TraceCapture::OnBrowserClosed(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if ((state_ == State::kTracing || state_ == State::kSettling) &&
+        browser->GetIdentifier() == browser_id_) {
+        EndTrace(generation_);
+    }
+}
+
+void TraceCapture::EndTrace(uint64_t generation) {
+    if (generation != generation_ || (state_ != State::kTracing && state_ != State::kSettling)) {
+        return;
+    }
+
+    state_ = State::kEnding;
+    const std::string path =
+        options_.dir + "/" + MakeTraceFileName(std::time(nullptr), sequence_++);
+    if (!CefEndTracing(path, this)) {
+        state_ = State::kIdle;
+    }
+}
+
+void TraceCapture::OnEndTracingComplete(const CefString& tracing_file) {
+    CEF_REQUIRE_UI_THREAD();
+
+    state_ = State::kIdle;
+    CefPostTask(TID_FILE_BACKGROUND,
+                base::BindOnce(&RotateTraces, options_.dir, options_.max_bytes));
+}
+
+void InitTraceCapture(const TraceCaptureOptions& options) {
+    CEF_REQUIRE_UI_THREAD();
+
+    g_trace_capture = new TraceCapture(options);
+}
+
+TraceCapture* GetTraceCapture() {
+    return g_trace_capture.get();
+}
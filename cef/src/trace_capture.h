@@ -0,0 +1,91 @@
+// CEF Browser - Per-navigation Trace Capture
+#ifndef CEF_BROWSER_TRACE_CAPTURE_H_
+#define CEF_BROWSER_TRACE_CAPTURE_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "include/cef_browser.h"
+#include "include/cef_trace.h"
+
+struct TraceCaptureOptions {
+    // Main frame URLs to trace, see MatchURLPattern(); empty traces only
+    // renderer stalls
+    std::string pattern;
+
+    // Comma-separated trace categories; empty uses Chromium's defaults
+    std::string categories;
+
+    // Fraction of matching navigations that are traced, 0-1
+    double sample_rate = 1.0;
+
+    // Keep tracing this long after the main frame has loaded, to include
+    // post-load work such as lazy images and analytics
+    int settle_ms = 2000;
+
+    // Stop a trace whose page never finishes loading
+    int max_duration_ms = 30000;
+
+    // Directory the traces are written to
+    std::string dir;
+
+    // Oldest traces in |dir| are deleted beyond this total size
+    uint64_t max_bytes = 256 * 1024 * 1024;
+};
+
+// Records a Chrome trace of matching page loads and of renderer stalls. Tracing is process-wide, so
+// one navigation is traced at a time and others are skipped meanwhile. A trace
+// begins in OnLoadStart, ends |settle_ms| after the main frame load ends, and
+// is written to a timestamped JSON file loadable in chrome://tracing or
+// Perfetto. All methods must be called on the UI thread.
+class TraceCapture : public CefEndTracingCallback {
+public:
+    explicit TraceCapture(const TraceCaptureOptions& options);
+
+    // Main frame load events of every browser
+    void OnLoadStart(CefRefPtr<CefBrowser> browser, const std::string& url);
+    void OnLoadEnd(CefRefPtr<CefBrowser> browser);
+    void OnBrowserClosed(CefRefPtr<CefBrowser> browser);
+
+    // The renderer of |browser| stopped answering watchdog heartbeats, and
+    // answered again. A stall is traced like a load, from its detection
+    // until |settle_ms| after its end, unless a trace is already running.
+    void OnStallStart(CefRefPtr<CefBrowser> browser);
+    void OnStallEnd(CefRefPtr<CefBrowser> browser);
+
+    // CefEndTracingCallback methods
+    void OnEndTracingComplete(const CefString& tracing_file) override;
+
+private:
+    enum class State {
+        kIdle,
+        kTracing,   // Waiting for the traced load to end
+        kSettling,  // Load ended; waiting out the settle period
+        kEnding,    // Waiting for the trace file to be written
+    };
+
+    // Finish the trace of |generation| unless a newer one has started
+    void EndTrace(uint64_t generation);
+
+    TraceCaptureOptions options_;
+    State state_ = State::kIdle;
+    int browser_id_ = 0;
+
+    // The trace is of a stall rather than a load
+    bool stall_ = false;
+    uint64_t generation_ = 0;
+    uint32_t sequence_ = 0;
+    std::mt19937 random_;
+
+    IMPLEMENT_REFCOUNTING(TraceCapture);
+    DISALLOW_COPY_AND_ASSIGN(TraceCapture);
+};
+
+// Create the process-wide trace capture. Called once on the UI thread.
+void InitTraceCapture(const TraceCaptureOptions& options);
+
+// Get the process-wide trace capture, or nullptr if tracing is disabled
+TraceCapture* GetTraceCapture();
+
+#endif  // CEF_BROWSER_TRACE_CAPTURE_H_
@@ -0,0 +1,60 @@
+// CEF Browser - Trace File Naming and Rotation Implementation
+#include "trace_files.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+std::string MakeTraceFileName(std::time_t time, uint32_t sequence) {
+    std::tm utc = {};
+#if defined(_WIN32)
+    gmtime_s(&utc, &time);
+#else
+    gmtime_r(&time, &utc);
+#endif
+
+    char name[64];
+    snprintf(name, sizeof(name), "%s%04d%02d%02d-%02d%02d%02d-%04u%s", kTraceFilePrefix,
+             utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min,
+             utc.tm_sec, sequence % 10000, kTraceFileSuffix);
+    return name;
+}
+
+size_t RotateTraceFiles(const std::string& dir, uint64_t max_bytes) {
+    const std::string prefix = kTraceFilePrefix;
+    const std::string suffix = kTraceFileSuffix;
+
+    std::error_code error;
+    std::vector<std::pair<std::string, uint64_t>> traces;
+    uint64_t total = 0;
+    for (const auto& entry : fs::directory_iterator(dir, error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() <= prefix.size() + suffix.size() || name.rfind(prefix, 0) != 0 ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+
+        uint64_t size = entry.file_size(error);
+        if (error) {
+            continue;
+        }
+        traces.emplace_back(name, size);
+        total += size;
+    }
+
+    std::sort(traces.begin(), traces.end());
+
+    size_t deleted = 0;
+    for (size_t i = 0; i + 1 < traces.size() && total > max_bytes; ++i) {
+        if (fs::remove(fs::path(dir) / traces[i].first, error)) {
+            total -= traces[i].second;
+            deleted++;
+        }
+    }
+    return deleted;
+}
@@ -0,0 +1,21 @@
+// CEF Browser - Trace File Naming and Rotation
+#ifndef CEF_BROWSER_TRACE_FILES_H_
+#define CEF_BROWSER_TRACE_FILES_H_
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+// Trace files are named "trace-YYYYMMDD-HHMMSS-NNNN.json" in UTC, so sorting
+// by name sorts by capture time
+constexpr const char* kTraceFilePrefix = "trace-";
+constexpr const char* kTraceFileSuffix = ".json";
+
+// File name for the |sequence|th trace captured at |time|
+std::string MakeTraceFileName(std::time_t time, uint32_t sequence);
+
+// Delete the oldest trace files in |dir| until they total at most |max_bytes|.
+// The newest trace is always kept. Returns the number of files deleted.
+size_t RotateTraceFiles(const std::string& dir, uint64_t max_bytes);
+
+#endif  // CEF_BROWSER_TRACE_FILES_H_
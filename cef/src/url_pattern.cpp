@@ -0,0 +1,31 @@
+// CEF Browser - URL Wildcard Patterns Implementation
+#include "url_pattern.h"
+
+bool MatchURLPattern(std::string_view url, std::string_view pattern) {
+    // Greedy matching with backtracking to the most recent '*'; linear in
+    // practice and never exponential.
+    size_t u = 0;
+    size_t p = 0;
+    size_t star = std::string_view::npos;
+    size_t star_u = 0;
+
+    while (u < url.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == url[u])) {
+            ++u;
+            ++p;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            star_u = u;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            u = ++star_u;
+        } else {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
@@ -0,0 +1,12 @@
+// CEF Browser - URL Wildcard Patterns
+#ifndef CEF_BROWSER_URL_PATTERN_H_
+#define CEF_BROWSER_URL_PATTERN_H_
+
+#include <string_view>
+
+// Match |url| against a glob |pattern| where '*' matches any run of characters
+// and '?' matches exactly one. The whole URL must match, so use a leading or
+// trailing '*' for substring matches, e.g. "*://*.example.com/*".
+bool MatchURLPattern(std::string_view url, std::string_view pattern);
+
+#endif  // CEF_BROWSER_URL_PATTERN_H_
@@ -0,0 +1,68 @@
+// CEF Browser - UTF-16 Conversion Implementation
+#include "utf16.h"
+
+namespace {
+
+constexpr char32_t kReplacementCharacter = 0xFFFD;
+
+bool IsLeadSurrogate(char16_t unit) {
+    return unit >= 0xD800 && unit <= 0xDBFF;
+}
+
+bool IsTrailSurrogate(char16_t unit) {
+    return unit >= 0xDC00 && unit <= 0xDFFF;
+}
+
+void AppendCodePoint(char32_t code_point, std::string* out) {
+    if (code_point < 0x80) {
+        out->push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        out->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+}  // namespace
+
+void AppendUtf8(std::u16string_view text, std::string* out) {
+    out->reserve(out->size() + text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char16_t unit = text[i];
+        if (unit < 0x80) {
+            out->push_back(static_cast<char>(unit));
+        } else if (IsLeadSurrogate(unit) && i + 1 < text.size() &&
+                   IsTrailSurrogate(text[i + 1])) {
+            AppendCodePoint(0x10000 + ((unit - 0xD800) << 10) + (text[i + 1] - 0xDC00), out);
+            ++i;
+        } else if (IsLeadSurrogate(unit) || IsTrailSurrogate(unit)) {
+            AppendCodePoint(kReplacementCharacter, out);
+        } else {
+            AppendCodePoint(unit, out);
+        }
+    }
+}
+
+std::string Utf16ToUtf8(std::u16string_view text) {
+    std::string result;
+    AppendUtf8(text, &result);
+    return result;
+}
+
+size_t Utf16PrefixLength(std::u16string_view text, size_t max) {
+    if (text.size() <= max) {
+        return text.size();
+    }
+    if (max > 0 && IsLeadSurrogate(text[max - 1]) && IsTrailSurrogate(text[max])) {
+        return max - 1;
+    }
+    return max;
+}
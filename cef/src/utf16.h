@@ -0,0 +1,19 @@
+// CEF Browser - UTF-16 Conversion
+#ifndef CEF_BROWSER_UTF16_H_
+#define CEF_BROWSER_UTF16_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Append |text| to |out| as UTF-8. Unpaired surrogates become U+FFFD.
+void AppendUtf8(std::u16string_view text, std::string* out);
+
+// Convert |text| to UTF-8
+std::string Utf16ToUtf8(std::u16string_view text);
+
+// Get the length of the longest prefix of |text| that is at most |max| code
+// units and does not end between the halves of a surrogate pair
+size_t Utf16PrefixLength(std::u16string_view text, size_t max);
+
+#endif  // CEF_BROWSER_UTF16_H_
@@ -0,0 +1,26 @@
+// CEF Browser - Virtual Time Options Implementation
+#include "virtual_time.h"
+
+std::string FormatDeterministicScript(uint32_t seed) {
+    // Mulberry32: small, fast and identical to NextDeterministicRandom()
+    return "(() => {\n"
+           "  let state = " +
+           std::to_string(seed) +
+           " >>> 0;\n"
+           "  Math.random = function random() {\n"
+           "    state = (state + 0x6D2B79F5) >>> 0;\n"
+           "    let t = state;\n"
+           "    t = Math.imul(t ^ (t >>> 15), t | 1);\n"
+           "    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);\n"
+           "    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;\n"
+           "  };\n"
+           "})();\n";
+}
+
+double NextDeterministicRandom(uint32_t* state) {
+    *state += 0x6D2B79F5u;
+    uint32_t t = *state;
+    t = (t ^ (t >> 15)) * (t | 1u);
+    t ^= t + (t ^ (t >> 7)) * (t | 61u);
+    return (t ^ (t >> 14)) / 4294967296.0;
+}
@@ -0,0 +1,39 @@
+// CEF Browser - Virtual Time Options
+#ifndef CEF_BROWSER_VIRTUAL_TIME_H_
+#define CEF_BROWSER_VIRTUAL_TIME_H_
+
+#include <cstdint>
+#include <string>
+
+// Start of page time in deterministic captures: 2020-01-01T00:00:00Z
+constexpr double kDeterministicEpochSeconds = 1577836800;
+
+// How a page is run under virtual time before it is reported ready
+struct VirtualTimeOptions {
+    // Virtual milliseconds the page runs for. Virtual time stands still while
+    // network fetches are pending, so the budget expires only once the
+    // network is idle.
+    int budget_ms = 5000;
+
+    // Tasks run without advancing virtual time before it is forced forward,
+    // so pages that poll with zero-delay timers still make progress
+    int max_task_starvation_count = 100;
+
+    // Wall-clock limit for pages whose fetches never finish
+    int timeout_ms = 30000;
+
+    // Seed Math.random and start Date at kDeterministicEpochSeconds; Date and
+    // Math.random stay real when not set
+    bool deterministic = false;
+    uint32_t seed = 0;
+};
+
+// Script evaluated before any page script, in every frame, that replaces
+// Math.random with a generator seeded by |seed|
+std::string FormatDeterministicScript(uint32_t seed);
+
+// Reference implementation of the generator in FormatDeterministicScript():
+// the next value in [0, 1) for generator |state|
+double NextDeterministicRandom(uint32_t* state);
+
+#endif  // CEF_BROWSER_VIRTUAL_TIME_H_
@@ -0,0 +1,163 @@
+// CEF Browser - Virtual Time Capture Implementation
+#include "virtual_time_capture.h"
+#include "browser_config.h"
+
+#include <cstdio>
+#include <utility>
+
+#include "include/base/cef_callback.h"
+#include "include/base/cef_logging.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace {
+
+// Capture of the start URL, if virtual time is on
+std::unique_ptr<VirtualTimeCapture> g_start_url_capture;
+int g_start_url_browser_id = 0;
+
+}  // namespace
+
+VirtualTimeCapture::VirtualTimeCapture(CefRefPtr<CefBrowser> browser,
+                                       const VirtualTimeOptions& options)
+    : options_(options),
+      client_(browser),
+      self_(std::make_shared<VirtualTimeCapture*>(this)) {
+    client_.Emulation().OnVirtualTimeBudgetExpired([this] {
+        if (loading()) {
+            Finish(true, false, std::string());
+        }
+    });
+}
+
+VirtualTimeCapture::~VirtualTimeCapture() {
+    CEF_REQUIRE_UI_THREAD();
+}
+
+void VirtualTimeCapture::Load(const std::string& url, ReadyCallback ready) {
+    CEF_REQUIRE_UI_THREAD();
+
+    const int generation = ++generation_;
+    ready_ = std::move(ready);
+    start_ = std::chrono::steady_clock::now();
+
+    // Before the first navigation, so every document of the page gets it
+    if (options_.deterministic && !script_added_) {
+        client_.Page().AddScriptToEvaluateOnNewDocument(
+            FormatDeterministicScript(options_.seed));
+        script_added_ = true;
+    }
+
+    // Freeze page time before the new document runs any script. Methods run
+    // in order, so the navigation below starts after the policy is applied.
+    DevToolsEmulation::VirtualTimePolicy pause;
+    pause.policy = "pause";
+    if (options_.deterministic) {
+        pause.initial_virtual_time = kDeterministicEpochSeconds;
+    }
+    client_.Emulation().SetVirtualTimePolicy(pause, [this, generation](double ticks_base) {
+        if (generation == generation_ && ticks_base == 0) {
+            Finish(false, false, "Emulation.setVirtualTimePolicy failed");
+        }
+    });
+    client_.Page().Navigate(url, [this, generation](const DevToolsPage::NavigateResult& result) {
+        OnNavigated(generation, result);
+    });
+
+    CefPostDelayedTask(TID_UI,
+                       base::BindOnce(&VirtualTimeCapture::OnTimeout,
+                                      std::weak_ptr<VirtualTimeCapture*>(self_), generation),
+                       options_.timeout_ms);
+}
+
+// static
+void VirtualTimeCapture::OnTimeout(std::weak_ptr<VirtualTimeCapture*> capture, int generation) {
+    std::shared_ptr<VirtualTimeCapture*> self = capture.lock();
+    if (self && (*self)->generation_ == generation && (*self)->loading()) {
+        (*self)->Finish(false, true, "Timed out waiting for the network to become idle");
+    }
+}
+
+void VirtualTimeCapture::OnNavigated(int generation, const DevToolsPage::NavigateResult& result) {
+    if (generation != generation_ || !loading()) {
+        return;
+    }
+    if (!result.success) {
+        Finish(false, false, result.error);
+        return;
+    }
+
+    // The document has committed with its time paused; let it run
+    DevToolsEmulation::VirtualTimePolicy run;
+    run.policy = "pauseIfNetworkFetchesPending";
+    run.budget_ms = options_.budget_ms;
+    run.max_task_starvation_count = options_.max_task_starvation_count;
+    client_.Emulation().SetVirtualTimePolicy(run, [this, generation](double ticks_base) {
+        if (generation == generation_ && ticks_base == 0) {
+            Finish(false, false, "Emulation.setVirtualTimePolicy failed");
+        }
+    });
+}
+
+void VirtualTimeCapture::Finish(bool ready, bool timed_out, const std::string& error) {
+    if (!loading()) {
+        return;
+    }
+    VirtualTimeCaptureResult result;
+    result.ready = ready;
+    result.timed_out = timed_out;
+    result.error = error;
+    result.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                               start_)
+                         .count();
+
+    // The callback may start another load or destroy the capture
+    ReadyCallback ready_callback = std::move(ready_);
+    ready_ = nullptr;
+    ready_callback(result);
+}
+
+VirtualTimeOptions GetConfiguredVirtualTimeOptions() {
+    const BrowserConfig& config = GetBrowserConfig();
+    VirtualTimeOptions options;
+    options.budget_ms = config.virtual_time_budget_ms;
+    options.deterministic = config.deterministic_seed >= 0;
+    options.seed = options.deterministic ? static_cast<uint32_t>(config.deterministic_seed) : 0;
+    return options;
+}
+
+bool StartVirtualTimeStartUrl(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    const BrowserConfig& config = GetBrowserConfig();
+    if (config.virtual_time_budget_ms <= 0 || g_start_url_capture) {
+        return false;
+    }
+
+    g_start_url_browser_id = browser->GetIdentifier();
+    g_start_url_capture =
+        std::make_unique<VirtualTimeCapture>(browser, GetConfiguredVirtualTimeOptions());
+    const std::string url = config.start_url;
+    g_start_url_capture->Load(url, [url](const VirtualTimeCaptureResult& result) {
+        if (!result.ready) {
+            LOG(WARNING) << "Virtual time capture of " << url << " failed: " << result.error;
+            return;
+        }
+        LOG(INFO) << "Virtual time budget expired for " << url << " after " << result.wall_ms
+                  << " ms";
+        // Launchers wait for this line before capturing the page
+        printf("ready %s\n", url.c_str());
+        fflush(stdout);
+    });
+    return true;
+}
+
+void StopVirtualTimeStartUrl(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (g_start_url_capture && browser->GetIdentifier() == g_start_url_browser_id) {
+        g_start_url_capture.reset();
+        g_start_url_browser_id = 0;
+    }
+}
@@ -0,0 +1,89 @@
+// CEF Browser - Virtual Time Capture
+#ifndef CEF_BROWSER_VIRTUAL_TIME_CAPTURE_H_
+#define CEF_BROWSER_VIRTUAL_TIME_CAPTURE_H_
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "include/cef_browser.h"
+
+#include "devtools_client.h"
+#include "virtual_time.h"
+
+// Outcome of a virtual time load
+struct VirtualTimeCaptureResult {
+    // The budget expired with the network idle; false on errors and timeouts
+    bool ready = false;
+
+    // Not ready within VirtualTimeOptions::timeout_ms
+    bool timed_out = false;
+
+    // Why the page is not ready
+    std::string error;
+
+    // Wall-clock milliseconds from Load() to the outcome
+    double wall_ms = 0;
+};
+
+// Loads pages into a browser under DevTools virtual time, so timers,
+// animations and polling loops run as fast as the CPU allows instead of in
+// real time, and reports when the page is ready to capture.
+//
+// Page time is paused before the navigation starts, then advances by the
+// budget under the pauseIfNetworkFetchesPending policy: it stands still while
+// fetches are in flight and jumps over idle periods to the next timer. The
+// budget expiring therefore means the network is idle and the page has run
+// its timers for |budget_ms|. Page time stays paused once ready, so the
+// frame is stable while it is captured.
+//
+// UI thread only. Destroying the capture abandons a pending load without
+// running its callback.
+class VirtualTimeCapture {
+public:
+    using ReadyCallback = std::function<void(const VirtualTimeCaptureResult& result)>;
+
+    VirtualTimeCapture(CefRefPtr<CefBrowser> browser, const VirtualTimeOptions& options);
+    ~VirtualTimeCapture();
+
+    VirtualTimeCapture(const VirtualTimeCapture&) = delete;
+    VirtualTimeCapture& operator=(const VirtualTimeCapture&) = delete;
+
+    // Navigate to |url| and run |ready| once the page is ready or failed. A
+    // load still pending is abandoned without running its callback.
+    void Load(const std::string& url, ReadyCallback ready);
+
+    bool loading() const { return ready_ != nullptr; }
+
+private:
+    static void OnTimeout(std::weak_ptr<VirtualTimeCapture*> capture, int generation);
+
+    void OnNavigated(int generation, const DevToolsPage::NavigateResult& result);
+    void Finish(bool ready, bool timed_out, const std::string& error);
+
+    const VirtualTimeOptions options_;
+    DevToolsClient client_;
+    bool script_added_ = false;
+
+    // Identifies the current load; callbacks of abandoned loads are ignored
+    int generation_ = 0;
+    ReadyCallback ready_;
+    std::chrono::steady_clock::time_point start_;
+
+    // Bound weakly into delayed tasks that may outlive the capture
+    std::shared_ptr<VirtualTimeCapture*> self_;
+};
+
+// Load the start URL into the main browser under virtual time when
+// --virtual-time-budget is set, and print "ready <url>" to stdout once the
+// page is ready. Returns false when virtual time is off. UI thread.
+bool StartVirtualTimeStartUrl(CefRefPtr<CefBrowser> browser);
+
+// Drop the start URL capture of |browser|, before it closes. UI thread.
+void StopVirtualTimeStartUrl(CefRefPtr<CefBrowser> browser);
+
+// Options of --virtual-time-budget and --deterministic-seed
+VirtualTimeOptions GetConfiguredVirtualTimeOptions();
+
+#endif  // CEF_BROWSER_VIRTUAL_TIME_CAPTURE_H_
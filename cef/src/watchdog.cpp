@@ -0,0 +1,135 @@
+// CEF Browser - Responsiveness Watchdog Implementation
+#include "watchdog.h"
+#include "json_writer.h"
+
+#include <algorithm>
+#include <cstdio>
+
+void WatchdogStats::WriteJson(JsonWriter& writer) const {
+    writer.BeginObject();
+    for (const auto& entry : targets) {
+        const WatchdogTargetStats& target = entry.second;
+        writer.Key(entry.first).BeginObject();
+        writer.Key("beats").Uint(target.beats);
+        writer.Key("stalls").Uint(target.stalls);
+        writer.Key("longest_stall_ms").Uint(target.longest_stall_ms);
+        writer.Key("delay_us");
+        target.delay_us.WriteJson(writer);
+        writer.EndObject();
+    }
+    writer.EndObject();
+}
+
+std::string FormatWatchdogStall(const WatchdogStall& stall, std::time_t time,
+                                const std::vector<std::string>& stack) {
+    std::tm utc = {};
+#if defined(_WIN32)
+    gmtime_s(&utc, &time);
+#else
+    gmtime_r(&time, &utc);
+#endif
+
+    char header[80];
+    snprintf(header, sizeof(header), "%04d-%02d-%02dT%02d:%02d:%02dZ ", utc.tm_year + 1900,
+             utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec);
+    std::string text = header;
+    text.append(stall.name);
+    text.append(" stalled for ");
+    text.append(std::to_string(stall.pending.count()));
+    text.append(" ms\n");
+    for (const std::string& frame : stack) {
+        text.append("    ");
+        text.append(frame);
+        text.push_back('\n');
+    }
+    return text;
+}
+
+Watchdog::Watchdog(const WatchdogOptions& options) : options_(options) {}
+
+int Watchdog::AddTarget(const std::string& name) {
+    std::lock_guard<std::mutex> lock(lock_);
+    const int target = next_target_++;
+    targets_[target].name = name;
+    stats_.targets[name];
+    return target;
+}
+
+void Watchdog::RemoveTarget(int target) {
+    std::lock_guard<std::mutex> lock(lock_);
+    targets_.erase(target);
+}
+
+bool Watchdog::BeginBeat(int target, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = targets_.find(target);
+    if (it == targets_.end() || it->second.pending) {
+        return false;
+    }
+    it->second.pending = true;
+    it->second.stalled = false;
+    it->second.sent = now;
+    return true;
+}
+
+bool Watchdog::EndBeat(int target, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = targets_.find(target);
+    if (it == targets_.end() || !it->second.pending) {
+        return false;
+    }
+    Target& state = it->second;
+    state.pending = false;
+
+    WatchdogTargetStats& stats = stats_.targets[state.name];
+    const auto delay = now - state.sent;
+    stats.beats++;
+    stats.delay_us.Record(
+        std::chrono::duration_cast<std::chrono::microseconds>(delay).count());
+    if (state.stalled) {
+        const uint64_t delay_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(delay).count();
+        stats.longest_stall_ms = std::max(stats.longest_stall_ms, delay_ms);
+    }
+    return state.stalled;
+}
+
+void Watchdog::CancelBeat(int target) {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = targets_.find(target);
+    if (it != targets_.end()) {
+        it->second.pending = false;
+        it->second.stalled = false;
+    }
+}
+
+bool Watchdog::IsStalled(int target) const {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = targets_.find(target);
+    return it != targets_.end() && it->second.pending && it->second.stalled;
+}
+
+std::vector<WatchdogStall> Watchdog::FindStalls(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(lock_);
+    std::vector<WatchdogStall> stalls;
+    for (auto& entry : targets_) {
+        Target& state = entry.second;
+        if (!state.pending || state.stalled || now - state.sent < options_.stall_threshold) {
+            continue;
+        }
+        state.stalled = true;
+        stats_.targets[state.name].stalls++;
+
+        WatchdogStall stall;
+        stall.target = entry.first;
+        stall.name = state.name;
+        stall.pending = std::chrono::duration_cast<std::chrono::milliseconds>(now - state.sent);
+        stalls.push_back(stall);
+    }
+    return stalls;
+}
+
+WatchdogStats Watchdog::GetStats() const {
+    std::lock_guard<std::mutex> lock(lock_);
+    return stats_;
+}
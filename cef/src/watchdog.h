@@ -0,0 +1,110 @@
+// CEF Browser - Responsiveness Watchdog
+#ifndef CEF_BROWSER_WATCHDOG_H_
+#define CEF_BROWSER_WATCHDOG_H_
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "histogram.h"
+
+class JsonWriter;
+
+struct WatchdogOptions {
+    // Heartbeats are sent to each target this often
+    std::chrono::milliseconds interval{1000};
+
+    // A heartbeat pending this long is reported as a stall
+    std::chrono::milliseconds stall_threshold{2000};
+};
+
+// A heartbeat that has been pending for the stall threshold
+struct WatchdogStall {
+    int target = 0;
+    std::string name;
+    std::chrono::milliseconds pending{0};
+};
+
+struct WatchdogTargetStats {
+    uint64_t beats = 0;
+    uint64_t stalls = 0;
+
+    // Longest a heartbeat of a stalled target was pending before it arrived
+    uint64_t longest_stall_ms = 0;
+
+    // From sending each heartbeat to its arrival, in microseconds: the
+    // queueing delay of a thread, or the round trip to a renderer
+    Histogram delay_us;
+};
+
+struct WatchdogStats {
+    // By target name, e.g. "ui"
+    std::map<std::string, WatchdogTargetStats> targets;
+
+    // Write {name: {"beats", "stalls", "longest_stall_ms", "delay_us"}}
+    void WriteJson(JsonWriter& writer) const;
+};
+
+// "<UTC time> <name> stalled for <pending> ms" followed by |stack|, one
+// indented frame per line, as appended to the stall log
+std::string FormatWatchdogStall(const WatchdogStall& stall, std::time_t time,
+                                const std::vector<std::string>& stack);
+
+// Heartbeat bookkeeping for threads and processes that must stay responsive.
+// Its caller sends each target a heartbeat through the target's own queue,
+// e.g. a task posted to a thread or a message to a renderer, and reports its
+// arrival; a heartbeat that stays pending for the stall threshold is reported
+// once as a stall. At most one heartbeat per target is pending, so a stalled
+// target does not pile them up. Thread-safe.
+class Watchdog {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Watchdog(const WatchdogOptions& options);
+
+    const WatchdogOptions& options() const { return options_; }
+
+    // Watch a target, numbered from 1; targets of one |name| share their
+    // stats
+    int AddTarget(const std::string& name);
+    void RemoveTarget(int target);
+
+    // Send a heartbeat to |target| at |now|. Returns false, and the caller
+    // sends nothing, while an earlier one is pending or for unknown targets.
+    bool BeginBeat(int target, Clock::time_point now);
+
+    // The pending heartbeat of |target| arrived at |now|. Returns whether it
+    // had been reported as a stall.
+    bool EndBeat(int target, Clock::time_point now);
+
+    // Forget the pending heartbeat of |target|, e.g. when its process exits
+    void CancelBeat(int target);
+
+    // Whether |target| has a heartbeat reported as a stall still pending
+    bool IsStalled(int target) const;
+
+    // Heartbeats newly pending for the stall threshold
+    std::vector<WatchdogStall> FindStalls(Clock::time_point now);
+
+    WatchdogStats GetStats() const;
+
+private:
+    struct Target {
+        std::string name;
+        bool pending = false;
+        bool stalled = false;
+        Clock::time_point sent;
+    };
+
+    const WatchdogOptions options_;
+    mutable std::mutex lock_;
+    std::map<int, Target> targets_;
+    WatchdogStats stats_;
+    int next_target_ = 1;
+};
+
+#endif  // CEF_BROWSER_WATCHDOG_H_
@@ -0,0 +1,217 @@
+// CEF Browser - Responsiveness Watchdog Handler Implementation
+#include "watchdog_handler.h"
+#include "browser_client.h"
+#include "stack_snapshot.h"
+#include "trace_capture.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "include/base/cef_callback.h"
+#include "include/base/cef_logging.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace {
+
+using Clock = Watchdog::Clock;
+
+// How long a stalled thread gets to unwind its stack
+constexpr std::chrono::milliseconds kStackTimeout{100};
+
+struct WatchedThread {
+    const char* name;
+    cef_thread_id_t id;
+    int target = 0;
+
+    // Set by the thread's first heartbeat
+    std::atomic<bool> known{false};
+    NativeThread native{};
+};
+
+WatchedThread g_ui_thread{"ui", TID_UI};
+WatchedThread g_io_thread{"io", TID_IO};
+WatchedThread* const g_threads[] = {&g_ui_thread, &g_io_thread};
+
+// Kept until exit, since heartbeat tasks may run after the watchdog stops
+std::unique_ptr<Watchdog> g_watchdog;
+std::string g_stall_log_path;
+
+// Whether stalled renderers are traced. UI thread.
+bool g_trace_renderers = false;
+
+// Watchdog thread
+std::thread g_thread;
+std::mutex g_lock;
+std::condition_variable g_wake;
+bool g_stopping = false;
+
+void Beat(WatchedThread* thread) {
+    if (!thread->known.load(std::memory_order_acquire)) {
+        thread->native = GetCurrentNativeThread();
+        thread->known.store(true, std::memory_order_release);
+    }
+    g_watchdog->EndBeat(thread->target, Clock::now());
+}
+
+void TraceRendererStall(int target, std::chrono::milliseconds pending) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (!g_watchdog->IsStalled(target)) {
+        return;
+    }
+    GetBrowserRegistry().ForEach(
+        [target, pending](const BrowserRecord& record, const CefRefPtr<CefBrowser>& browser) {
+            if (record.watchdog_target != target) {
+                return;
+            }
+            LOG(WARNING) << "Renderer of " << record.url << " has not answered a ping for "
+                         << pending.count() << " ms";
+            TraceCapture* trace = GetTraceCapture();
+            if (g_trace_renderers && trace) {
+                trace->OnStallStart(browser);
+            }
+        });
+}
+
+// Called on the watchdog thread
+void ReportStall(const WatchdogStall& stall) {
+    WatchedThread* thread = nullptr;
+    for (WatchedThread* candidate : g_threads) {
+        if (candidate->target == stall.target) {
+            thread = candidate;
+        }
+    }
+
+    if (!thread) {
+        // Renderer answers are handled on the UI thread, so a stalled UI
+        // thread stalls every renderer's heartbeat too
+        if (!g_watchdog->IsStalled(g_ui_thread.target)) {
+            CefPostTask(TID_UI, base::BindOnce(&TraceRendererStall, stall.target, stall.pending));
+        }
+        return;
+    }
+
+    std::vector<std::string> stack;
+    if (thread->known.load(std::memory_order_acquire)) {
+        stack = CaptureThreadStack(thread->native, kStackTimeout);
+    }
+    LOG(WARNING) << "The " << stall.name << " thread has not run a heartbeat for "
+                 << stall.pending.count() << " ms";
+    if (!g_stall_log_path.empty()) {
+        std::ofstream out(g_stall_log_path, std::ios::app);
+        out << FormatWatchdogStall(stall, std::time(nullptr), stack);
+    }
+}
+
+void WatchLoop() {
+    const std::chrono::milliseconds interval = g_watchdog->options().interval;
+    std::unique_lock<std::mutex> lock(g_lock);
+    while (!g_stopping) {
+        lock.unlock();
+
+        const Clock::time_point now = Clock::now();
+        for (WatchedThread* thread : g_threads) {
+            if (g_watchdog->BeginBeat(thread->target, now)) {
+                CefPostTask(thread->id, base::BindOnce(&Beat, thread));
+            }
+        }
+        for (const WatchdogStall& stall : g_watchdog->FindStalls(now)) {
+            ReportStall(stall);
+        }
+
+        lock.lock();
+        g_wake.wait_for(lock, interval, [] { return g_stopping; });
+    }
+}
+
+// Watchdog target of |browser|'s renderer, or 0 if it is not watched
+int FindRenderer(CefRefPtr<CefBrowser> browser) {
+    const BrowserRecord* record = GetBrowserRegistry().Find(browser->GetIdentifier());
+    return record ? record->watchdog_target : 0;
+}
+
+}  // namespace
+
+void StartWatchdog(const WatchdogOptions& options, const std::string& stall_log_path,
+                   bool trace_renderers) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (g_watchdog) {
+        return;
+    }
+    g_watchdog = std::make_unique<Watchdog>(options);
+    g_stall_log_path = stall_log_path;
+    g_trace_renderers = trace_renderers;
+    for (WatchedThread* thread : g_threads) {
+        thread->target = g_watchdog->AddTarget(thread->name);
+    }
+    g_thread = std::thread(&WatchLoop);
+}
+
+void StopWatchdog() {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (!g_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_lock);
+        g_stopping = true;
+    }
+    g_wake.notify_one();
+    g_thread.join();
+}
+
+const Watchdog* GetWatchdog() {
+    return g_watchdog.get();
+}
+
+void OnWatchdogBrowserCreated(CefRefPtr<CefBrowser> browser) {
+    if (g_watchdog) {
+        const int target = g_watchdog->AddTarget("renderer");
+        GetBrowserRegistry().Update(browser->GetIdentifier(), [target](BrowserRecord& record) {
+            record.watchdog_target = target;
+        });
+    }
+}
+
+void OnWatchdogBrowserClosed(CefRefPtr<CefBrowser> browser) {
+    if (const int target = FindRenderer(browser)) {
+        g_watchdog->RemoveTarget(target);
+    }
+}
+
+void OnWatchdogRendererReady(CefRefPtr<CefBrowser> browser) {
+    if (const int target = FindRenderer(browser)) {
+        g_watchdog->CancelBeat(target);
+    }
+}
+
+void OnWatchdogRendererTerminated(CefRefPtr<CefBrowser> browser) {
+    if (const int target = FindRenderer(browser)) {
+        g_watchdog->CancelBeat(target);
+    }
+}
+
+void OnWatchdogRendererPing(CefRefPtr<CefBrowser> browser) {
+    if (const int target = FindRenderer(browser)) {
+        g_watchdog->BeginBeat(target, Clock::now());
+    }
+}
+
+void OnWatchdogRendererPong(CefRefPtr<CefBrowser> browser) {
+    const int target = FindRenderer(browser);
+    if (target && g_watchdog->EndBeat(target, Clock::now())) {
+        TraceCapture* trace = GetTraceCapture();
+        if (g_trace_renderers && trace) {
+            trace->OnStallEnd(browser);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+// CEF Browser - Responsiveness Watchdog Handler
+#ifndef CEF_BROWSER_WATCHDOG_HANDLER_H_
+#define CEF_BROWSER_WATCHDOG_HANDLER_H_
+
+#include <string>
+
+#include "include/cef_browser.h"
+
+#include "watchdog.h"
+
+// Start a thread that sends heartbeats to the browser UI and IO threads, and
+// watch every browser's renderer through the pings of renderer recovery,
+// which must be initialized too. A stalled thread's stack is appended to
+// |stall_log_path|; a stalled renderer is traced if |trace_renderers| and
+// trace capture exists. Called once on the UI thread after CefInitialize().
+void StartWatchdog(const WatchdogOptions& options, const std::string& stall_log_path,
+                   bool trace_renderers);
+
+// Stop the watchdog thread. Called on the UI thread before CefShutdown().
+void StopWatchdog();
+
+// The watchdog, or nullptr when it is off. Any thread.
+const Watchdog* GetWatchdog();
+
+// Browser events of BrowserClient. UI thread.
+void OnWatchdogBrowserCreated(CefRefPtr<CefBrowser> browser);
+void OnWatchdogBrowserClosed(CefRefPtr<CefBrowser> browser);
+
+// The renderer of |browser|'s main frame reported in, or exited; a ping to
+// the renderer before is no longer awaited
+void OnWatchdogRendererReady(CefRefPtr<CefBrowser> browser);
+void OnWatchdogRendererTerminated(CefRefPtr<CefBrowser> browser);
+
+// Renderer recovery sent |browser|'s renderer a kRendererPingMessage, or had
+// it answered. The first ping unanswered is the renderer's heartbeat. UI
+// thread.
+void OnWatchdogRendererPing(CefRefPtr<CefBrowser> browser);
+void OnWatchdogRendererPong(CefRefPtr<CefBrowser> browser);
+
+#endif  // CEF_BROWSER_WATCHDOG_HANDLER_H_
@@ -0,0 +1,295 @@
+// CEF Browser - WebSocket and HTTP Framing Implementation
+#include "websocket.h"
+#include "base64.h"
+
+#include <cctype>
+#include <cstring>
+
+namespace {
+
+// RFC 6455 1.3
+constexpr char kWebSocketGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+std::string ToLower(std::string_view text) {
+    std::string result(text);
+    for (char& c : result) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return result;
+}
+
+std::string_view Trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Whether comma-separated |list| contains |token|, ignoring case
+bool HasToken(std::string_view list, std::string_view token) {
+    const std::string lower_token = ToLower(token);
+    while (!list.empty()) {
+        size_t comma = list.find(',');
+        std::string_view item = Trim(list.substr(0, comma));
+        if (ToLower(item) == lower_token) {
+            return true;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        list.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+uint32_t RotateLeft(uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+void Sha1Block(const uint8_t* block, uint32_t state[5]) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (uint32_t{block[i * 4]} << 24) | (uint32_t{block[i * 4 + 1]} << 16) |
+               (uint32_t{block[i * 4 + 2]} << 8) | uint32_t{block[i * 4 + 3]};
+    }
+    for (int i = 16; i < 80; ++i) {
+        w[i] = RotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (int i = 0; i < 80; ++i) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t temp = RotateLeft(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = RotateLeft(b, 30);
+        b = a;
+        a = temp;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+}  // namespace
+
+std::string HttpRequestHead::Header(const std::string& name) const {
+    auto it = headers.find(name);
+    return it == headers.end() ? std::string() : it->second;
+}
+
+ParseStatus ParseHttpRequestHead(std::string_view data, HttpRequestHead* head, size_t* consumed,
+                                 size_t max_size) {
+    size_t end = data.find("\r\n\r\n");
+    if (end == std::string_view::npos) {
+        return data.size() > max_size ? ParseStatus::kError : ParseStatus::kIncomplete;
+    }
+    if (end + 4 > max_size) {
+        return ParseStatus::kError;
+    }
+
+    HttpRequestHead result;
+    std::string_view lines = data.substr(0, end + 2);
+    size_t line_end = lines.find("\r\n");
+    std::string_view request_line = lines.substr(0, line_end);
+    lines.remove_prefix(line_end + 2);
+
+    // METHOD SP PATH SP VERSION
+    size_t first_space = request_line.find(' ');
+    size_t second_space = request_line.find(' ', first_space + 1);
+    if (first_space == std::string_view::npos || second_space == std::string_view::npos ||
+        request_line.substr(second_space + 1).rfind("HTTP/", 0) != 0) {
+        return ParseStatus::kError;
+    }
+    result.method = std::string(request_line.substr(0, first_space));
+    result.path = std::string(request_line.substr(first_space + 1, second_space - first_space - 1));
+    if (result.method.empty() || result.path.empty()) {
+        return ParseStatus::kError;
+    }
+
+    while (!lines.empty()) {
+        line_end = lines.find("\r\n");
+        std::string_view line = lines.substr(0, line_end);
+        lines.remove_prefix(line_end + 2);
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0) {
+            return ParseStatus::kError;
+        }
+        result.headers[ToLower(line.substr(0, colon))] = std::string(Trim(line.substr(colon + 1)));
+    }
+
+    *head = std::move(result);
+    *consumed = end + 4;
+    return ParseStatus::kComplete;
+}
+
+std::string FormatHttpResponse(int status, std::string_view reason, std::string_view content_type,
+                               std::string_view body) {
+    std::string response = "HTTP/1.1 " + std::to_string(status) + " " + std::string(reason) +
+                           "\r\nContent-Type: " + std::string(content_type) +
+                           "\r\nContent-Length: " + std::to_string(body.size()) +
+                           "\r\nConnection: close\r\n\r\n";
+    response.append(body);
+    return response;
+}
+
+void Sha1(const void* data, size_t size, uint8_t digest[20]) {
+    uint32_t state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    size_t offset = 0;
+    for (; offset + 64 <= size; offset += 64) {
+        Sha1Block(bytes + offset, state);
+    }
+
+    // Pad with 0x80, zeros and the bit length to a multiple of 64 bytes
+    uint8_t tail[128] = {};
+    size_t remaining = size - offset;
+    std::memcpy(tail, bytes + offset, remaining);
+    tail[remaining] = 0x80;
+    size_t tail_size = remaining < 56 ? 64 : 128;
+    uint64_t bit_length = static_cast<uint64_t>(size) * 8;
+    for (int i = 0; i < 8; ++i) {
+        tail[tail_size - 1 - i] = static_cast<uint8_t>(bit_length >> (i * 8));
+    }
+    for (size_t block = 0; block < tail_size; block += 64) {
+        Sha1Block(tail + block, state);
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        digest[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+    }
+}
+
+std::string ComputeWebSocketAccept(std::string_view key) {
+    std::string input(key);
+    input += kWebSocketGuid;
+    uint8_t digest[20];
+    Sha1(input.data(), input.size(), digest);
+
+    std::string accept(Base64EncodedLength(sizeof(digest)), '\0');
+    accept.resize(Base64Encode(digest, sizeof(digest), accept.data()));
+    return accept;
+}
+
+bool IsWebSocketUpgrade(const HttpRequestHead& head) {
+    return head.method == "GET" && HasToken(head.Header("connection"), "upgrade") &&
+           ToLower(head.Header("upgrade")) == "websocket" &&
+           !head.Header("sec-websocket-key").empty();
+}
+
+std::string FormatWebSocketHandshake(const HttpRequestHead& head) {
+    return "HTTP/1.1 101 Switching Protocols\r\n"
+           "Upgrade: websocket\r\n"
+           "Connection: Upgrade\r\n"
+           "Sec-WebSocket-Accept: " +
+           ComputeWebSocketAccept(head.Header("sec-websocket-key")) + "\r\n\r\n";
+}
+
+ParseStatus DecodeWebSocketFrame(std::string_view data, WebSocketFrame* frame, size_t* consumed,
+                                 uint64_t max_payload, WebSocketSender sender) {
+    if (data.size() < 2) {
+        return ParseStatus::kIncomplete;
+    }
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    const bool fin = bytes[0] & 0x80;
+    const uint8_t opcode = bytes[0] & 0x0F;
+    const bool masked = bytes[1] & 0x80;
+
+    // Extensions are never negotiated, so reserved bits must be clear
+    if ((bytes[0] & 0x70) || masked != (sender == WebSocketSender::kClient)) {
+        return ParseStatus::kError;
+    }
+
+    uint64_t length = bytes[1] & 0x7F;
+    size_t header_size = 2;
+    if (length == 126) {
+        header_size += 2;
+    } else if (length == 127) {
+        header_size += 8;
+    }
+    const size_t mask_size = masked ? 4 : 0;
+    if (data.size() < header_size + mask_size) {
+        return ParseStatus::kIncomplete;
+    }
+    if (length >= 126) {
+        length = 0;
+        for (size_t i = 2; i < header_size; ++i) {
+            length = (length << 8) | bytes[i];
+        }
+    }
+
+    // Control frames are short and never fragmented (RFC 6455 5.5)
+    if ((opcode & 0x08) && (!fin || length > 125)) {
+        return ParseStatus::kError;
+    }
+    if (length > max_payload) {
+        return ParseStatus::kError;
+    }
+    if (data.size() - header_size - mask_size < length) {
+        return ParseStatus::kIncomplete;
+    }
+
+    const char* payload = data.data() + header_size + mask_size;
+    frame->opcode = opcode;
+    frame->fin = fin;
+    frame->payload.assign(payload, length);
+    if (masked) {
+        const uint8_t* mask = bytes + header_size;
+        for (uint64_t i = 0; i < length; ++i) {
+            frame->payload[i] = static_cast<char>(frame->payload[i] ^ mask[i & 3]);
+        }
+    }
+    *consumed = header_size + mask_size + length;
+    return ParseStatus::kComplete;
+}
+
+void EncodeWebSocketFrame(uint8_t opcode, std::string_view payload, std::string* out,
+                          const uint8_t* mask) {
+    out->push_back(static_cast<char>(0x80 | opcode));
+    const uint8_t mask_bit = mask ? 0x80 : 0;
+    const uint64_t length = payload.size();
+    if (length < 126) {
+        out->push_back(static_cast<char>(mask_bit | length));
+    } else if (length <= 0xFFFF) {
+        out->push_back(static_cast<char>(mask_bit | 126));
+        out->push_back(static_cast<char>(length >> 8));
+        out->push_back(static_cast<char>(length));
+    } else {
+        out->push_back(static_cast<char>(mask_bit | 127));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            out->push_back(static_cast<char>(length >> shift));
+        }
+    }
+    if (!mask) {
+        out->append(payload);
+        return;
+    }
+    out->append(reinterpret_cast<const char*>(mask), 4);
+    const size_t start = out->size();
+    out->append(payload);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        (*out)[start + i] = static_cast<char>((*out)[start + i] ^ mask[i & 3]);
+    }
+}
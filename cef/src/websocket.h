@@ -0,0 +1,87 @@
+// CEF Browser - WebSocket and HTTP Framing
+#ifndef CEF_BROWSER_WEBSOCKET_H_
+#define CEF_BROWSER_WEBSOCKET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+
+// Result of parsing the start of a receive buffer
+enum class ParseStatus {
+    kIncomplete,
+    kComplete,
+    kError,
+};
+
+// Request line and headers of an HTTP/1.1 request
+struct HttpRequestHead {
+    std::string method;
+    std::string path;
+
+    // Header values keyed by lowercase name
+    std::map<std::string, std::string> headers;
+
+    // Value of header |name| (lowercase), or empty
+    std::string Header(const std::string& name) const;
+};
+
+// Parse a request head ending in an empty line from the start of |data|.
+// Sets |consumed| to its length on kComplete. Heads over |max_size| bytes are
+// errors.
+ParseStatus ParseHttpRequestHead(std::string_view data, HttpRequestHead* head, size_t* consumed,
+                                 size_t max_size = 16 * 1024);
+
+// Format an HTTP/1.1 response that closes the connection
+std::string FormatHttpResponse(int status, std::string_view reason, std::string_view content_type,
+                               std::string_view body);
+
+// SHA-1 digest of |data|
+void Sha1(const void* data, size_t size, uint8_t digest[20]);
+
+// Sec-WebSocket-Accept value for the client's Sec-WebSocket-Key
+std::string ComputeWebSocketAccept(std::string_view key);
+
+// Whether |head| asks to upgrade to a WebSocket
+bool IsWebSocketUpgrade(const HttpRequestHead& head);
+
+// Format the 101 response accepting the WebSocket upgrade of |head|
+std::string FormatWebSocketHandshake(const HttpRequestHead& head);
+
+enum WebSocketOpcode : uint8_t {
+    kWebSocketContinuation = 0x0,
+    kWebSocketText = 0x1,
+    kWebSocketBinary = 0x2,
+    kWebSocketClose = 0x8,
+    kWebSocketPing = 0x9,
+    kWebSocketPong = 0xA,
+};
+
+struct WebSocketFrame {
+    uint8_t opcode = 0;
+    bool fin = true;
+
+    // Unmasked payload
+    std::string payload;
+};
+
+// Peer that sent a frame
+enum class WebSocketSender {
+    kClient,
+    kServer,
+};
+
+// Parse one frame from the start of |data|. Client frames must be masked and
+// server frames must not be (RFC 6455 5.1); payloads over |max_payload| bytes
+// are errors. Sets |consumed| to the frame length on kComplete.
+ParseStatus DecodeWebSocketFrame(std::string_view data, WebSocketFrame* frame, size_t* consumed,
+                                 uint64_t max_payload = 256 * 1024 * 1024,
+                                 WebSocketSender sender = WebSocketSender::kClient);
+
+// Append a final frame to |out|: an unmasked server frame, or a client frame
+// masked with the 4 bytes at |mask|
+void EncodeWebSocketFrame(uint8_t opcode, std::string_view payload, std::string* out,
+                          const uint8_t* mask = nullptr);
+
+#endif  // CEF_BROWSER_WEBSOCKET_H_
@@ -0,0 +1,248 @@
+// CEF Browser - Unit Tests for Base64 Encoding
+#include <gtest/gtest.h>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base64.h"
+
+namespace {
+
+// Reference encoder matching CefBase64Encode output (padded, standard alphabet)
+std::string ReferenceEncode(const std::string& data) {
+    static const char* base64_chars =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string encoded;
+    int val = 0, valb = -6;
+    for (unsigned char c : data) {
+        val = (val << 8) + c;
+        valb += 8;
+        while (valb >= 0) {
+            encoded.push_back(base64_chars[(val >> valb) & 0x3F]);
+            valb -= 6;
+        }
+    }
+    if (valb > -6) {
+        encoded.push_back(base64_chars[((val << 8) >> (valb + 8)) & 0x3F]);
+    }
+    while (encoded.size() % 4) {
+        encoded.push_back('=');
+    }
+    return encoded;
+}
+
+std::string Decode(const std::string& encoded) {
+    std::string decoded;
+    int val = 0, valb = -8;
+    for (char c : encoded) {
+        int digit;
+        if (c >= 'A' && c <= 'Z') {
+            digit = c - 'A';
+        } else if (c >= 'a' && c <= 'z') {
+            digit = c - 'a' + 26;
+        } else if (c >= '0' && c <= '9') {
+            digit = c - '0' + 52;
+        } else if (c == '+') {
+            digit = 62;
+        } else if (c == '/') {
+            digit = 63;
+        } else {
+            break;
+        }
+        val = (val << 6) + digit;
+        valb += 6;
+        if (valb >= 0) {
+            decoded.push_back(static_cast<char>((val >> valb) & 0xFF));
+            valb -= 8;
+        }
+    }
+    return decoded;
+}
+
+std::string Encode(Base64Kernel kernel, const std::string& data) {
+    // Guard bytes catch writes past the computed length
+    std::string out(Base64EncodedLength(data.size()) + 8, '#');
+    size_t written = Base64EncodeWith(kernel, data.data(), data.size(), &out[0]);
+    EXPECT_EQ(written, Base64EncodedLength(data.size()));
+    EXPECT_EQ(out.substr(written), std::string(8, '#'));
+    out.resize(written);
+    return out;
+}
+
+// Reference for CefURIEncode(text, false): Chromium's EscapeUrlEncodedData()
+// keeps alphanumerics and !'()*-._~ and escapes everything else
+std::string ReferenceUriEncode(const std::string& text) {
+    static const char kHex[] = "0123456789ABCDEF";
+    std::string escaped;
+    for (unsigned char c : text) {
+        if (isalnum(c) || strchr("!'()*-._~", c)) {
+            escaped.push_back(static_cast<char>(c));
+        } else {
+            escaped.push_back('%');
+            escaped.push_back(kHex[c >> 4]);
+            escaped.push_back(kHex[c & 0xF]);
+        }
+    }
+    return escaped;
+}
+
+// Output of GetDataURI() before the one-pass encoder
+std::string ReferenceUriBase64(const std::string& data) {
+    return ReferenceUriEncode(ReferenceEncode(data));
+}
+
+std::string UriEncode(Base64Kernel kernel, const std::string& data) {
+    std::string out(Base64UriEncodedMaxLength(data.size()) + 8, '#');
+    size_t written = Base64UriEncodeWith(kernel, data.data(), data.size(), &out[0]);
+    EXPECT_LE(written, Base64UriEncodedMaxLength(data.size()));
+    EXPECT_EQ(out.substr(Base64UriEncodedMaxLength(data.size())), std::string(8, '#'));
+    out.resize(written);
+    return out;
+}
+
+std::vector<Base64Kernel> SupportedKernels() {
+    std::vector<Base64Kernel> kernels;
+    for (Base64Kernel kernel : {Base64Kernel::kScalar, Base64Kernel::kSSE41, Base64Kernel::kAVX2,
+                                Base64Kernel::kNEON}) {
+        if (IsBase64KernelSupported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+    return kernels;
+}
+
+}  // namespace
+
+class Base64Test : public ::testing::TestWithParam<Base64Kernel> {};
+
+TEST_P(Base64Test, KnownVectors) {
+    EXPECT_EQ(Encode(GetParam(), ""), "");
+    EXPECT_EQ(Encode(GetParam(), "f"), "Zg==");
+    EXPECT_EQ(Encode(GetParam(), "fo"), "Zm8=");
+    EXPECT_EQ(Encode(GetParam(), "foo"), "Zm9v");
+    EXPECT_EQ(Encode(GetParam(), "foobar"), "Zm9vYmFy");
+    EXPECT_EQ(Encode(GetParam(), "<html><body>Hello</body></html>"),
+              "PGh0bWw+PGJvZHk+SGVsbG88L2JvZHk+PC9odG1sPg==");
+}
+
+TEST_P(Base64Test, AllOneAndTwoByteInputs) {
+    std::string data(2, '\0');
+    for (int a = 0; a < 256; ++a) {
+        data.resize(1);
+        data[0] = static_cast<char>(a);
+        ASSERT_EQ(Encode(GetParam(), data), ReferenceEncode(data));
+        data.resize(2);
+        for (int b = 0; b < 256; ++b) {
+            data[1] = static_cast<char>(b);
+            ASSERT_EQ(Encode(GetParam(), data), ReferenceEncode(data));
+        }
+    }
+}
+
+TEST_P(Base64Test, EveryByteValueInEveryLanePosition) {
+    // Shift a 0..255 ramp through all offsets of the widest (48-byte) block
+    std::string data;
+    for (int i = 0; i < 256 + 48; ++i) {
+        data.push_back(static_cast<char>(i & 0xFF));
+    }
+    for (size_t offset = 0; offset < 48; ++offset) {
+        std::string slice = data.substr(offset, 256);
+        ASSERT_EQ(Encode(GetParam(), slice), ReferenceEncode(slice)) << "offset " << offset;
+    }
+}
+
+TEST_P(Base64Test, RandomRoundTripAllLengths) {
+    std::mt19937 rng(12345);
+    for (size_t length = 0; length <= 2048; ++length) {
+        std::string data(length, '\0');
+        for (char& c : data) {
+            c = static_cast<char>(rng() & 0xFF);
+        }
+        std::string encoded = Encode(GetParam(), data);
+        ASSERT_EQ(encoded, ReferenceEncode(data)) << "length " << length;
+        ASSERT_EQ(Decode(encoded), data) << "length " << length;
+    }
+}
+
+TEST_P(Base64Test, LargeInputMatchesScalar) {
+    std::mt19937 rng(54321);
+    std::string data(1 << 20, '\0');
+    for (char& c : data) {
+        c = static_cast<char>(rng() & 0xFF);
+    }
+    EXPECT_EQ(Encode(GetParam(), data), Encode(Base64Kernel::kScalar, data));
+}
+
+TEST_P(Base64Test, UriKnownVectors) {
+    EXPECT_EQ(UriEncode(GetParam(), ""), "");
+    EXPECT_EQ(UriEncode(GetParam(), "f"), "Zg%3D%3D");
+    EXPECT_EQ(UriEncode(GetParam(), "foo"), "Zm9v");
+    EXPECT_EQ(UriEncode(GetParam(), "\xfb\xff"), "%2B%2F8%3D");
+    EXPECT_EQ(UriEncode(GetParam(), "<html><body>Hello</body></html>"),
+              "PGh0bWw%2BPGJvZHk%2BSGVsbG88L2JvZHk%2BPC9odG1sPg%3D%3D");
+}
+
+TEST_P(Base64Test, UriMatchesOldPipelineForAllOneAndTwoByteInputs) {
+    std::string data(2, '\0');
+    for (int a = 0; a < 256; ++a) {
+        data.resize(1);
+        data[0] = static_cast<char>(a);
+        ASSERT_EQ(UriEncode(GetParam(), data), ReferenceUriBase64(data));
+        data.resize(2);
+        for (int b = 0; b < 256; ++b) {
+            data[1] = static_cast<char>(b);
+            ASSERT_EQ(UriEncode(GetParam(), data), ReferenceUriBase64(data));
+        }
+    }
+}
+
+TEST_P(Base64Test, UriMatchesOldPipelineInEveryLanePosition) {
+    std::string data;
+    for (int i = 0; i < 256 + 48; ++i) {
+        data.push_back(static_cast<char>(i & 0xFF));
+    }
+    for (size_t offset = 0; offset < 48; ++offset) {
+        std::string slice = data.substr(offset, 256);
+        ASSERT_EQ(UriEncode(GetParam(), slice), ReferenceUriBase64(slice)) << "offset " << offset;
+    }
+}
+
+TEST_P(Base64Test, UriMatchesOldPipelineAllLengths) {
+    // Blocks with and without characters to escape: bytes of 0xFF and 0xFB
+    // encode to '/' and '+', small bytes to letters only
+    std::mt19937 rng(777);
+    for (size_t length = 0; length <= 1024; ++length) {
+        std::string data(length, '\0');
+        const bool sparse = length % 2 == 0;
+        for (char& c : data) {
+            uint32_t value = rng();
+            c = static_cast<char>(sparse && value % 64 ? value & 0x0F : value & 0xFF);
+        }
+        ASSERT_EQ(UriEncode(GetParam(), data), ReferenceUriBase64(data)) << "length " << length;
+    }
+    EXPECT_EQ(UriEncode(GetParam(), std::string(300, '\xff')),
+              ReferenceUriBase64(std::string(300, '\xff')));
+}
+
+INSTANTIATE_TEST_SUITE_P(Kernels, Base64Test, ::testing::ValuesIn(SupportedKernels()),
+                         [](const ::testing::TestParamInfo<Base64Kernel>& info) {
+                             std::string name = GetBase64KernelName(info.param);
+                             return name == "sse4.1" ? std::string("sse41") : name;
+                         });
+
+TEST(Base64DispatchTest, SelectedKernelIsSupported) {
+    EXPECT_TRUE(IsBase64KernelSupported(GetBase64Kernel()));
+
+    std::string data = "dispatch";
+    std::string out(Base64EncodedLength(data.size()), '\0');
+    Base64Encode(data.data(), data.size(), &out[0]);
+    EXPECT_EQ(out, ReferenceEncode(data));
+
+    std::string uri(Base64UriEncodedMaxLength(data.size()), '\0');
+    uri.resize(Base64UriEncode(data.data(), data.size(), &uri[0]));
+    EXPECT_EQ(uri, ReferenceUriBase64(data));
+}
@@ -0,0 +1,208 @@
+// CEF Browser - Unit Tests for the Browser Pool Bookkeeping
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "browser_pool_state.h"
+
+namespace {
+
+using Clock = BrowserPoolState::Clock;
+using std::chrono::seconds;
+
+BrowserPoolOptions MakeOptions(size_t min_size, size_t max_size) {
+    BrowserPoolOptions options;
+    options.min_size = min_size;
+    options.max_size = max_size;
+    options.max_uses = 3;
+    options.idle_timeout = seconds(60);
+    return options;
+}
+
+PooledBrowserState StateOf(const BrowserPoolState& pool, int browser_id) {
+    const PooledBrowser* browser = pool.Find(browser_id);
+    EXPECT_NE(browser, nullptr);
+    return browser ? browser->state : PooledBrowserState::kClosing;
+}
+
+// Create the browsers |pool| asks for as |first_id|, |first_id| + 1, ...
+// and finish loading their blank pages
+void CreateBrowsers(BrowserPoolState& pool, int first_id, Clock::time_point now) {
+    const size_t creates = pool.TakeCreates();
+    for (size_t i = 0; i < creates; ++i) {
+        ASSERT_TRUE(pool.OnCreated(first_id + static_cast<int>(i)));
+    }
+    for (size_t i = 0; i < creates; ++i) {
+        pool.OnResetDone(first_id + static_cast<int>(i), now);
+    }
+}
+
+}  // namespace
+
+TEST(BrowserPoolStateTest, ChecksOutAndResetsBrowsers) {
+    BrowserPoolState pool(MakeOptions(2, 4));
+    const Clock::time_point now = Clock::now();
+    EXPECT_EQ(pool.TakeCreates(), 2u);
+    EXPECT_EQ(pool.TakeCreates(), 0u);
+    EXPECT_EQ(pool.size(), 2u);
+
+    // Browsers become available once their blank page has loaded
+    ASSERT_TRUE(pool.OnCreated(1));
+    ASSERT_TRUE(pool.OnCreated(2));
+    EXPECT_EQ(StateOf(pool, 1), PooledBrowserState::kResetting);
+    EXPECT_EQ(pool.idle_count(), 0u);
+    EXPECT_EQ(pool.OnResetDone(1, now).browser_id, 0);
+    EXPECT_EQ(pool.OnResetDone(2, now).browser_id, 0);
+    EXPECT_EQ(pool.idle_count(), 2u);
+
+    // The browser returned last is handed out first
+    BrowserPoolCheckout checkout = pool.Checkout();
+    EXPECT_EQ(checkout.browser_id, 2);
+    EXPECT_EQ(checkout.job_id, 1u);
+    EXPECT_EQ(StateOf(pool, 2), PooledBrowserState::kCheckedOut);
+    EXPECT_EQ(pool.Find(2)->uses, 1);
+    EXPECT_EQ(pool.Find(2)->job_id, 1u);
+
+    // Only checked out browsers can come back
+    EXPECT_EQ(pool.Return(1), BrowserPoolReturn::kIgnore);
+    EXPECT_EQ(pool.Return(7), BrowserPoolReturn::kIgnore);
+    EXPECT_EQ(pool.Return(2), BrowserPoolReturn::kReset);
+    EXPECT_EQ(pool.Return(2), BrowserPoolReturn::kIgnore);
+    EXPECT_EQ(StateOf(pool, 2), PooledBrowserState::kResetting);
+    EXPECT_EQ(pool.Find(2)->job_id, 0u);
+
+    // A browser being reset is not handed out
+    checkout = pool.Checkout();
+    EXPECT_EQ(checkout.browser_id, 1);
+    EXPECT_EQ(checkout.job_id, 2u);
+    pool.OnResetDone(2, now);
+    checkout = pool.Checkout();
+    EXPECT_EQ(checkout.browser_id, 2);
+    EXPECT_EQ(checkout.job_id, 3u);
+    EXPECT_EQ(pool.Find(2)->uses, 2);
+    EXPECT_EQ(pool.TakeCreates(), 0u);
+}
+
+TEST(BrowserPoolStateTest, RetiresBrowsersAfterMaxUses) {
+    BrowserPoolState pool(MakeOptions(1, 1));
+    const Clock::time_point now = Clock::now();
+    CreateBrowsers(pool, 1, now);
+
+    for (int use = 1; use < 3; ++use) {
+        ASSERT_EQ(pool.Checkout().browser_id, 1);
+        ASSERT_EQ(pool.Return(1), BrowserPoolReturn::kReset);
+        pool.OnResetDone(1, now);
+    }
+    ASSERT_EQ(pool.Checkout().browser_id, 1);
+    EXPECT_EQ(pool.Return(1), BrowserPoolReturn::kRetire);
+    EXPECT_EQ(StateOf(pool, 1), PooledBrowserState::kClosing);
+    EXPECT_EQ(pool.Checkout().browser_id, 0);
+
+    // The replacement is created once the retired browser has closed
+    EXPECT_EQ(pool.TakeCreates(), 0u);
+    pool.OnClosed(1);
+    EXPECT_EQ(pool.Find(1), nullptr);
+    EXPECT_EQ(pool.TakeCreates(), 1u);
+    ASSERT_TRUE(pool.OnCreated(2));
+
+    // The waiting checkout gets the replacement, with a fresh use count
+    const BrowserPoolCheckout checkout = pool.OnResetDone(2, now);
+    EXPECT_EQ(checkout.browser_id, 2);
+    EXPECT_EQ(checkout.job_id, 4u);
+    EXPECT_EQ(pool.Find(2)->uses, 1);
+    EXPECT_EQ(pool.waiting_count(), 0u);
+}
+
+TEST(BrowserPoolStateTest, QueuesCheckoutsBeyondMaxSize) {
+    BrowserPoolState pool(MakeOptions(0, 2));
+    const Clock::time_point now = Clock::now();
+    EXPECT_EQ(pool.TakeCreates(), 0u);
+
+    // Each waiting checkout asks for a browser, up to |max_size|
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(pool.Checkout().browser_id, 0);
+    }
+    EXPECT_EQ(pool.waiting_count(), 3u);
+    EXPECT_EQ(pool.TakeCreates(), 2u);
+    EXPECT_EQ(pool.TakeCreates(), 0u);
+
+    ASSERT_TRUE(pool.OnCreated(1));
+    ASSERT_TRUE(pool.OnCreated(2));
+    EXPECT_EQ(pool.OnResetDone(2, now).job_id, 1u);
+    EXPECT_EQ(pool.OnResetDone(1, now).job_id, 2u);
+    EXPECT_EQ(pool.waiting_count(), 1u);
+
+    // A browser being reset covers the last checkout; nothing is created
+    ASSERT_EQ(pool.Return(1), BrowserPoolReturn::kReset);
+    EXPECT_EQ(pool.TakeCreates(), 0u);
+    const BrowserPoolCheckout checkout = pool.OnResetDone(1, now);
+    EXPECT_EQ(checkout.browser_id, 1);
+    EXPECT_EQ(checkout.job_id, 3u);
+    EXPECT_EQ(pool.waiting_count(), 0u);
+    EXPECT_EQ(pool.idle_count(), 0u);
+}
+
+TEST(BrowserPoolStateTest, TrimsIdleBrowsersAboveMinSize) {
+    BrowserPoolState pool(MakeOptions(1, 4));
+    const Clock::time_point start = Clock::now();
+    CreateBrowsers(pool, 1, start);
+
+    // Grow to three browsers, then return them at different times
+    for (int i = 0; i < 3; ++i) {
+        pool.Checkout();
+    }
+    CreateBrowsers(pool, 2, start);
+    ASSERT_EQ(pool.size(), 3u);
+    ASSERT_EQ(pool.idle_count(), 0u);
+    for (int id = 1; id <= 3; ++id) {
+        ASSERT_EQ(pool.Return(id), BrowserPoolReturn::kReset);
+        pool.OnResetDone(id, start + seconds(id * 10));
+    }
+
+    EXPECT_TRUE(pool.TrimIdle(start + seconds(69)).empty());
+    EXPECT_EQ(pool.TrimIdle(start + seconds(75)), (std::vector<int>{1}));
+    EXPECT_EQ(StateOf(pool, 1), PooledBrowserState::kClosing);
+    EXPECT_EQ(pool.idle_count(), 2u);
+
+    // |min_size| browsers stay however long they are idle
+    EXPECT_EQ(pool.TrimIdle(start + seconds(1000)), (std::vector<int>{2}));
+    EXPECT_TRUE(pool.TrimIdle(start + seconds(2000)).empty());
+    EXPECT_EQ(StateOf(pool, 3), PooledBrowserState::kIdle);
+
+    pool.OnClosed(1);
+    pool.OnClosed(2);
+    EXPECT_EQ(pool.size(), 1u);
+    EXPECT_EQ(pool.TakeCreates(), 0u);
+    EXPECT_EQ(pool.Checkout().browser_id, 3);
+}
+
+TEST(BrowserPoolStateTest, ShutsDown) {
+    BrowserPoolState pool(MakeOptions(2, 2));
+    const Clock::time_point now = Clock::now();
+    CreateBrowsers(pool, 1, now);
+    ASSERT_EQ(pool.Checkout().browser_id, 2);
+    ASSERT_EQ(pool.Checkout().browser_id, 1);
+    pool.Checkout();
+    EXPECT_EQ(pool.waiting_count(), 1u);
+
+    // One browser is being replaced when the pool shuts down
+    ASSERT_EQ(pool.Return(1), BrowserPoolReturn::kReset);
+    pool.Retire(1);
+    pool.OnClosed(1);
+    EXPECT_EQ(pool.TakeCreates(), 1u);
+
+    EXPECT_EQ(pool.Shutdown(), (std::vector<int>{2}));
+    EXPECT_TRUE(pool.shutting_down());
+    EXPECT_EQ(pool.waiting_count(), 0u);
+    EXPECT_EQ(pool.Checkout().browser_id, 0);
+    EXPECT_EQ(pool.waiting_count(), 0u);
+    EXPECT_EQ(pool.TakeCreates(), 0u);
+    EXPECT_EQ(pool.Return(2), BrowserPoolReturn::kIgnore);
+
+    // A browser created after the shutdown is closed right away
+    EXPECT_FALSE(pool.OnCreated(3));
+    EXPECT_EQ(StateOf(pool, 3), PooledBrowserState::kClosing);
+    EXPECT_FALSE(pool.closed());
+    pool.OnClosed(2);
+    pool.OnClosed(3);
+    EXPECT_TRUE(pool.closed());
+}
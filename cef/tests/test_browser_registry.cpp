@@ -0,0 +1,174 @@
+// CEF Browser - Unit Tests for the Browser Registry
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "browser_registry.h"
+
+namespace {
+
+// Stands in for CefRefPtr<CefBrowser>
+using Browser = std::shared_ptr<std::string>;
+using Registry = BrowserRegistry<Browser>;
+
+Browser MakeBrowser(const std::string& name) {
+    return std::make_shared<std::string>(name);
+}
+
+}  // namespace
+
+TEST(BrowserRegistryTest, AddsAndFindsBrowsers) {
+    Registry registry;
+    EXPECT_TRUE(registry.empty());
+    EXPECT_EQ(registry.Find(1), nullptr);
+
+    const SlotHandle a = registry.Add(1, MakeBrowser("a"), kBrowserMain);
+    const SlotHandle b = registry.Add(2, MakeBrowser("b"), kBrowserDelegated);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(registry.Add(2, MakeBrowser("c"), 0), SlotHandle());
+    EXPECT_EQ(registry.size(), 2u);
+    EXPECT_EQ(registry.HandleOf(2), b);
+
+    const BrowserRecord* record = registry.Find(2);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(registry.Find(b), record);
+    EXPECT_EQ(record->browser_id, 2);
+    EXPECT_EQ(record->flags, kBrowserDelegated);
+    EXPECT_EQ(record->renderer_pid, 0);
+    EXPECT_EQ(record->resource_policy, nullptr);
+    EXPECT_EQ(record->watchdog_target, 0);
+    EXPECT_EQ(*registry.GetBrowser(b), "b");
+    EXPECT_EQ(*registry.GetBrowser(1), "a");
+
+    std::vector<std::string> names;
+    registry.ForEach([&names](const BrowserRecord& record, const Browser& browser) {
+        names.push_back(std::to_string(record.browser_id) + *browser);
+    });
+    std::sort(names.begin(), names.end());
+    EXPECT_EQ(names, (std::vector<std::string>{"1a", "2b"}));
+}
+
+TEST(BrowserRegistryTest, UpdatesRecords) {
+    Registry registry;
+    const SlotHandle handle = registry.Add(7, MakeBrowser("a"), 0);
+
+    EXPECT_TRUE(registry.Update(7, [](BrowserRecord& record) {
+        record.flags |= kBrowserLoading;
+        record.renderer_pid = 1234;
+    }));
+    EXPECT_TRUE(registry.Update(handle, [](BrowserRecord& record) {
+        record.url = "https://example.com/";
+        record.page_load.OnNavigation(PageLoadState::Clock::now());
+    }));
+
+    bool ran = false;
+    EXPECT_FALSE(registry.Update(8, [&ran](BrowserRecord&) { ran = true; }));
+    EXPECT_FALSE(ran);
+
+    const BrowserRecord* record = registry.Find(7);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->flags, kBrowserLoading);
+    EXPECT_EQ(record->renderer_pid, 1234);
+    EXPECT_EQ(record->url, "https://example.com/");
+    EXPECT_EQ(record->page_load.page(), 1u);
+}
+
+TEST(BrowserRegistryTest, RemovesBrowsersAndTheirState) {
+    Registry registry;
+    Browser browser = MakeBrowser("a");
+    const SlotHandle handle = registry.Add(1, browser, 0);
+    registry.Add(2, MakeBrowser("b"), 0);
+
+    FrameBuffer* frame_buffer = registry.GetOrCreateFrameBuffer(1);
+    ASSERT_NE(frame_buffer, nullptr);
+    EXPECT_EQ(registry.GetOrCreateFrameBuffer(1), frame_buffer);
+    EXPECT_EQ(registry.GetFrameBuffer(1), frame_buffer);
+    EXPECT_EQ(registry.GetFrameBuffer(2), nullptr);
+    EXPECT_EQ(registry.GetOrCreateFrameBuffer(3), nullptr);
+    EXPECT_EQ(browser.use_count(), 2);
+
+    EXPECT_TRUE(registry.Remove(1));
+    EXPECT_FALSE(registry.Remove(1));
+    EXPECT_EQ(registry.Find(1), nullptr);
+    EXPECT_EQ(registry.GetFrameBuffer(1), nullptr);
+    EXPECT_EQ(registry.size(), 1u);
+
+    // The registry let go of the browser
+    EXPECT_EQ(browser.use_count(), 1);
+
+    // A reused identifier starts afresh, and the old handle stays dead even
+    // though the new browser took its slot
+    const SlotHandle reused = registry.Add(1, MakeBrowser("c"), 0);
+    EXPECT_EQ(reused.index, handle.index);
+    EXPECT_EQ(registry.Find(handle), nullptr);
+    EXPECT_EQ(registry.GetBrowser(handle), nullptr);
+    EXPECT_FALSE(registry.Update(handle, [](BrowserRecord&) {}));
+    EXPECT_EQ(registry.GetFrameBuffer(1), nullptr);
+    EXPECT_EQ(registry.Find(1)->flags, 0u);
+    EXPECT_EQ(*registry.GetBrowser(reused), "c");
+}
+
+TEST(BrowserRegistryTest, HandlesStayValidWhileOtherBrowsersComeAndGo) {
+    Registry registry;
+    const SlotHandle kept = registry.Add(1, MakeBrowser("kept"), kBrowserMain);
+
+    // Enough churn to move the kept entry around the dense array
+    for (int id = 2; id < 2000; ++id) {
+        registry.Add(id, MakeBrowser(std::to_string(id)), 0);
+        registry.Update(kept, [](BrowserRecord& record) { ++record.renderer_pid; });
+        if (id % 3 == 0) {
+            registry.Remove(id - 1);
+        }
+        ASSERT_EQ(registry.HandleOf(1), kept);
+        ASSERT_EQ(registry.Find(id)->browser_id, id);
+    }
+
+    const BrowserRecord* record = registry.Find(kept);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->flags, kBrowserMain);
+    EXPECT_EQ(record->renderer_pid, 1998);
+    EXPECT_EQ(*registry.GetBrowser(kept), "kept");
+    EXPECT_EQ(registry.size(), 1u + 1998u - 1998u / 3);
+}
+
+TEST(BrowserRegistryTest, LooksUpFromOtherThreads) {
+    Registry registry;
+    registry.Add(1, MakeBrowser("kept"), 0);
+
+    // Readers stand in for the IO thread while the "UI thread" churns
+    std::atomic<bool> done{false};
+    std::atomic<int> misses{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&registry, &done, &misses] {
+            while (!done.load()) {
+                int pid = -1;
+                if (!registry.Lookup(1, [&pid](const BrowserRecord& record) {
+                        pid = record.renderer_pid;
+                    }) ||
+                    pid < 0 || !registry.GetBrowser(1)) {
+                    misses.fetch_add(1);
+                }
+                registry.Lookup(2, [](const BrowserRecord&) {});
+            }
+        });
+    }
+
+    for (int id = 2; id < 5000; ++id) {
+        registry.Add(id, MakeBrowser(std::to_string(id)), 0);
+        registry.Update(1, [id](BrowserRecord& record) { record.renderer_pid = id; });
+        registry.Remove(id);
+    }
+    done.store(true);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(misses.load(), 0);
+    EXPECT_EQ(registry.size(), 1u);
+    EXPECT_EQ(registry.Find(1)->renderer_pid, 4999);
+}
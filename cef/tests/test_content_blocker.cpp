@@ -0,0 +1,153 @@
+// CEF Browser - Unit Tests for the Content Blocker
+#include <gtest/gtest.h>
+#include <string>
+
+#include "content_blocker.h"
+#include "json_writer.h"
+
+namespace {
+
+ContentRequest Request(std::string_view url, uint32_t type = kContentScript,
+                       std::string_view document_url = "https://news.test/") {
+    ContentRequest request;
+    request.url = url;
+    request.document_url = document_url;
+    request.type = type;
+    return request;
+}
+
+}  // namespace
+
+TEST(ContentBlockerTest, SkipsCommentsCosmeticAndUnknownOptions) {
+    ContentBlocker blocker;
+    EXPECT_EQ(blocker.AddRules("[Adblock Plus 2.0]\n"
+                               "! Title: test\n"
+                               "example.com##.ad\n"
+                               "/banner[0-9]+/\n"
+                               "||popup.test^$popup\n"
+                               "\n"
+                               "||ads.test^\r\n"),
+              1u);
+    blocker.Compile();
+    EXPECT_EQ(blocker.rule_count(), 1u);
+    EXPECT_EQ(blocker.rule_text(0), "||ads.test^");
+}
+
+TEST(ContentBlockerTest, HostAnchorMatchesDomainAndSubdomains) {
+    ContentBlocker blocker;
+    blocker.AddRules("||ads.test^\n||tracker.test/pixel\n");
+    blocker.Compile();
+
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://ads.test/a.js")));
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://cdn.ads.test:8443/a.js")));
+    EXPECT_TRUE(blocker.ShouldBlock(Request("HTTPS://ADS.TEST/a.js")));
+    EXPECT_FALSE(blocker.ShouldBlock(Request("https://badads.test/a.js")));
+    EXPECT_FALSE(blocker.ShouldBlock(Request("https://ads.test.example/a.js")));
+    EXPECT_FALSE(blocker.ShouldBlock(Request("https://news.test/?ref=ads.test")));
+
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://tracker.test/pixel.gif")));
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://eu.tracker.test/pixel?id=1")));
+    EXPECT_FALSE(blocker.ShouldBlock(Request("https://tracker.test/other/pixel")));
+}
+
+TEST(ContentBlockerTest, WildcardsSeparatorsAndAnchors) {
+    ContentBlocker blocker;
+    blocker.AddRules("/banner/*/img^\n"
+                     "|https://start.test/\n"
+                     "swf|\n"
+                     "&adtype=\n");
+    blocker.Compile();
+
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://a.test/banner/big/img?x")));
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://a.test/banner/big/img")));
+    EXPECT_FALSE(blocker.ShouldBlock(Request("https://a.test/banner/big/imgs")));
+
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://start.test/x.js")));
+    EXPECT_FALSE(blocker.ShouldBlock(Request("https://a.test/?u=https://start.test/")));
+
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://a.test/movie.swf")));
+    EXPECT_FALSE(blocker.ShouldBlock(Request("https://a.test/movie.swf?x")));
+
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://a.test/s?q=1&adtype=2")));
+}
+
+TEST(ContentBlockerTest, ExceptionsOverrideBlocks) {
+    ContentBlocker blocker;
+    blocker.AddRules("||ads.test^\n@@||ads.test/allowed/\n");
+    blocker.Compile();
+
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://ads.test/blocked.js")));
+    EXPECT_FALSE(blocker.ShouldBlock(Request("https://ads.test/allowed/ok.js")));
+    EXPECT_EQ(blocker.rule_hits(0), 1u);
+    EXPECT_EQ(blocker.rule_hits(1), 1u);
+}
+
+TEST(ContentBlockerTest, TypeOptions) {
+    ContentBlocker blocker;
+    blocker.AddRules("||img.test^$image\n||noscript.test^$~script\n");
+    blocker.Compile();
+
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://img.test/a.png", kContentImage)));
+    EXPECT_FALSE(blocker.ShouldBlock(Request("https://img.test/a.js", kContentScript)));
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://noscript.test/a.css", kContentStylesheet)));
+    EXPECT_FALSE(blocker.ShouldBlock(Request("https://noscript.test/a.js", kContentScript)));
+}
+
+TEST(ContentBlockerTest, PartyAndDomainOptions) {
+    ContentBlocker blocker;
+    blocker.AddRules("/analytics.js$third-party\n"
+                     "/widget.js$domain=news.test|~sports.news.test\n");
+    blocker.Compile();
+
+    EXPECT_TRUE(blocker.ShouldBlock(
+        Request("https://cdn.test/analytics.js", kContentScript, "https://news.test/")));
+    EXPECT_FALSE(blocker.ShouldBlock(
+        Request("https://static.news.test/analytics.js", kContentScript, "https://news.test/")));
+    EXPECT_FALSE(blocker.ShouldBlock(Request("https://cdn.test/analytics.js", kContentScript, "")));
+
+    EXPECT_TRUE(blocker.ShouldBlock(
+        Request("https://cdn.test/widget.js", kContentScript, "https://www.news.test/")));
+    EXPECT_FALSE(blocker.ShouldBlock(
+        Request("https://cdn.test/widget.js", kContentScript, "https://sports.news.test/")));
+    EXPECT_FALSE(blocker.ShouldBlock(
+        Request("https://cdn.test/widget.js", kContentScript, "https://other.test/")));
+}
+
+TEST(ContentBlockerTest, OverlappingLiterals) {
+    ContentBlocker blocker;
+    blocker.AddRules("adserver\nserver/ads\nrver/ad\n");
+    blocker.Compile();
+
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://a.test/server/ads.js")));
+    EXPECT_EQ(blocker.rule_hits(0) + blocker.rule_hits(1) + blocker.rule_hits(2), 1u);
+    EXPECT_TRUE(blocker.ShouldBlock(Request("https://a.test/myadserver.js")));
+    EXPECT_FALSE(blocker.ShouldBlock(Request("https://a.test/server/a.js")));
+}
+
+TEST(ContentBlockerTest, HostParsing) {
+    EXPECT_EQ(ContentBlocker::GetHost("https://user:pw@a.test:80/x"), "a.test");
+    EXPECT_EQ(ContentBlocker::GetHost("https://a.test?x"), "a.test");
+    EXPECT_EQ(ContentBlocker::GetHost("http://[::1]:8080/"), "[::1]");
+    EXPECT_EQ(ContentBlocker::GetHost("about:blank"), "");
+
+    EXPECT_FALSE(ContentBlocker::IsThirdParty("cdn.news.test", "www.news.test"));
+    EXPECT_TRUE(ContentBlocker::IsThirdParty("cdn.test", "news.test"));
+    EXPECT_FALSE(ContentBlocker::IsThirdParty("a.bbc.co.uk", "www.bbc.co.uk"));
+    EXPECT_TRUE(ContentBlocker::IsThirdParty("a.bbc.co.uk", "itv.co.uk"));
+}
+
+TEST(ContentBlockerTest, WritesHitRulesMostHitFirst) {
+    ContentBlocker blocker;
+    blocker.AddRules("||a.test^\n||b.test^\n||c.test^\n");
+    blocker.Compile();
+    blocker.ShouldBlock(Request("https://b.test/1"));
+    blocker.ShouldBlock(Request("https://b.test/2"));
+    blocker.ShouldBlock(Request("https://a.test/1"));
+    blocker.ShouldBlock(Request("https://d.test/1"));
+
+    JsonWriter writer;
+    blocker.WriteJson(writer);
+    EXPECT_EQ(writer.str(),
+              "{\"requests\":4,\"blocked\":3,\"rules\":["
+              "{\"rule\":\"||b.test^\",\"hits\":2},{\"rule\":\"||a.test^\",\"hits\":1}]}");
+}
@@ -0,0 +1,64 @@
+// CEF Browser - Unit Tests for the DevTools Endpoint
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "devtools_endpoint.h"
+
+TEST(DevToolsEndpointTest, ChromiumServesOnlyEagerTcp) {
+    DevToolsEndpoint endpoint;
+    endpoint.transport = "tcp";
+    endpoint.port = 9333;
+    EXPECT_EQ(endpoint.ChromiumPort(), 9333);
+    endpoint.lazy = true;
+    EXPECT_EQ(endpoint.ChromiumPort(), 0);
+    endpoint.transport = "pipe";
+    endpoint.lazy = false;
+    EXPECT_EQ(endpoint.ChromiumPort(), 0);
+
+    EXPECT_TRUE(IsDevToolsTransport("tcp"));
+    EXPECT_TRUE(IsDevToolsTransport("off"));
+    EXPECT_FALSE(IsDevToolsTransport("websocket"));
+}
+
+#if !defined(_WIN32)
+TEST(DevToolsEndpointTest, MovesOffTakenPorts) {
+    int port = 0;
+    int listener = ListenOnLoopback(0, &port);
+    ASSERT_GE(listener, 0);
+    EXPECT_GT(port, 0);
+
+    // A second instance cannot take the same port
+    int taken_port = 0;
+    EXPECT_EQ(ListenOnLoopback(port, &taken_port), -1);
+
+    int free_port = FindFreeLoopbackPort();
+    EXPECT_GT(free_port, 0);
+    EXPECT_NE(free_port, port);
+    CloseSocket(listener);
+
+    EXPECT_EQ(ListenOnLoopback(70000, &port), -1);
+}
+#endif
+
+TEST(DevToolsEndpointTest, WritesDiscoveryFile) {
+    DevToolsEndpoint endpoint;
+    endpoint.transport = "tcp";
+    endpoint.port = 40123;
+    EXPECT_EQ(FormatDevToolsDiscovery(endpoint, 42),
+              R"({"pid":42,"transport":"tcp","host":"127.0.0.1","port":40123,)"
+              R"("url":"http://127.0.0.1:40123","lazy":false})");
+
+    endpoint.transport = "pipe";
+    EXPECT_EQ(FormatDevToolsDiscovery(endpoint, 42),
+              R"({"pid":42,"transport":"pipe","read_fd":3,"write_fd":4})");
+
+    const std::string path = ::testing::TempDir() + "/DevToolsEndpoint.json";
+    ASSERT_TRUE(WriteDevToolsDiscoveryFile(path, "{}"));
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    EXPECT_EQ(contents.str(), "{}");
+    std::remove(path.c_str());
+}
@@ -0,0 +1,53 @@
+// CEF Browser - Unit Tests for the DevTools Message Scanner
+#include <gtest/gtest.h>
+
+#include "devtools_message.h"
+
+TEST(DevToolsMessageTest, ScansResults) {
+    DevToolsMessageView view;
+    ASSERT_TRUE(ScanDevToolsMessage(
+        R"({"id":12,"result":{"result":{"type":"number","value":2}},"sessionId":"A"})", &view));
+    EXPECT_EQ(view.id, 12);
+    EXPECT_FALSE(view.is_event());
+    EXPECT_EQ(view.result, R"({"result":{"type":"number","value":2}})");
+    EXPECT_TRUE(view.error.empty());
+
+    ASSERT_TRUE(ScanDevToolsMessage(
+        R"( { "id" : 3 , "error" : {"code":-32601,"message":"'Foo.bar' wasn't found"} } )",
+        &view));
+    EXPECT_EQ(view.id, 3);
+    EXPECT_EQ(view.error, R"({"code":-32601,"message":"'Foo.bar' wasn't found"})");
+    EXPECT_TRUE(view.result.empty());
+}
+
+TEST(DevToolsMessageTest, ScansEventsWithoutParsingParams) {
+    DevToolsMessageView view;
+    // Brackets and quotes inside strings do not end the params
+    ASSERT_TRUE(ScanDevToolsMessage(
+        R"({"method":"Runtime.consoleAPICalled","params":{"args":[{"value":"}]\"{["}],)"
+        R"("n":[1,[2,{}]],"ok":true}})",
+        &view));
+    EXPECT_TRUE(view.is_event());
+    EXPECT_EQ(view.method, "Runtime.consoleAPICalled");
+    EXPECT_EQ(view.params,
+              R"({"args":[{"value":"}]\"{["}],"n":[1,[2,{}]],"ok":true})");
+
+    // Nested members named like top-level ones are skipped
+    ASSERT_TRUE(ScanDevToolsMessage(
+        R"({"params":{"id":5,"method":"x"},"method":"Page.loadEventFired"})", &view));
+    EXPECT_EQ(view.id, 0);
+    EXPECT_EQ(view.method, "Page.loadEventFired");
+
+    ASSERT_TRUE(ScanDevToolsMessage("{}", &view));
+    EXPECT_FALSE(view.is_event());
+}
+
+TEST(DevToolsMessageTest, RejectsMalformedMessages) {
+    DevToolsMessageView view;
+    EXPECT_FALSE(ScanDevToolsMessage("", &view));
+    EXPECT_FALSE(ScanDevToolsMessage("[1,2]", &view));
+    EXPECT_FALSE(ScanDevToolsMessage(R"({"id":1,"result":{"a":1})", &view));
+    EXPECT_FALSE(ScanDevToolsMessage(R"({"method":"Page.x","params":"unterminated})", &view));
+    EXPECT_FALSE(ScanDevToolsMessage(R"({"method":5})", &view));
+    EXPECT_FALSE(ScanDevToolsMessage(R"({"id" 1})", &view));
+}
@@ -0,0 +1,118 @@
+// CEF Browser - Unit Tests for the epoll Event Loop
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "event_loop.h"
+
+using namespace std::chrono_literals;
+
+TEST(EventLoopTest, RunsTasksPostedFromOtherThreads) {
+    EventLoop loop;
+    ASSERT_TRUE(loop.Init());
+
+    std::vector<int> order;
+    std::thread poster([&] {
+        for (int i = 0; i < 100; ++i) {
+            loop.PostTask([&order, i] { order.push_back(i); });
+        }
+        loop.PostTask([&loop] { loop.Quit(); });
+    });
+    loop.Run();
+    poster.join();
+
+    ASSERT_EQ(order.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST(EventLoopTest, RunsTimersInDeadlineOrder) {
+    EventLoop loop;
+    ASSERT_TRUE(loop.Init());
+
+    std::string fired;
+    const auto start = EventLoop::Clock::now();
+    loop.AddTimer(30ms, [&] {
+        fired += "c";
+        loop.Quit();
+    });
+    loop.AddTimer(10ms, [&] { fired += "a"; });
+    uint64_t cancelled = loop.AddTimer(5ms, [&] { fired += "x"; });
+    loop.AddTimer(20ms, [&] { fired += "b"; });
+    loop.CancelTimer(cancelled);
+    loop.Run();
+
+    EXPECT_EQ(fired, "abc");
+    EXPECT_GE(EventLoop::Clock::now() - start, 30ms);
+}
+
+TEST(EventLoopTest, TimerCanRescheduleItself) {
+    EventLoop loop;
+    ASSERT_TRUE(loop.Init());
+
+    int count = 0;
+    std::function<void()> tick = [&] {
+        if (++count == 5) {
+            loop.Quit();
+        } else {
+            loop.AddTimer(1ms, tick);
+        }
+    };
+    loop.AddTimer(0ms, tick);
+    loop.Run();
+    EXPECT_EQ(count, 5);
+}
+
+TEST(EventLoopTest, DispatchesFdEvents) {
+    EventLoop loop;
+    ASSERT_TRUE(loop.Init());
+
+    int fds[2];
+    ASSERT_EQ(pipe2(fds, O_NONBLOCK), 0);
+
+    std::string received;
+    ASSERT_TRUE(loop.AddFd(fds[0], EPOLLIN, [&](uint32_t events) {
+        EXPECT_TRUE(events & EPOLLIN);
+        char buffer[16];
+        ssize_t bytes = read(fds[0], buffer, sizeof(buffer));
+        received.append(buffer, bytes > 0 ? bytes : 0);
+        if (received == "ping") {
+            // A callback may remove its own watch
+            loop.RemoveFd(fds[0]);
+            loop.Quit();
+        }
+    }));
+
+    std::thread writer([&] {
+        std::this_thread::sleep_for(5ms);
+        ASSERT_EQ(write(fds[1], "ping", 4), 4);
+    });
+    loop.Run();
+    writer.join();
+
+    EXPECT_EQ(received, "ping");
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(EventLoopTest, IdleLoopDoesNotWake) {
+    EventLoop loop;
+    ASSERT_TRUE(loop.Init());
+
+    std::thread quitter([&] {
+        std::this_thread::sleep_for(50ms);
+        loop.Quit();
+    });
+    loop.Run();
+    quitter.join();
+
+    // Only the quit request wakes the loop
+    EXPECT_EQ(loop.wakeups(), 1u);
+}
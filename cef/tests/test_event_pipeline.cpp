@@ -0,0 +1,344 @@
+// CEF Browser - Unit Tests for the Browser Event Pipeline
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "event_pipeline.h"
+#include "json_writer.h"
+#include "mpsc_ring.h"
+
+namespace {
+
+// Records every event; optionally blocks deliveries until released
+class RecordingObserver : public BrowserEventObserver {
+public:
+    void OnBrowserEvent(const BrowserEvent& event) override {
+        std::unique_lock<std::mutex> lock(lock_);
+        blocked_.wait(lock, [this] { return !blocking_ || allowed_ > 0; });
+        if (blocking_) {
+            --allowed_;
+        }
+        events_.push_back(event);
+        changed_.notify_all();
+    }
+
+    void Block() {
+        std::lock_guard<std::mutex> lock(lock_);
+        blocking_ = true;
+        allowed_ = 0;
+    }
+
+    // Let |count| more deliveries through while blocking
+    void Allow(size_t count) {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            allowed_ += count;
+        }
+        blocked_.notify_all();
+    }
+
+    void Release() {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            blocking_ = false;
+        }
+        blocked_.notify_all();
+    }
+
+    // Wait until |count| events have arrived
+    bool WaitFor(size_t count) {
+        std::unique_lock<std::mutex> lock(lock_);
+        return changed_.wait_for(lock, std::chrono::seconds(5),
+                                 [&] { return events_.size() >= count; });
+    }
+
+    std::vector<BrowserEvent> events() {
+        std::lock_guard<std::mutex> lock(lock_);
+        return events_;
+    }
+
+private:
+    std::mutex lock_;
+    std::condition_variable blocked_;
+    std::condition_variable changed_;
+    bool blocking_ = false;
+    size_t allowed_ = 0;
+    std::vector<BrowserEvent> events_;
+};
+
+BrowserEvent MakeEvent(BrowserEventType type, int browser_id, int code = 0) {
+    BrowserEvent event(type, browser_id);
+    event.code = code;
+    return event;
+}
+
+}  // namespace
+
+TEST(MpscRingTest, PushesUntilFull) {
+    MpscRing<int> ring(3);
+    EXPECT_EQ(ring.capacity(), 4u);
+    EXPECT_TRUE(ring.empty());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.TryPush(i));
+    }
+    EXPECT_FALSE(ring.TryPush(4));
+
+    std::vector<int> values;
+    EXPECT_EQ(ring.Drain([&](int value) { values.push_back(value); }, 2), 2u);
+    EXPECT_EQ(values, (std::vector<int>{0, 1}));
+
+    // Freed slots are reused on the next lap
+    EXPECT_TRUE(ring.TryPush(4));
+    EXPECT_TRUE(ring.TryPush(5));
+    EXPECT_FALSE(ring.TryPush(6));
+    EXPECT_EQ(ring.Drain([&](int value) { values.push_back(value); }, 10), 4u);
+    EXPECT_EQ(values, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(MpscRingTest, KeepsEachProducersOrder) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+    MpscRing<std::pair<int, int>> ring(256);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&ring, p] {
+            for (int i = 0; i < kPerProducer;) {
+                if (ring.TryPush({p, i})) {
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(kProducers, 0);
+    int received = 0;
+    bool ordered = true;
+    while (received < kProducers * kPerProducer) {
+        received += static_cast<int>(ring.Drain(
+            [&](const std::pair<int, int>& value) {
+                ordered = ordered && value.second == next[value.first];
+                next[value.first] = value.second + 1;
+            },
+            64));
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(BrowserEventTest, TruncatesText) {
+    BrowserEvent event(BrowserEventType::kConsoleMessage, 1);
+    event.SetText("message", "source.js");
+    EXPECT_EQ(event.text(), "message");
+    EXPECT_EQ(event.secondary_text(), "source.js");
+    EXPECT_FALSE(event.truncated());
+
+    const std::string long_text(BrowserEvent::kTextCapacity + 10, 'x');
+    event.SetText("message", long_text);
+    EXPECT_EQ(event.text(), "message");
+    EXPECT_EQ(event.secondary_text().size(), BrowserEvent::kTextCapacity - 7);
+    EXPECT_TRUE(event.truncated());
+
+    event.SetText(long_text, "source.js");
+    EXPECT_EQ(event.text().size(), BrowserEvent::kTextCapacity);
+    EXPECT_EQ(event.secondary_text(), "");
+}
+
+TEST(BrowserEventTest, ConvertsUtf16TextWhenRead) {
+    BrowserEvent event(BrowserEventType::kConsoleMessage, 1);
+    event.SetText(u"caf\u00e9", u"app.js");
+    EXPECT_EQ(event.text(), "caf\xc3\xa9");
+    EXPECT_EQ(event.secondary_text(), "app.js");
+
+    const std::u16string long_text(BrowserEvent::kTextCapacity, u'x');
+    event.SetText(long_text);
+    EXPECT_EQ(event.text().size(), BrowserEvent::kTextCapacity / 2);
+    EXPECT_TRUE(event.truncated());
+
+    // Narrow text replaces it
+    event.SetText("plain");
+    EXPECT_EQ(event.text(), "plain");
+}
+
+TEST(BrowserEventTest, WritesJson) {
+    BrowserEvent event(BrowserEventType::kDownloadProgress, 3);
+    event.id = 7;
+    event.code = 50;
+    event.value = 512;
+    event.total = 1024;
+    event.SetText("/tmp/file.zip");
+
+    JsonWriter writer;
+    event.WriteJson(writer, event.time);
+    EXPECT_EQ(writer.str(),
+              "{\"type\":\"download_progress\",\"browser\":3,\"time_us\":0,\"id\":7,"
+              "\"file\":\"/tmp/file.zip\",\"percent\":50,\"received\":512,\"total\":1024,"
+              "\"state\":\"in_progress\"}");
+}
+
+TEST(BrowserEventTest, WritesRendererHangs) {
+    BrowserEvent event(BrowserEventType::kRendererHang, 2);
+    event.code = 1;
+    event.value = 4321;
+    event.SetText("https://a.test/");
+
+    JsonWriter writer;
+    event.WriteJson(writer, event.time);
+    EXPECT_EQ(writer.str(),
+              "{\"type\":\"renderer_hang\",\"browser\":2,\"time_us\":0,"
+              "\"url\":\"https://a.test/\",\"pid\":4321,\"closing\":true}");
+}
+
+TEST(EventPipelineTest, DeliversEachBrowsersEventsInOrder) {
+    EventPipelineOptions options;
+    options.workers = 3;
+    EventPipeline pipeline(options);
+    RecordingObserver observer;
+    pipeline.AddObserver(&observer);
+    EXPECT_TRUE(pipeline.has_observers());
+    pipeline.Start();
+
+    for (int i = 0; i < 100; ++i) {
+        for (int browser_id = 1; browser_id <= 5; ++browser_id) {
+            EXPECT_TRUE(pipeline.Publish(MakeEvent(BrowserEventType::kLoadEnd, browser_id, i)));
+        }
+    }
+    ASSERT_TRUE(observer.WaitFor(500));
+    pipeline.Stop();
+
+    std::map<int, int> next;
+    for (const BrowserEvent& event : observer.events()) {
+        EXPECT_EQ(event.code, next[event.browser_id]++);
+    }
+    EXPECT_EQ(next.size(), 5u);
+
+    const EventPipelineStats stats = pipeline.GetStats();
+    EXPECT_EQ(stats.published, 500u);
+    EXPECT_EQ(stats.delivered, 500u);
+    EXPECT_EQ(stats.total_dropped(), 0u);
+}
+
+TEST(EventPipelineTest, DropsOrCoalescesWhenFull) {
+    EventPipelineOptions options;
+    options.workers = 1;
+    options.queue_size = 4;
+    options.max_coalesced = 2;
+    EventPipeline pipeline(options);
+    RecordingObserver observer;
+    pipeline.AddObserver(&observer);
+    pipeline.Start();
+
+    // The worker holds the first event, and its slot, while the rest of the
+    // ring fills up
+    observer.Block();
+    ASSERT_TRUE(pipeline.Publish(MakeEvent(BrowserEventType::kLoadStart, 1)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(pipeline.Publish(MakeEvent(BrowserEventType::kLoadEnd, 1, i)));
+    }
+    EXPECT_FALSE(pipeline.Publish(MakeEvent(BrowserEventType::kLoadEnd, 1, 3)));
+
+    // Progress of one download keeps only its latest event
+    for (int percent = 10; percent <= 50; percent += 10) {
+        BrowserEvent event = MakeEvent(BrowserEventType::kDownloadProgress, 1, percent);
+        event.id = 9;
+        EXPECT_TRUE(pipeline.Publish(event));
+    }
+    EXPECT_TRUE(pipeline.Publish(MakeEvent(BrowserEventType::kTitleChange, 1)));
+
+    // The coalescing table is full
+    BrowserEvent other = MakeEvent(BrowserEventType::kDownloadProgress, 1, 10);
+    other.id = 10;
+    EXPECT_FALSE(pipeline.Publish(other));
+
+    observer.Release();
+    ASSERT_TRUE(observer.WaitFor(6));
+    pipeline.Stop();
+
+    const std::vector<BrowserEvent> events = observer.events();
+    ASSERT_EQ(events.size(), 6u);
+    EXPECT_EQ(events[3].code, 2);
+    EXPECT_EQ(events[4].type, BrowserEventType::kDownloadProgress);
+    EXPECT_EQ(events[4].code, 50);
+    EXPECT_EQ(events[5].type, BrowserEventType::kTitleChange);
+
+    const EventPipelineStats stats = pipeline.GetStats();
+    EXPECT_EQ(stats.coalesced, 4u);
+    EXPECT_EQ(stats.dropped[static_cast<size_t>(BrowserEventType::kLoadEnd)], 1u);
+    EXPECT_EQ(stats.dropped[static_cast<size_t>(BrowserEventType::kDownloadProgress)], 1u);
+}
+
+TEST(EventPipelineTest, KeepsEachBrowsersOrderBehindCoalescedEvents) {
+    EventPipelineOptions options;
+    options.workers = 1;
+    options.queue_size = 4;
+    EventPipeline pipeline(options);
+    RecordingObserver observer;
+    pipeline.AddObserver(&observer);
+    pipeline.Start();
+
+    // Fill the ring behind a blocked delivery, so the title has to wait
+    observer.Block();
+    ASSERT_TRUE(pipeline.Publish(MakeEvent(BrowserEventType::kLoadStart, 1, 0)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    for (int i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(pipeline.Publish(MakeEvent(BrowserEventType::kLoadStart, 1, i)));
+    }
+    ASSERT_TRUE(pipeline.Publish(MakeEvent(BrowserEventType::kTitleChange, 1, 4)));
+    ASSERT_TRUE(pipeline.Publish(MakeEvent(BrowserEventType::kTitleChange, 2, 0)));
+
+    // One delivery frees a ring slot while the titles still wait
+    observer.Allow(1);
+    ASSERT_TRUE(observer.WaitFor(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Browser 1's events queue behind its title and replace it in order;
+    // browser 3 has nothing waiting and takes the free slot
+    ASSERT_TRUE(pipeline.Publish(MakeEvent(BrowserEventType::kLoadEnd, 1, 5)));
+    ASSERT_TRUE(pipeline.Publish(MakeEvent(BrowserEventType::kTitleChange, 1, 6)));
+    ASSERT_TRUE(pipeline.Publish(MakeEvent(BrowserEventType::kLoadError, 1, 7)));
+    ASSERT_TRUE(pipeline.Publish(MakeEvent(BrowserEventType::kLoadEnd, 3, 0)));
+
+    observer.Release();
+    ASSERT_TRUE(observer.WaitFor(8));
+    pipeline.Stop();
+
+    std::map<int, std::vector<int>> codes;
+    for (const BrowserEvent& event : observer.events()) {
+        codes[event.browser_id].push_back(event.code);
+    }
+    EXPECT_EQ(codes[1], (std::vector<int>{0, 1, 2, 3, 5, 6, 7}));
+    EXPECT_EQ(codes[2], std::vector<int>{0});
+    EXPECT_EQ(codes[3], std::vector<int>{0});
+
+    const EventPipelineStats stats = pipeline.GetStats();
+    EXPECT_EQ(stats.coalesced, 1u);
+    EXPECT_EQ(stats.total_dropped(), 0u);
+}
+
+TEST(EventPipelineTest, StopDeliversQueuedEvents) {
+    EventPipeline pipeline(EventPipelineOptions{});
+    RecordingObserver observer;
+    pipeline.AddObserver(&observer);
+    pipeline.Start();
+    for (int i = 0; i < 1000; ++i) {
+        pipeline.Publish(MakeEvent(BrowserEventType::kLoadStart, i));
+    }
+    pipeline.Stop();
+    EXPECT_EQ(observer.events().size(), 1000u);
+
+    EXPECT_FALSE(pipeline.Publish(MakeEvent(BrowserEventType::kLoadStart, 1)));
+    pipeline.RemoveObserver(&observer);
+    EXPECT_FALSE(pipeline.has_observers());
+}
@@ -0,0 +1,79 @@
+// CEF Browser - Unit Tests for the Off-screen Frame Buffer
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "frame_buffer.h"
+
+namespace {
+
+struct TestRect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+std::vector<uint8_t> MakeFrame(int width, int height, uint8_t value) {
+    return std::vector<uint8_t>(width * height * FrameBuffer::kBytesPerPixel, value);
+}
+
+uint8_t PixelAt(const FrameBuffer& frame, int x, int y) {
+    return frame.data()[y * frame.stride() + x * FrameBuffer::kBytesPerPixel];
+}
+
+}  // namespace
+
+TEST(FrameBufferTest, FirstPaintCopiesWholeFrame) {
+    FrameBuffer frame;
+    auto pixels = MakeFrame(8, 4, 7);
+    frame.Paint(pixels.data(), 8, 4, std::vector<TestRect>{});
+
+    EXPECT_EQ(frame.width(), 8);
+    EXPECT_EQ(frame.height(), 4);
+    EXPECT_EQ(frame.stride(), 32u);
+    EXPECT_EQ(PixelAt(frame, 7, 3), 7);
+    EXPECT_EQ(frame.frame_count(), 1u);
+}
+
+TEST(FrameBufferTest, CopiesOnlyDirtyRects) {
+    FrameBuffer frame;
+    auto pixels = MakeFrame(8, 4, 1);
+    frame.Paint(pixels.data(), 8, 4, std::vector<TestRect>{});
+
+    pixels = MakeFrame(8, 4, 2);
+    frame.Paint(pixels.data(), 8, 4, std::vector<TestRect>{{2, 1, 3, 2}});
+
+    EXPECT_EQ(PixelAt(frame, 2, 1), 2);
+    EXPECT_EQ(PixelAt(frame, 4, 2), 2);
+    EXPECT_EQ(PixelAt(frame, 1, 1), 1);
+    EXPECT_EQ(PixelAt(frame, 5, 2), 1);
+    EXPECT_EQ(PixelAt(frame, 2, 3), 1);
+    EXPECT_EQ(frame.frame_count(), 2u);
+}
+
+TEST(FrameBufferTest, ClipsRectsOutsideTheView) {
+    FrameBuffer frame;
+    auto pixels = MakeFrame(4, 4, 1);
+    frame.Paint(pixels.data(), 4, 4, std::vector<TestRect>{});
+
+    pixels = MakeFrame(4, 4, 3);
+    frame.Paint(pixels.data(), 4, 4, std::vector<TestRect>{{-2, 2, 4, 10}, {10, 0, 2, 2}});
+
+    EXPECT_EQ(PixelAt(frame, 0, 2), 3);
+    EXPECT_EQ(PixelAt(frame, 1, 3), 3);
+    EXPECT_EQ(PixelAt(frame, 2, 2), 1);
+    EXPECT_EQ(PixelAt(frame, 0, 1), 1);
+}
+
+TEST(FrameBufferTest, ResizeCopiesWholeFrame) {
+    FrameBuffer frame;
+    auto pixels = MakeFrame(4, 4, 1);
+    frame.Paint(pixels.data(), 4, 4, std::vector<TestRect>{});
+
+    pixels = MakeFrame(6, 2, 5);
+    frame.Paint(pixels.data(), 6, 2, std::vector<TestRect>{{0, 0, 1, 1}});
+
+    EXPECT_EQ(frame.width(), 6);
+    EXPECT_EQ(frame.height(), 2);
+    EXPECT_EQ(PixelAt(frame, 5, 1), 5);
+}
@@ -0,0 +1,78 @@
+// CEF Browser - Unit Tests for GPU Detection
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+#include "gpu_detection.h"
+
+namespace fs = std::filesystem;
+
+TEST(GpuDetectionTest, FindsRenderNodesAndDrivers) {
+    const fs::path root = fs::path(::testing::TempDir()) / "gpu_detection_test";
+    fs::remove_all(root);
+    fs::create_directories(root / "dev");
+    fs::create_directories(root / "sys" / "renderD129" / "device");
+    fs::create_directories(root / "drivers" / "amdgpu");
+    for (const char* name : {"card0", "renderD129", "renderD128"}) {
+        std::ofstream(root / "dev" / name);
+    }
+    fs::create_directory_symlink(root / "drivers" / "amdgpu",
+                                 root / "sys" / "renderD129" / "device" / "driver");
+
+    std::vector<DrmRenderNode> nodes =
+        FindRenderNodes((root / "dev").string(), (root / "sys").string());
+    ASSERT_EQ(nodes.size(), 2u);
+    EXPECT_EQ(fs::path(nodes[0].path).filename(), "renderD128");
+    EXPECT_EQ(nodes[0].driver, "");
+    EXPECT_EQ(fs::path(nodes[1].path).filename(), "renderD129");
+    EXPECT_EQ(nodes[1].driver, "amdgpu");
+
+    EXPECT_TRUE(FindRenderNodes((root / "missing").string()).empty());
+    fs::remove_all(root);
+}
+
+TEST(GpuDetectionTest, RecognizesSoftwareRenderers) {
+    EXPECT_TRUE(IsSoftwareGlRenderer("llvmpipe (LLVM 15.0.7, 256 bits)"));
+    EXPECT_TRUE(IsSoftwareGlRenderer("Google SwiftShader"));
+    EXPECT_TRUE(IsSoftwareGlRenderer("ANGLE (Google, Vulkan 1.3.0 (SwiftShader Device))"));
+    EXPECT_TRUE(IsSoftwareGlRenderer("Mesa softpipe"));
+    EXPECT_FALSE(IsSoftwareGlRenderer("Mesa Intel(R) UHD Graphics 630 (CFL GT2)"));
+    EXPECT_FALSE(IsSoftwareGlRenderer("NVIDIA GeForce RTX 3080/PCIe/SSE2"));
+
+    EXPECT_TRUE(IsSoftwareDrmDriver("vgem"));
+    EXPECT_TRUE(IsSoftwareDrmDriver("vkms"));
+    EXPECT_FALSE(IsSoftwareDrmDriver("i915"));
+}
+
+TEST(GpuDetectionTest, ProbeExplainsItsChoice) {
+    GpuProbeResult probe = ProbeGpu(5000);
+    EXPECT_FALSE(probe.reason.empty());
+    if (!probe.gl_renderer.empty()) {
+        EXPECT_EQ(probe.hardware, !IsSoftwareGlRenderer(probe.gl_renderer));
+    }
+}
+
+TEST(GpuDetectionTest, ProvidesRenderingConfigs) {
+    for (const std::string& name : GetRenderingConfigNames()) {
+        RenderingConfig config;
+        ASSERT_TRUE(GetRenderingConfig(name, &config)) << name;
+        EXPECT_EQ(config.name, name);
+        EXPECT_FALSE(config.switches.empty());
+    }
+
+    RenderingConfig software;
+    ASSERT_TRUE(GetRenderingConfig("software", &software));
+    auto has = [&](const char* name) {
+        for (const CommandLineSwitch& entry : software.switches) {
+            if (entry.name == name) {
+                return true;
+            }
+        }
+        return false;
+    };
+    EXPECT_TRUE(has("disable-gpu-compositing"));
+    EXPECT_FALSE(has("enable-gpu"));
+
+    RenderingConfig unknown;
+    EXPECT_FALSE(GetRenderingConfig("vulkan", &unknown));
+}
@@ -0,0 +1,111 @@
+// CEF Browser - Unit Tests for Histograms and the JSON Writer
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+
+#include "histogram.h"
+#include "json_writer.h"
+
+TEST(HistogramTest, SmallValuesAreExact) {
+    for (uint64_t value = 0; value < 128; ++value) {
+        EXPECT_EQ(Histogram::BucketUpperBound(Histogram::BucketIndex(value)), value);
+    }
+}
+
+TEST(HistogramTest, BucketsBoundRelativeError) {
+    size_t last_index = 0;
+    for (uint64_t value = 1; value < Histogram::kMaxValue; value = value * 3 / 2 + 1) {
+        size_t index = Histogram::BucketIndex(value);
+        EXPECT_GE(index, last_index);
+        last_index = index;
+
+        uint64_t upper = Histogram::BucketUpperBound(index);
+        EXPECT_GE(upper, value);
+        EXPECT_LE(static_cast<double>(upper - value) / value, 1.0 / 64) << value;
+    }
+    EXPECT_EQ(Histogram::BucketUpperBound(Histogram::BucketIndex(Histogram::kMaxValue)),
+              Histogram::kMaxValue);
+}
+
+TEST(HistogramTest, Percentiles) {
+    Histogram histogram;
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.Record(value);
+    }
+
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_EQ(histogram.min(), 1u);
+    EXPECT_EQ(histogram.max(), 1000u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 500.5);
+    EXPECT_NEAR(histogram.ValueAtPercentile(50.0), 500, 8);
+    EXPECT_NEAR(histogram.ValueAtPercentile(99.0), 990, 16);
+    EXPECT_EQ(histogram.ValueAtPercentile(100.0), 1000u);
+    EXPECT_EQ(histogram.ValueAtPercentile(0.0), 1u);
+}
+
+TEST(HistogramTest, EmptyHistogram) {
+    Histogram histogram;
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.min(), 0u);
+    EXPECT_EQ(histogram.ValueAtPercentile(99.0), 0u);
+    EXPECT_EQ(histogram.mean(), 0.0);
+}
+
+TEST(HistogramTest, ClampsLargeValues) {
+    Histogram histogram;
+    histogram.Record(UINT64_MAX);
+    EXPECT_EQ(histogram.max(), Histogram::kMaxValue);
+    EXPECT_EQ(histogram.ValueAtPercentile(50.0), Histogram::kMaxValue);
+}
+
+TEST(HistogramTest, MergeAndReset) {
+    Histogram a;
+    Histogram b;
+    a.Record(10);
+    b.Record(5);
+    b.RecordCount(20, 2);
+
+    a.Merge(b);
+    EXPECT_EQ(a.count(), 4u);
+    EXPECT_EQ(a.min(), 5u);
+    EXPECT_EQ(a.max(), 20u);
+    EXPECT_EQ(a.ValueAtPercentile(50.0), 10u);
+
+    a.Reset();
+    EXPECT_EQ(a.count(), 0u);
+    EXPECT_EQ(a.max(), 0u);
+}
+
+TEST(JsonWriterTest, WritesNestedContainers) {
+    JsonWriter writer;
+    writer.BeginObject();
+    writer.Key("a").Int(-1);
+    writer.Key("b").BeginArray().Uint(1).Bool(true).Null().EndArray();
+    writer.Key("c").BeginObject().EndObject();
+    writer.Key("d").Double(0.5);
+    writer.EndObject();
+    EXPECT_EQ(writer.str(), "{\"a\":-1,\"b\":[1,true,null],\"c\":{},\"d\":0.5}");
+}
+
+TEST(JsonWriterTest, EscapesStrings) {
+    JsonWriter writer;
+    writer.String(std::string("q\"b\\n\n\x01", 7));
+    EXPECT_EQ(writer.str(), "\"q\\\"b\\\\n\\n\\u0001\"");
+}
+
+TEST(JsonWriterTest, NonFiniteDoublesAreNull) {
+    JsonWriter writer;
+    writer.BeginArray().Double(1.0 / 0.0).EndArray();
+    EXPECT_EQ(writer.str(), "[null]");
+}
+
+TEST(JsonWriterTest, HistogramSummary) {
+    Histogram histogram;
+    histogram.Record(7);
+
+    JsonWriter writer;
+    histogram.WriteJson(writer);
+    EXPECT_EQ(writer.str(),
+              "{\"count\":1,\"min\":7,\"mean\":7,\"p50\":7,\"p90\":7,\"p99\":7,\"p999\":7,"
+              "\"max\":7}");
+}
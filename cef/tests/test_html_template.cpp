@@ -0,0 +1,68 @@
+// CEF Browser - Unit Tests for HTML Templates and Internal Pages
+#include <gtest/gtest.h>
+#include <string>
+
+#include "html_template.h"
+#include "internal_pages.h"
+
+namespace {
+
+constexpr std::string_view kGreetingSource = "<p title=\"{{title}}\">Hello, {{name}}!</p>";
+constexpr HtmlTemplate<CountTemplateSlots(kGreetingSource)> kGreeting(kGreetingSource);
+
+static_assert(CountTemplateSlots(kGreetingSource) == 2, "two slots");
+static_assert(kGreeting.static_size() == kGreetingSource.size() - 17, "markers are stripped");
+static_assert(kGreeting.slot_name(0) == "title", "slots are named in order");
+
+}  // namespace
+
+TEST(HtmlTemplateTest, RendersSlotsInOrder) {
+    EXPECT_EQ(kGreeting.Render({"greeting", "world"}), "<p title=\"greeting\">Hello, world!</p>");
+}
+
+TEST(HtmlTemplateTest, EscapesSlotValues) {
+    EXPECT_EQ(kGreeting.Render({"a\"b", "<script>alert('x')</script>&"}),
+              "<p title=\"a&#34;b\">Hello, "
+              "&lt;script&gt;alert(&#39;x&#39;)&lt;/script&gt;&amp;!</p>");
+}
+
+TEST(HtmlTemplateTest, RendersIntoExactlySizedBuffer) {
+    std::string html = kGreeting.Render({"<>", "&"});
+    EXPECT_EQ(html.size(), kGreeting.static_size() + HtmlEscapedLength("<>") +
+                               HtmlEscapedLength("&"));
+}
+
+TEST(HtmlTemplateTest, TemplateWithoutSlots) {
+    constexpr std::string_view kSource = "<html></html>";
+    constexpr HtmlTemplate<CountTemplateSlots(kSource)> page(kSource);
+    EXPECT_EQ(page.Render({}), "<html></html>");
+}
+
+TEST(InternalPagesTest, ErrorPageEscapesErrorText) {
+    auto page = BuildInternalPage("error.html", "code=-105&text=%3Cb%3Ebad%3C%2Fb%3E");
+    ASSERT_TRUE(page);
+    EXPECT_NE(page->find("&lt;b&gt;bad&lt;/b&gt; (-105)"), std::string::npos);
+    EXPECT_EQ(page->find("<b>bad"), std::string::npos);
+}
+
+TEST(InternalPagesTest, ErrorPagesAreCachedByErrorCode) {
+    auto first = BuildInternalPage("error.html", "code=-106&text=ERR_INTERNET_DISCONNECTED&url=a");
+    auto second = BuildInternalPage("error.html", "code=-106&text=ERR_INTERNET_DISCONNECTED&url=b");
+    EXPECT_EQ(first.get(), second.get());
+
+    auto other = BuildInternalPage("error.html", "code=-105&text=ERR_NAME_NOT_RESOLVED");
+    EXPECT_NE(first.get(), other.get());
+}
+
+TEST(InternalPagesTest, UnknownPathsAreNotGenerated) {
+    EXPECT_FALSE(BuildInternalPage("blank.html", ""));
+}
+
+TEST(InternalPagesTest, ErrorPageURLRoundTripsQueryValues) {
+    std::string url = GetErrorPageURL(-105, "ERR_NAME_NOT_RESOLVED", "https://a.test/?x=1&y=2");
+    std::string query = url.substr(url.find('?') + 1);
+    EXPECT_EQ(GetQueryValue(query, "code"), "-105");
+    EXPECT_EQ(GetQueryValue(query, "text"), "ERR_NAME_NOT_RESOLVED");
+    EXPECT_EQ(GetQueryValue(query, "url"), "https://a.test/?x=1&y=2");
+    EXPECT_EQ(GetQueryValue(query, "missing"), "");
+}
@@ -0,0 +1,151 @@
+// CEF Browser - Unit Tests for the HTTP Record/Replay Archive
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "http_archive.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+HttpExchange Exchange(const std::string& url, const std::string& body, int status = 200) {
+    HttpExchange exchange;
+    exchange.url = url;
+    exchange.status = status;
+    exchange.status_text = status == 200 ? "OK" : "Found";
+    exchange.mime_type = "text/html";
+    exchange.headers = {{"Content-Type", "text/html; charset=utf-8"}, {"X-Test", "1"}};
+    exchange.body = body;
+    return exchange;
+}
+
+}  // namespace
+
+TEST(HttpArchiveKeyTest, NormalizesUrl) {
+    std::string query;
+    EXPECT_EQ(GetHttpArchiveKey("GET", "HTTPS://Example.COM/Path/A?b=2&a=1&_=123#top", &query),
+              "GET https://example.com/Path/A");
+    EXPECT_EQ(query, "a=1&b=2");
+
+    EXPECT_EQ(GetHttpArchiveKey("POST", "https://example.com", &query),
+              "POST https://example.com/");
+    EXPECT_EQ(query, "");
+
+    EXPECT_EQ(GetHttpArchiveKey("GET", "https://a.test/x?cb=1&&ts=2", &query),
+              "GET https://a.test/x");
+    EXPECT_EQ(query, "");
+}
+
+class HttpArchiveTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (fs::path(::testing::TempDir()) / "http_archive_test.cbha").string();
+    }
+
+    void TearDown() override {
+        fs::remove(path_);
+    }
+
+    std::string path_;
+};
+
+TEST_F(HttpArchiveTest, RoundTripsResponses) {
+    std::string binary(100000, '\0');
+    for (size_t i = 0; i < binary.size(); ++i) {
+        binary[i] = static_cast<char>(i * 131);
+    }
+
+    HttpArchiveWriter writer;
+    HttpExchange page = Exchange("https://a.test/", "<html>a</html>");
+    page.start_us = 10;
+    page.response_us = 200;
+    page.complete_us = 350;
+    writer.Add(page);
+    writer.Add(Exchange("https://a.test/image.bin", binary));
+    HttpExchange redirect = Exchange("https://a.test/old", "", 302);
+    redirect.headers = {{"Location", "https://a.test/"}};
+    writer.Add(redirect);
+    ASSERT_TRUE(writer.Write(path_));
+
+    HttpArchive archive;
+    ASSERT_TRUE(archive.Open(path_));
+    EXPECT_EQ(archive.GetEntryCount(), 3u);
+
+    HttpArchiveResponse response;
+    ASSERT_TRUE(archive.Lookup("GET", "https://a.test/", &response));
+    EXPECT_EQ(response.status, 200);
+    EXPECT_EQ(response.status_text, "OK");
+    EXPECT_EQ(response.mime_type, "text/html");
+    EXPECT_EQ(response.body, "<html>a</html>");
+    ASSERT_EQ(response.headers.size(), 2u);
+    EXPECT_EQ(response.headers[0].first, "Content-Type");
+    EXPECT_EQ(response.headers[0].second, "text/html; charset=utf-8");
+
+    ASSERT_TRUE(archive.Lookup("GET", "https://a.test/image.bin", &response));
+    EXPECT_EQ(response.body, binary);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(response.body.data()) % 16, 0u);
+
+    ASSERT_TRUE(archive.Lookup("GET", "https://a.test/old", &response));
+    EXPECT_EQ(response.status, 302);
+    EXPECT_TRUE(response.body.empty());
+
+    EXPECT_FALSE(archive.Lookup("GET", "https://a.test/missing", &response));
+    EXPECT_FALSE(archive.Lookup("POST", "https://a.test/", &response));
+}
+
+TEST_F(HttpArchiveTest, RepeatsInRecordingOrder) {
+    HttpArchiveWriter writer;
+    writer.Add(Exchange("https://a.test/counter", "1"));
+    writer.Add(Exchange("https://a.test/other", "x"));
+    writer.Add(Exchange("https://a.test/counter", "2"));
+    ASSERT_TRUE(writer.Write(path_));
+
+    HttpArchive archive;
+    ASSERT_TRUE(archive.Open(path_));
+    HttpArchiveResponse response;
+    ASSERT_TRUE(archive.Lookup("GET", "https://a.test/counter", &response));
+    EXPECT_EQ(response.body, "1");
+    ASSERT_TRUE(archive.Lookup("GET", "https://a.test/counter", &response));
+    EXPECT_EQ(response.body, "2");
+    ASSERT_TRUE(archive.Lookup("GET", "https://a.test/counter", &response));
+    EXPECT_EQ(response.body, "2");
+}
+
+TEST_F(HttpArchiveTest, ToleratesQueryNoise) {
+    HttpArchiveWriter writer;
+    writer.Add(Exchange("https://a.test/api?page=1&session=abc&_=111", "page1"));
+    writer.Add(Exchange("https://a.test/api?page=2&session=abc&_=222", "page2"));
+    ASSERT_TRUE(writer.Write(path_));
+
+    HttpArchive archive;
+    ASSERT_TRUE(archive.Open(path_));
+    HttpArchiveResponse response;
+
+    // Cache busters are ignored and parameter order does not matter
+    ASSERT_TRUE(archive.Lookup("GET", "https://a.test/api?_=999&session=abc&page=2", &response));
+    EXPECT_EQ(response.body, "page2");
+
+    // A changed session id falls back to the closest recorded query
+    ASSERT_TRUE(archive.Lookup("GET", "https://a.test/api?page=1&session=xyz", &response));
+    EXPECT_EQ(response.body, "page1");
+}
+
+TEST_F(HttpArchiveTest, RejectsCorruptArchives) {
+    HttpArchiveWriter writer;
+    writer.Add(Exchange("https://a.test/", "body"));
+    ASSERT_TRUE(writer.Write(path_));
+
+    // Truncate into the index
+    fs::resize_file(path_, sizeof(HttpArchiveHeader) + 8);
+    HttpArchive archive;
+    EXPECT_FALSE(archive.Open(path_));
+
+    {
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        out << "not an archive at all";
+    }
+    EXPECT_FALSE(archive.Open(path_));
+    EXPECT_FALSE(archive.Open(path_ + ".missing"));
+}
@@ -0,0 +1,311 @@
+// CEF Browser - Unit Tests for the Console Log Sink
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log_sink.h"
+#include "utf16.h"
+
+#if defined(HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// cef_log_severity_t
+constexpr int kWarning = 3;
+
+}  // namespace
+
+TEST(Utf16Test, ConvertsToUtf8) {
+    EXPECT_EQ(Utf16ToUtf8(u"plain ascii"), "plain ascii");
+    EXPECT_EQ(Utf16ToUtf8(u"café €"), "caf\xc3\xa9 \xe2\x82\xac");
+    EXPECT_EQ(Utf16ToUtf8(u"\U0001F600"), "\xf0\x9f\x98\x80");
+
+    // Unpaired surrogates
+    const char16_t lone[] = {u'a', 0xD83D, u'b', 0xDE00};
+    EXPECT_EQ(Utf16ToUtf8(std::u16string_view(lone, 4)), "a\xef\xbf\xbd" "b\xef\xbf\xbd");
+}
+
+TEST(Utf16Test, PrefixKeepsSurrogatePairs) {
+    const std::u16string text = u"ab\U0001F600c";
+    EXPECT_EQ(Utf16PrefixLength(text, 10), 5u);
+    EXPECT_EQ(Utf16PrefixLength(text, 4), 4u);
+    EXPECT_EQ(Utf16PrefixLength(text, 3), 2u);
+    EXPECT_EQ(Utf16PrefixLength(text, 0), 0u);
+}
+
+TEST(LogRecordTest, ReservesRoomForSource) {
+    LogRecord record;
+    record.SetText(u"message", u"app.js");
+    EXPECT_EQ(record.message(), u"message");
+    EXPECT_EQ(record.source(), u"app.js");
+    EXPECT_FALSE(record.truncated());
+
+    const std::u16string long_message(LogRecord::kTextCapacity, u'm');
+    const std::u16string long_source(LogRecord::kTextCapacity, u's');
+    record.SetText(long_message, u"app.js");
+    EXPECT_EQ(record.message().size(), LogRecord::kTextCapacity - 6);
+    EXPECT_EQ(record.source(), u"app.js");
+    EXPECT_TRUE(record.truncated());
+
+    record.SetText(u"message", long_source);
+    EXPECT_EQ(record.message(), u"message");
+    EXPECT_EQ(record.source().size(), LogRecord::kTextCapacity - 7);
+
+    record.SetText(long_message, long_source);
+    EXPECT_EQ(record.source().size(), LogRecord::kSourceReserve);
+}
+
+TEST(LogSinkTest, NamesRotatedFiles) {
+    EXPECT_EQ(GetRotatedLogPath("/tmp/console.log.gz", 0), "/tmp/console.log.gz");
+    EXPECT_EQ(GetRotatedLogPath("/tmp/console.log.gz", 2), "/tmp/console.log.2.gz");
+    EXPECT_EQ(GetRotatedLogPath("/tmp/console.log", 1), "/tmp/console.log.1");
+}
+
+class LogSinkFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::path(::testing::TempDir()) / "log_sink_test";
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+
+    LogSinkOptions MakeOptions(const std::string& name) {
+        LogSinkOptions options;
+        options.path = (dir_ / name).string();
+        options.compress = false;
+        return options;
+    }
+
+    static std::vector<std::string> ReadLines(const std::string& path) {
+        std::ifstream in(path);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(in, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    // Whether |line| ends with |suffix|
+    static bool EndsWith(const std::string& line, const std::string& suffix) {
+        return line.size() >= suffix.size() &&
+               line.compare(line.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    fs::path dir_;
+};
+
+TEST_F(LogSinkFileTest, WritesOneLinePerMessage) {
+    std::unique_ptr<LogSink> sink = LogSink::Open(MakeOptions("console.log"));
+    ASSERT_TRUE(sink);
+    EXPECT_TRUE(sink->Append(3, kWarning, u"café loaded", u"https://a.test/app.js", 12));
+    EXPECT_TRUE(sink->Append(3, kWarning, u"first\nsecond", u"https://a.test/app.js", 13));
+    sink->Flush();
+
+    const std::vector<std::string> lines = ReadLines((dir_ / "console.log").string());
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_TRUE(EndsWith(lines[0], "Z WARNING [3] https://a.test/app.js:12 caf\xc3\xa9 loaded"))
+        << lines[0];
+    EXPECT_TRUE(EndsWith(lines[1], " https://a.test/app.js:13 first\\nsecond")) << lines[1];
+
+    const LogSinkStats stats = sink->GetStats();
+    EXPECT_EQ(stats.appended, 2u);
+    EXPECT_EQ(stats.written, 2u);
+    EXPECT_GT(stats.bytes_written, 0u);
+}
+
+TEST_F(LogSinkFileTest, CollapsesRepeatedMessages) {
+    std::unique_ptr<LogSink> sink = LogSink::Open(MakeOptions("console.log"));
+    ASSERT_TRUE(sink);
+    for (int i = 0; i < 5; ++i) {
+        sink->Append(1, kWarning, u"tick", u"app.js", 7);
+    }
+    sink->Append(1, kWarning, u"tock", u"app.js", 7);
+    sink->Append(1, kWarning, u"tock", u"app.js", 7);
+    sink->Flush();
+
+    const std::vector<std::string> lines = ReadLines((dir_ / "console.log").string());
+    ASSERT_EQ(lines.size(), 4u);
+    EXPECT_TRUE(EndsWith(lines[0], " app.js:7 tick"));
+    EXPECT_TRUE(EndsWith(lines[1], " app.js:7 last message repeated 4 times"));
+    EXPECT_TRUE(EndsWith(lines[2], " app.js:7 tock"));
+    EXPECT_TRUE(EndsWith(lines[3], " app.js:7 last message repeated 1 time"));
+    EXPECT_EQ(sink->GetStats().deduplicated, 5u);
+}
+
+TEST_F(LogSinkFileTest, RateLimitsEachSourceLocation) {
+    LogSinkOptions options = MakeOptions("console.log");
+    options.burst = 3;
+    options.rate = 100;
+    std::unique_ptr<LogSink> sink = LogSink::Open(options);
+    ASSERT_TRUE(sink);
+
+    int admitted = 0;
+    for (int i = 0; i < 10; ++i) {
+        admitted += sink->Append(1, kWarning, u"spam " + std::u16string(1, u'0' + i), u"a.js", 1);
+    }
+    EXPECT_LE(admitted, 4);
+
+    // Other locations have their own budget
+    EXPECT_TRUE(sink->Append(1, kWarning, u"other", u"a.js", 2));
+    EXPECT_TRUE(sink->Append(1, kWarning, u"other", u"b.js", 1));
+
+    // The next message let through reports what was dropped
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(sink->Append(1, kWarning, u"later", u"a.js", 1));
+    sink->Flush();
+
+    const std::vector<std::string> lines = ReadLines((dir_ / "console.log").string());
+    ASSERT_FALSE(lines.empty());
+    EXPECT_TRUE(EndsWith(lines.back(), " a.js:1 later [rate limited: " +
+                                           std::to_string(10 - admitted) + " dropped]"))
+        << lines.back();
+    EXPECT_EQ(sink->GetStats().rate_limited, static_cast<uint64_t>(10 - admitted));
+}
+
+TEST_F(LogSinkFileTest, KeepsTheLimitsOfCollidingLocations) {
+    LogSinkOptions options = MakeOptions("console.log");
+    options.burst = 3;
+    options.rate = 10;
+    std::unique_ptr<LogSink> sink = LogSink::Open(options);
+    ASSERT_TRUE(sink);
+
+    // Two lines whose keys share a slot in any table of up to 256 sets
+    const int first = 1;
+    int second = first + 1;
+    while ((GetLogLocationKey(u"a.js", second) - GetLogLocationKey(u"a.js", first)) % 256) {
+        ++second;
+    }
+
+    // Alternating between them must not refill either bucket
+    int admitted[2] = {0, 0};
+    for (int i = 0; i < 10; ++i) {
+        admitted[0] += sink->Append(1, kWarning, u"one", u"a.js", first);
+        admitted[1] += sink->Append(1, kWarning, u"two", u"a.js", second);
+    }
+    EXPECT_LE(admitted[0], 4);
+    EXPECT_LE(admitted[1], 4);
+
+    // And each keeps its own count of what it dropped
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_TRUE(sink->Append(1, kWarning, u"one later", u"a.js", first));
+    EXPECT_TRUE(sink->Append(1, kWarning, u"two later", u"a.js", second));
+    sink->Flush();
+
+    const std::vector<std::string> lines = ReadLines((dir_ / "console.log").string());
+    ASSERT_GE(lines.size(), 2u);
+    EXPECT_TRUE(EndsWith(lines[lines.size() - 2],
+                         " a.js:1 one later [rate limited: " + std::to_string(10 - admitted[0]) +
+                             " dropped]"))
+        << lines[lines.size() - 2];
+    EXPECT_TRUE(EndsWith(lines.back(), " a.js:" + std::to_string(second) + " two later [rate " +
+                                           "limited: " + std::to_string(10 - admitted[1]) +
+                                           " dropped]"))
+        << lines.back();
+    EXPECT_EQ(sink->GetStats().rate_limited,
+              static_cast<uint64_t>(20 - admitted[0] - admitted[1]));
+}
+
+TEST_F(LogSinkFileTest, RotatesBySize) {
+    LogSinkOptions options = MakeOptions("console.log");
+    options.max_file_bytes = 200;
+    options.max_files = 2;
+    std::unique_ptr<LogSink> sink = LogSink::Open(options);
+    ASSERT_TRUE(sink);
+    for (int i = 0; i < 5; ++i) {
+        for (int line = 0; line < 3; ++line) {
+            sink->Append(1, kWarning, u"a message long enough to fill the file", u"a.js", line);
+        }
+        sink->Flush();
+    }
+    sink->Stop();
+
+    EXPECT_TRUE(fs::exists(dir_ / "console.log"));
+    EXPECT_TRUE(fs::exists(dir_ / "console.log.1"));
+    EXPECT_TRUE(fs::exists(dir_ / "console.log.2"));
+    EXPECT_FALSE(fs::exists(dir_ / "console.log.3"));
+    EXPECT_EQ(sink->GetStats().rotations, 5u);
+    EXPECT_EQ(ReadLines((dir_ / "console.log.1").string()).size(), 3u);
+
+    // Stopped sinks drop messages
+    EXPECT_FALSE(sink->Append(1, kWarning, u"late", u"a.js", 1));
+}
+
+TEST_F(LogSinkFileTest, KeepsEveryThreadsMessages) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 200;
+    LogSinkOptions options = MakeOptions("console.log");
+    options.flush_interval = std::chrono::milliseconds(1);
+    std::unique_ptr<LogSink> sink = LogSink::Open(options);
+    ASSERT_TRUE(sink);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&sink, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                // A location per message stays under the rate limit
+                sink->Append(t, kWarning, u"message", u"t.js", i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    sink->Stop();
+
+    const LogSinkStats stats = sink->GetStats();
+    EXPECT_EQ(stats.written + stats.dropped, static_cast<uint64_t>(kThreads * kPerThread));
+    EXPECT_EQ(ReadLines((dir_ / "console.log").string()).size(), stats.written);
+}
+
+#if defined(HAVE_ZLIB)
+TEST_F(LogSinkFileTest, WritesGzip) {
+    LogSinkOptions options = MakeOptions("console.log.gz");
+    options.compress = true;
+    std::unique_ptr<LogSink> sink = LogSink::Open(options);
+    ASSERT_TRUE(sink);
+    for (int line = 0; line < 100; ++line) {
+        sink->Append(1, kWarning, u"compressible message", u"a.js", line);
+    }
+    sink->Flush();
+    sink->Stop();
+
+    // Reopening appends a second gzip member
+    sink = LogSink::Open(options);
+    ASSERT_TRUE(sink);
+    sink->Append(1, kWarning, u"after restart", u"a.js", 1);
+    sink->Stop();
+
+    gzFile file = gzopen((dir_ / "console.log.gz").string().c_str(), "rb");
+    ASSERT_TRUE(file);
+    std::string text;
+    char buffer[4096];
+    int read;
+    while ((read = gzread(file, buffer, sizeof(buffer))) > 0) {
+        text.append(buffer, read);
+    }
+    gzclose(file);
+
+    std::istringstream in(text);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 101u);
+    EXPECT_TRUE(EndsWith(lines[99], " a.js:99 compressible message"));
+    EXPECT_TRUE(EndsWith(lines[100], " a.js:1 after restart"));
+    EXPECT_LT(fs::file_size(dir_ / "console.log.gz"), text.size());
+}
+#endif
@@ -0,0 +1,110 @@
+// CEF Browser - Unit Tests for Navigation Timing Metrics
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+
+#include "json_writer.h"
+#include "navigation_metrics.h"
+
+namespace {
+
+using std::chrono::milliseconds;
+
+std::string ToJson(const NavigationMetrics& metrics) {
+    JsonWriter writer;
+    metrics.WriteJson(writer);
+    return writer.str();
+}
+
+}  // namespace
+
+TEST(NavigationMetricsTest, GetHost) {
+    EXPECT_EQ(NavigationMetrics::GetHost("https://Example.COM/path?q#f"), "example.com");
+    EXPECT_EQ(NavigationMetrics::GetHost("http://user:pw@a.test:8080/"), "a.test");
+    EXPECT_EQ(NavigationMetrics::GetHost("http://[::1]:8080/x"), "[::1]");
+    EXPECT_EQ(NavigationMetrics::GetHost("app://internal"), "internal");
+    EXPECT_EQ(NavigationMetrics::GetHost("about:blank"), "");
+}
+
+TEST(NavigationMetricsTest, RecordsNavigationPhases) {
+    NavigationMetrics metrics;
+    auto start = NavigationMetrics::Clock::now();
+
+    metrics.OnNavigationStart(1, "https://a.test/", start);
+    metrics.OnCommit(1, "https://a.test/", start + milliseconds(10));
+    // A same-document navigation must not count as a second commit
+    metrics.OnCommit(1, "https://a.test/#x", start + milliseconds(15));
+    metrics.OnLoadEnd(1, start + milliseconds(20));
+    metrics.OnLoadingIdle(1, start + milliseconds(30));
+
+    std::string json = ToJson(metrics);
+    EXPECT_NE(json.find("\"a.test\":{\"navigations\":1,\"errors\":0,\"abandoned\":0,"
+                        "\"commit_us\":{\"count\":1,\"min\":10000"),
+              std::string::npos)
+        << json;
+    EXPECT_NE(json.find("\"load_end_us\":{\"count\":1,\"min\":20000"), std::string::npos);
+    EXPECT_NE(json.find("\"idle_us\":{\"count\":1,\"min\":30000"), std::string::npos);
+}
+
+TEST(NavigationMetricsTest, AttributesRedirectsToCommittedHost) {
+    NavigationMetrics metrics;
+    auto start = NavigationMetrics::Clock::now();
+
+    metrics.OnNavigationStart(1, "http://short.test/", start);
+    metrics.OnCommit(1, "https://long.test/", start + milliseconds(5));
+    metrics.OnLoadingIdle(1, start + milliseconds(6));
+
+    std::string json = ToJson(metrics);
+    EXPECT_EQ(json.find("short.test"), std::string::npos);
+    EXPECT_NE(json.find("\"long.test\":{\"navigations\":1"), std::string::npos);
+}
+
+TEST(NavigationMetricsTest, CountsErrorsAndAbandonedNavigations) {
+    NavigationMetrics metrics;
+    auto start = NavigationMetrics::Clock::now();
+
+    metrics.OnNavigationStart(1, "https://a.test/", start);
+    metrics.OnLoadError(1, -105, start + milliseconds(1));
+    metrics.OnLoadingIdle(1, start + milliseconds(2));
+
+    metrics.OnNavigationStart(1, "https://a.test/slow", start + milliseconds(3));
+    metrics.OnNavigationStart(1, "https://a.test/next", start + milliseconds(4));
+    // Aborted loads belong to the replaced navigation and are ignored
+    metrics.OnLoadError(1, -3, start + milliseconds(4));
+    metrics.OnBrowserClosed(1);
+
+    std::string json = ToJson(metrics);
+    EXPECT_NE(json.find("\"a.test\":{\"navigations\":3,\"errors\":1,\"abandoned\":2"),
+              std::string::npos)
+        << json;
+    EXPECT_NE(json.find("\"all\":{\"navigations\":3"), std::string::npos);
+}
+
+TEST(NavigationMetricsTest, BrowsersAreTimedIndependently) {
+    NavigationMetrics metrics;
+    auto start = NavigationMetrics::Clock::now();
+
+    metrics.OnNavigationStart(1, "https://a.test/", start);
+    metrics.OnNavigationStart(2, "https://b.test/", start + milliseconds(1));
+    metrics.OnLoadingIdle(1, start + milliseconds(7));
+    metrics.OnLoadingIdle(2, start + milliseconds(9));
+
+    std::string json = ToJson(metrics);
+    EXPECT_NE(json.find("\"a.test\":{\"navigations\":1,\"errors\":0,\"abandoned\":0"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"idle_us\":{\"count\":1,\"min\":8000"), std::string::npos);
+}
+
+TEST(NavigationMetricsTest, LimitsHostCount) {
+    NavigationMetrics metrics;
+    auto now = NavigationMetrics::Clock::now();
+
+    for (size_t i = 0; i < NavigationMetrics::kMaxHosts + 10; ++i) {
+        std::string url = "https://h" + std::to_string(i) + ".test/";
+        metrics.OnNavigationStart(1, url, now);
+        metrics.OnLoadingIdle(1, now);
+    }
+
+    std::string json = ToJson(metrics);
+    EXPECT_NE(json.find("\"(other)\":{\"navigations\":10"), std::string::npos);
+}
@@ -0,0 +1,134 @@
+// CEF Browser - Unit Tests for Page Readiness
+#include <gtest/gtest.h>
+#include <chrono>
+
+#include "page_readiness.h"
+
+namespace {
+
+using std::chrono::milliseconds;
+
+PageReadyCondition Parse(const char* spec) {
+    PageReadyCondition condition;
+    EXPECT_TRUE(ParsePageReadyCondition(spec, &condition)) << spec;
+    return condition;
+}
+
+}  // namespace
+
+TEST(PageReadinessTest, ParsesConditions) {
+    PageReadyCondition condition = Parse("network-idle-2-for-750-ms");
+    EXPECT_EQ(condition.max_inflight, 2);
+    EXPECT_EQ(condition.quiet_ms, 750);
+    EXPECT_FALSE(condition.dom_content_loaded);
+
+    condition = Parse("domcontentloaded+network-idle-0-for-100-ms");
+    EXPECT_EQ(condition.max_inflight, 0);
+    EXPECT_EQ(condition.quiet_ms, 100);
+    EXPECT_TRUE(condition.dom_content_loaded);
+
+    condition = Parse("domcontentloaded+idle");
+    EXPECT_EQ(condition.max_inflight, 0);
+    EXPECT_EQ(condition.quiet_ms, 500);
+    EXPECT_TRUE(condition.dom_content_loaded);
+
+    condition.timeout_ms = 1234;
+    for (const char* spec : {"", "idle", "network-idle-for-500-ms", "network-idle--1-for-5-ms",
+                             "network-idle-1-for-500", "network-idle-1-for-500-msx",
+                             "network-idle-1-for-9999999-ms", "load+network-idle-0-for-5-ms"}) {
+        EXPECT_FALSE(ParsePageReadyCondition(spec, &condition)) << spec;
+    }
+    EXPECT_EQ(condition.timeout_ms, 1234);
+    EXPECT_TRUE(condition.dom_content_loaded);
+}
+
+TEST(PageReadinessTest, WaitsForQuietNetwork) {
+    PageReadyCondition idle0 = Parse("network-idle-0-for-500-ms");
+    PageReadyCondition idle2 = Parse("network-idle-2-for-500-ms");
+    PageLoadState state;
+    auto start = PageLoadState::Clock::now();
+
+    state.OnNavigation(start);
+    EXPECT_EQ(state.page(), 1u);
+    EXPECT_EQ(state.ReadyAt(idle0), start + milliseconds(500));
+
+    for (uint64_t id = 1; id <= 4; ++id) {
+        state.OnRequestStarted(id);
+    }
+    // A redirect restarts a request under the same identifier
+    state.OnRequestStarted(1);
+    EXPECT_EQ(state.inflight(), 4u);
+    EXPECT_EQ(state.ReadyAt(idle0), PageLoadState::TimePoint::max());
+    EXPECT_EQ(state.ReadyAt(idle2), PageLoadState::TimePoint::max());
+
+    state.OnRequestFinished(1, start + milliseconds(100));
+    state.OnRequestFinished(2, start + milliseconds(200));
+    EXPECT_EQ(state.ReadyAt(idle2), start + milliseconds(700));
+
+    // Dropping further does not restart the quiet period of a higher limit
+    state.OnRequestFinished(3, start + milliseconds(300));
+    EXPECT_EQ(state.ReadyAt(idle2), start + milliseconds(700));
+
+    // Rising above the limit and dropping back does
+    state.OnRequestStarted(5);
+    state.OnRequestStarted(6);
+    state.OnRequestFinished(5, start + milliseconds(400));
+    EXPECT_EQ(state.ReadyAt(idle2), start + milliseconds(900));
+
+    state.OnRequestFinished(4, start + milliseconds(450));
+    state.OnRequestFinished(6, start + milliseconds(600));
+    EXPECT_EQ(state.ReadyAt(idle0), start + milliseconds(1100));
+
+    // Completions without a start are ignored
+    state.OnRequestFinished(42, start + milliseconds(700));
+    EXPECT_EQ(state.ReadyAt(idle0), start + milliseconds(1100));
+}
+
+TEST(PageReadinessTest, WaitsForDomContentLoaded) {
+    PageReadyCondition condition = Parse("domcontentloaded+network-idle-0-for-100-ms");
+    PageLoadState state;
+    auto start = PageLoadState::Clock::now();
+
+    state.OnNavigation(start);
+    EXPECT_EQ(state.ReadyAt(condition), PageLoadState::TimePoint::max());
+
+    state.OnDomContentLoaded(start + milliseconds(50));
+    EXPECT_TRUE(state.dom_content_loaded());
+    EXPECT_EQ(state.ReadyAt(condition), start + milliseconds(100));
+
+    state.OnDomContentLoaded(start + milliseconds(300));
+    state.OnRequestStarted(1);
+    state.OnRequestFinished(1, start + milliseconds(250));
+    EXPECT_EQ(state.ReadyAt(condition), start + milliseconds(350));
+
+    // Late DOMContentLoaded after a quiet network
+    state.OnNavigation(start + milliseconds(1000));
+    EXPECT_EQ(state.page(), 2u);
+    EXPECT_FALSE(state.dom_content_loaded());
+    EXPECT_EQ(state.ReadyAt(condition), PageLoadState::TimePoint::max());
+    state.OnDomContentLoaded(start + milliseconds(2000));
+    EXPECT_EQ(state.ReadyAt(condition), start + milliseconds(2000));
+}
+
+TEST(PageReadinessTest, NavigationRestartsQuietPeriod) {
+    PageReadyCondition condition = Parse("network-idle-0-for-500-ms");
+    PageLoadState state;
+    auto start = PageLoadState::Clock::now();
+
+    state.OnNavigation(start);
+    state.OnRequestStarted(1);
+    state.OnRequestStarted(2);
+    state.OnRequestFinished(1, start + milliseconds(100));
+
+    // A request of the previous page still holds up the new one
+    state.OnNavigation(start + milliseconds(200));
+    EXPECT_EQ(state.inflight(), 1u);
+    EXPECT_EQ(state.ReadyAt(condition), PageLoadState::TimePoint::max());
+
+    state.OnRequestFinished(2, start + milliseconds(300));
+    EXPECT_EQ(state.ReadyAt(condition), start + milliseconds(800));
+
+    state.OnNavigation(start + milliseconds(1000));
+    EXPECT_EQ(state.ReadyAt(condition), start + milliseconds(1500));
+    EXPECT_EQ(state.page_start(), start + milliseconds(1000));
+}
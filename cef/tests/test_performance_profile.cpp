@@ -0,0 +1,120 @@
+// CEF Browser - Unit Tests for Performance Profiles
+#include <gtest/gtest.h>
+#include <string>
+
+#include "performance_profile.h"
+
+namespace {
+
+constexpr uint64_t kGigabyte = uint64_t{1} << 30;
+
+HostResources Host(int cpu_count, uint64_t memory_gb) {
+    HostResources resources;
+    resources.cpu_count = cpu_count;
+    resources.memory_bytes = memory_gb * kGigabyte;
+    return resources;
+}
+
+std::string Value(const PerformanceProfile& profile, const char* name) {
+    const CommandLineSwitch* entry = profile.Find(name);
+    return entry ? entry->value : "<unset>";
+}
+
+}  // namespace
+
+TEST(PerformanceProfileTest, ParsesCgroupLimits) {
+    EXPECT_EQ(ParseCgroupCpuQuota("200000 100000\n"), 2);
+    EXPECT_EQ(ParseCgroupCpuQuota("150000 100000"), 2);
+    EXPECT_EQ(ParseCgroupCpuQuota("50000 100000"), 1);
+    EXPECT_EQ(ParseCgroupCpuQuota("max 100000"), 0);
+    EXPECT_EQ(ParseCgroupCpuQuota("-1 100000"), 0);
+    EXPECT_EQ(ParseCgroupCpuQuota(""), 0);
+
+    EXPECT_EQ(ParseCgroupMemoryLimit("2147483648\n"), 2 * kGigabyte);
+    EXPECT_EQ(ParseCgroupMemoryLimit("max\n"), 0u);
+    EXPECT_EQ(ParseCgroupMemoryLimit("9223372036854771712"), 0u);
+    EXPECT_EQ(ParseCgroupMemoryLimit(""), 0u);
+}
+
+TEST(PerformanceProfileTest, DetectsHost) {
+    HostResources resources = DetectHostResources();
+    EXPECT_GE(resources.cpu_count, 1);
+    EXPECT_GT(resources.memory_bytes, 0u);
+}
+
+TEST(PerformanceProfileTest, AutoFollowsHost) {
+    PerformanceProfile profile;
+    ASSERT_TRUE(GetPerformanceProfile("auto", Host(64, 256), true, &profile));
+    EXPECT_EQ(profile.name, "throughput");
+    ASSERT_TRUE(GetPerformanceProfile("auto", Host(8, 16), false, &profile));
+    EXPECT_EQ(profile.name, "low-latency");
+    ASSERT_TRUE(GetPerformanceProfile("auto", Host(4, 2), true, &profile));
+    EXPECT_EQ(profile.name, "low-memory");
+
+    EXPECT_FALSE(GetPerformanceProfile("fast", Host(4, 8), false, &profile));
+}
+
+TEST(PerformanceProfileTest, ScalesWithHost) {
+    PerformanceProfile profile;
+
+    // Large render host: one renderer per core, small heaps each
+    ASSERT_TRUE(GetPerformanceProfile("throughput", Host(64, 256), true, &profile));
+    EXPECT_EQ(Value(profile, "renderer-process-limit"), "64");
+    EXPECT_EQ(Value(profile, "num-raster-threads"), "1");
+    EXPECT_EQ(Value(profile, "js-flags"), "--max-old-space-size=2048");
+    EXPECT_EQ(Value(profile, "disable-renderer-backgrounding"), "");
+
+    // Memory bounds the renderer count before cores do
+    ASSERT_TRUE(GetPerformanceProfile("throughput", Host(64, 4), true, &profile));
+    EXPECT_EQ(Value(profile, "renderer-process-limit"), "8");
+    EXPECT_EQ(Value(profile, "num-raster-threads"), "4");
+    EXPECT_EQ(Value(profile, "js-flags"), "--max-old-space-size=256");
+
+    ASSERT_TRUE(GetPerformanceProfile("low-latency", Host(8, 16), false, &profile));
+    EXPECT_EQ(Value(profile, "renderer-process-limit"), "4");
+    EXPECT_EQ(Value(profile, "num-raster-threads"), "4");
+    EXPECT_EQ(Value(profile, "disable-smooth-scrolling"), "");
+
+    // 2 GB kiosk
+    ASSERT_TRUE(GetPerformanceProfile("low-memory", Host(4, 2), false, &profile));
+    EXPECT_EQ(Value(profile, "renderer-process-limit"), "2");
+    EXPECT_EQ(Value(profile, "num-raster-threads"), "1");
+    EXPECT_EQ(Value(profile, "js-flags"), "--max-old-space-size=256 --optimize-for-size");
+    EXPECT_EQ(Value(profile, "enable-low-end-device-mode"), "");
+
+    // Unknown memory falls back to a 4 GB assumption
+    ASSERT_TRUE(GetPerformanceProfile("auto", Host(1, 0), false, &profile));
+    EXPECT_EQ(profile.name, "low-latency");
+    EXPECT_EQ(Value(profile, "renderer-process-limit"), "1");
+}
+
+TEST(PerformanceProfileTest, AppliesConfigFile) {
+    PerformanceProfileConfig config;
+    int error_line = 0;
+    ASSERT_TRUE(ParsePerformanceProfileConfig("# kiosk\n"
+                                              "profile = low-latency\n"
+                                              "\n"
+                                              "renderer-process-limit = 3\n"
+                                              "--enable-features=Foo,Bar\n"
+                                              "  enable-experimental-web-platform-features\n"
+                                              "!disable-smooth-scrolling\n",
+                                              &config, &error_line));
+    EXPECT_EQ(config.profile, "low-latency");
+    ASSERT_EQ(config.overrides.size(), 3u);
+    EXPECT_EQ(config.overrides[1], (CommandLineSwitch{"enable-features", "Foo,Bar"}));
+    ASSERT_EQ(config.removals.size(), 1u);
+
+    PerformanceProfile profile;
+    ASSERT_TRUE(GetPerformanceProfile(config.profile, Host(8, 16), false, &profile));
+    ApplyPerformanceProfileConfig(config, &profile);
+    EXPECT_EQ(Value(profile, "renderer-process-limit"), "3");
+    EXPECT_EQ(Value(profile, "enable-experimental-web-platform-features"), "");
+    EXPECT_EQ(Value(profile, "disable-smooth-scrolling"), "<unset>");
+    EXPECT_EQ(profile.ToString(),
+              "renderer-process-limit=3 num-raster-threads=4 js-flags=--max-old-space-size=2048 "
+              "disable-renderer-backgrounding enable-features=Foo,Bar "
+              "enable-experimental-web-platform-features");
+
+    EXPECT_FALSE(ParsePerformanceProfileConfig("profile=auto\n= 3\n", &config, &error_line));
+    EXPECT_EQ(error_line, 2);
+}
@@ -0,0 +1,188 @@
+// CEF Browser - Unit Tests for Renderer Crash and Hang Recovery
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "json_writer.h"
+#include "renderer_recovery.h"
+
+namespace {
+
+using Clock = RendererRecovery::Clock;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+RendererRecoveryOptions MakeOptions() {
+    RendererRecoveryOptions options;
+    options.initial_backoff = milliseconds(100);
+    options.max_backoff = milliseconds(500);
+    options.quarantine_threshold = 3;
+    options.quarantine_window = seconds(60);
+    options.quarantine_duration = seconds(300);
+    options.hang_timeout = milliseconds(1000);
+    return options;
+}
+
+}  // namespace
+
+TEST(RendererRecoveryTest, BacksOffUntilALoadCompletes) {
+    RendererRecovery recovery(MakeOptions());
+    const Clock::time_point start = Clock::now();
+
+    // Different URLs, so quarantine stays out of the way
+    std::vector<int64_t> delays;
+    for (int i = 0; i < 5; ++i) {
+        const RecoveryDecision decision = recovery.OnTerminated(
+            1, "https://a.test/" + std::to_string(i), RendererExit::kCrashed, start);
+        EXPECT_TRUE(decision.reload);
+        EXPECT_EQ(decision.attempt, i + 1);
+        delays.push_back(decision.delay.count());
+    }
+    EXPECT_EQ(delays, (std::vector<int64_t>{100, 200, 400, 500, 500}));
+
+    recovery.OnLoadEnd(1);
+    const RecoveryDecision decision =
+        recovery.OnTerminated(1, "https://a.test/x", RendererExit::kOutOfMemory, start);
+    EXPECT_EQ(decision.attempt, 1);
+    EXPECT_EQ(decision.delay.count(), 100);
+    EXPECT_EQ(decision.exit, RendererExit::kOutOfMemory);
+
+    EXPECT_EQ(recovery.stats().exits[static_cast<size_t>(RendererExit::kCrashed)], 5u);
+    EXPECT_EQ(recovery.stats().reloads, 6u);
+}
+
+TEST(RendererRecoveryTest, NavigationSupersedesPendingReload) {
+    RendererRecovery recovery(MakeOptions());
+    const RecoveryDecision decision =
+        recovery.OnTerminated(1, "https://a.test/", RendererExit::kCrashed, Clock::now());
+    EXPECT_TRUE(recovery.IsCurrent(1, decision.generation));
+    EXPECT_FALSE(recovery.IsCurrent(2, decision.generation));
+
+    recovery.OnLoadStart(1);
+    EXPECT_FALSE(recovery.IsCurrent(1, decision.generation));
+
+    recovery.OnBrowserClosed(1);
+    EXPECT_FALSE(recovery.IsCurrent(1, decision.generation));
+}
+
+TEST(RendererRecoveryTest, QuarantinesUrlsThatKeepCrashing) {
+    RendererRecovery recovery(MakeOptions());
+    const Clock::time_point start = Clock::now();
+
+    // Exits spread over more than the window don't add up
+    EXPECT_TRUE(recovery.OnTerminated(1, "https://bad.test/#a", RendererExit::kCrashed, start)
+                    .reload);
+    EXPECT_TRUE(recovery
+                    .OnTerminated(2, "https://bad.test/", RendererExit::kCrashed,
+                                  start + seconds(61))
+                    .reload);
+    RecoveryDecision decision = recovery.OnTerminated(1, "https://bad.test/#b",
+                                                      RendererExit::kCrashed, start + seconds(62));
+    EXPECT_TRUE(decision.reload);
+    EXPECT_FALSE(decision.quarantined);
+    EXPECT_EQ(decision.url_exits, 2);
+
+    // Third exit within the window, from any browser and fragment
+    decision = recovery.OnTerminated(3, "https://bad.test/#c", RendererExit::kOutOfMemory,
+                                     start + seconds(63));
+    EXPECT_FALSE(decision.reload);
+    EXPECT_TRUE(decision.quarantined);
+    EXPECT_EQ(decision.url_exits, 3);
+
+    EXPECT_TRUE(recovery.IsQuarantined("https://bad.test/", start + seconds(64)));
+    EXPECT_TRUE(recovery.IsQuarantined("https://bad.test/#top", start + seconds(64)));
+    EXPECT_FALSE(recovery.IsQuarantined("https://good.test/", start + seconds(64)));
+    EXPECT_FALSE(recovery.IsQuarantined("https://bad.test/", start + seconds(363)));
+
+    // Unknown URLs cannot be reloaded
+    EXPECT_FALSE(recovery.OnTerminated(4, "", RendererExit::kAbnormal, start).reload);
+
+    EXPECT_EQ(recovery.stats().quarantined, 1u);
+    EXPECT_EQ(recovery.stats().refused, 2u);
+}
+
+TEST(RendererRecoveryTest, ReportsRenderersThatStopAnswering) {
+    RendererRecovery recovery(MakeOptions());
+    const Clock::time_point start = Clock::now();
+
+    const uint32_t first = recovery.StartPing(1, start);
+    recovery.StartPing(2, start);
+    EXPECT_TRUE(recovery.OnPong(1, first, start + milliseconds(3)));
+    EXPECT_FALSE(recovery.OnPong(1, first + 1, start + milliseconds(3)));
+    EXPECT_FALSE(recovery.OnPong(9, 1, start));
+
+    // A hang is timed from the oldest unanswered ping
+    recovery.StartPing(1, start + milliseconds(500));
+    recovery.StartPing(2, start + milliseconds(500));
+    EXPECT_EQ(recovery.FindHung(start + milliseconds(1000)), std::vector<int>{2});
+    EXPECT_EQ(recovery.FindHung(start + milliseconds(1500)), std::vector<int>{1});
+    EXPECT_TRUE(recovery.FindHung(start + milliseconds(5000)).empty());
+
+    // Killing a hung renderer is recovered as a hang
+    const RecoveryDecision decision = recovery.OnTerminated(
+        2, "https://a.test/", RendererExit::kKilled, start + milliseconds(5000));
+    EXPECT_EQ(decision.exit, RendererExit::kHung);
+    EXPECT_TRUE(decision.reload);
+
+    // A late answer clears a hang
+    const uint32_t late = recovery.StartPing(1, start + milliseconds(5000));
+    EXPECT_TRUE(recovery.OnPong(1, late, start + milliseconds(5010)));
+    EXPECT_EQ(recovery.FindHung(start + milliseconds(9000)), std::vector<int>{});
+
+    const RendererRecoveryStats& stats = recovery.stats();
+    EXPECT_EQ(stats.hangs, 2u);
+    EXPECT_EQ(stats.pongs, 2u);
+    EXPECT_EQ(stats.round_trip_us.count(), 2u);
+    EXPECT_EQ(stats.exits[static_cast<size_t>(RendererExit::kHung)], 1u);
+
+    JsonWriter writer;
+    stats.WriteJson(writer);
+    EXPECT_NE(writer.str().find("\"exits\":{\"hung\":1}"), std::string::npos);
+}
+
+TEST(RendererRecoveryTest, RetriesRefusedKillsThenGivesUp) {
+    RendererRecovery recovery(MakeOptions());
+    const Clock::time_point start = Clock::now();
+
+    recovery.StartPing(1, start);
+    ASSERT_EQ(recovery.FindHung(start + milliseconds(1000)), std::vector<int>{1});
+
+    // A refused kill reports the hang again after another timeout
+    EXPECT_EQ(recovery.OnKillRefused(1, start + milliseconds(1000)), RefusedKill::kRetry);
+    EXPECT_TRUE(recovery.FindHung(start + milliseconds(1999)).empty());
+    EXPECT_EQ(recovery.FindHung(start + milliseconds(2000)), std::vector<int>{1});
+
+    // The last refused kill closes the browser, whose hang is not reported again
+    EXPECT_EQ(recovery.OnKillRefused(1, start + milliseconds(2000)), RefusedKill::kClose);
+    EXPECT_TRUE(recovery.FindHung(start + milliseconds(9000)).empty());
+
+    // Nothing to refuse for a renderer that is not hung, or answered meanwhile
+    EXPECT_EQ(recovery.OnKillRefused(9, start), RefusedKill::kIgnore);
+    const uint32_t sequence = recovery.StartPing(2, start);
+    ASSERT_EQ(recovery.FindHung(start + milliseconds(9000)), std::vector<int>{2});
+    EXPECT_TRUE(recovery.OnPong(2, sequence, start + milliseconds(9001)));
+    EXPECT_EQ(recovery.OnKillRefused(2, start + milliseconds(9001)), RefusedKill::kIgnore);
+
+    const RendererRecoveryStats& stats = recovery.stats();
+    EXPECT_EQ(stats.hangs, 2u);
+    EXPECT_EQ(stats.kills_refused, 2u);
+    EXPECT_EQ(stats.hang_closes, 1u);
+}
+
+TEST(RendererRecoveryTest, ParsesProcessStatus) {
+    // A sandboxed renderer: pid 4321 here, 2 in its own namespace
+    ProcessStatus status = ParseProcessStatus(
+        "Name:\tchrome\nState:\tS (sleeping)\nTgid:\t4321\nPid:\t4321\nPPid:\t4300\n"
+        "NSpid:\t4321\t7\t2\nNSpgid:\t4300\t1\t1\n");
+    EXPECT_EQ(status.ppid, 4300);
+    EXPECT_EQ(status.namespace_pid, 2);
+
+    status = ParseProcessStatus("Pid:\t55\nPPid:\t1\nNSpid:\t55\n");
+    EXPECT_EQ(status.ppid, 1);
+    EXPECT_EQ(status.namespace_pid, 55);
+
+    // Kernels before 4.1 have no NSpid line
+    status = ParseProcessStatus("Pid:\t55\nPPid:\t1\n");
+    EXPECT_EQ(status.namespace_pid, 0);
+    EXPECT_EQ(ParseProcessStatus("").ppid, 0);
+}
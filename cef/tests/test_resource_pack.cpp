@@ -0,0 +1,154 @@
+// CEF Browser - Unit Tests for the Resource Pack
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "resource_pack.h"
+
+class ResourcePackTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = ::testing::TempDir() + "resource_pack_test.pak";
+    }
+
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+
+    // The pack at |path_| as bytes
+    std::string ReadPack() {
+        std::ifstream in(path_, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void WritePack(const std::string& bytes) {
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    // Entry |i| of the index in |bytes|
+    static ResourcePackEntry* EntryAt(std::string& bytes, size_t i) {
+        return reinterpret_cast<ResourcePackEntry*>(&bytes[sizeof(ResourcePackHeader)]) + i;
+    }
+
+    std::string path_;
+};
+
+TEST_F(ResourcePackTest, LookupReturnsStoredEntries) {
+    std::vector<ResourcePackInput> inputs = {
+        {"internal/error.html", "<html>error</html>"},
+        {"internal/blank.html", "<html></html>"},
+        {"empty.txt", ""},
+    };
+    ASSERT_TRUE(WriteResourcePack(path_, inputs, false));
+
+    ResourcePack pack;
+    ASSERT_TRUE(pack.Open(path_));
+    EXPECT_EQ(pack.GetEntryCount(), 3u);
+
+    for (const ResourcePackInput& input : inputs) {
+        std::string_view data;
+        ASSERT_TRUE(pack.Lookup(input.name, &data)) << input.name;
+        EXPECT_EQ(data, input.data);
+    }
+}
+
+TEST_F(ResourcePackTest, LookupMissingEntry) {
+    ASSERT_TRUE(WriteResourcePack(path_, {{"a.txt", "a"}, {"c.txt", "c"}}, false));
+
+    ResourcePack pack;
+    ASSERT_TRUE(pack.Open(path_));
+
+    std::string_view data;
+    EXPECT_FALSE(pack.Lookup("b.txt", &data));
+    EXPECT_FALSE(pack.Lookup("", &data));
+    EXPECT_FALSE(pack.Lookup("c.txt.bak", &data));
+}
+
+TEST_F(ResourcePackTest, CompressedEntriesRoundTrip) {
+    std::string repetitive(64 * 1024, 'x');
+    std::string incompressible;
+    for (int i = 0; i < 256; ++i) {
+        incompressible.push_back(static_cast<char>((i * 167 + 13) & 0xFF));
+    }
+
+    ASSERT_TRUE(
+        WriteResourcePack(path_, {{"big.css", repetitive}, {"noise.bin", incompressible}}, true));
+
+    ResourcePack pack;
+    ASSERT_TRUE(pack.Open(path_));
+
+    std::string_view data;
+    ASSERT_TRUE(pack.Lookup("big.css", &data));
+    EXPECT_EQ(data, repetitive);
+
+    // Repeated lookups of an inflated entry return the same cached buffer
+    std::string_view again;
+    ASSERT_TRUE(pack.Lookup("big.css", &again));
+    EXPECT_EQ(data.data(), again.data());
+
+    ASSERT_TRUE(pack.Lookup("noise.bin", &data));
+    EXPECT_EQ(data, incompressible);
+}
+
+TEST_F(ResourcePackTest, RejectsDuplicateNames) {
+    EXPECT_FALSE(WriteResourcePack(path_, {{"a.txt", "1"}, {"a.txt", "2"}}, false));
+}
+
+TEST_F(ResourcePackTest, RejectsInvalidFiles) {
+    ResourcePack pack;
+    EXPECT_FALSE(pack.Open(path_ + ".missing"));
+    EXPECT_FALSE(pack.IsValid());
+
+    FILE* file = std::fopen(path_.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fputs("not a resource pack", file);
+    std::fclose(file);
+
+    EXPECT_FALSE(pack.Open(path_));
+
+    std::string_view data;
+    EXPECT_FALSE(pack.Lookup("anything", &data));
+}
+
+TEST_F(ResourcePackTest, RejectsOverflowingEntries) {
+    ASSERT_TRUE(WriteResourcePack(path_, {{"a.txt", "aaaa"}, {"b.txt", "bbbb"}}, false));
+    const std::string original = ReadPack();
+    ResourcePack pack;
+
+    // data_offset + stored_size wraps around to a small value
+    std::string bytes = original;
+    EntryAt(bytes, 1)->stored_size = ~uint64_t{0} - EntryAt(bytes, 1)->data_offset + 2;
+    WritePack(bytes);
+    EXPECT_FALSE(pack.Open(path_));
+
+    bytes = original;
+    EntryAt(bytes, 0)->data_offset = ~uint64_t{0};
+    WritePack(bytes);
+    EXPECT_FALSE(pack.Open(path_));
+
+    bytes = original;
+    EntryAt(bytes, 0)->name_length = ~uint32_t{0};
+    WritePack(bytes);
+    EXPECT_FALSE(pack.Open(path_));
+
+    WritePack(original);
+    EXPECT_TRUE(pack.Open(path_));
+}
+
+TEST_F(ResourcePackTest, RejectsUnsortedIndex) {
+    ASSERT_TRUE(WriteResourcePack(path_, {{"a.txt", "a"}, {"b.txt", "b"}}, false));
+    std::string bytes = ReadPack();
+    ResourcePackEntry first;
+    std::memcpy(&first, EntryAt(bytes, 0), sizeof(first));
+    std::memcpy(EntryAt(bytes, 0), EntryAt(bytes, 1), sizeof(first));
+    std::memcpy(EntryAt(bytes, 1), &first, sizeof(first));
+    WritePack(bytes);
+
+    ResourcePack pack;
+    EXPECT_FALSE(pack.Open(path_));
+}
@@ -0,0 +1,69 @@
+// CEF Browser - Unit Tests for Resource Suppression Policy
+#include <gtest/gtest.h>
+
+#include "json_writer.h"
+#include "resource_policy.h"
+
+TEST(ResourcePolicyTest, ParsesTypesAndMimeTypes) {
+    ResourcePolicy policy;
+    EXPECT_TRUE(policy.empty());
+    ASSERT_TRUE(
+        ParseResourcePolicy(" image=placeholder, font,media=cancel,beacon, Video/*", &policy));
+    EXPECT_EQ(policy.placeholder_types, kContentImage);
+    EXPECT_EQ(policy.cancel_types, kContentFont | kContentMedia | kContentPing);
+    ASSERT_EQ(policy.blocked_mime_types.size(), 1u);
+    EXPECT_EQ(policy.blocked_mime_types[0], "video/*");
+    EXPECT_FALSE(policy.empty());
+
+    // Later entries move a type between actions
+    ASSERT_TRUE(ParseResourcePolicy("font=placeholder", &policy));
+    EXPECT_EQ(policy.placeholder_types, kContentImage | kContentFont);
+    EXPECT_EQ(policy.cancel_types, kContentMedia | kContentPing);
+
+    for (const char* spec : {"images", "image=drop", "font,bogus", "=cancel"}) {
+        EXPECT_FALSE(ParseResourcePolicy(spec, &policy)) << spec;
+    }
+    EXPECT_EQ(policy.placeholder_types, kContentImage | kContentFont);
+}
+
+TEST(ResourcePolicyTest, MatchesMimeTypes) {
+    ResourcePolicy policy;
+    ASSERT_TRUE(ParseResourcePolicy("video/*,application/pdf", &policy));
+
+    EXPECT_TRUE(policy.BlocksMimeType("video/mp4"));
+    EXPECT_TRUE(policy.BlocksMimeType("Application/PDF; charset=binary"));
+    EXPECT_FALSE(policy.BlocksMimeType("video"));
+    EXPECT_FALSE(policy.BlocksMimeType("video/"));
+    EXPECT_FALSE(policy.BlocksMimeType("application/pdfx"));
+    EXPECT_FALSE(policy.BlocksMimeType("text/html"));
+    EXPECT_FALSE(ResourcePolicy().BlocksMimeType("video/mp4"));
+}
+
+TEST(ResourcePolicyTest, Placeholders) {
+    ResourcePlaceholder image = GetResourcePlaceholder(kContentImage);
+    EXPECT_EQ(image.status, 200);
+    EXPECT_STREQ(image.mime_type, "image/gif");
+    ASSERT_EQ(image.body.size(), 43u);
+    EXPECT_EQ(image.body.substr(0, 6), "GIF89a");
+    EXPECT_EQ(image.body.back(), ';');
+
+    ResourcePlaceholder ping = GetResourcePlaceholder(kContentPing);
+    EXPECT_EQ(ping.status, 204);
+    EXPECT_TRUE(ping.body.empty());
+
+    EXPECT_STREQ(GetResourcePlaceholder(kContentStylesheet).mime_type, "text/css");
+    EXPECT_TRUE(GetResourcePlaceholder(kContentFont).body.empty());
+}
+
+TEST(ResourcePolicyTest, WritesCounts) {
+    ResourcePolicyCounts counts;
+    counts.cancelled = 3;
+    counts.substituted = 2;
+    counts.aborted = 1;
+    counts.bytes_avoided = 4096;
+
+    JsonWriter writer;
+    counts.WriteJson(writer);
+    EXPECT_EQ(writer.str(),
+              "{\"cancelled\":3,\"substituted\":2,\"aborted\":1,\"bytes_avoided\":4096}");
+}
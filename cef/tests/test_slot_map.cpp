@@ -0,0 +1,85 @@
+// CEF Browser - Unit Tests for the Generational Slot Map
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "slot_map.h"
+
+TEST(SlotMapTest, InsertsAndGets) {
+    SlotMap<int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.Get(SlotHandle()), nullptr);
+
+    const SlotHandle a = map.Insert(1);
+    const SlotHandle b = map.Insert(2);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(map.size(), 2u);
+    ASSERT_NE(map.Get(a), nullptr);
+    EXPECT_EQ(*map.Get(a), 1);
+    EXPECT_EQ(*map.Get(b), 2);
+
+    *map.Get(b) = 20;
+    EXPECT_EQ(*map.Get(b), 20);
+}
+
+TEST(SlotMapTest, EraseKeepsOtherHandlesValid) {
+    SlotMap<int> map;
+    std::vector<SlotHandle> handles;
+    for (int i = 0; i < 5; ++i) {
+        handles.push_back(map.Insert(i));
+    }
+
+    // Erasing from the middle moves the last value into the gap
+    EXPECT_TRUE(map.Erase(handles[1]));
+    EXPECT_FALSE(map.Erase(handles[1]));
+    EXPECT_EQ(map.Get(handles[1]), nullptr);
+    EXPECT_EQ(map.size(), 4u);
+    for (int i : {0, 2, 3, 4}) {
+        ASSERT_NE(map.Get(handles[i]), nullptr);
+        EXPECT_EQ(*map.Get(handles[i]), i);
+    }
+
+    std::vector<int> values(map.begin(), map.end());
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(values, (std::vector<int>{0, 2, 3, 4}));
+
+    // Handles of every value, wherever it moved
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        EXPECT_EQ(*map.Get(map.HandleOf(it)), *it);
+    }
+}
+
+TEST(SlotMapTest, ReusedSlotInvalidatesOldHandle) {
+    SlotMap<int> map;
+    const SlotHandle old_handle = map.Insert(1);
+    map.Erase(old_handle);
+
+    const SlotHandle new_handle = map.Insert(2);
+    EXPECT_EQ(new_handle.index, old_handle.index);
+    EXPECT_NE(new_handle.generation, old_handle.generation);
+    EXPECT_EQ(map.Get(old_handle), nullptr);
+    EXPECT_EQ(*map.Get(new_handle), 2);
+    EXPECT_FALSE(map.Erase(old_handle));
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(SlotMapTest, HoldsMoveOnlyValues) {
+    SlotMap<std::unique_ptr<int>> map;
+    const SlotHandle a = map.Insert(std::make_unique<int>(1));
+    const SlotHandle b = map.Insert(std::make_unique<int>(2));
+    map.Erase(a);
+    EXPECT_EQ(**map.Get(b), 2);
+
+    map.Clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.Get(b), nullptr);
+
+    // Every slot is free again
+    const SlotHandle c = map.Insert(std::make_unique<int>(3));
+    const SlotHandle d = map.Insert(std::make_unique<int>(4));
+    EXPECT_LT(c.index, 2u);
+    EXPECT_LT(d.index, 2u);
+    EXPECT_EQ(**map.Get(d), 4);
+}
@@ -0,0 +1,73 @@
+// CEF Browser - Unit Tests for Trace Files and URL Patterns
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "trace_files.h"
+#include "url_pattern.h"
+
+namespace fs = std::filesystem;
+
+TEST(URLPatternTest, MatchesWildcards) {
+    EXPECT_TRUE(MatchURLPattern("https://a.example.com/x", "*://*.example.com/*"));
+    EXPECT_TRUE(MatchURLPattern("https://a.test/", "https://a.test/"));
+    EXPECT_TRUE(MatchURLPattern("https://a.test/", "*"));
+    EXPECT_FALSE(MatchURLPattern("http://b.test/", "http?://b.test/"));
+    EXPECT_TRUE(MatchURLPattern("https://b.test/", "http?://b.test/"));
+    EXPECT_TRUE(MatchURLPattern("https://a.test/a/b/c", "*/a/*/c"));
+    EXPECT_FALSE(MatchURLPattern("https://example.com/", "*://*.example.com/*"));
+    EXPECT_FALSE(MatchURLPattern("https://a.test/x", "https://a.test/"));
+    EXPECT_FALSE(MatchURLPattern("https://a.test/", ""));
+    EXPECT_TRUE(MatchURLPattern("", "*"));
+}
+
+TEST(TraceFilesTest, NamesSortByTime) {
+    EXPECT_EQ(MakeTraceFileName(0, 7), "trace-19700101-000000-0007.json");
+    EXPECT_LT(MakeTraceFileName(1700000000, 9999), MakeTraceFileName(1700000001, 0));
+}
+
+class TraceRotationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::path(::testing::TempDir()) / "trace_rotation_test";
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+
+    void WriteFile(const std::string& name, size_t size) {
+        std::ofstream out(dir_ / name, std::ios::binary);
+        out << std::string(size, 'x');
+    }
+
+    fs::path dir_;
+};
+
+TEST_F(TraceRotationTest, DeletesOldestTracesOverLimit) {
+    WriteFile(MakeTraceFileName(100, 0), 100);
+    WriteFile(MakeTraceFileName(200, 1), 100);
+    WriteFile(MakeTraceFileName(300, 2), 100);
+    WriteFile("navigation_metrics.json", 1000);
+
+    EXPECT_EQ(RotateTraceFiles(dir_.string(), 250), 1u);
+    EXPECT_FALSE(fs::exists(dir_ / MakeTraceFileName(100, 0)));
+    EXPECT_TRUE(fs::exists(dir_ / MakeTraceFileName(200, 1)));
+    EXPECT_TRUE(fs::exists(dir_ / MakeTraceFileName(300, 2)));
+    EXPECT_TRUE(fs::exists(dir_ / "navigation_metrics.json"));
+}
+
+TEST_F(TraceRotationTest, KeepsNewestTrace) {
+    WriteFile(MakeTraceFileName(100, 0), 100);
+    WriteFile(MakeTraceFileName(200, 1), 500);
+
+    EXPECT_EQ(RotateTraceFiles(dir_.string(), 10), 1u);
+    EXPECT_TRUE(fs::exists(dir_ / MakeTraceFileName(200, 1)));
+}
+
+TEST_F(TraceRotationTest, MissingDirectory) {
+    EXPECT_EQ(RotateTraceFiles((dir_ / "missing").string(), 0), 0u);
+}
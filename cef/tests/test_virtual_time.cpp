@@ -0,0 +1,31 @@
+// CEF Browser - Unit Tests for Virtual Time Options
+#include <gtest/gtest.h>
+
+#include "virtual_time.h"
+
+TEST(VirtualTimeTest, GeneratorIsSeeded) {
+    uint32_t state = 42;
+    // First value of the page script for seed 42, as computed by V8
+    EXPECT_DOUBLE_EQ(NextDeterministicRandom(&state), 0.6011037519201636);
+    EXPECT_DOUBLE_EQ(NextDeterministicRandom(&state), 0.44829055899754167);
+
+    uint32_t a = 7;
+    uint32_t b = 7;
+    uint32_t c = 8;
+    bool differs = false;
+    for (int i = 0; i < 1000; ++i) {
+        const double value = NextDeterministicRandom(&a);
+        EXPECT_GE(value, 0.0);
+        EXPECT_LT(value, 1.0);
+        EXPECT_EQ(value, NextDeterministicRandom(&b));
+        differs |= value != NextDeterministicRandom(&c);
+    }
+    EXPECT_TRUE(differs);
+}
+
+TEST(VirtualTimeTest, ScriptEmbedsSeed) {
+    const std::string script = FormatDeterministicScript(4000000000u);
+    EXPECT_NE(script.find("let state = 4000000000 >>> 0;"), std::string::npos);
+    EXPECT_NE(script.find("Math.random = function random()"), std::string::npos);
+    EXPECT_NE(FormatDeterministicScript(1), FormatDeterministicScript(2));
+}
@@ -0,0 +1,173 @@
+// CEF Browser - Unit Tests for the Responsiveness Watchdog
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <signal.h>
+#endif
+
+#include "json_writer.h"
+#include "stack_snapshot.h"
+#include "watchdog.h"
+
+namespace {
+
+using Clock = Watchdog::Clock;
+using std::chrono::milliseconds;
+
+WatchdogOptions MakeOptions() {
+    WatchdogOptions options;
+    options.stall_threshold = milliseconds(100);
+    return options;
+}
+
+}  // namespace
+
+TEST(WatchdogTest, RecordsHeartbeatDelays) {
+    Watchdog watchdog(MakeOptions());
+    const int ui = watchdog.AddTarget("ui");
+    const int first = watchdog.AddTarget("renderer");
+    const int second = watchdog.AddTarget("renderer");
+    const Clock::time_point start = Clock::now();
+
+    EXPECT_TRUE(watchdog.BeginBeat(ui, start));
+    EXPECT_TRUE(watchdog.BeginBeat(first, start));
+    EXPECT_TRUE(watchdog.BeginBeat(second, start));
+
+    // One heartbeat pending at a time
+    EXPECT_FALSE(watchdog.BeginBeat(ui, start + milliseconds(1)));
+    EXPECT_FALSE(watchdog.BeginBeat(99, start));
+
+    EXPECT_FALSE(watchdog.EndBeat(ui, start + milliseconds(2)));
+    EXPECT_FALSE(watchdog.EndBeat(first, start + milliseconds(5)));
+    EXPECT_FALSE(watchdog.EndBeat(second, start + milliseconds(7)));
+    EXPECT_FALSE(watchdog.EndBeat(second, start + milliseconds(8)));
+    EXPECT_TRUE(watchdog.BeginBeat(ui, start + milliseconds(9)));
+
+    const WatchdogStats stats = watchdog.GetStats();
+    ASSERT_EQ(stats.targets.size(), 2u);
+    EXPECT_EQ(stats.targets.at("ui").beats, 1u);
+    EXPECT_EQ(stats.targets.at("ui").delay_us.max(), 2000u);
+    EXPECT_EQ(stats.targets.at("renderer").beats, 2u);
+    EXPECT_EQ(stats.targets.at("renderer").delay_us.min(), 5000u);
+    EXPECT_EQ(stats.targets.at("renderer").stalls, 0u);
+}
+
+TEST(WatchdogTest, ReportsEachStallOnce) {
+    Watchdog watchdog(MakeOptions());
+    const int ui = watchdog.AddTarget("ui");
+    const int io = watchdog.AddTarget("io");
+    const Clock::time_point start = Clock::now();
+
+    watchdog.BeginBeat(ui, start);
+    watchdog.BeginBeat(io, start + milliseconds(50));
+    EXPECT_TRUE(watchdog.FindStalls(start + milliseconds(99)).empty());
+
+    std::vector<WatchdogStall> stalls = watchdog.FindStalls(start + milliseconds(120));
+    ASSERT_EQ(stalls.size(), 1u);
+    EXPECT_EQ(stalls[0].target, ui);
+    EXPECT_EQ(stalls[0].name, "ui");
+    EXPECT_EQ(stalls[0].pending.count(), 120);
+    EXPECT_TRUE(watchdog.IsStalled(ui));
+    EXPECT_FALSE(watchdog.IsStalled(io));
+
+    stalls = watchdog.FindStalls(start + milliseconds(200));
+    ASSERT_EQ(stalls.size(), 1u);
+    EXPECT_EQ(stalls[0].name, "io");
+
+    // The stall ends when its heartbeat arrives
+    EXPECT_TRUE(watchdog.EndBeat(ui, start + milliseconds(300)));
+    EXPECT_FALSE(watchdog.IsStalled(ui));
+
+    // An exited process is not stalled
+    watchdog.CancelBeat(io);
+    EXPECT_FALSE(watchdog.IsStalled(io));
+    EXPECT_FALSE(watchdog.EndBeat(io, start + milliseconds(400)));
+    EXPECT_TRUE(watchdog.FindStalls(start + milliseconds(1000)).empty());
+
+    const WatchdogStats stats = watchdog.GetStats();
+    EXPECT_EQ(stats.targets.at("ui").stalls, 1u);
+    EXPECT_EQ(stats.targets.at("ui").longest_stall_ms, 300u);
+    EXPECT_EQ(stats.targets.at("io").stalls, 1u);
+    EXPECT_EQ(stats.targets.at("io").beats, 0u);
+
+    JsonWriter writer;
+    stats.WriteJson(writer);
+    EXPECT_NE(writer.str().find("\"ui\":{\"beats\":1,\"stalls\":1,\"longest_stall_ms\":300"),
+              std::string::npos)
+        << writer.str();
+}
+
+TEST(WatchdogTest, FormatsStalls) {
+    WatchdogStall stall;
+    stall.name = "ui";
+    stall.pending = milliseconds(2500);
+    EXPECT_EQ(FormatWatchdogStall(stall, 0, {"a(f+0x1) [0x10]", "b(g+0x2) [0x20]"}),
+              "1970-01-01T00:00:00Z ui stalled for 2500 ms\n"
+              "    a(f+0x1) [0x10]\n"
+              "    b(g+0x2) [0x20]\n");
+}
+
+#if !defined(_WIN32)
+TEST(StackSnapshotTest, CapturesABlockedThread) {
+    std::atomic<bool> started{false};
+    std::atomic<bool> done{false};
+    NativeThread native;
+    std::thread thread([&] {
+        native = GetCurrentNativeThread();
+        started = true;
+        while (!done) {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+
+    // Twice, to check captures don't leak into each other
+    for (int i = 0; i < 2; ++i) {
+        const std::vector<std::string> stack = CaptureThreadStack(native, milliseconds(1000));
+        EXPECT_GE(stack.size(), 3u);
+    }
+    done = true;
+    thread.join();
+}
+
+TEST(StackSnapshotTest, GivesUpOnAThreadThatDoesNotAnswer) {
+    std::atomic<bool> started{false};
+    std::atomic<bool> unblock{false};
+    std::atomic<bool> done{false};
+    NativeThread native;
+    std::thread thread([&] {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGURG);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+        native = GetCurrentNativeThread();
+        started = true;
+        while (!unblock) {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        // The signal of the abandoned capture arrives now
+        pthread_sigmask(SIG_UNBLOCK, &signals, nullptr);
+        while (!done) {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+
+    EXPECT_TRUE(CaptureThreadStack(native, milliseconds(20)).empty());
+    unblock = true;
+    std::this_thread::sleep_for(milliseconds(20));
+
+    // The late signal claims nothing, and the next capture is answered
+    EXPECT_GE(CaptureThreadStack(native, milliseconds(1000)).size(), 3u);
+    done = true;
+    thread.join();
+}
+#endif
@@ -0,0 +1,141 @@
+// CEF Browser - Unit Tests for WebSocket and HTTP Framing
+#include <gtest/gtest.h>
+#include <cstring>
+
+#include "websocket.h"
+
+namespace {
+
+// Mask |payload| as a client would
+std::string ClientFrame(uint8_t first_byte, const std::string& payload) {
+    const char mask[4] = {0x12, 0x34, 0x56, 0x78};
+    std::string frame(1, static_cast<char>(first_byte));
+    if (payload.size() < 126) {
+        frame.push_back(static_cast<char>(0x80 | payload.size()));
+    } else {
+        frame.push_back(static_cast<char>(0x80 | 126));
+        frame.push_back(static_cast<char>(payload.size() >> 8));
+        frame.push_back(static_cast<char>(payload.size()));
+    }
+    frame.append(mask, 4);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        frame.push_back(static_cast<char>(payload[i] ^ mask[i & 3]));
+    }
+    return frame;
+}
+
+}  // namespace
+
+TEST(WebSocketTest, ComputesSha1) {
+    uint8_t digest[20];
+    Sha1("abc", 3, digest);
+    const uint8_t expected[20] = {0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81, 0x6a, 0xba, 0x3e,
+                                  0x25, 0x71, 0x78, 0x50, 0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d};
+    EXPECT_EQ(std::memcmp(digest, expected, sizeof(digest)), 0);
+
+    // Two padding blocks
+    const std::string long_input(56, 'a');
+    Sha1(long_input.data(), long_input.size(), digest);
+    const uint8_t expected_long[20] = {0xc2, 0xdb, 0x33, 0x0f, 0x60, 0x83, 0x85, 0x4c, 0x99, 0xd4,
+                                       0xb5, 0xbf, 0xb6, 0xe8, 0xf2, 0x9f, 0x20, 0x1b, 0xe6, 0x99};
+    EXPECT_EQ(std::memcmp(digest, expected_long, sizeof(digest)), 0);
+}
+
+TEST(WebSocketTest, ParsesUpgradeRequest) {
+    const std::string request =
+        "GET /devtools/page/3 HTTP/1.1\r\n"
+        "Host: 127.0.0.1:9222\r\n"
+        "Connection: keep-alive, Upgrade\r\n"
+        "Upgrade: websocket\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+        "\r\n";
+
+    HttpRequestHead head;
+    size_t consumed = 0;
+    EXPECT_EQ(ParseHttpRequestHead(request.substr(0, 40), &head, &consumed),
+              ParseStatus::kIncomplete);
+    ASSERT_EQ(ParseHttpRequestHead(request + "extra", &head, &consumed), ParseStatus::kComplete);
+    EXPECT_EQ(consumed, request.size());
+    EXPECT_EQ(head.method, "GET");
+    EXPECT_EQ(head.path, "/devtools/page/3");
+    EXPECT_EQ(head.Header("host"), "127.0.0.1:9222");
+    EXPECT_TRUE(IsWebSocketUpgrade(head));
+
+    // RFC 6455 1.3 example
+    EXPECT_EQ(ComputeWebSocketAccept("dGhlIHNhbXBsZSBub25jZQ=="), "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+    EXPECT_NE(FormatWebSocketHandshake(head).find(
+                  "Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n"),
+              std::string::npos);
+
+    head.headers.erase("upgrade");
+    EXPECT_FALSE(IsWebSocketUpgrade(head));
+    EXPECT_EQ(ParseHttpRequestHead("GARBAGE\r\n\r\n", &head, &consumed), ParseStatus::kError);
+    EXPECT_EQ(ParseHttpRequestHead(std::string(100, 'x'), &head, &consumed, 64),
+              ParseStatus::kError);
+}
+
+TEST(WebSocketTest, DecodesMaskedFrames) {
+    const std::string message = R"({"id":1,"method":"Page.enable"})";
+    const std::string frame = ClientFrame(0x81, message);
+
+    WebSocketFrame decoded;
+    size_t consumed = 0;
+    EXPECT_EQ(DecodeWebSocketFrame(frame.substr(0, frame.size() - 1), &decoded, &consumed),
+              ParseStatus::kIncomplete);
+    ASSERT_EQ(DecodeWebSocketFrame(frame, &decoded, &consumed), ParseStatus::kComplete);
+    EXPECT_EQ(consumed, frame.size());
+    EXPECT_EQ(decoded.opcode, kWebSocketText);
+    EXPECT_TRUE(decoded.fin);
+    EXPECT_EQ(decoded.payload, message);
+
+    // 16-bit length
+    const std::string large(300, 'z');
+    ASSERT_EQ(DecodeWebSocketFrame(ClientFrame(0x82, large), &decoded, &consumed),
+              ParseStatus::kComplete);
+    EXPECT_EQ(decoded.payload, large);
+    EXPECT_EQ(DecodeWebSocketFrame(ClientFrame(0x82, large), &decoded, &consumed, 100),
+              ParseStatus::kError);
+
+    // Unmasked client frames and fragmented control frames are invalid
+    EXPECT_EQ(DecodeWebSocketFrame(std::string("\x81\x01x", 3), &decoded, &consumed),
+              ParseStatus::kError);
+    EXPECT_EQ(DecodeWebSocketFrame(ClientFrame(0x09, "ping"), &decoded, &consumed),
+              ParseStatus::kError);
+}
+
+TEST(WebSocketTest, EncodesServerFrames) {
+    std::string out;
+    EncodeWebSocketFrame(kWebSocketText, "hi", &out);
+    EXPECT_EQ(out, std::string("\x81\x02hi", 4));
+
+    out.clear();
+    EncodeWebSocketFrame(kWebSocketBinary, std::string(70000, 'a'), &out);
+    ASSERT_EQ(out.size(), 10u + 70000u);
+    EXPECT_EQ(static_cast<uint8_t>(out[1]), 127);
+    EXPECT_EQ(static_cast<uint8_t>(out[7]), 0x01);
+    EXPECT_EQ(static_cast<uint8_t>(out[8]), 0x11);
+    EXPECT_EQ(static_cast<uint8_t>(out[9]), 0x70);
+}
+
+TEST(WebSocketTest, RoundTripsClientFrames) {
+    const uint8_t mask[4] = {0x37, 0xFA, 0x21, 0x3D};
+    std::string out;
+    EncodeWebSocketFrame(kWebSocketText, "Hello", &out, mask);
+
+    // RFC 6455 5.7 example
+    EXPECT_EQ(out, std::string("\x81\x85\x37\xfa\x21\x3d\x7f\x9f\x4d\x51\x58", 11));
+
+    WebSocketFrame decoded;
+    size_t consumed = 0;
+    ASSERT_EQ(DecodeWebSocketFrame(out, &decoded, &consumed), ParseStatus::kComplete);
+    EXPECT_EQ(decoded.payload, "Hello");
+
+    // Servers must not mask
+    EXPECT_EQ(DecodeWebSocketFrame(out, &decoded, &consumed, 100, WebSocketSender::kServer),
+              ParseStatus::kError);
+    ASSERT_EQ(DecodeWebSocketFrame(std::string("\x81\x02hi", 4), &decoded, &consumed, 100,
+                                   WebSocketSender::kServer),
+              ParseStatus::kComplete);
+    EXPECT_EQ(decoded.payload, "hi");
+    EXPECT_EQ(consumed, 4u);
+}
@@ -0,0 +1,80 @@
+// CEF Browser - Resource Pack Builder
+// Packs a resources directory into a single indexed archive at build time.
+//
+// Usage: pack_resources <output.pak> <resources_dir> [--compress] [--exclude=<dir>]...
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "resource_pack.h"
+
+namespace fs = std::filesystem;
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <output.pak> <resources_dir> [--compress] [--exclude=<dir>]..." << std::endl;
+        return 1;
+    }
+
+    const std::string output_path = argv[1];
+    const fs::path root = argv[2];
+    bool compress = false;
+    std::vector<std::string> excludes;
+
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--compress") {
+            compress = true;
+        } else if (arg.rfind("--exclude=", 0) == 0) {
+            excludes.push_back(arg.substr(10));
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<ResourcePackInput> inputs;
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(root, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        std::string name = fs::relative(it->path(), root).generic_string();
+
+        if (it->is_directory()) {
+            if (std::find(excludes.begin(), excludes.end(), name) != excludes.end()) {
+                it.disable_recursion_pending();
+            }
+            continue;
+        }
+        if (!it->is_regular_file()) {
+            continue;
+        }
+
+        std::ifstream file(it->path(), std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Failed to read " << it->path() << std::endl;
+            return 1;
+        }
+        inputs.push_back({name, std::string(std::istreambuf_iterator<char>(file),
+                                            std::istreambuf_iterator<char>())});
+    }
+
+    if (ec) {
+        std::cerr << "Failed to scan " << root << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    size_t count = inputs.size();
+    if (!WriteResourcePack(output_path, std::move(inputs), compress)) {
+        std::cerr << "Failed to write " << output_path << std::endl;
+        return 1;
+    }
+
+    std::cout << "Packed " << count << " resources into " << output_path << std::endl;
+    return 0;
+}